@@ -0,0 +1,102 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SampleUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+// Simulates a UI renderer that creates a bind group for every draw even though each draw only
+// references one of a handful of (atlas texture, sampler) pairs. Frozen bind groups are
+// deduplicated by the device so every frame only allocates one bind group per distinct pair,
+// while dynamic bind groups are allocated again for every draw.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kAtlasCount = 8;
+static constexpr uint32_t kDrawsPerFrame = 2000;
+static constexpr uint32_t kFrameCount = 100;
+
+int main(int argc, const char* argv[]) {
+    if (!InitSample(argc, argv)) {
+        return 1;
+    }
+
+    nxt::Device device = CreateCppNXTDevice();
+
+    nxt::BindGroupLayout bgl = device.CreateBindGroupLayoutBuilder()
+        .SetBindingsType(nxt::ShaderStageBit::Fragment, nxt::BindingType::Sampler, 0, 1)
+        .SetBindingsType(nxt::ShaderStageBit::Fragment, nxt::BindingType::SampledTexture, 1, 1)
+        .GetResult();
+
+    std::vector<nxt::TextureView> views;
+    for (uint32_t i = 0; i < kAtlasCount; ++i) {
+        nxt::Texture texture = device.CreateTextureBuilder()
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(256, 256, 1)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+            .GetResult();
+        texture.FreezeUsage(nxt::TextureUsageBit::Sampled);
+        views.push_back(texture.CreateTextureViewBuilder().GetResult());
+    }
+
+    nxt::Sampler samplers[2] = {
+        device.CreateSamplerBuilder()
+            .SetFilterMode(nxt::FilterMode::Nearest, nxt::FilterMode::Nearest, nxt::FilterMode::Nearest)
+            .GetResult(),
+        device.CreateSamplerBuilder()
+            .SetFilterMode(nxt::FilterMode::Linear, nxt::FilterMode::Linear, nxt::FilterMode::Linear)
+            .GetResult(),
+    };
+
+    auto RunFrames = [&](nxt::BindGroupUsage usage, const char* name) {
+        size_t allocations = 0;
+        Clock::time_point start = Clock::now();
+
+        for (uint32_t frame = 0; frame < kFrameCount; ++frame) {
+            // The bind groups stay alive until the end of the frame like they would while
+            // referenced by the frame's command buffers.
+            std::vector<nxt::BindGroup> frameBindGroups;
+            frameBindGroups.reserve(kDrawsPerFrame);
+
+            for (uint32_t draw = 0; draw < kDrawsPerFrame; ++draw) {
+                uint32_t atlas = (draw * 7 + frame) % kAtlasCount;
+                frameBindGroups.push_back(device.CreateBindGroupBuilder()
+                                              .SetLayout(bgl)
+                                              .SetUsage(usage)
+                                              .SetSamplers(0, 1, &samplers[atlas % 2])
+                                              .SetTextureViews(1, 1, &views[atlas])
+                                              .GetResult());
+            }
+
+            std::unordered_set<nxtBindGroup> distinct;
+            for (const nxt::BindGroup& bindGroup : frameBindGroups) {
+                distinct.insert(bindGroup.Get());
+            }
+            allocations += distinct.size();
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        printf("%s: %.2f ms per frame, %.1f bind groups allocated per frame for %u draws\n", name,
+               ms / kFrameCount, static_cast<double>(allocations) / kFrameCount, kDrawsPerFrame);
+    };
+
+    RunFrames(nxt::BindGroupUsage::Dynamic, "Dynamic bind groups");
+    RunFrames(nxt::BindGroupUsage::Frozen, "Frozen bind groups");
+    return 0;
+}
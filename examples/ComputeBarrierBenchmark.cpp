@@ -0,0 +1,169 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SampleUtils.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Measures frames made of many small dispatches, like the steps of a prefix sum or a sort. In the
+// dependent case each dispatch works on the results of the previous one, in the independent case
+// each dispatch works on its own buffer so none of them has to wait for the others. Backends that
+// synchronize after every dispatch make both cases equally slow.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kDispatches = 32;
+static constexpr uint32_t kElements = 4096;
+static constexpr uint32_t kWorkgroupSize = 64;
+static constexpr uint32_t kFrames = 100;
+
+static bool gMapReadDone = false;
+static std::vector<uint32_t> gReadbackData;
+
+static void MapReadCallback(nxtBufferMapReadStatus status,
+                            const void* data,
+                            nxtCallbackUserdata) {
+    if (status != NXT_BUFFER_MAP_READ_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to map the readback buffer\n");
+    } else {
+        const uint32_t* elements = static_cast<const uint32_t*>(data);
+        gReadbackData.assign(elements, elements + kElements);
+    }
+    gMapReadDone = true;
+}
+
+int main(int argc, const char* argv[]) {
+    if (!InitSample(argc, argv)) {
+        return 1;
+    }
+
+    nxt::Device device = CreateCppNXTDevice();
+    nxt::Queue queue = device.CreateQueueBuilder().GetResult();
+
+    // Each invocation increments one element, reading the value written by the last dispatch.
+    nxt::ShaderModule module = utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+        #version 450
+        layout(local_size_x = 64) in;
+        layout(set = 0, binding = 0) buffer Data {
+            uint elements[];
+        } data;
+        void main() {
+            data.elements[gl_GlobalInvocationID.x] += 1;
+        })");
+
+    nxt::BindGroupLayout bgl = device.CreateBindGroupLayoutBuilder()
+        .SetBindingsType(nxt::ShaderStageBit::Compute, nxt::BindingType::StorageBuffer, 0, 1)
+        .GetResult();
+
+    nxt::ComputePipeline pipeline = device.CreateComputePipelineBuilder()
+        .SetLayout(device.CreatePipelineLayoutBuilder().SetBindGroupLayout(0, bgl).GetResult())
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .GetResult();
+
+    std::vector<uint32_t> zeroes(kElements, 0);
+    std::vector<nxt::Buffer> buffers;
+    std::vector<nxt::BindGroup> bindGroups;
+    for (uint32_t i = 0; i < kDispatches; ++i) {
+        nxt::Buffer buffer = device.CreateBufferBuilder()
+            .SetSize(kElements * sizeof(uint32_t))
+            .SetAllowedUsage(nxt::BufferUsageBit::Storage | nxt::BufferUsageBit::TransferSrc |
+                             nxt::BufferUsageBit::TransferDst)
+            .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+            .GetResult();
+        buffer.SetSubData(0, kElements, zeroes.data());
+
+        nxt::BufferView view = buffer.CreateBufferViewBuilder()
+            .SetExtent(0, kElements * sizeof(uint32_t))
+            .GetResult();
+        bindGroups.push_back(device.CreateBindGroupBuilder()
+            .SetLayout(bgl)
+            .SetUsage(nxt::BindGroupUsage::Frozen)
+            .SetBufferViews(0, 1, &view)
+            .GetResult());
+        buffers.push_back(std::move(buffer));
+    }
+
+    nxt::Buffer readback = device.CreateBufferBuilder()
+        .SetSize(kElements * sizeof(uint32_t))
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferDst | nxt::BufferUsageBit::MapRead)
+        .GetResult();
+
+    // Waits for the GPU to be done with the frames by reading back the first buffer, and checks
+    // each of its elements was incremented the expected number of times.
+    auto WaitForGPU = [&](uint32_t expected) {
+        nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+            .TransitionBufferUsage(buffers[0], nxt::BufferUsageBit::TransferSrc)
+            .TransitionBufferUsage(readback, nxt::BufferUsageBit::TransferDst)
+            .CopyBufferToBuffer(buffers[0], 0, readback, 0, kElements * sizeof(uint32_t))
+            .GetResult();
+        queue.Submit(1, &commands);
+
+        gMapReadDone = false;
+        readback.TransitionUsage(nxt::BufferUsageBit::MapRead);
+        readback.MapReadAsync(0, kElements * sizeof(uint32_t), MapReadCallback, 0);
+        while (!gMapReadDone) {
+            queue.Submit(0, nullptr);
+            device.Tick();
+            DoFlush();
+        }
+        readback.Unmap();
+
+        for (uint32_t value : gReadbackData) {
+            if (value != expected) {
+                fprintf(stderr, "Expected %u increments, got %u\n", expected, value);
+                break;
+            }
+        }
+    };
+
+    // The number of times the elements of the first buffer were incremented.
+    uint32_t expectedIncrements = 0;
+    auto Run = [&](const char* name, bool dependent) {
+        nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+        for (const nxt::Buffer& buffer : buffers) {
+            builder.TransitionBufferUsage(buffer, nxt::BufferUsageBit::Storage);
+        }
+        builder.BeginComputePass().SetComputePipeline(pipeline);
+        for (uint32_t i = 0; i < kDispatches; ++i) {
+            builder.SetBindGroup(0, bindGroups[dependent ? 0 : i])
+                .Dispatch(kElements / kWorkgroupSize, 1, 1);
+        }
+        nxt::CommandBuffer frame = builder.EndComputePass().GetResult();
+        uint32_t incrementsPerFrame = dependent ? kDispatches : 1;
+
+        // Warm up, then time the frames up to the GPU finishing them.
+        queue.Submit(1, &frame);
+        expectedIncrements += incrementsPerFrame;
+        WaitForGPU(expectedIncrements);
+
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < kFrames; ++i) {
+            queue.Submit(1, &frame);
+        }
+        expectedIncrements += kFrames * incrementsPerFrame;
+        WaitForGPU(expectedIncrements);
+        double frameMs =
+            std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+
+        printf("%s: %.3f ms per frame of %u dispatches\n", name, frameMs, kDispatches);
+    };
+
+    Run("Independent dispatches", false);
+    Run("Dependent dispatches", true);
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "SampleUtils.h"
+
+#include "utils/SystemUtils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Streams data from a staging buffer to a destination buffer with many small copies each frame,
+// like a streaming system updating parts of a large buffer. Contiguous copies and scattered copies
+// are alternated to exercise both the merging and the batching of buffer copies.
+
+nxt::Device device;
+nxt::Queue queue;
+nxt::SwapChain swapchain;
+nxt::TextureView depthStencilView;
+nxt::RenderPass renderpass;
+
+nxt::Buffer stagingBuffer;
+nxt::Buffer destinationBuffer;
+
+static constexpr uint32_t kCopySize = 64;
+static constexpr uint32_t kCopyCount = 4096;
+static constexpr uint32_t kBufferSize = kCopySize * kCopyCount;
+
+void init() {
+    device = CreateCppNXTDevice();
+
+    queue = device.CreateQueueBuilder().GetResult();
+    swapchain = GetSwapChain(device);
+    swapchain.Configure(GetPreferredSwapChainTextureFormat(),
+                        nxt::TextureUsageBit::OutputAttachment, 640, 480);
+
+    renderpass = CreateDefaultRenderPass(device);
+    depthStencilView = CreateDefaultDepthStencilView(device);
+
+    std::vector<uint32_t> data(kBufferSize / sizeof(uint32_t));
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint32_t>(i);
+    }
+
+    stagingBuffer = device.CreateBufferBuilder()
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+        .SetSize(kBufferSize)
+        .GetResult();
+    stagingBuffer.SetSubData(0, static_cast<uint32_t>(data.size()), data.data());
+    stagingBuffer.FreezeUsage(nxt::BufferUsageBit::TransferSrc);
+
+    destinationBuffer = device.CreateBufferBuilder()
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+        .SetSize(kBufferSize)
+        .GetResult();
+    destinationBuffer.FreezeUsage(nxt::BufferUsageBit::TransferDst);
+}
+
+void frame() {
+    nxt::Texture backbuffer;
+    nxt::Framebuffer framebuffer;
+    GetNextFramebuffer(device, renderpass, swapchain, depthStencilView, &backbuffer, &framebuffer);
+
+    static int f = 0;
+    f++;
+    bool scattered = (f / 120) % 2 == 1;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    nxt::CommandBuffer commands;
+    {
+        nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+        for (uint32_t i = 0; i < kCopyCount; ++i) {
+            // Scattered copies fill the even slots then the odd slots, in reverse order, so that
+            // they are all disjoint but none of them can be merged.
+            uint32_t slot = i;
+            if (scattered) {
+                uint32_t half = kCopyCount / 2;
+                slot = i < half ? (half - 1 - i) * 2 : (kCopyCount - 1 - i) * 2 + 1;
+            }
+            builder.CopyBufferToBuffer(stagingBuffer, i * kCopySize, destinationBuffer,
+                                       slot * kCopySize, kCopySize);
+        }
+
+        builder.BeginRenderPass(renderpass, framebuffer)
+            .BeginRenderSubpass()
+            .EndRenderSubpass()
+            .EndRenderPass();
+        commands = builder.GetResult();
+    }
+    queue.Submit(1, &commands);
+    DoFlush();
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    backbuffer.TransitionUsage(nxt::TextureUsageBit::Present);
+    swapchain.Present(backbuffer);
+    DoFlush();
+
+    if (f % 60 == 0) {
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        fprintf(stderr, "frame %i: %u %s copies recorded and submitted in %.3f ms\n", f,
+                kCopyCount, scattered ? "scattered" : "contiguous", ms);
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    if (!InitSample(argc, argv)) {
+        return 1;
+    }
+    init();
+
+    while (!ShouldQuit()) {
+        frame();
+        utils::USleep(16000);
+    }
+
+    // TODO release stuff
+}
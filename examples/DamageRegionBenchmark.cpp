@@ -0,0 +1,175 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SampleUtils.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <chrono>
+#include <cstdio>
+
+// Compares redrawing a whole frame with redrawing only its damaged regions, like a dashboard UI
+// where a few widgets change each frame. The damaged regions are redrawn by scissoring the same
+// full-frame draw, so the difference in GPU time is only the reduced fill.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kWidth = 1920;
+static constexpr uint32_t kHeight = 1080;
+static constexpr uint32_t kFrames = 100;
+
+struct DamageRect {
+    uint32_t x, y, width, height;
+};
+
+// A few widgets being updated, about 5% of the frame.
+static const DamageRect kDamage[] = {
+    {32, 32, 320, 48},
+    {32, 96, 320, 48},
+    {1500, 40, 380, 120},
+    {600, 900, 240, 64},
+    {880, 900, 240, 64},
+};
+
+static bool gMapReadDone = false;
+
+static void MapReadCallback(nxtBufferMapReadStatus status, const void*, nxtCallbackUserdata) {
+    if (status != NXT_BUFFER_MAP_READ_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to map the readback buffer\n");
+    }
+    gMapReadDone = true;
+}
+
+int main(int argc, const char* argv[]) {
+    if (!InitSample(argc, argv)) {
+        return 1;
+    }
+
+    nxt::Device device = CreateCppNXTDevice();
+    nxt::Queue queue = device.CreateQueueBuilder().GetResult();
+
+    nxt::Texture renderTarget = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(kWidth, kHeight, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+        .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+
+    // The parts of the frame that aren't redrawn are kept.
+    nxt::RenderPass renderPass = device.CreateRenderPassBuilder()
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorLoadOp(0, nxt::LoadOp::Load)
+        .SetSubpassCount(1)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+
+    nxt::Framebuffer framebuffer = device.CreateFramebufferBuilder()
+        .SetRenderPass(renderPass)
+        .SetDimensions(kWidth, kHeight)
+        .SetAttachment(0, renderTarget.CreateTextureViewBuilder().GetResult())
+        .GetResult();
+
+    nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+        #version 450
+        void main() {
+            const vec2 pos[3] = vec2[3](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+            gl_Position = vec4(pos[gl_VertexIndex], 0.0, 1.0);
+        })");
+
+    // Some arithmetic per fragment so that the draws are bound by fill like UI shading is.
+    nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+        #version 450
+        layout(location = 0) out vec4 fragColor;
+        void main() {
+            vec2 uv = gl_FragCoord.xy / vec2(1920.0, 1080.0);
+            vec3 color = vec3(0.0);
+            for (int i = 0; i < 32; ++i) {
+                color += 0.03 * sin(vec3(uv * float(i), float(i)) + color.zxy);
+            }
+            fragColor = vec4(color, 1.0);
+        })");
+
+    nxt::RenderPipeline pipeline = device.CreateRenderPipelineBuilder()
+        .SetSubpass(renderPass, 0)
+        .SetLayout(device.CreatePipelineLayoutBuilder().GetResult())
+        .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+        .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+        .GetResult();
+
+    nxt::Buffer readback = device.CreateBufferBuilder()
+        .SetSize(256)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferDst | nxt::BufferUsageBit::MapRead)
+        .GetResult();
+
+    // Waits for the GPU to be done with the frames by reading back a pixel.
+    auto WaitForGPU = [&]() {
+        nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+            .TransitionTextureUsage(renderTarget, nxt::TextureUsageBit::TransferSrc)
+            .TransitionBufferUsage(readback, nxt::BufferUsageBit::TransferDst)
+            .CopyTextureToBuffer(renderTarget, 0, 0, 0, 1, 1, 1, 0, readback, 0, 256)
+            .GetResult();
+        queue.Submit(1, &commands);
+
+        gMapReadDone = false;
+        readback.TransitionUsage(nxt::BufferUsageBit::MapRead);
+        readback.MapReadAsync(0, 4, MapReadCallback, 0);
+        while (!gMapReadDone) {
+            queue.Submit(0, nullptr);
+            device.Tick();
+            DoFlush();
+        }
+        readback.Unmap();
+    };
+
+    auto Run = [&](const char* name, bool damageOnly) {
+        uint64_t pixelsPerFrame = 0;
+        nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+        builder.BeginRenderPass(renderPass, framebuffer)
+            .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline);
+        if (damageOnly) {
+            for (const DamageRect& rect : kDamage) {
+                builder.SetScissorRect(rect.x, rect.y, rect.width, rect.height)
+                    .DrawArrays(3, 1, 0, 0);
+                pixelsPerFrame += uint64_t(rect.width) * rect.height;
+            }
+        } else {
+            builder.DrawArrays(3, 1, 0, 0);
+            pixelsPerFrame = uint64_t(kWidth) * kHeight;
+        }
+        nxt::CommandBuffer frame = builder.EndRenderSubpass().EndRenderPass().GetResult();
+
+        // Warm up, then time the frames up to the GPU finishing them.
+        queue.Submit(1, &frame);
+        WaitForGPU();
+
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < kFrames; ++i) {
+            queue.Submit(1, &frame);
+        }
+        WaitForGPU();
+        double frameMs =
+            std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+
+        printf("%s: %.3f ms per frame, %.2f Mpixels shaded per frame\n", name, frameMs,
+               pixelsPerFrame / 1e6);
+    };
+
+    Run("Full frame", false);
+    Run("Damaged regions", true);
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/BackendBinding.h"
+
+#include <nxt/nxtcpp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Measures the startup cost of each backend that can run headless: how long it takes to create a
+// device, and then how long the first frame takes, which includes the work that backends defer
+// until the device is used. Short-lived tools and tests create many devices so both need to stay
+// cheap.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kRTSize = 64;
+
+struct BenchmarkedBackend {
+    utils::BackendType type;
+    const char* name;
+};
+
+static const BenchmarkedBackend kBackends[] = {
+    {utils::BackendType::Null, "null"},
+    {utils::BackendType::OpenGL, "opengl"},
+    {utils::BackendType::Vulkan, "vulkan"},
+};
+
+static double MicrosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static void PrintDeviceError(const char* message, nxt::CallbackUserdata) {
+    fprintf(stderr, "Device error: %s\n", message);
+}
+
+static bool gMapReadDone = false;
+
+static void MapReadCallback(nxtBufferMapReadStatus status, const void*, nxtCallbackUserdata) {
+    if (status != NXT_BUFFER_MAP_READ_STATUS_SUCCESS) {
+        fprintf(stderr, "Failed to map the readback buffer\n");
+    }
+    gMapReadDone = true;
+}
+
+// Clears a render target and reads it back, then waits until the GPU is done.
+static void RenderFirstFrame(const nxt::Device& device) {
+    nxt::Queue queue = device.CreateQueueBuilder().GetResult();
+
+    nxt::Texture renderTarget =
+        device.CreateTextureBuilder()
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(kRTSize, kRTSize, 1)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment |
+                             nxt::TextureUsageBit::TransferSrc)
+            .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+            .GetResult();
+    nxt::TextureView renderTargetView = renderTarget.CreateTextureViewBuilder().GetResult();
+
+    nxt::RenderPass renderpass = device.CreateRenderPassBuilder()
+                                     .SetAttachmentCount(1)
+                                     .SetSubpassCount(1)
+                                     .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                                     .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+                                     .SubpassSetColorAttachment(0, 0, 0)
+                                     .GetResult();
+
+    nxt::Framebuffer framebuffer = device.CreateFramebufferBuilder()
+                                       .SetRenderPass(renderpass)
+                                       .SetDimensions(kRTSize, kRTSize)
+                                       .SetAttachment(0, renderTargetView)
+                                       .GetResult();
+    framebuffer.AttachmentSetClearColor(0, 0.0f, 1.0f, 0.0f, 1.0f);
+
+    nxt::Buffer readback = device.CreateBufferBuilder()
+                               .SetSize(kRTSize * kRTSize * 4)
+                               .SetAllowedUsage(nxt::BufferUsageBit::TransferDst |
+                                                nxt::BufferUsageBit::MapRead)
+                               .GetResult();
+
+    nxt::CommandBuffer commands =
+        device.CreateCommandBufferBuilder()
+            .BeginRenderPass(renderpass, framebuffer)
+            .BeginRenderSubpass()
+            .EndRenderSubpass()
+            .EndRenderPass()
+            .TransitionTextureUsage(renderTarget, nxt::TextureUsageBit::TransferSrc)
+            .TransitionBufferUsage(readback, nxt::BufferUsageBit::TransferDst)
+            .CopyTextureToBuffer(renderTarget, 0, 0, 0, kRTSize, kRTSize, 1, 0, readback, 0,
+                                 kRTSize * 4)
+            .GetResult();
+    queue.Submit(1, &commands);
+
+    gMapReadDone = false;
+    readback.TransitionUsage(nxt::BufferUsageBit::MapRead);
+    readback.MapReadAsync(0, kRTSize * kRTSize * 4, MapReadCallback, 0);
+    while (!gMapReadDone) {
+        // The null backend completes map operations at the next submit.
+        queue.Submit(0, nullptr);
+        device.Tick();
+    }
+    readback.Unmap();
+}
+
+static void PrintUsage(const char* program) {
+    printf("Usage: %s [--backend (null|opengl|vulkan)] [--iterations N]\n", program);
+}
+
+int main(int argc, const char** argv) {
+    const char* backendName = nullptr;
+    uint32_t iterations = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp("--backend", argv[i]) == 0 && i + 1 < argc) {
+            backendName = argv[++i];
+        } else if (strcmp("--iterations", argv[i]) == 0 && i + 1 < argc) {
+            iterations = std::max(1, atoi(argv[++i]));
+        } else {
+            PrintUsage(argv[0]);
+            return strcmp("-h", argv[i]) == 0 || strcmp("--help", argv[i]) == 0 ? 0 : 1;
+        }
+    }
+
+    for (const BenchmarkedBackend& backend : kBackends) {
+        if (backendName != nullptr && strcmp(backendName, backend.name) != 0) {
+            continue;
+        }
+
+        std::vector<double> creationUs;
+        std::vector<double> firstFrameUs;
+        std::vector<double> destructionUs;
+
+        for (uint32_t i = 0; i < iterations; ++i) {
+            utils::BackendBinding* binding = utils::CreateHeadlessBinding(backend.type);
+            if (binding == nullptr) {
+                break;
+            }
+
+            // Device creation includes creating the context or instance in the binding since
+            // short-lived users have to pay for it too.
+            Clock::time_point start = Clock::now();
+            nxtDevice backendDevice = nullptr;
+            nxtProcTable backendProcs;
+            binding->GetProcAndDevice(&backendProcs, &backendDevice);
+            if (backendDevice == nullptr) {
+                delete binding;
+                break;
+            }
+            nxtSetProcs(&backendProcs);
+            backendProcs.deviceSetErrorCallback(backendDevice, PrintDeviceError, 0);
+            nxt::Device device = nxt::Device::Acquire(backendDevice);
+            creationUs.push_back(MicrosecondsSince(start));
+
+            start = Clock::now();
+            RenderFirstFrame(device);
+            firstFrameUs.push_back(MicrosecondsSince(start));
+
+            start = Clock::now();
+            device = nxt::Device();
+            delete binding;
+            destructionUs.push_back(MicrosecondsSince(start));
+        }
+
+        if (creationUs.empty()) {
+            printf("%s: not available\n", backend.name);
+            continue;
+        }
+
+        // The first iteration is reported separately because it includes the one-time
+        // initialization of the process, like loading drivers.
+        auto Print = [](const char* what, std::vector<double>* samples) {
+            double first = samples->front();
+            std::sort(samples->begin(), samples->end());
+            double total = 0.0;
+            for (double sample : *samples) {
+                total += sample;
+            }
+            printf("  %-12s first %10.1f us, mean %10.1f us, median %10.1f us, min %10.1f us\n",
+                   what, first, total / samples->size(), (*samples)[samples->size() / 2],
+                   samples->front());
+        };
+
+        printf("%s (%zu iterations):\n", backend.name, creationUs.size());
+        Print("creation", &creationUs);
+        Print("first frame", &firstFrameUs);
+        Print("destruction", &destructionUs);
+    }
+
+    return 0;
+}
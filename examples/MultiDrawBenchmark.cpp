@@ -0,0 +1,130 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SampleUtils.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Compares recording, validating and submitting many tiny draws, like a particle or UI renderer
+// does, as individual DrawArrays commands and as a single MultiDrawArrays command.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kDrawCount = 10000;
+static constexpr uint32_t kIterations = 20;
+
+int main(int argc, const char* argv[]) {
+    if (!InitSample(argc, argv)) {
+        return 1;
+    }
+
+    nxt::Device device = CreateCppNXTDevice();
+    nxt::Queue queue = device.CreateQueueBuilder().GetResult();
+
+    nxt::RenderPass renderPass = device.CreateRenderPassBuilder()
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetSubpassCount(1)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+
+    nxt::Texture renderTarget = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(640, 480, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    renderTarget.FreezeUsage(nxt::TextureUsageBit::OutputAttachment);
+
+    nxt::Framebuffer framebuffer = device.CreateFramebufferBuilder()
+        .SetRenderPass(renderPass)
+        .SetDimensions(640, 480)
+        .SetAttachment(0, renderTarget.CreateTextureViewBuilder().GetResult())
+        .GetResult();
+
+    nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+        #version 450
+        void main() {
+            float x = float(gl_VertexIndex % 200) / 100.0 - 1.0;
+            float y = float(gl_VertexIndex / 200 % 200) / 100.0 - 1.0;
+            gl_Position = vec4(x, y, 0.0, 1.0);
+        })");
+
+    nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+        #version 450
+        layout(location = 0) out vec4 fragColor;
+        void main() {
+            fragColor = vec4(1.0, 1.0, 1.0, 1.0);
+        })");
+
+    nxt::RenderPipeline pipeline = device.CreateRenderPipelineBuilder()
+        .SetSubpass(renderPass, 0)
+        .SetLayout(device.CreatePipelineLayoutBuilder().GetResult())
+        .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+        .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+        .GetResult();
+
+    // Each draw is a single triangle.
+    std::vector<uint32_t> vertexCounts(kDrawCount, 3);
+    std::vector<uint32_t> firstVertices(kDrawCount);
+    for (uint32_t i = 0; i < kDrawCount; ++i) {
+        firstVertices[i] = 3 * i;
+    }
+
+    auto Run = [&](const char* name, bool multiDraw) {
+        double recordMs = 0.0;
+        double validateMs = 0.0;
+        double submitMs = 0.0;
+
+        for (uint32_t iteration = 0; iteration < kIterations; ++iteration) {
+            Clock::time_point start = Clock::now();
+            nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+            builder.BeginRenderPass(renderPass, framebuffer)
+                .BeginRenderSubpass()
+                .SetRenderPipeline(pipeline);
+            if (multiDraw) {
+                builder.MultiDrawArrays(kDrawCount, vertexCounts.data(), firstVertices.data(), 1,
+                                        0);
+            } else {
+                for (uint32_t i = 0; i < kDrawCount; ++i) {
+                    builder.DrawArrays(vertexCounts[i], 1, firstVertices[i], 0);
+                }
+            }
+            builder.EndRenderSubpass().EndRenderPass();
+
+            Clock::time_point recorded = Clock::now();
+            nxt::CommandBuffer commands = builder.GetResult();
+            Clock::time_point validated = Clock::now();
+            queue.Submit(1, &commands);
+            Clock::time_point submitted = Clock::now();
+
+            recordMs += std::chrono::duration<double, std::milli>(recorded - start).count();
+            validateMs += std::chrono::duration<double, std::milli>(validated - recorded).count();
+            submitMs += std::chrono::duration<double, std::milli>(submitted - validated).count();
+        }
+
+        printf("%s: record %.3f ms, validate %.3f ms, submit %.3f ms for %u draws\n", name,
+               recordMs / kIterations, validateMs / kIterations, submitMs / kIterations,
+               kDrawCount);
+    };
+
+    Run("Individual DrawArrays", false);
+    Run("MultiDrawArrays", true);
+    return 0;
+}
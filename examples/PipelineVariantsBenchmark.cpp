@@ -0,0 +1,138 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SampleUtils.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Measures how long it takes to create many pipelines that are variants of a few materials: each
+// material has its own shaders and is used with every combination of blend state, depth-stencil
+// state and primitive topology. Backends that share programs or shader compilation between
+// pipelines with the same shaders should create the variants much faster than the first
+// pipeline of each material.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kMaterialCount = 10;
+
+static std::string FragmentShaderSource(uint32_t material) {
+    return R"(
+        #version 450
+        layout(location = 0) out vec4 fragColor;
+        void main() {
+            fragColor = vec4()" +
+           std::to_string(material) + ".0 / " + std::to_string(kMaterialCount) +
+           R"(, gl_FragCoord.x, 0.0, 1.0);
+        })";
+}
+
+int main(int argc, const char* argv[]) {
+    if (!InitSample(argc, argv)) {
+        return 1;
+    }
+
+    nxt::Device device = CreateCppNXTDevice();
+    nxt::RenderPass renderPass = CreateDefaultRenderPass(device);
+    nxt::PipelineLayout layout = device.CreatePipelineLayoutBuilder().GetResult();
+
+    nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+        #version 450
+        const vec2 pos[3] = vec2[3](vec2(0.0, 0.5), vec2(-0.5, -0.5), vec2(0.5, -0.5));
+        void main() {
+            gl_Position = vec4(pos[gl_VertexIndex % 3], 0.0, 1.0);
+        })");
+
+    std::vector<nxt::ShaderModule> fsModules;
+    for (uint32_t i = 0; i < kMaterialCount; ++i) {
+        fsModules.push_back(utils::CreateShaderModule(device, nxt::ShaderStage::Fragment,
+                                                      FragmentShaderSource(i).c_str()));
+    }
+
+    std::vector<nxt::BlendState> blendStates;
+    blendStates.push_back(device.CreateBlendStateBuilder().GetResult());
+    blendStates.push_back(device.CreateBlendStateBuilder()
+                              .SetBlendEnabled(true)
+                              .SetColorBlend(nxt::BlendOperation::Add, nxt::BlendFactor::SrcAlpha,
+                                             nxt::BlendFactor::OneMinusSrcAlpha)
+                              .GetResult());
+    blendStates.push_back(device.CreateBlendStateBuilder()
+                              .SetBlendEnabled(true)
+                              .SetColorBlend(nxt::BlendOperation::Add, nxt::BlendFactor::One,
+                                             nxt::BlendFactor::One)
+                              .GetResult());
+    blendStates.push_back(device.CreateBlendStateBuilder()
+                              .SetColorWriteMask(nxt::ColorWriteMask::Red)
+                              .GetResult());
+
+    std::vector<nxt::DepthStencilState> depthStencilStates;
+    depthStencilStates.push_back(device.CreateDepthStencilStateBuilder().GetResult());
+    depthStencilStates.push_back(device.CreateDepthStencilStateBuilder()
+                                     .SetDepthCompareFunction(nxt::CompareFunction::Less)
+                                     .SetDepthWriteEnabled(true)
+                                     .GetResult());
+
+    std::vector<nxt::PrimitiveTopology> topologies = {nxt::PrimitiveTopology::TriangleList,
+                                                      nxt::PrimitiveTopology::TriangleStrip};
+
+    std::vector<nxt::RenderPipeline> pipelines;
+    auto CreatePipeline = [&](uint32_t material, uint32_t variant) {
+        uint32_t blend = variant % blendStates.size();
+        variant /= blendStates.size();
+        uint32_t depthStencil = variant % depthStencilStates.size();
+        variant /= depthStencilStates.size();
+        uint32_t topology = variant;
+
+        pipelines.push_back(device.CreateRenderPipelineBuilder()
+                                .SetSubpass(renderPass, 0)
+                                .SetLayout(layout)
+                                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                                .SetStage(nxt::ShaderStage::Fragment, fsModules[material], "main")
+                                .SetColorAttachmentBlendState(0, blendStates[blend])
+                                .SetDepthStencilState(depthStencilStates[depthStencil])
+                                .SetPrimitiveTopology(topologies[topology])
+                                .GetResult());
+    };
+    uint32_t variantCount = static_cast<uint32_t>(blendStates.size() * depthStencilStates.size() *
+                                                  topologies.size());
+
+    // Create the first pipeline of each material separately to see how much of the time is spent
+    // compiling shaders.
+    Clock::time_point start = Clock::now();
+    for (uint32_t material = 0; material < kMaterialCount; ++material) {
+        CreatePipeline(material, 0);
+    }
+    double firstMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t firstCount = pipelines.size();
+
+    start = Clock::now();
+    for (uint32_t material = 0; material < kMaterialCount; ++material) {
+        for (uint32_t variant = 1; variant < variantCount; ++variant) {
+            CreatePipeline(material, variant);
+        }
+    }
+    double variantsMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t variantsCount = pipelines.size() - firstCount;
+
+    printf("%u materials, %zu pipelines\n", kMaterialCount, pipelines.size());
+    printf("First pipeline of each material: %.2f ms (%.3f ms per pipeline)\n", firstMs,
+           firstMs / firstCount);
+    printf("Fixed-function variants: %.2f ms (%.3f ms per pipeline)\n", variantsMs,
+           variantsMs / variantsCount);
+    return 0;
+}
@@ -15,6 +15,7 @@
 #include "common/Platform.h"
 #include "utils/BackendBinding.h"
 #include "wire/TerribleCommandBuffer.h"
+#include "wire/TerribleTransferBuffer.h"
 
 #include <nxt/nxt.h>
 #include <nxt/nxtcpp.h>
@@ -51,34 +52,51 @@ enum class CmdBufType {
 static CmdBufType cmdBufType = CmdBufType::Terrible;
 static utils::BackendBinding* binding = nullptr;
 
+// Headless samples render offscreen for a fixed number of frames instead of opening a window.
+static bool headless = false;
+static constexpr unsigned int kHeadlessFrameCount = 100;
+static unsigned int headlessFrameIndex = 0;
+
 static GLFWwindow* window = nullptr;
 
 static nxt::wire::CommandHandler* wireServer = nullptr;
 static nxt::wire::CommandHandler* wireClient = nullptr;
 static nxt::wire::TerribleCommandBuffer* c2sBuf = nullptr;
 static nxt::wire::TerribleCommandBuffer* s2cBuf = nullptr;
+static nxt::wire::TerribleTransferBuffer* transferBuf = nullptr;
 
 nxt::Device CreateCppNXTDevice() {
-    binding = utils::CreateBinding(backendType);
-    if (binding == nullptr) {
-        return nxt::Device();
-    }
+    if (headless) {
+        binding = utils::CreateHeadlessBinding(backendType);
+        if (binding == nullptr) {
+            fprintf(stderr, "The backend doesn't support running headless\n");
+            return nxt::Device();
+        }
+    } else {
+        binding = utils::CreateBinding(backendType);
+        if (binding == nullptr) {
+            return nxt::Device();
+        }
 
-    if (!glfwInit()) {
-        return nxt::Device();
-    }
+        if (!glfwInit()) {
+            return nxt::Device();
+        }
 
-    binding->SetupGLFWWindowHints();
-    window = glfwCreateWindow(640, 480, "NXT window", nullptr, nullptr);
-    if (!window) {
-        return nxt::Device();
-    }
+        binding->SetupGLFWWindowHints();
+        window = glfwCreateWindow(640, 480, "NXT window", nullptr, nullptr);
+        if (!window) {
+            return nxt::Device();
+        }
 
-    binding->SetWindow(window);
+        binding->SetWindow(window);
+    }
 
     nxtDevice backendDevice;
     nxtProcTable backendProcs;
     binding->GetProcAndDevice(&backendProcs, &backendDevice);
+    if (backendDevice == nullptr) {
+        return nxt::Device();
+    }
 
     nxtDevice cDevice = nullptr;
     nxtProcTable procs;
@@ -92,13 +110,14 @@ nxt::Device CreateCppNXTDevice() {
             {
                 c2sBuf = new nxt::wire::TerribleCommandBuffer();
                 s2cBuf = new nxt::wire::TerribleCommandBuffer();
+                transferBuf = new nxt::wire::TerribleTransferBuffer();
 
-                wireServer = nxt::wire::NewServerCommandHandler(backendDevice, backendProcs, s2cBuf);
+                wireServer = nxt::wire::NewServerCommandHandler(backendDevice, backendProcs, s2cBuf, transferBuf);
                 c2sBuf->SetHandler(wireServer);
 
                 nxtDevice clientDevice;
                 nxtProcTable clientProcs;
-                wireClient = nxt::wire::NewClientDevice(&clientProcs, &clientDevice, c2sBuf);
+                wireClient = nxt::wire::NewClientDevice(&clientProcs, &clientDevice, c2sBuf, transferBuf);
                 s2cBuf->SetHandler(wireClient);
 
                 procs = clientProcs;
@@ -208,10 +227,16 @@ bool InitSample(int argc, const char** argv) {
             fprintf(stderr, "--command-buffer expects a command buffer name (none, terrible)\n");
             return false;
         }
+        if (std::string("--headless") == argv[i]) {
+            headless = true;
+            continue;
+        }
         if (std::string("-h") == argv[i] || std::string("--help") == argv[i]) {
-            printf("Usage: %s [-b BACKEND] [-c COMMAND_BUFFER]\n", argv[0]);
+            printf("Usage: %s [-b BACKEND] [-c COMMAND_BUFFER] [--headless]\n", argv[0]);
             printf("  BACKEND is one of: d3d12, metal, null, opengl, vulkan\n");
             printf("  COMMAND_BUFFER is one of: none, terrible\n");
+            printf("  --headless renders %u frames offscreen without creating a window\n",
+                   kHeadlessFrameCount);
             return false;
         }
     }
@@ -223,10 +248,15 @@ void DoFlush() {
         c2sBuf->Flush();
         s2cBuf->Flush();
     }
-    glfwPollEvents();
+    if (window != nullptr) {
+        glfwPollEvents();
+    }
 }
 
 bool ShouldQuit() {
+    if (headless) {
+        return headlessFrameIndex++ >= kHeadlessFrameCount;
+    }
     return glfwWindowShouldClose(window);
 }
 
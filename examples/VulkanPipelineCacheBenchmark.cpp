@@ -0,0 +1,125 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/BackendBinding.h"
+#include "utils/NXTHelpers.h"
+
+#include <nxt/nxtcpp.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Measures how long the Vulkan backend takes to create pipelines with a cold and a warm
+// VkPipelineCache. The first device starts without a cache file and writes it when it is
+// destroyed, the second device loads it and should create the same pipelines faster. The cache
+// file is given by the NXT_VULKAN_PIPELINE_CACHE environment variable.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kPipelineCount = 200;
+
+// Each pipeline has a different fragment shader so that the driver has to compile each of them.
+static std::string FragmentShaderSource(uint32_t index) {
+    return R"(
+        #version 450
+        layout(location = 0) out vec4 fragColor;
+        void main() {
+            fragColor = vec4()" +
+           std::to_string(index) + ".0 / " + std::to_string(kPipelineCount) +
+           R"(, gl_FragCoord.x, 0.0, 1.0);
+        })";
+}
+
+static double CreatePipelines(utils::BackendBinding* binding) {
+    nxtDevice backendDevice;
+    nxtProcTable backendProcs;
+    binding->GetProcAndDevice(&backendProcs, &backendDevice);
+    nxtSetProcs(&backendProcs);
+
+    double elapsedMs = 0.0;
+    {
+        nxt::Device device = nxt::Device::Acquire(backendDevice);
+
+        nxt::ShaderModule vsModule =
+            utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+            #version 450
+            const vec2 pos[3] = vec2[3](vec2(0.0, 0.5), vec2(-0.5, -0.5), vec2(0.5, -0.5));
+            void main() {
+                gl_Position = vec4(pos[gl_VertexIndex], 0.0, 1.0);
+            })");
+
+        // Shaders are compiled to SPIR-V before starting the clock so that only the pipeline
+        // creation is measured.
+        std::vector<nxt::ShaderModule> fsModules;
+        for (uint32_t i = 0; i < kPipelineCount; ++i) {
+            fsModules.push_back(utils::CreateShaderModule(device, nxt::ShaderStage::Fragment,
+                                                          FragmentShaderSource(i).c_str()));
+        }
+
+        nxt::RenderPass renderPass = device.CreateRenderPassBuilder()
+                                         .SetAttachmentCount(1)
+                                         .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                                         .SetSubpassCount(1)
+                                         .SubpassSetColorAttachment(0, 0, 0)
+                                         .GetResult();
+        nxt::PipelineLayout layout = device.CreatePipelineLayoutBuilder().GetResult();
+
+        std::vector<nxt::RenderPipeline> pipelines;
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < kPipelineCount; ++i) {
+            pipelines.push_back(device.CreateRenderPipelineBuilder()
+                                    .SetSubpass(renderPass, 0)
+                                    .SetLayout(layout)
+                                    .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                                    .SetStage(nxt::ShaderStage::Fragment, fsModules[i], "main")
+                                    .GetResult());
+        }
+        elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // The device was released at the end of the scope above, which wrote the pipeline cache.
+    nxtSetProcs(nullptr);
+    return elapsedMs;
+}
+
+static void PrintResult(const char* name, double elapsedMs) {
+    printf("%s: %u pipelines in %.2f ms (%.3f ms per pipeline)\n", name, kPipelineCount,
+           elapsedMs, elapsedMs / kPipelineCount);
+}
+
+int main(int, const char**) {
+    // The pipeline cache is only persisted when the file to store it in is given.
+    const char* envPath = getenv("NXT_VULKAN_PIPELINE_CACHE");
+    std::string cachePath = envPath != nullptr ? envPath : "";
+    if (cachePath.empty()) {
+        fprintf(stderr, "Set NXT_VULKAN_PIPELINE_CACHE to the file to store the pipeline cache\n");
+        return 1;
+    }
+
+    utils::BackendBinding* binding = utils::CreateBinding(utils::BackendType::Vulkan);
+    if (binding == nullptr) {
+        fprintf(stderr, "The Vulkan backend is required for this benchmark\n");
+        return 1;
+    }
+
+    std::remove(cachePath.c_str());
+    PrintResult("Cold pipeline cache", CreatePipelines(binding));
+    PrintResult("Warm pipeline cache", CreatePipelines(binding));
+
+    delete binding;
+    return 0;
+}
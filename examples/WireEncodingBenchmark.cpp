@@ -0,0 +1,143 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/BackendBinding.h"
+#include "wire/Wire.h"
+#include "wire/WireCmd.h"
+
+#include <nxt/nxtcpp.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Compares the compact encoding of CommandBufferBuilder commands with the generic encoding, by
+// recording draws in a command buffer on the wire and measuring how many bytes they take and how
+// long the server takes to decode and execute them on the null backend.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kDrawCount = 100000;
+
+// Keeps the commands sent by the client so that they can be given to the server separately.
+class RecordingSerializer : public nxt::wire::CommandSerializer {
+  public:
+    void* GetCmdSpace(size_t size) override {
+        size_t offset = mData.size();
+        mData.resize(offset + size);
+        return &mData[offset];
+    }
+    void Flush() override {
+    }
+
+    double Replay(nxt::wire::CommandHandler* handler) {
+        Clock::time_point start = Clock::now();
+        const uint8_t* result = handler->HandleCommands(mData.data(), mData.size());
+        double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        if (result == nullptr) {
+            fprintf(stderr, "The server failed to handle the commands\n");
+        }
+        mData.clear();
+        return elapsedMs;
+    }
+
+    size_t GetSize() const {
+        return mData.size();
+    }
+
+    void Reserve(size_t size) {
+        mData.reserve(size);
+    }
+
+  private:
+    std::vector<uint8_t> mData;
+};
+
+static uint32_t VertexCount(uint32_t draw) {
+    // A mix of small and large draws
+    return 3 + (draw % 16) * 67;
+}
+
+static void PrintResult(const char* name, size_t bytes, double decodeMs) {
+    printf("%s:\n", name);
+    printf("  %.2f bytes per draw, server decode and execution: %.2f ms (%.1f ns per draw)\n",
+           static_cast<double>(bytes) / kDrawCount, decodeMs, decodeMs * 1e6 / kDrawCount);
+}
+
+int main(int, const char**) {
+    utils::BackendBinding* binding = utils::CreateBinding(utils::BackendType::Null);
+    if (binding == nullptr) {
+        fprintf(stderr, "The null backend is required for this benchmark\n");
+        return 1;
+    }
+
+    nxtDevice backendDevice;
+    nxtProcTable backendProcs;
+    binding->GetProcAndDevice(&backendProcs, &backendDevice);
+
+    RecordingSerializer c2sBuf;
+    RecordingSerializer s2cBuf;
+    c2sBuf.Reserve(kDrawCount * sizeof(nxt::wire::CommandBufferBuilderDrawArraysCmd));
+
+    nxt::wire::CommandHandler* wireServer =
+        nxt::wire::NewServerCommandHandler(backendDevice, backendProcs, &s2cBuf);
+
+    nxtDevice clientDevice;
+    nxtProcTable clientProcs;
+    nxt::wire::CommandHandler* wireClient =
+        nxt::wire::NewClientDevice(&clientProcs, &clientDevice, &c2sBuf);
+    nxtSetProcs(&clientProcs);
+
+    {
+        nxt::Device device = nxt::Device::Acquire(clientDevice);
+
+        // Compact encoding, used by the client for recording commands.
+        nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+        c2sBuf.Replay(wireServer);
+
+        for (uint32_t i = 0; i < kDrawCount; ++i) {
+            builder.DrawArrays(VertexCount(i), 1, 0, 0);
+        }
+        size_t compactBytes = c2sBuf.GetSize();
+        double compactMs = c2sBuf.Replay(wireServer);
+        PrintResult("Compact encoding", compactBytes, compactMs);
+
+        // Generic encoding, written by hand in a new builder. The first command buffer builder
+        // created by the client has ID 1 so the second one has ID 2.
+        nxt::CommandBufferBuilder genericBuilder = device.CreateCommandBufferBuilder();
+        c2sBuf.Replay(wireServer);
+
+        for (uint32_t i = 0; i < kDrawCount; ++i) {
+            nxt::wire::CommandBufferBuilderDrawArraysCmd cmd;
+            cmd.self = 2;
+            cmd.vertexCount = VertexCount(i);
+            cmd.instanceCount = 1;
+            cmd.firstVertex = 0;
+            cmd.firstInstance = 0;
+
+            auto allocCmd = reinterpret_cast<decltype(cmd)*>(c2sBuf.GetCmdSpace(sizeof(cmd)));
+            *allocCmd = cmd;
+        }
+        size_t genericBytes = c2sBuf.GetSize();
+        double genericMs = c2sBuf.Replay(wireServer);
+        PrintResult("Generic encoding", genericBytes, genericMs);
+    }
+
+    nxtSetProcs(nullptr);
+    delete wireServer;
+    delete wireClient;
+    delete binding;
+    return 0;
+}
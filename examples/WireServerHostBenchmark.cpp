@@ -0,0 +1,191 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/BackendBinding.h"
+#include "wire/Wire.h"
+#include "wire/WireServerHost.h"
+
+#include <nxt/nxtcpp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Measures the command throughput of a wire server host on the null backend with an increasing
+// number of clients, each sending commands from its own thread. The clients either all share one
+// device, or each have their own device so that the host can handle their commands concurrently.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kFlushesPerClient = 200;
+static constexpr uint32_t kCommandsPerFlush = 100;
+static constexpr uint32_t kBufferSize = 64;
+
+// Submits the commands of a client to the host when they are flushed.
+class HostSubmitSerializer : public nxt::wire::CommandSerializer {
+  public:
+    HostSubmitSerializer(nxt::wire::ServerHost* host) : mHost(host) {
+    }
+
+    void SetClient(nxt::wire::ServerHost::ClientId client) {
+        mClient = client;
+    }
+
+    void* GetCmdSpace(size_t size) override {
+        size_t offset = mData.size();
+        mData.resize(offset + size);
+        return &mData[offset];
+    }
+    void Flush() override {
+        if (!mHost->SubmitCommands(mClient, mData.data(), mData.size())) {
+            fprintf(stderr, "The server failed to handle the commands\n");
+        }
+        mData.clear();
+    }
+
+  private:
+    nxt::wire::ServerHost* mHost;
+    nxt::wire::ServerHost::ClientId mClient = 0;
+    std::vector<uint8_t> mData;
+};
+
+// The benchmark doesn't use anything the server sends back. Commands are serialized as soon as
+// their space is allocated so it can be reused once the buffer is full.
+class DiscardSerializer : public nxt::wire::CommandSerializer {
+  public:
+    void* GetCmdSpace(size_t size) override {
+        if (mOffset + size > mData.size()) {
+            mData.resize(std::max(mData.size(), size));
+            mOffset = 0;
+        }
+        void* result = &mData[mOffset];
+        mOffset += size;
+        return result;
+    }
+    void Flush() override {
+        mOffset = 0;
+    }
+
+  private:
+    std::vector<uint8_t> mData = std::vector<uint8_t>(1 << 16);
+    size_t mOffset = 0;
+};
+
+struct BenchmarkClient {
+    std::unique_ptr<HostSubmitSerializer> c2sBuf;
+    DiscardSerializer s2cBuf;
+    std::unique_ptr<nxt::wire::CommandHandler> handler;
+    nxtDevice device;
+    nxt::wire::ServerHost::ClientId id;
+};
+
+static void ClientThread(BenchmarkClient* client) {
+    nxt::Device device = nxt::Device::Acquire(client->device);
+
+    nxt::Buffer buffer = device.CreateBufferBuilder()
+                             .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+                             .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                             .SetSize(kBufferSize)
+                             .GetResult();
+
+    std::vector<uint32_t> data(kBufferSize / sizeof(uint32_t), 0);
+    for (uint32_t i = 0; i < kFlushesPerClient; ++i) {
+        for (uint32_t j = 0; j < kCommandsPerFlush; ++j) {
+            data[0] = j;
+            buffer.SetSubData(0, static_cast<uint32_t>(data.size()), data.data());
+        }
+        client->c2sBuf->Flush();
+    }
+}
+
+// Returns the number of commands handled per second.
+static double RunBenchmark(utils::BackendBinding* binding,
+                           uint32_t clientCount,
+                           bool sharedDevice,
+                           uint32_t threadCount) {
+    nxtProcTable backendProcs;
+    std::vector<nxtDevice> backendDevices;
+
+    nxt::wire::ServerHost host(threadCount);
+    std::vector<BenchmarkClient> clients(clientCount);
+
+    for (uint32_t i = 0; i < clientCount; ++i) {
+        nxt::wire::ServerHost::DeviceId hostDevice = 0;
+        if (i == 0 || !sharedDevice) {
+            nxtDevice backendDevice;
+            binding->GetProcAndDevice(&backendProcs, &backendDevice);
+            backendDevices.push_back(backendDevice);
+            hostDevice = host.AddDevice(backendDevice, backendProcs);
+        }
+
+        BenchmarkClient* client = &clients[i];
+        client->c2sBuf.reset(new HostSubmitSerializer(&host));
+
+        nxtProcTable clientProcs;
+        client->handler.reset(
+            nxt::wire::NewClientDevice(&clientProcs, &client->device, client->c2sBuf.get()));
+        nxtSetProcs(&clientProcs);
+
+        client->id = host.AddClient(hostDevice, &client->s2cBuf);
+        client->c2sBuf->SetClient(client->id);
+    }
+
+    Clock::time_point start = Clock::now();
+    {
+        std::vector<std::thread> threads;
+        for (BenchmarkClient& client : clients) {
+            threads.emplace_back(ClientThread, &client);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        host.WaitIdle();
+    }
+    double elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (BenchmarkClient& client : clients) {
+        host.RemoveClient(client.id);
+    }
+    for (nxtDevice device : backendDevices) {
+        backendProcs.deviceRelease(device);
+    }
+
+    uint64_t commandCount = uint64_t(clientCount) * kFlushesPerClient * kCommandsPerFlush;
+    return commandCount / elapsedSeconds;
+}
+
+int main(int, const char**) {
+    utils::BackendBinding* binding = utils::CreateBinding(utils::BackendType::Null);
+    if (binding == nullptr) {
+        fprintf(stderr, "The null backend is required for this benchmark\n");
+        return 1;
+    }
+
+    uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    printf("Server threads: %u\n", threadCount);
+    printf("%8s %26s %26s\n", "clients", "shared device (cmd/s)", "device per client (cmd/s)");
+
+    for (uint32_t clientCount = 1; clientCount <= 32; clientCount *= 2) {
+        double shared = RunBenchmark(binding, clientCount, true, threadCount);
+        double perClient = RunBenchmark(binding, clientCount, false, threadCount);
+        printf("%8u %26.0f %26.0f\n", clientCount, shared, perClient);
+    }
+
+    nxtSetProcs(nullptr);
+    delete binding;
+    return 0;
+}
@@ -0,0 +1,179 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/BackendBinding.h"
+#include "wire/TerribleCommandBuffer.h"
+#include "wire/TerribleTransferBuffer.h"
+#include "wire/Wire.h"
+
+#include <nxt/nxtcpp.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Measures the cost of sending bulk data over the wire, with the data inline in the command stream
+// or out of band in a transfer buffer. The wire runs on top of the null backend so that only the
+// cost of the wire is measured. Two things are measured:
+//  - The throughput of uploading 100 MB with SetSubData.
+//  - The latency of a small command that is sent after bulk uploads, from the time it is issued
+//    to the time the server executes it.
+
+using Clock = std::chrono::high_resolution_clock;
+
+static constexpr uint32_t kUploadSize = 1024 * 1024;
+static constexpr uint32_t kTotalUploadSize = 100 * 1024 * 1024;
+static constexpr uint32_t kUploadsPerFlush = 4;
+static constexpr uint32_t kLatencyIterations = 100;
+
+// The server-side SetSubData is hooked to know when the small command gets executed.
+static nxtProcBufferSetSubData backendBufferSetSubData = nullptr;
+static Clock::time_point smallCommandExecutionTime;
+
+static void HookedBufferSetSubData(nxtBuffer buffer, uint32_t start, uint32_t count,
+                                   const uint32_t* data) {
+    if (count == 1) {
+        smallCommandExecutionTime = Clock::now();
+    }
+    backendBufferSetSubData(buffer, start, count, data);
+}
+
+// Counts how many bytes of commands the client sends to the server.
+class CountingSerializer : public nxt::wire::CommandSerializer {
+  public:
+    CountingSerializer(nxt::wire::CommandSerializer* serializer) : mSerializer(serializer) {
+    }
+
+    void* GetCmdSpace(size_t size) override {
+        mBytes += size;
+        return mSerializer->GetCmdSpace(size);
+    }
+    void Flush() override {
+        mSerializer->Flush();
+    }
+
+    uint64_t GetBytes() const {
+        return mBytes;
+    }
+
+  private:
+    nxt::wire::CommandSerializer* mSerializer;
+    uint64_t mBytes = 0;
+};
+
+static double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void RunBenchmark(bool useTransferBuffer) {
+    utils::BackendBinding* binding = utils::CreateBinding(utils::BackendType::Null);
+    if (binding == nullptr) {
+        fprintf(stderr, "The null backend is required for this benchmark\n");
+        return;
+    }
+
+    nxtDevice backendDevice;
+    nxtProcTable backendProcs;
+    binding->GetProcAndDevice(&backendProcs, &backendDevice);
+
+    backendBufferSetSubData = backendProcs.bufferSetSubData;
+    backendProcs.bufferSetSubData = HookedBufferSetSubData;
+
+    auto* c2sBuf = new nxt::wire::TerribleCommandBuffer();
+    auto* s2cBuf = new nxt::wire::TerribleCommandBuffer();
+    nxt::wire::TerribleTransferBuffer* transferBuf = nullptr;
+    if (useTransferBuffer) {
+        transferBuf = new nxt::wire::TerribleTransferBuffer();
+    }
+
+    nxt::wire::CommandHandler* wireServer =
+        nxt::wire::NewServerCommandHandler(backendDevice, backendProcs, s2cBuf, transferBuf);
+    c2sBuf->SetHandler(wireServer);
+
+    CountingSerializer counter(c2sBuf);
+    nxtDevice clientDevice;
+    nxtProcTable clientProcs;
+    nxt::wire::CommandHandler* wireClient =
+        nxt::wire::NewClientDevice(&clientProcs, &clientDevice, &counter, transferBuf);
+    s2cBuf->SetHandler(wireClient);
+    nxtSetProcs(&clientProcs);
+
+    {
+        nxt::Device device = nxt::Device::Acquire(clientDevice);
+        nxt::Buffer bulkBuffer = device.CreateBufferBuilder()
+            .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+            .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+            .SetSize(kUploadSize)
+            .GetResult();
+        nxt::Buffer smallBuffer = device.CreateBufferBuilder()
+            .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+            .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+            .SetSize(sizeof(uint32_t))
+            .GetResult();
+
+        std::vector<uint32_t> data(kUploadSize / sizeof(uint32_t));
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint32_t>(i);
+        }
+        uint32_t dataCount = static_cast<uint32_t>(data.size());
+        c2sBuf->Flush();
+
+        // Upload throughput
+        uint64_t bytesBefore = counter.GetBytes();
+        Clock::time_point uploadStart = Clock::now();
+        for (uint32_t i = 0; i < kTotalUploadSize / kUploadSize; ++i) {
+            bulkBuffer.SetSubData(0, dataCount, data.data());
+            if ((i + 1) % kUploadsPerFlush == 0) {
+                c2sBuf->Flush();
+            }
+        }
+        c2sBuf->Flush();
+        double uploadMs = ElapsedMs(uploadStart, Clock::now());
+        uint64_t streamBytes = counter.GetBytes() - bytesBefore;
+
+        // Latency of a small command sent after bulk traffic
+        double totalLatencyMs = 0.0;
+        for (uint32_t i = 0; i < kLatencyIterations; ++i) {
+            for (uint32_t j = 0; j < kUploadsPerFlush; ++j) {
+                bulkBuffer.SetSubData(0, dataCount, data.data());
+            }
+
+            uint32_t value = i;
+            Clock::time_point issueTime = Clock::now();
+            smallBuffer.SetSubData(0, 1, &value);
+            c2sBuf->Flush();
+            totalLatencyMs += ElapsedMs(issueTime, smallCommandExecutionTime);
+        }
+
+        printf("%s:\n", useTransferBuffer ? "Transfer buffer" : "Inline");
+        printf("  100 MB upload: %.2f ms (%.1f MB/s), %llu bytes of commands\n", uploadMs,
+               (kTotalUploadSize / (1024.0 * 1024.0)) / (uploadMs / 1000.0),
+               static_cast<unsigned long long>(streamBytes));
+        printf("  small command latency: %.3f ms\n", totalLatencyMs / kLatencyIterations);
+    }
+
+    nxtSetProcs(nullptr);
+    delete wireServer;
+    delete wireClient;
+    delete c2sBuf;
+    delete s2cBuf;
+    delete transferBuf;
+    delete binding;
+}
+
+int main(int, const char**) {
+    RunBenchmark(false);
+    RunBenchmark(true);
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// A read-only memory mapping of a whole file, so large .glb files are paged in on demand instead
+// of being copied in memory before parsing.
+class MappedFile {
+    public:
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+#if defined(NXT_PLATFORM_WINDOWS)
+        explicit MappedFile(const char* filename) {
+            _file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (_file == INVALID_HANDLE_VALUE) {
+                return;
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(_file, &size) || size.QuadPart == 0) {
+                return;
+            }
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping == nullptr) {
+                return;
+            }
+            _data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (_data != nullptr) {
+                _size = static_cast<size_t>(size.QuadPart);
+            }
+        }
+
+        ~MappedFile() {
+            if (_data != nullptr) {
+                UnmapViewOfFile(_data);
+            }
+            if (_mapping != nullptr) {
+                CloseHandle(_mapping);
+            }
+            if (_file != INVALID_HANDLE_VALUE) {
+                CloseHandle(_file);
+            }
+        }
+#elif defined(NXT_PLATFORM_POSIX)
+        explicit MappedFile(const char* filename) {
+            int fd = open(filename, O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+            struct stat fileStat;
+            if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+                size_t size = static_cast<size_t>(fileStat.st_size);
+                void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    _data = data;
+                    _size = size;
+                }
+            }
+            // The mapping stays valid after the file descriptor is closed.
+            close(fd);
+        }
+
+        ~MappedFile() {
+            if (_data != nullptr) {
+                munmap(_data, _size);
+            }
+        }
+#else
+#    error "Implement MappedFile for your platform."
+#endif
+
+        const unsigned char* data() const {
+            return static_cast<const unsigned char*>(_data);
+        }
+        size_t size() const {
+            return _size;
+        }
+
+    private:
+        void* _data = nullptr;
+        size_t _size = 0;
+#if defined(NXT_PLATFORM_WINDOWS)
+        HANDLE _file = INVALID_HANDLE_VALUE;
+        HANDLE _mapping = nullptr;
+#endif
+};
@@ -0,0 +1,67 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// A fixed set of threads running jobs in the order they were posted. NXT objects must not be
+// used from the jobs since the device is only used on the main thread.
+class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threadCount) {
+            for (size_t i = 0; i < threadCount; ++i) {
+                _threads.emplace_back([this]() { run(); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _condition.notify_all();
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        void post(std::function<void()> job) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _jobs.push(std::move(job));
+            }
+            _condition.notify_one();
+        }
+
+    private:
+        void run() {
+            while (true) {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+                    if (_jobs.empty()) {
+                        return;
+                    }
+                    job = std::move(_jobs.front());
+                    _jobs.pop();
+                }
+                job();
+            }
+        }
+
+        std::vector<std::thread> _threads;
+        std::queue<std::function<void()>> _jobs;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stopping = false;
+};
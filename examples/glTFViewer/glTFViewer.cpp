@@ -22,10 +22,32 @@
 
 #include "common/Math.h"
 #include "common/Constants.h"
+#include "common/Platform.h"
 #include "utils/NXTHelpers.h"
 #include "utils/SystemUtils.h"
 
+#if defined(NXT_PLATFORM_WINDOWS)
+#    define NOMINMAX
+#    define WIN32_LEAN_AND_MEAN
+#    include <Windows.h>
+#elif defined(NXT_PLATFORM_POSIX)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <thread>
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
@@ -33,12 +55,15 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #define TINYGLTF_LOADER_IMPLEMENTATION
+#define TINYGLTF_LOADER_NO_IMAGE_DECODING
 #define STB_IMAGE_IMPLEMENTATION
 #include <tinygltfloader/tiny_gltf_loader.h>
 
 #include "GLFW/glfw3.h"
 
 #include "Camera.inl"
+#include "MappedFile.inl"
+#include "ThreadPool.inl"
 
 namespace gl {
     enum {
@@ -93,6 +118,32 @@ tinygltf::Scene scene;
 glm::mat4 projection = glm::perspective(glm::radians(60.f), 640.f/480, 0.1f, 2000.f);
 Camera camera;
 
+// Loading state: images are decoded on a thread pool while the main thread uploads meshes and
+// decoded images a few at a time between frames. Meshes are drawn as soon as they are uploaded,
+// with an untextured placeholder material until their texture is ready.
+struct DecodedImage {
+    std::string textureID;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+std::mutex decodedImagesMutex;
+std::vector<DecodedImage> decodedImages;
+// Declared after the data used by its threads so that they are stopped before it is destroyed.
+std::unique_ptr<ThreadPool> decoderPool;
+size_t pendingTextureCount = 0;
+std::deque<std::string> pendingMeshes;
+std::set<std::string> loadedMeshes;
+
+// Bounds the amount of data uploaded between two frames so that frames keep being rendered.
+constexpr size_t kUploadBytesPerFrame = 8 * 1024 * 1024;
+
+using Clock = std::chrono::steady_clock;
+Clock::time_point startTime;
+bool firstFrameDone = false;
+bool fullyLoaded = false;
+
 // Helpers
 namespace {
     std::string getFilePathExtension(const std::string &FileName) {
@@ -121,63 +172,85 @@ namespace {
 
 // Initialization
 namespace {
-    void initBuffers() {
+    void initDefaultBuffer() {
         defaultBuffer = device.CreateBufferBuilder()
             .SetAllowedUsage(nxt::BufferUsageBit::Vertex | nxt::BufferUsageBit::Index)
             .SetSize(256)
             .GetResult();
         defaultBuffer.FreezeUsage(nxt::BufferUsageBit::Vertex | nxt::BufferUsageBit::Index);
+    }
 
-        for (const auto& bv : scene.bufferViews) {
-            const auto& iBufferViewID = bv.first;
-            const auto& iBufferView = bv.second;
+    // Returns the number of bytes uploaded
+    size_t uploadBufferView(const std::string& iBufferViewID) {
+        if (buffers.find(iBufferViewID) != buffers.end()) {
+            return 0;
+        }
+        const auto& iBufferView = scene.bufferViews.at(iBufferViewID);
+
+        nxt::BufferUsageBit usage = nxt::BufferUsageBit::None;
+        switch (iBufferView.target) {
+            case gl::ArrayBuffer:
+                usage |= nxt::BufferUsageBit::Vertex;
+                break;
+            case gl::ElementArrayBuffer:
+                usage |= nxt::BufferUsageBit::Index;
+                break;
+            case 0:
+                fprintf(stderr, "TODO: buffer view has no target; skipping\n");
+                return 0;
+            default:
+                fprintf(stderr, "unsupported buffer view target %d\n", iBufferView.target);
+                return 0;
+        }
+        const auto& iBuffer = scene.buffers.at(iBufferView.buffer);
+
+        size_t iBufferViewSize =
+            iBufferView.byteLength ? iBufferView.byteLength :
+            (iBuffer.data.size() - iBufferView.byteOffset);
+        auto oBuffer = utils::CreateFrozenBufferFromData(device, &iBuffer.data.at(iBufferView.byteOffset), static_cast<uint32_t>(iBufferViewSize), usage);
+        buffers[iBufferViewID] = std::move(oBuffer);
+        return iBufferViewSize;
+    }
 
-            nxt::BufferUsageBit usage = nxt::BufferUsageBit::None;
-            switch (iBufferView.target) {
-                case gl::ArrayBuffer:
-                    usage |= nxt::BufferUsageBit::Vertex;
-                    break;
-                case gl::ElementArrayBuffer:
-                    usage |= nxt::BufferUsageBit::Index;
-                    break;
-                case 0:
-                    fprintf(stderr, "TODO: buffer view has no target; skipping\n");
-                    continue;
-                default:
-                    fprintf(stderr, "unsupported buffer view target %d\n", iBufferView.target);
-                    continue;
+    // Uploads all the buffer views used by the mesh, returns the number of bytes uploaded
+    size_t uploadMesh(const std::string& iMeshID) {
+        size_t uploadedSize = 0;
+        for (const auto& iPrim : scene.meshes.at(iMeshID).primitives) {
+            for (const auto& a : iPrim.attributes) {
+                uploadedSize += uploadBufferView(scene.accessors.at(a.second).bufferView);
+            }
+            if (!iPrim.indices.empty()) {
+                uploadedSize += uploadBufferView(scene.accessors.at(iPrim.indices).bufferView);
             }
-            const auto& iBuffer = scene.buffers.at(iBufferView.buffer);
-
-            size_t iBufferViewSize =
-                iBufferView.byteLength ? iBufferView.byteLength :
-                (iBuffer.data.size() - iBufferView.byteOffset);
-            auto oBuffer = utils::CreateFrozenBufferFromData(device, &iBuffer.data.at(iBufferView.byteOffset), static_cast<uint32_t>(iBufferViewSize), usage);
-            buffers[iBufferViewID] = std::move(oBuffer);
         }
+        loadedMeshes.insert(iMeshID);
+        return uploadedSize;
     }
 
     const MaterialInfo& getMaterial(const std::string& iMaterialID, size_t stridePos, size_t strideNor, size_t strideTxc) {
-        static std::map<std::tuple<std::string, size_t, size_t, size_t>, MaterialInfo> materials;
-        auto key = make_tuple(iMaterialID, stridePos, strideNor, strideTxc);
-        auto materialIterator = materials.find(key);
-        if (materialIterator != materials.end()) {
-            return materialIterator->second;
-        }
-
         const auto& iMaterial = scene.materials.at(iMaterialID);
-        const auto& iTechnique = scene.techniques.at(iMaterial.technique);
 
+        // Materials whose texture isn't loaded yet use an untextured placeholder material
         bool hasTexture = false;
         std::string iTextureID;
         {
             auto it = iMaterial.values.find("diffuse");
-            if (it != iMaterial.values.end() && !it->second.string_value.empty()) {
+            if (it != iMaterial.values.end() && !it->second.string_value.empty() &&
+                    textures.find(it->second.string_value) != textures.end()) {
                 hasTexture = true;
                 iTextureID = it->second.string_value;
             }
         }
 
+        static std::map<std::tuple<std::string, bool, size_t, size_t, size_t>, MaterialInfo> materials;
+        auto key = make_tuple(iMaterialID, hasTexture, stridePos, strideNor, strideTxc);
+        auto materialIterator = materials.find(key);
+        if (materialIterator != materials.end()) {
+            return materialIterator->second;
+        }
+
+        const auto& iTechnique = scene.techniques.at(iMaterial.technique);
+
         auto oVSModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
             #version 450
 
@@ -385,78 +458,104 @@ namespace {
         }
     }
 
-    void initTextures() {
+    // Decodes an image to RGBA8, this runs on the thread pool
+    DecodedImage decodeImage(const tinygltf::Image& iImage) {
+        DecodedImage decoded;
+        int width = 0;
+        int height = 0;
+        int component = 0;
+        stbi_uc* pixels = stbi_load_from_memory(iImage.image.data(), static_cast<int>(iImage.image.size()), &width, &height, &component, 4);
+        if (pixels == nullptr) {
+            fprintf(stderr, "failed to decode image %s\n", iImage.name.c_str());
+            return decoded;
+        }
+
+        decoded.width = static_cast<uint32_t>(width);
+        decoded.height = static_cast<uint32_t>(height);
+        decoded.rgba.assign(pixels, pixels + decoded.width * decoded.height * 4);
+        stbi_image_free(pixels);
+        return decoded;
+    }
+
+    void startImageDecoding() {
+        size_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        decoderPool.reset(new ThreadPool(threadCount));
+
         for (const auto& t : scene.textures) {
             const auto& iTextureID = t.first;
             const auto& iTexture = t.second;
-            const auto& iImage = scene.images[iTexture.source];
 
-            nxt::TextureFormat format = nxt::TextureFormat::R8G8B8A8Unorm;
-            switch (iTexture.format) {
-                case gl::RGBA:
-                    format = nxt::TextureFormat::R8G8B8A8Unorm;
-                    break;
-                default:
-                    fprintf(stderr, "unsupported texture format %d\n", iTexture.format);
-                    continue;
+            if (iTexture.format != gl::RGBA) {
+                fprintf(stderr, "unsupported texture format %d\n", iTexture.format);
+                continue;
             }
 
-            auto oTexture = device.CreateTextureBuilder()
-                .SetDimension(nxt::TextureDimension::e2D)
-                .SetExtent(iImage.width, iImage.height, 1)
-                .SetFormat(format)
-                .SetMipLevels(1)
-                .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
-                .GetResult();
-                // TODO: release this texture
-
-            const uint8_t* origData = iImage.image.data();
-            const uint8_t* data = nullptr;
-            std::vector<uint8_t> newData;
-
-            uint32_t width = static_cast<uint32_t>(iImage.width);
-            uint32_t height = static_cast<uint32_t>(iImage.height);
-            uint32_t rowSize = width * 4;
-            uint32_t rowPitch = Align(rowSize, kTextureRowPitchAlignment);
-
-            if (iImage.component == 3 || iImage.component == 4) {
-                if (rowSize != rowPitch || iImage.component == 3) {
-                    newData.resize(rowPitch * height);
-                    uint32_t pixelsPerRow = rowPitch / 4;
-                    for (uint32_t y = 0; y < height; ++y) {
-                        for (uint32_t x = 0; x < width; ++x) {
-                            size_t oldIndex = x + y * height;
-                            size_t newIndex = x + y * pixelsPerRow;
-                            if (iImage.component == 4) {
-                                newData[4 * newIndex + 0] = origData[4 * oldIndex + 0];
-                                newData[4 * newIndex + 1] = origData[4 * oldIndex + 1];
-                                newData[4 * newIndex + 2] = origData[4 * oldIndex + 2];
-                                newData[4 * newIndex + 3] = origData[4 * oldIndex + 3];
-                            } else if (iImage.component == 3) {
-                                newData[4 * newIndex + 0] = origData[3 * oldIndex + 0];
-                                newData[4 * newIndex + 1] = origData[3 * oldIndex + 1];
-                                newData[4 * newIndex + 2] = origData[3 * oldIndex + 2];
-                                newData[4 * newIndex + 3] = 255;
-                            }
-                        }
-                    }
-                    data = newData.data();
-                } else {
-                    data = origData;
+            // Elements of the std::map stay at the same address while the decoding happens.
+            const tinygltf::Image* iImage = &scene.images[iTexture.source];
+            pendingTextureCount++;
+            decoderPool->post([iTextureID, iImage]() {
+                DecodedImage decoded = decodeImage(*iImage);
+                decoded.textureID = iTextureID;
+
+                std::lock_guard<std::mutex> lock(decodedImagesMutex);
+                decodedImages.push_back(std::move(decoded));
+            });
+        }
+    }
+
+    // Returns the number of bytes uploaded
+    size_t uploadTexture(const DecodedImage& image) {
+        uint32_t width = image.width;
+        uint32_t height = image.height;
+        uint32_t rowSize = width * 4;
+        uint32_t numMipLevels = Log2(std::max(width, height)) + 1;
+
+        auto oTexture = device.CreateTextureBuilder()
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(width, height, 1)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+            .SetMipLevels(numMipLevels)
+            .SetAllowedUsage(nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
+            .GetResult();
+            // TODO: release this texture
+
+        oTexture.TransitionUsage(nxt::TextureUsageBit::TransferDst);
+        oTexture.SetSubData(0, 0, 0, width, height, rowSize, rowSize * height, image.rgba.data());
+        auto cmdbuf = device.CreateCommandBufferBuilder()
+            .GenerateMipmaps(oTexture, 0, numMipLevels)
+            .GetResult();
+        queue.Submit(1, &cmdbuf);
+        oTexture.FreezeUsage(nxt::TextureUsageBit::Sampled);
+
+        textures[image.textureID] = oTexture.CreateTextureViewBuilder().GetResult();
+        return image.rgba.size();
+    }
+
+    // Uploads some of the meshes and decoded images that are still pending, called before each
+    // frame until everything is loaded.
+    void uploadPendingData() {
+        size_t uploadedSize = 0;
+
+        while (uploadedSize < kUploadBytesPerFrame && !pendingMeshes.empty()) {
+            uploadedSize += uploadMesh(pendingMeshes.front());
+            pendingMeshes.pop_front();
+        }
+
+        while (uploadedSize < kUploadBytesPerFrame) {
+            DecodedImage image;
+            {
+                std::lock_guard<std::mutex> lock(decodedImagesMutex);
+                if (decodedImages.empty()) {
+                    break;
                 }
-            } else {
-                fprintf(stderr, "unsupported image.component %d\n", iImage.component);
+                image = std::move(decodedImages.back());
+                decodedImages.pop_back();
             }
 
-            nxt::Buffer staging = utils::CreateFrozenBufferFromData(device, data, rowPitch * iImage.height, nxt::BufferUsageBit::TransferSrc);
-            auto cmdbuf = device.CreateCommandBufferBuilder()
-                .TransitionTextureUsage(oTexture, nxt::TextureUsageBit::TransferDst)
-                .CopyBufferToTexture(staging, 0, rowPitch, oTexture, 0, 0, 0, iImage.width, iImage.height, 1, 0)
-                .GetResult();
-            queue.Submit(1, &cmdbuf);
-            oTexture.FreezeUsage(nxt::TextureUsageBit::Sampled);
-
-            textures[iTextureID] = oTexture.CreateTextureViewBuilder().GetResult();
+            pendingTextureCount--;
+            if (!image.rgba.empty()) {
+                uploadedSize += uploadTexture(image);
+            }
         }
     }
 
@@ -471,9 +570,17 @@ namespace {
         renderpass = CreateDefaultRenderPass(device);
         depthStencilView = CreateDefaultDepthStencilView(device);
 
-        initBuffers();
+        initDefaultBuffer();
         initSamplers();
-        initTextures();
+        startImageDecoding();
+        for (const auto& m : scene.meshes) {
+            pendingMeshes.push_back(m.first);
+        }
+    }
+
+    void printLoadingTime(const char* milestone) {
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - startTime;
+        fprintf(stderr, "%s: %.1f ms\n", milestone, elapsed.count());
     }
 }
 
@@ -576,6 +683,10 @@ namespace {
         model = parent * model;
 
         for (const auto& meshID : node.meshes) {
+            // Meshes that are still loading are skipped
+            if (loadedMeshes.find(meshID) == loadedMeshes.end()) {
+                continue;
+            }
             drawMesh(cmd, scene.meshes[meshID], model);
         }
         for (const auto& child : node.children) {
@@ -584,6 +695,10 @@ namespace {
     }
 
     void frame() {
+        if (!fullyLoaded) {
+            uploadPendingData();
+        }
+
         nxt::Texture backbuffer;
         nxt::Framebuffer framebuffer;
         GetNextFramebuffer(device, renderpass, swapchain, depthStencilView, &backbuffer, &framebuffer);
@@ -606,6 +721,16 @@ namespace {
         backbuffer.TransitionUsage(nxt::TextureUsageBit::Present);
         swapchain.Present(backbuffer);
         DoFlush();
+
+        if (!firstFrameDone) {
+            firstFrameDone = true;
+            printLoadingTime("time to first frame");
+        }
+        if (!fullyLoaded && pendingMeshes.empty() && pendingTextureCount == 0) {
+            fullyLoaded = true;
+            decoderPool.reset();
+            printLoadingTime("time to fully loaded");
+        }
     }
 }
 
@@ -639,6 +764,8 @@ namespace {
 }
 
 int main(int argc, const char* argv[]) {
+    startTime = Clock::now();
+
     if (!InitSample(argc, argv)) {
         return 1;
     }
@@ -654,8 +781,14 @@ int main(int argc, const char* argv[]) {
 
     bool ret = false;
     if (ext.compare("glb") == 0) {
-        // assume binary glTF.
-        ret = loader.LoadBinaryFromFile(&scene, &err, input_filename.c_str());
+        // assume binary glTF, the file is mapped instead of being read in memory. The loader
+        // copies the data it needs so the file can be unmapped after loading.
+        MappedFile file(input_filename.c_str());
+        if (file.data() == nullptr) {
+            fprintf(stderr, "Failed to map .glb file: %s\n", argv[1]);
+            exit(-1);
+        }
+        ret = loader.LoadBinaryFromMemory(&scene, &err, file.data(), static_cast<unsigned int>(file.size()), tinygltf::GetBaseDir(input_filename));
     } else {
         // assume ascii glTF.
         ret = loader.LoadASCIIFromFile(&scene, &err, input_filename.c_str());
@@ -671,9 +804,11 @@ int main(int argc, const char* argv[]) {
     init();
 
     GLFWwindow* window = GetGLFWWindow();
-    glfwSetMouseButtonCallback(window, mouseButtonCallback);
-    glfwSetCursorPosCallback(window, cursorPosCallback);
-    glfwSetScrollCallback(window, scrollCallback);
+    if (window != nullptr) {
+        glfwSetMouseButtonCallback(window, mouseButtonCallback);
+        glfwSetCursorPosCallback(window, cursorPosCallback);
+        glfwSetScrollCallback(window, scrollCallback);
+    }
 
     while (!ShouldQuit()) {
         frame();
@@ -180,25 +180,36 @@ namespace {{namespace}} {
                 }
             {% endfor %}
         {% endfor %}
+
+        nxtProcTable CreateNonValidatingProcs() {
+            nxtProcTable table;
+            {% for type in by_category["object"] %}
+                {% for method in native_methods(type) %}
+                    table.{{as_varName(type.name, method.name)}} = reinterpret_cast<{{as_cProc(type.name, method.name)}}>(NonValidating{{as_MethodSuffix(type.name, method.name)}});
+                {% endfor %}
+            {% endfor %}
+            return table;
+        }
+
+        nxtProcTable CreateValidatingProcs() {
+            nxtProcTable table;
+            {% for type in by_category["object"] %}
+                {% for method in native_methods(type) %}
+                    table.{{as_varName(type.name, method.name)}} = reinterpret_cast<{{as_cProc(type.name, method.name)}}>(Validating{{as_MethodSuffix(type.name, method.name)}});
+                {% endfor %}
+            {% endfor %}
+            return table;
+        }
     }
 
+    // The tables are filled once, the first time they are needed, instead of for every device.
     nxtProcTable GetNonValidatingProcs() {
-        nxtProcTable table;
-        {% for type in by_category["object"] %}
-            {% for method in native_methods(type) %}
-                table.{{as_varName(type.name, method.name)}} = reinterpret_cast<{{as_cProc(type.name, method.name)}}>(NonValidating{{as_MethodSuffix(type.name, method.name)}});
-            {% endfor %}
-        {% endfor %}
+        static const nxtProcTable table = CreateNonValidatingProcs();
         return table;
     }
 
     nxtProcTable GetValidatingProcs() {
-        nxtProcTable table;
-        {% for type in by_category["object"] %}
-            {% for method in native_methods(type) %}
-                table.{{as_varName(type.name, method.name)}} = reinterpret_cast<{{as_cProc(type.name, method.name)}}>(Validating{{as_MethodSuffix(type.name, method.name)}});
-            {% endfor %}
-        {% endfor %}
+        static const nxtProcTable table = CreateValidatingProcs();
         return table;
     }
 }
@@ -189,18 +189,34 @@ namespace wire {
         //* and the object id allocators.
         class Device : public ObjectBase {
             public:
-                Device(CommandSerializer* serializer)
+                Device(CommandSerializer* serializer, TransferBuffer* transferBuffer)
                     : ObjectBase(this, 1, 1),
                     {% for type in by_category["object"] if not type.name.canonical_case() == "device" %}
                         {{type.name.camelCase()}}(this),
                     {% endfor %}
-                    mSerializer(serializer) {
+                    mSerializer(serializer), mTransferBuffer(transferBuffer) {
                 }
 
                 void* GetCmdSpace(size_t size) {
                     return mSerializer->GetCmdSpace(size);
                 }
 
+                //* Returns where to write argument data that is sent out of band, or nullptr if it
+                //* should be sent inline. Small arguments stay inline so that the server doesn't
+                //* need to go look for them.
+                void* GetTransferSpace(size_t size, TransferAllocation* allocation) {
+                    allocation->handle = kInlineTransferHandle;
+                    if (mTransferBuffer == nullptr || size < kMinTransferSize) {
+                        return nullptr;
+                    }
+
+                    void* result = mTransferBuffer->Allocate(size, allocation);
+                    if (result == nullptr) {
+                        allocation->handle = kInlineTransferHandle;
+                    }
+                    return result;
+                }
+
                 {% for type in by_category["object"] if not type.name.canonical_case() == "device" %}
                     ObjectAllocator<{{type.name.CamelCase()}}> {{type.name.camelCase()}};
                 {% endfor %}
@@ -211,13 +227,55 @@ namespace wire {
                     }
                 }
 
+                //* Makes the server record the following compact commands in this builder.
+                void SelectCommandBufferBuilder(uint32_t id) {
+                    if (selectedCommandBufferBuilder == id) {
+                        return;
+                    }
+
+                    wire::SelectCommandBufferBuilderCmd cmd;
+                    cmd.builderId = id;
+
+                    auto allocCmd = reinterpret_cast<decltype(cmd)*>(GetCmdSpace(cmd.GetRequiredSize()));
+                    *allocCmd = cmd;
+
+                    selectedCommandBufferBuilder = id;
+                }
+
                 nxtDeviceErrorCallback errorCallback = nullptr;
                 nxtCallbackUserdata errorUserdata;
 
+                //* ID of the builder compact commands are recorded in on the server, 0 if none.
+                uint32_t selectedCommandBufferBuilder = 0;
+
             private:
+               static constexpr size_t kMinTransferSize = 1024;
+
                CommandSerializer* mSerializer = nullptr;
+               TransferBuffer* mTransferBuffer = nullptr;
         };
 
+        //* Helpers to compute the size of and write arguments in the compact encoding.
+        {% macro compact_size(type, value) -%}
+            {%- if type.name.canonical_case() == "float" -%}
+                sizeof(float)
+            {%- elif type.category == "object" -%}
+                GetVarUintSize({{value}}->id)
+            {%- else -%}
+                GetVarUintSize(static_cast<uint32_t>({{value}}))
+            {%- endif -%}
+        {%- endmacro %}
+
+        {% macro compact_write(type, value) -%}
+            {%- if type.name.canonical_case() == "float" -%}
+                writer.WriteFloat({{value}})
+            {%- elif type.category == "object" -%}
+                writer.WriteVarUint({{value}}->id)
+            {%- else -%}
+                writer.WriteVarUint(static_cast<uint32_t>({{value}}))
+            {%- endif -%}
+        {%- endmacro %}
+
         //* Implementation of the client API functions.
         {% for type in by_category["object"] %}
             {% set Type = type.name.CamelCase() %}
@@ -225,6 +283,7 @@ namespace wire {
             {% for method in type.methods %}
                 {% set Suffix = as_MethodSuffix(type.name, method.name) %}
 
+                {% set opcode = loop.index0 %}
                 {{as_backendType(method.return_type)}} Client{{Suffix}}(
                     {{-as_backendType(type)}} self
                     {%- for arg in method.arguments -%}
@@ -232,6 +291,46 @@ namespace wire {
                     {%- endfor -%}
                 ) {
                     Device* device = self->device;
+
+                    {% if type.name.canonical_case() == "command buffer builder" and method.return_type.name.canonical_case() == "void" %}
+                        //* Recording commands use the compact encoding described in WireCmd.h unless
+                        //* their arguments don't fit in its payload.
+                        {
+                            size_t payloadSize = 0;
+                            {% for arg in method.arguments %}
+                                {% set argName = as_varName(arg.name) %}
+                                {% if arg.annotation == "value" %}
+                                    payloadSize += {{compact_size(arg.type, argName)}};
+                                {% else %}
+                                    for (size_t i = 0; i < {{as_varName(arg.length.name)}}; i++) {
+                                        payloadSize += {{compact_size(arg.type, argName + "[i]")}};
+                                    }
+                                {% endif %}
+                            {% endfor %}
+
+                            if (payloadSize <= kMaxCompactPayloadSize) {
+                                device->SelectCommandBufferBuilder(self->id);
+
+                                auto header = reinterpret_cast<uint32_t*>(device->GetCmdSpace(sizeof(uint32_t) + payloadSize));
+                                *header = MakeCompactCommandHeader({{opcode}}, payloadSize);
+
+                                {% if method.arguments | length > 0 %}
+                                    CompactCommandWriter writer(reinterpret_cast<uint8_t*>(header + 1));
+                                {% endif %}
+                                {% for arg in method.arguments %}
+                                    {% set argName = as_varName(arg.name) %}
+                                    {% if arg.annotation == "value" %}
+                                        {{compact_write(arg.type, argName)}};
+                                    {% else %}
+                                        for (size_t i = 0; i < {{as_varName(arg.length.name)}}; i++) {
+                                            {{compact_write(arg.type, argName + "[i]")}};
+                                        }
+                                    {% endif %}
+                                {% endfor %}
+                                return;
+                            }
+                        }
+                    {% endif %}
                     wire::{{Suffix}}Cmd cmd;
 
                     //* Create the structure going on the wire on the stack and fill it with the value
@@ -254,6 +353,19 @@ namespace wire {
                         {% endfor %}
                     }
 
+                    //* Write large arrays of values out of band so they don't take space in the
+                    //* command stream.
+                    {% for arg in method.arguments if arg.annotation != "value" and arg.length != "strlen" and arg.type.category != "object" %}
+                        {% set argName = as_varName(arg.name) %}
+                        {
+                            size_t {{argName}}TransferSize = {{as_varName(arg.length.name)}} * sizeof(*{{argName}});
+                            void* {{argName}}TransferData = device->GetTransferSpace({{argName}}TransferSize, &cmd.{{argName}}Transfer);
+                            if ({{argName}}TransferData != nullptr) {
+                                memcpy({{argName}}TransferData, {{argName}}, {{argName}}TransferSize);
+                            }
+                        }
+                    {% endfor %}
+
                     //* Allocate space to send the command and copy the value args over.
                     size_t requiredSize = cmd.GetRequiredSize();
                     auto allocCmd = reinterpret_cast<decltype(cmd)*>(device->GetCmdSpace(requiredSize));
@@ -270,7 +382,9 @@ namespace wire {
                                 {{argName}}Storage[i] = {{argName}}[i]->id;
                             }
                         {% else %}
-                            memcpy(allocCmd->GetPtr_{{argName}}(), {{argName}}, {{as_varName(arg.length.name)}} * sizeof(*{{argName}}));
+                            if (allocCmd->{{argName}}Transfer.handle == kInlineTransferHandle) {
+                                memcpy(allocCmd->GetPtr_{{argName}}(), {{argName}}, {{as_varName(arg.length.name)}} * sizeof(*{{argName}}));
+                            }
                         {% endif %}
                     {% endfor %}
 
@@ -322,6 +436,13 @@ namespace wire {
                     auto allocCmd = reinterpret_cast<decltype(cmd)*>(obj->device->GetCmdSpace(requiredSize));
                     *allocCmd = cmd;
 
+                    {% if type.name.canonical_case() == "command buffer builder" %}
+                        //* The ID can be reused by another builder that will need to be selected.
+                        if (obj->device->selectedCommandBufferBuilder == obj->id) {
+                            obj->device->selectedCommandBufferBuilder = 0;
+                        }
+                    {% endif %}
+
                     obj->device->{{type.name.camelCase()}}.Free(obj);
                 }
 
@@ -560,8 +681,8 @@ namespace wire {
 
     }
 
-    CommandHandler* NewClientDevice(nxtProcTable* procs, nxtDevice* device, CommandSerializer* serializer) {
-        auto clientDevice = new client::Device(serializer);
+    CommandHandler* NewClientDevice(nxtProcTable* procs, nxtDevice* device, CommandSerializer* serializer, TransferBuffer* transferBuffer) {
+        auto clientDevice = new client::Device(serializer, transferBuffer);
 
         *device = reinterpret_cast<nxtDeviceImpl*>(clientDevice);
         *procs = client::GetProcs();
@@ -30,7 +30,9 @@ namespace wire {
                     {% elif arg.type.category == "object" %}
                         result += {{as_varName(arg.length.name)}} * sizeof(uint32_t);
                     {% else %}
-                        result += {{as_varName(arg.length.name)}} * sizeof({{as_cType(arg.type.name)}});
+                        if ({{as_varName(arg.name)}}Transfer.handle == kInlineTransferHandle) {
+                            result += {{as_varName(arg.length.name)}} * sizeof({{as_cType(arg.type.name)}});
+                        }
                     {% endif %}
                 {% endfor %}
 
@@ -56,7 +58,9 @@ namespace wire {
                             {% elif arg.type.category == "object" %}
                                 ptr += {{as_varName(arg.length.name)}} * sizeof(uint32_t);
                             {% else %}
-                                ptr += {{as_varName(arg.length.name)}} * sizeof({{as_cType(arg.type.name)}});
+                                if ({{as_varName(arg.name)}}Transfer.handle == kInlineTransferHandle) {
+                                    ptr += {{as_varName(arg.length.name)}} * sizeof({{as_cType(arg.type.name)}});
+                                }
                             {% endif %}
                         {% endfor %}
                     }
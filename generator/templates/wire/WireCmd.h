@@ -17,6 +17,8 @@
 
 #include <nxt/nxt.h>
 
+#include "wire/Wire.h"
+
 namespace nxt {
 namespace wire {
 
@@ -29,6 +31,7 @@ namespace wire {
             {{as_MethodSuffix(type.name, Name("destroy"))}},
         {% endfor %}
         BufferMapReadAsync,
+        SelectCommandBufferBuilder,
     };
 
     {% for type in by_category["object"] %}
@@ -67,6 +70,12 @@ namespace wire {
                     size_t {{as_varName(arg.name)}}Strlen;
                 {% endfor %}
 
+                //* Arrays of values can be sent in a TransferBuffer instead of after the structure,
+                //* in which case they take no space in the command stream.
+                {% for arg in method.arguments if arg.annotation != "value" and arg.length != "strlen" and arg.type.category != "object" %}
+                    TransferAllocation {{as_varName(arg.name)}}Transfer;
+                {% endfor %}
+
                 //* The following commands do computation, provided the members for value parameters
                 //* have been initialized.
 
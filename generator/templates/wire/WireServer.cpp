@@ -122,6 +122,33 @@ namespace wire {
                 std::vector<Data> mKnown;
         };
 
+        //* Reads an argument in the compact encoding into 'target'. Objects are looked up from
+        //* their ID and set 'valid' to false if they are errors.
+        {% macro compact_read(type, target) %}
+            {% if type.name.canonical_case() == "float" %}
+                if (!reader->ReadFloat(&{{target}})) {
+                    return false;
+                }
+            {% else %}
+                {
+                    uint32_t value;
+                    if (!reader->ReadVarUint(&value)) {
+                        return false;
+                    }
+                    {% if type.category == "object" %}
+                        auto* data = mKnown{{type.name.CamelCase()}}.Get(value);
+                        if (data == nullptr) {
+                            return false;
+                        }
+                        valid = valid && data->valid;
+                        {{target}} = data->handle;
+                    {% else %}
+                        {{target}} = static_cast<{{as_cType(type.name)}}>(value);
+                    {% endif %}
+                }
+            {% endif %}
+        {% endmacro %}
+
         void ForwardDeviceErrorToServer(const char* message, nxtCallbackUserdata userdata);
 
         {% for type in by_category["object"] if type.is_builder%}
@@ -132,8 +159,8 @@ namespace wire {
 
         class Server : public CommandHandler {
             public:
-                Server(nxtDevice device, const nxtProcTable& procs, CommandSerializer* serializer)
-                    : mProcs(procs), mSerializer(serializer) {
+                Server(nxtDevice device, const nxtProcTable& procs, CommandSerializer* serializer, TransferBuffer* transferBuffer, bool sharedDevice)
+                    : mProcs(procs), mSerializer(serializer), mTransferBuffer(transferBuffer), mSharedDevice(sharedDevice) {
                     //* The client-server knowledge is bootstrapped with device 1.
                     auto* deviceData = mKnownDevice.Allocate(1);
                     deviceData->handle = device;
@@ -206,6 +233,13 @@ namespace wire {
                 }
 
                 const uint8_t* HandleCommands(const uint8_t* commands, size_t size) override {
+                    //* When the device is shared with other servers, its errors are reported to the
+                    //* server handling commands when they happen.
+                    if (mSharedDevice) {
+                        auto userdata = static_cast<nxtCallbackUserdata>(reinterpret_cast<intptr_t>(this));
+                        mProcs.deviceSetErrorCallback(mKnownDevice.Get(1)->handle, ForwardDeviceErrorToServer, userdata);
+                    }
+
                     mProcs.deviceTick(mKnownDevice.Get(1)->handle);
 
                     while (size > sizeof(WireCmd)) {
@@ -228,16 +262,26 @@ namespace wire {
                             case WireCmd::BufferMapReadAsync:
                                 success = HandleBufferMapReadAsync(&commands, &size);
                                 break;
+                            case WireCmd::SelectCommandBufferBuilder:
+                                success = HandleSelectCommandBufferBuilder(&commands, &size);
+                                break;
 
                             default:
-                                success = false;
+                                //* Compact commands start with a header word instead of a WireCmd.
+                                success = (static_cast<uint32_t>(cmdId) & kCompactCommandBit) != 0 &&
+                                          HandleCompactCommand(&commands, &size);
                         }
 
                         if (!success) {
+                            ReleaseTransfers();
                             return nullptr;
                         }
                     }
 
+                    //* All the commands have been executed so the transfer data they used isn't
+                    //* needed anymore.
+                    ReleaseTransfers();
+
                     if (size != 0) {
                         return nullptr;
                     }
@@ -248,11 +292,38 @@ namespace wire {
             private:
                 nxtProcTable mProcs;
                 CommandSerializer* mSerializer = nullptr;
+                TransferBuffer* mTransferBuffer = nullptr;
+                bool mSharedDevice = false;
+                uint64_t mLastUsedTransferSerial = 0;
+                uint64_t mLastReleasedTransferSerial = 0;
 
                 void* GetCmdSpace(size_t size) {
                     return mSerializer->GetCmdSpace(size);
                 }
 
+                //* Returns the data of an argument sent out of band, or nullptr if it isn't valid.
+                const void* GetTransferData(const TransferAllocation& allocation, size_t size) {
+                    if (mTransferBuffer == nullptr) {
+                        return nullptr;
+                    }
+
+                    const void* data = mTransferBuffer->GetData(allocation, size);
+                    if (data != nullptr && allocation.serial > mLastUsedTransferSerial) {
+                        mLastUsedTransferSerial = allocation.serial;
+                    }
+                    return data;
+                }
+
+                void ReleaseTransfers() {
+                    if (mLastUsedTransferSerial > mLastReleasedTransferSerial) {
+                        mTransferBuffer->Release(mLastUsedTransferSerial);
+                        mLastReleasedTransferSerial = mLastUsedTransferSerial;
+                    }
+                }
+
+                //* The builder compact commands are recorded in.
+                uint32_t mSelectedCommandBufferBuilder = 0;
+
                 //* The list of known IDs for each object type.
                 {% for type in by_category["object"] %}
                     KnownObjects<{{as_cType(type.name)}}> mKnown{{type.name.CamelCase()}};
@@ -349,8 +420,17 @@ namespace wire {
                                     }
                                     arg_{{argName}} = {{argName}}Storage.data();
                                 {% else %}
-                                    //* For anything else, just get the pointer.
-                                    arg_{{argName}} = reinterpret_cast<const {{as_cType(arg.type.name)}}*>(cmd->GetPtr_{{argName}}());
+                                    //* For anything else, get the pointer to the data either in the
+                                    //* command stream or in the transfer buffer.
+                                    if (cmd->{{argName}}Transfer.handle == kInlineTransferHandle) {
+                                        arg_{{argName}} = reinterpret_cast<const {{as_cType(arg.type.name)}}*>(cmd->GetPtr_{{argName}}());
+                                    } else {
+                                        size_t {{argName}}TransferSize = size_t(cmd->{{as_varName(arg.length.name)}}) * sizeof({{as_cType(arg.type.name)}});
+                                        arg_{{argName}} = reinterpret_cast<const {{as_cType(arg.type.name)}}*>(GetTransferData(cmd->{{argName}}Transfer, {{argName}}TransferSize));
+                                        if (arg_{{argName}} == nullptr) {
+                                            return false;
+                                        }
+                                    }
                                 {% endif %}
                             {% endfor %}
 
@@ -440,11 +520,113 @@ namespace wire {
                             mProcs.{{as_varName(type.name, Name("release"))}}(data->handle);
                         }
 
+                        {% if type.name.canonical_case() == "command buffer builder" %}
+                            if (mSelectedCommandBufferBuilder == cmd->objectId) {
+                                mSelectedCommandBufferBuilder = 0;
+                            }
+                        {% endif %}
+
                         mKnown{{type.name.CamelCase()}}.Free(cmd->objectId);
                         return true;
                     }
                 {% endfor %}
 
+                bool HandleSelectCommandBufferBuilder(const uint8_t** commands, size_t* size) {
+                    const auto* cmd = GetCommand<SelectCommandBufferBuilderCmd>(commands, size);
+                    if (cmd == nullptr) {
+                        return false;
+                    }
+
+                    if (mKnownCommandBufferBuilder.Get(cmd->builderId) == nullptr) {
+                        return false;
+                    }
+
+                    mSelectedCommandBufferBuilder = cmd->builderId;
+                    return true;
+                }
+
+                bool HandleCompactCommand(const uint8_t** commands, size_t* size) {
+                    if (*size < sizeof(uint32_t)) {
+                        return false;
+                    }
+
+                    uint32_t header = *reinterpret_cast<const uint32_t*>(*commands);
+                    size_t payloadSize = GetCompactCommandPayloadSize(header);
+                    if (*size - sizeof(uint32_t) < payloadSize) {
+                        return false;
+                    }
+
+                    CompactCommandReader reader(*commands + sizeof(uint32_t), payloadSize);
+                    *commands += sizeof(uint32_t) + payloadSize;
+                    *size -= sizeof(uint32_t) + payloadSize;
+
+                    //* Builder 0 is the null object, meaning no builder was selected.
+                    auto* builderData = mKnownCommandBufferBuilder.Get(mSelectedCommandBufferBuilder);
+                    if (mSelectedCommandBufferBuilder == 0 || builderData == nullptr) {
+                        return false;
+                    }
+
+                    bool success = false;
+                    switch (GetCompactCommandOpcode(header)) {
+                        {% for type in by_category["object"] if type.name.canonical_case() == "command buffer builder" %}
+                            {% for method in type.methods %}
+                                {% if method.return_type.name.canonical_case() == "void" %}
+                                    case {{loop.index0}}:
+                                        success = HandleCompact{{as_MethodSuffix(type.name, method.name)}}(builderData, &reader);
+                                        break;
+                                {% endif %}
+                            {% endfor %}
+                        {% endfor %}
+                        default:
+                            return false;
+                    }
+
+                    //* All the payload must be used by the command.
+                    return success && reader.GetRemainingSize() == 0;
+                }
+
+                //* Handlers for the compact commands, which use the selected builder as 'self'.
+                {% for type in by_category["object"] if type.name.canonical_case() == "command buffer builder" %}
+                {% for method in type.methods if method.return_type.name.canonical_case() == "void" %}
+                    {% set Suffix = as_MethodSuffix(type.name, method.name) %}
+                    bool HandleCompact{{Suffix}}(ObjectDataBase<nxtCommandBufferBuilder>* builderData, CompactCommandReader* reader) {
+                        bool valid = builderData->valid;
+
+                        {% for arg in method.arguments %}
+                            {% set argName = as_varName(arg.name) %}
+                            {% if arg.annotation == "value" %}
+                                {{as_cType(arg.type.name)}} arg_{{argName}};
+                                {{compact_read(arg.type, "arg_" + argName)}}
+                            {% else %}
+                                //* Each element takes at least a byte, which prevents huge
+                                //* allocations from small invalid commands.
+                                if (reader->GetRemainingSize() < arg_{{as_varName(arg.length.name)}}) {
+                                    return false;
+                                }
+                                std::vector<{{as_cType(arg.type.name)}}> {{argName}}Storage(arg_{{as_varName(arg.length.name)}});
+                                for (size_t i = 0; i < {{argName}}Storage.size(); i++) {
+                                    {{compact_read(arg.type, argName + "Storage[i]")}}
+                                }
+                                const {{as_cType(arg.type.name)}}* arg_{{argName}} = {{argName}}Storage.data();
+                            {% endif %}
+                        {% endfor %}
+
+                        //* Recording with an error object makes the builder an error.
+                        if (!valid) {
+                            builderData->valid = false;
+                            return true;
+                        }
+
+                        mProcs.{{as_varName(type.name, method.name)}}(builderData->handle
+                            {%- for arg in method.arguments -%}
+                                , arg_{{as_varName(arg.name)}}
+                            {%- endfor -%}
+                        );
+                        return true;
+                    }
+                {% endfor %}
+                {% endfor %}
+
                 bool HandleBufferMapReadAsync(const uint8_t** commands, size_t* size) {
                     //* These requests are just forwarded to the buffer, with userdata containing what the client
                     //* will require in the return command.
@@ -499,8 +681,12 @@ namespace wire {
         }
     }
 
-    CommandHandler* NewServerCommandHandler(nxtDevice device, const nxtProcTable& procs, CommandSerializer* serializer) {
-        return new server::Server(device, procs, serializer);
+    CommandHandler* NewServerCommandHandler(nxtDevice device, const nxtProcTable& procs, CommandSerializer* serializer, TransferBuffer* transferBuffer) {
+        return new server::Server(device, procs, serializer, transferBuffer, false);
+    }
+
+    CommandHandler* NewSharedDeviceServerCommandHandler(nxtDevice device, const nxtProcTable& procs, CommandSerializer* serializer, TransferBuffer* transferBuffer) {
+        return new server::Server(device, procs, serializer, transferBuffer, true);
     }
 
 }
@@ -19,16 +19,34 @@
 #include "backend/Device.h"
 #include "backend/Texture.h"
 #include "common/Assert.h"
+#include "common/BitSetIterator.h"
+#include "common/HashUtils.h"
 #include "common/Math.h"
 
+#include <functional>
+
 namespace backend {
 
     // BindGroup
 
-    BindGroupBase::BindGroupBase(BindGroupBuilder* builder)
-        : mLayout(std::move(builder->mLayout)),
-          mUsage(builder->mUsage),
-          mBindings(std::move(builder->mBindings)) {
+    BindGroupBase::BindGroupBase(BindGroupBuilder* builder, bool blueprint)
+        : mDevice(builder->mDevice), mUsage(builder->mUsage), mIsBlueprint(blueprint) {
+        // The blueprint is only used to look up the cache, the builder keeps its objects so that
+        // the actual bind group can be created if there is no match.
+        if (blueprint) {
+            mLayout = builder->mLayout;
+            mBindings = builder->mBindings;
+        } else {
+            mLayout = std::move(builder->mLayout);
+            mBindings = std::move(builder->mBindings);
+        }
+    }
+
+    BindGroupBase::~BindGroupBase() {
+        // Only frozen bind groups are cached, and blueprints never are.
+        if (!mIsBlueprint && mUsage == nxt::BindGroupUsage::Frozen) {
+            mDevice->UncacheBindGroup(this);
+        }
     }
 
     const BindGroupLayoutBase* BindGroupBase::GetLayout() const {
@@ -83,6 +101,13 @@ namespace backend {
             return nullptr;
         }
 
+        // Frozen bind groups can never change so builders with the same arguments return the
+        // same object. Dynamic bind groups always get a new object.
+        if (mUsage == nxt::BindGroupUsage::Frozen) {
+            BindGroupBase blueprint(this, true);
+            return mDevice->GetOrCreateBindGroup(&blueprint, this);
+        }
+
         return mDevice->CreateBindGroup(this);
     }
 
@@ -222,4 +247,33 @@ namespace backend {
 
         return true;
     }
+
+    // BindGroupCacheFuncs
+
+    size_t BindGroupCacheFuncs::operator()(const BindGroupBase* bindGroup) const {
+        size_t hash = std::hash<const BindGroupLayoutBase*>()(bindGroup->mLayout.Get());
+
+        for (uint32_t binding : IterateBitSet(bindGroup->mLayout->GetBindingInfo().mask)) {
+            const RefCounted* object = bindGroup->mBindings[binding].Get();
+            CombineHashes(&hash, std::hash<const RefCounted*>()(object));
+        }
+
+        return hash;
+    }
+
+    bool BindGroupCacheFuncs::operator()(const BindGroupBase* a, const BindGroupBase* b) const {
+        // Bind group layouts are deduplicated so they are equal only if they are the same object.
+        if (a->mLayout.Get() != b->mLayout.Get() || a->mUsage != b->mUsage) {
+            return false;
+        }
+
+        for (uint32_t binding : IterateBitSet(a->mLayout->GetBindingInfo().mask)) {
+            if (a->mBindings[binding].Get() != b->mBindings[binding].Get()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
 }  // namespace backend
@@ -30,7 +30,8 @@ namespace backend {
 
     class BindGroupBase : public RefCounted {
       public:
-        BindGroupBase(BindGroupBuilder* builder);
+        BindGroupBase(BindGroupBuilder* builder, bool blueprint = false);
+        ~BindGroupBase() override;
 
         const BindGroupLayoutBase* GetLayout() const;
         nxt::BindGroupUsage GetUsage() const;
@@ -39,9 +40,13 @@ namespace backend {
         TextureViewBase* GetBindingAsTextureView(size_t binding);
 
       private:
+        friend struct BindGroupCacheFuncs;
+
+        DeviceBase* mDevice;
         Ref<BindGroupLayoutBase> mLayout;
         nxt::BindGroupUsage mUsage;
         std::array<Ref<RefCounted>, kMaxBindingsPerGroup> mBindings;
+        bool mIsBlueprint = false;
     };
 
     class BindGroupBuilder : public Builder<BindGroupBase> {
@@ -88,6 +93,17 @@ namespace backend {
         std::array<Ref<RefCounted>, kMaxBindingsPerGroup> mBindings;
     };
 
+    // Implements the functors necessary for the unordered_set<BindGroup*>-based cache of frozen
+    // bind groups. Bind groups are equal when they have the same layout and the same objects in
+    // their bindings.
+    struct BindGroupCacheFuncs {
+        // The hash function
+        size_t operator()(const BindGroupBase* bindGroup) const;
+
+        // The equality predicate
+        bool operator()(const BindGroupBase* a, const BindGroupBase* b) const;
+    };
+
 }  // namespace backend
 
 #endif  // BACKEND_BINDGROUP_H_
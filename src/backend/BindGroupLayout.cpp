@@ -15,6 +15,7 @@
 #include "backend/BindGroupLayout.h"
 
 #include "backend/Device.h"
+#include "common/HashUtils.h"
 
 #include <functional>
 
@@ -35,12 +36,6 @@ namespace backend {
             return std::hash<unsigned long long>()(value.to_ullong());
         }
 
-        // TODO(cwallez@chromium.org): see if we can use boost's hash combined or some equivalent
-        // this currently assumes that size_t is 64 bits
-        void CombineHashes(size_t* h1, size_t h2) {
-            *h1 ^= (h2 << 7) + (h2 >> (sizeof(size_t) * 8 - 7)) + 0x304975;
-        }
-
         size_t HashBindingInfo(const BindGroupLayoutBase::LayoutBindingInfo& info) {
             size_t hash = Hash(info.mask);
 
@@ -129,6 +129,33 @@ namespace backend {
         return commandPtr;
     }
 
+    bool CommandIterator::PeekCommandId(uint32_t* commandId) {
+        uint8_t* currentPtr = mCurrentPtr;
+        size_t currentBlock = mCurrentBlock;
+
+        // NextCommandId resets the iterator when reaching the end, restoring the position undoes
+        // that too.
+        bool hasCommand = NextCommandId(commandId);
+
+        mCurrentPtr = currentPtr;
+        mCurrentBlock = currentBlock;
+        return hasCommand;
+    }
+
+    void* CommandIterator::PeekCommand(size_t commandSize, size_t commandAlignment) {
+        uint8_t* currentPtr = mCurrentPtr;
+        size_t currentBlock = mCurrentBlock;
+
+        uint32_t id;
+        bool hasId = NextCommandId(&id);
+        ASSERT(hasId);
+        void* command = NextCommand(commandSize, commandAlignment);
+
+        mCurrentPtr = currentPtr;
+        mCurrentBlock = currentBlock;
+        return command;
+    }
+
     void* CommandIterator::NextData(size_t dataSize, size_t dataAlignment) {
         uint32_t id;
         bool hasId = NextCommandId(&id);
@@ -84,6 +84,17 @@ namespace backend {
             return reinterpret_cast<T*>(NextData(sizeof(T) * count, alignof(T)));
         }
 
+        // Look at the next command without moving the iterator forward. PeekCommand must only be
+        // called after PeekCommandId returned true.
+        template <typename E>
+        bool PeekCommandId(E* commandId) {
+            return PeekCommandId(reinterpret_cast<uint32_t*>(commandId));
+        }
+        template <typename T>
+        T* PeekCommand() {
+            return reinterpret_cast<T*>(PeekCommand(sizeof(T), alignof(T)));
+        }
+
         // Needs to be called if iteration was stopped early.
         void Reset();
 
@@ -95,6 +106,8 @@ namespace backend {
         bool NextCommandId(uint32_t* commandId);
         void* NextCommand(size_t commandSize, size_t commandAlignment);
         void* NextData(size_t dataSize, size_t dataAlignment);
+        bool PeekCommandId(uint32_t* commandId);
+        void* PeekCommand(size_t commandSize, size_t commandAlignment);
 
         CommandBlocks mBlocks;
         uint8_t* mCurrentPtr = nullptr;
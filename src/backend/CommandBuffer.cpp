@@ -25,6 +25,7 @@
 #include "backend/RenderPipeline.h"
 #include "backend/Texture.h"
 
+#include <algorithm>
 #include <cstring>
 #include <map>
 
@@ -51,10 +52,24 @@ namespace backend {
                 return false;
             }
 
-            // TODO(cwallez@chromium.org): Check the depth bound differently for 2D arrays and 3D
-            // textures
-            if (location.z != 0 || location.depth != 1) {
-                builder->HandleError("No support for z != 0 and depth != 1 for now");
+            if (!texture->IsRegionBlockAligned(location.level, location.x, location.y,
+                                               location.width, location.height)) {
+                builder->HandleError("Copy region isn't aligned to the texture format's blocks");
+                return false;
+            }
+
+            // For 2D array textures z and depth select a range of layers.
+            if (texture->GetDimension() == nxt::TextureDimension::e2D) {
+                if (location.z != 0 || location.depth != 1) {
+                    builder->HandleError("Copies to 2D textures must have z = 0 and depth = 1");
+                    return false;
+                }
+            } else if (location.depth == 0) {
+                builder->HandleError("Copies must have a depth of at least 1");
+                return false;
+            } else if (uint64_t(location.z) + uint64_t(location.depth) >
+                       uint64_t(texture->GetLevelDepth(location.level))) {
+                builder->HandleError("Copy would touch outside of the texture's depth or layers");
                 return false;
             }
 
@@ -80,10 +95,9 @@ namespace backend {
         bool ValidateTexelBufferOffset(CommandBufferBuilder* builder,
                                        TextureBase* texture,
                                        const BufferCopyLocation& location) {
-            uint32_t texelSize =
-                static_cast<uint32_t>(TextureFormatPixelSize(texture->GetFormat()));
-            if (location.offset % texelSize != 0) {
-                builder->HandleError("Buffer offset must be a multiple of the texel size");
+            uint32_t blockSize = TextureFormatBlockSize(texture->GetFormat());
+            if (location.offset % blockSize != 0) {
+                builder->HandleError("Buffer offset must be a multiple of the texel block size");
                 return false;
             }
 
@@ -95,14 +109,24 @@ namespace backend {
                                           uint32_t rowPitch,
                                           uint32_t* bufferSize) {
             // TODO(cwallez@chromium.org): check for overflows
-            *bufferSize = (rowPitch * (location.height - 1) + location.width) * location.depth;
+            nxt::TextureFormat format = location.texture->GetFormat();
+            uint32_t rowCount = ComputeTextureRowCount(format, location.height);
+            if (rowCount == 0 || location.width == 0 || location.depth == 0) {
+                *bufferSize = 0;
+                return true;
+            }
+
+            // Images for each layer or depth slice are tightly packed at rowPitch * rowCount
+            // bytes from each other, only the last row of the last image can be shorter.
+            uint32_t rowSize = ComputeTextureRowSize(format, location.width);
+            uint32_t imageSize = rowPitch * rowCount;
+            *bufferSize = imageSize * (location.depth - 1) + rowPitch * (rowCount - 1) + rowSize;
 
             return true;
         }
 
         uint32_t ComputeDefaultRowPitch(TextureBase* texture, uint32_t width) {
-            uint32_t texelSize = TextureFormatPixelSize(texture->GetFormat());
-            return texelSize * width;
+            return ComputeTextureRowSize(texture->GetFormat(), width);
         }
 
         bool ValidateRowPitch(CommandBufferBuilder* builder,
@@ -113,8 +137,8 @@ namespace backend {
                 return false;
             }
 
-            uint32_t texelSize = TextureFormatPixelSize(location.texture.Get()->GetFormat());
-            if (rowPitch < location.width * texelSize) {
+            uint32_t rowSize = ComputeTextureRowSize(location.texture->GetFormat(), location.width);
+            if (rowPitch < rowSize) {
                 builder->HandleError("Row pitch must not be less than the number of bytes per row");
                 return false;
             }
@@ -122,6 +146,54 @@ namespace backend {
             return true;
         }
 
+        bool ValidateMipmapGeneration(CommandBufferBuilder* builder,
+                                      const GenerateMipmapsCmd* cmd) {
+            const TextureBase* texture = cmd->texture.Get();
+            if (!builder->GetDevice()->IsMipmapGenerationSupported()) {
+                builder->HandleError("Mipmap generation isn't supported by this device");
+                return false;
+            }
+
+            if (cmd->levelCount == 0) {
+                builder->HandleError("Mipmap generation level count must be at least one");
+                return false;
+            }
+
+            if (uint64_t(cmd->baseLevel) + uint64_t(cmd->levelCount) >
+                texture->GetNumMipLevels()) {
+                builder->HandleError("Mipmap generation level range out of bounds");
+                return false;
+            }
+
+            if (texture->GetDimension() != nxt::TextureDimension::e2D) {
+                builder->HandleError("Mipmap generation is only supported for 2D textures");
+                return false;
+            }
+
+            if (!TextureFormatIsFilterable(texture->GetFormat())) {
+                builder->HandleError("Mipmap generation requires a filterable format");
+                return false;
+            }
+
+            return true;
+        }
+
+        bool ValidateTransitionLevels(CommandBufferBuilder* builder,
+                                      const TransitionTextureUsageCmd* cmd) {
+            if (cmd->levelCount == 0) {
+                builder->HandleError("Texture transition level count must be at least one");
+                return false;
+            }
+
+            if (uint64_t(cmd->baseLevel) + uint64_t(cmd->levelCount) >
+                cmd->texture->GetNumMipLevels()) {
+                builder->HandleError("Texture transition level range out of bounds");
+                return false;
+            }
+
+            return true;
+        }
+
     }  // namespace
 
     CommandBufferBase::CommandBufferBase(CommandBufferBuilder* builder)
@@ -202,6 +274,22 @@ namespace backend {
                     EndRenderSubpassCmd* cmd = commands->NextCommand<EndRenderSubpassCmd>();
                     cmd->~EndRenderSubpassCmd();
                 } break;
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = commands->NextCommand<GenerateMipmapsCmd>();
+                    cmd->~GenerateMipmapsCmd();
+                } break;
+                case Command::MultiDrawArrays: {
+                    MultiDrawArraysCmd* cmd = commands->NextCommand<MultiDrawArraysCmd>();
+                    commands->NextData<uint32_t>(cmd->drawCount);
+                    commands->NextData<uint32_t>(cmd->drawCount);
+                    cmd->~MultiDrawArraysCmd();
+                } break;
+                case Command::MultiDrawElements: {
+                    MultiDrawElementsCmd* cmd = commands->NextCommand<MultiDrawElementsCmd>();
+                    commands->NextData<uint32_t>(cmd->drawCount);
+                    commands->NextData<uint32_t>(cmd->drawCount);
+                    cmd->~MultiDrawElementsCmd();
+                } break;
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = commands->NextCommand<SetComputePipelineCmd>();
                     cmd->~SetComputePipelineCmd();
@@ -223,6 +311,14 @@ namespace backend {
                     SetBlendColorCmd* cmd = commands->NextCommand<SetBlendColorCmd>();
                     cmd->~SetBlendColorCmd();
                 } break;
+                case Command::SetViewport: {
+                    SetViewportCmd* cmd = commands->NextCommand<SetViewportCmd>();
+                    cmd->~SetViewportCmd();
+                } break;
+                case Command::SetScissorRect: {
+                    SetScissorRectCmd* cmd = commands->NextCommand<SetScissorRectCmd>();
+                    cmd->~SetScissorRectCmd();
+                } break;
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = commands->NextCommand<SetBindGroupCmd>();
                     cmd->~SetBindGroupCmd();
@@ -255,6 +351,81 @@ namespace backend {
         commands->DataWasDestroyed();
     }
 
+    namespace {
+
+        bool CanAddToBufferCopyBatch(const BufferCopyBatch& batch,
+                                     const CopyBufferToBufferCmd& copy) {
+            if (copy.source.buffer.Get() != batch.source ||
+                copy.destination.buffer.Get() != batch.destination) {
+                return false;
+            }
+
+            // Copies inside the same buffer can read what a previous copy wrote.
+            if (batch.source == batch.destination) {
+                return false;
+            }
+
+            if (copy.size == 0 || batch.regions.empty()) {
+                return true;
+            }
+
+            // Writes to the same range of the destination must stay ordered.
+            uint64_t start = copy.destination.offset;
+            uint64_t end = start + copy.size;
+            return start >= batch.destinationEnd || end <= batch.destinationStart;
+        }
+
+        void AddToBufferCopyBatch(BufferCopyBatch* batch, const CopyBufferToBufferCmd& copy) {
+            batch->commandCount++;
+            if (copy.size == 0) {
+                return;
+            }
+
+            uint32_t sourceOffset = copy.source.offset;
+            uint32_t destinationOffset = copy.destination.offset;
+            if (batch->regions.empty()) {
+                batch->destinationStart = destinationOffset;
+                batch->destinationEnd = destinationOffset + copy.size;
+            } else {
+                uint32_t destinationEnd = destinationOffset + copy.size;
+                batch->destinationStart = std::min(batch->destinationStart, destinationOffset);
+                batch->destinationEnd = std::max(batch->destinationEnd, destinationEnd);
+
+                BufferCopyRegion& last = batch->regions.back();
+                if (last.sourceOffset + last.size == sourceOffset &&
+                    last.destinationOffset + last.size == destinationOffset) {
+                    last.size += copy.size;
+                    return;
+                }
+            }
+
+            batch->regions.push_back({sourceOffset, destinationOffset, copy.size});
+        }
+
+    }  // anonymous namespace
+
+    void GatherBufferCopies(CommandIterator* commands,
+                            CopyBufferToBufferCmd* first,
+                            BufferCopyBatch* batch) {
+        batch->source = first->source.buffer.Get();
+        batch->destination = first->destination.buffer.Get();
+        batch->commandCount = 0;
+        batch->regions.clear();
+        AddToBufferCopyBatch(batch, *first);
+
+        Command type;
+        while (commands->PeekCommandId(&type) && type == Command::CopyBufferToBuffer) {
+            CopyBufferToBufferCmd* copy = commands->PeekCommand<CopyBufferToBufferCmd>();
+            if (!CanAddToBufferCopyBatch(*batch, *copy)) {
+                break;
+            }
+
+            commands->NextCommandId(&type);
+            commands->NextCommand<CopyBufferToBufferCmd>();
+            AddToBufferCopyBatch(batch, *copy);
+        }
+    }
+
     void SkipCommand(CommandIterator* commands, Command type) {
         switch (type) {
             case Command::BeginComputePass:
@@ -305,6 +476,22 @@ namespace backend {
                 commands->NextCommand<EndRenderSubpassCmd>();
                 break;
 
+            case Command::GenerateMipmaps:
+                commands->NextCommand<GenerateMipmapsCmd>();
+                break;
+
+            case Command::MultiDrawArrays: {
+                auto* cmd = commands->NextCommand<MultiDrawArraysCmd>();
+                commands->NextData<uint32_t>(cmd->drawCount);
+                commands->NextData<uint32_t>(cmd->drawCount);
+            } break;
+
+            case Command::MultiDrawElements: {
+                auto* cmd = commands->NextCommand<MultiDrawElementsCmd>();
+                commands->NextData<uint32_t>(cmd->drawCount);
+                commands->NextData<uint32_t>(cmd->drawCount);
+            } break;
+
             case Command::SetComputePipeline:
                 commands->NextCommand<SetComputePipelineCmd>();
                 break;
@@ -326,6 +513,14 @@ namespace backend {
                 commands->NextCommand<SetBlendColorCmd>();
                 break;
 
+            case Command::SetViewport:
+                commands->NextCommand<SetViewportCmd>();
+                break;
+
+            case Command::SetScissorRect:
+                commands->NextCommand<SetScissorRectCmd>();
+                break;
+
             case Command::SetBindGroup:
                 commands->NextCommand<SetBindGroupCmd>();
                 break;
@@ -427,9 +622,11 @@ namespace backend {
                         !mState->ValidateCanUseBufferAs(copy->source.buffer.Get(),
                                                         nxt::BufferUsageBit::TransferSrc) ||
                         !mState->ValidateCanUseTextureAs(copy->destination.texture.Get(),
+                                                         copy->destination.level,
                                                          nxt::TextureUsageBit::TransferDst)) {
                         return false;
                     }
+                    mState->SetTextureContentsWritten(copy->destination.texture.Get());
                 } break;
 
                 case Command::CopyTextureToBuffer: {
@@ -445,6 +642,7 @@ namespace backend {
                                                    copy->destination) ||
                         !mState->ValidateCanCopy() ||
                         !mState->ValidateCanUseTextureAs(copy->source.texture.Get(),
+                                                         copy->source.level,
                                                          nxt::TextureUsageBit::TransferSrc) ||
                         !mState->ValidateCanUseBufferAs(copy->destination.buffer.Get(),
                                                         nxt::BufferUsageBit::TransferDst)) {
@@ -494,6 +692,34 @@ namespace backend {
                     }
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mIterator.NextCommand<GenerateMipmapsCmd>();
+                    if (!ValidateMipmapGeneration(this, cmd) ||
+                        !mState->ValidateCanGenerateMipmaps(cmd->texture.Get(), cmd->baseLevel,
+                                                            cmd->levelCount)) {
+                        return false;
+                    }
+                } break;
+
+                // The draws of a multi-draw all use the same state so it is only validated once.
+                case Command::MultiDrawArrays: {
+                    MultiDrawArraysCmd* cmd = mIterator.NextCommand<MultiDrawArraysCmd>();
+                    mIterator.NextData<uint32_t>(cmd->drawCount);
+                    mIterator.NextData<uint32_t>(cmd->drawCount);
+                    if (!mState->ValidateCanDrawArrays()) {
+                        return false;
+                    }
+                } break;
+
+                case Command::MultiDrawElements: {
+                    MultiDrawElementsCmd* cmd = mIterator.NextCommand<MultiDrawElementsCmd>();
+                    mIterator.NextData<uint32_t>(cmd->drawCount);
+                    mIterator.NextData<uint32_t>(cmd->drawCount);
+                    if (!mState->ValidateCanDrawElements()) {
+                        return false;
+                    }
+                } break;
+
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mIterator.NextCommand<SetComputePipelineCmd>();
                     ComputePipelineBase* pipeline = cmd->pipeline.Get();
@@ -537,6 +763,22 @@ namespace backend {
                     }
                 } break;
 
+                case Command::SetViewport: {
+                    SetViewportCmd* cmd = mIterator.NextCommand<SetViewportCmd>();
+                    if (!mState->ValidateSetViewport(cmd->x, cmd->y, cmd->width, cmd->height,
+                                                     cmd->minDepth, cmd->maxDepth)) {
+                        return false;
+                    }
+                } break;
+
+                case Command::SetScissorRect: {
+                    SetScissorRectCmd* cmd = mIterator.NextCommand<SetScissorRectCmd>();
+                    if (!mState->ValidateSetScissorRect(cmd->x, cmd->y, cmd->width,
+                                                        cmd->height)) {
+                        return false;
+                    }
+                } break;
+
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mIterator.NextCommand<SetBindGroupCmd>();
                     if (!mState->SetBindGroup(cmd->index, cmd->group.Get())) {
@@ -572,7 +814,9 @@ namespace backend {
                 case Command::TransitionTextureUsage: {
                     TransitionTextureUsageCmd* cmd =
                         mIterator.NextCommand<TransitionTextureUsageCmd>();
-                    if (!mState->TransitionTextureUsage(cmd->texture.Get(), cmd->usage)) {
+                    if (!ValidateTransitionLevels(this, cmd) ||
+                        !mState->TransitionTextureUsage(cmd->texture.Get(), cmd->baseLevel,
+                                                        cmd->levelCount, cmd->usage)) {
                         return false;
                     }
 
@@ -733,6 +977,62 @@ namespace backend {
         mAllocator.Allocate<EndRenderSubpassCmd>(Command::EndRenderSubpass);
     }
 
+    void CommandBufferBuilder::GenerateMipmaps(TextureBase* texture,
+                                               uint32_t baseLevel,
+                                               uint32_t levelCount) {
+        GenerateMipmapsCmd* cmd = mAllocator.Allocate<GenerateMipmapsCmd>(Command::GenerateMipmaps);
+        new (cmd) GenerateMipmapsCmd;
+        cmd->texture = texture;
+        cmd->baseLevel = baseLevel;
+        cmd->levelCount = levelCount;
+    }
+
+    void CommandBufferBuilder::MultiDrawArrays(uint32_t drawCount,
+                                               uint32_t const* vertexCounts,
+                                               uint32_t const* firstVertices,
+                                               uint32_t instanceCount,
+                                               uint32_t firstInstance) {
+        // The arrays are copied below so they must have an element per draw.
+        if (drawCount > 0 && (vertexCounts == nullptr || firstVertices == nullptr)) {
+            HandleError("MultiDrawArrays needs an array element per draw");
+            return;
+        }
+
+        MultiDrawArraysCmd* cmd = mAllocator.Allocate<MultiDrawArraysCmd>(Command::MultiDrawArrays);
+        new (cmd) MultiDrawArraysCmd;
+        cmd->drawCount = drawCount;
+        cmd->instanceCount = instanceCount;
+        cmd->firstInstance = firstInstance;
+
+        uint32_t* counts = mAllocator.AllocateData<uint32_t>(drawCount);
+        memcpy(counts, vertexCounts, drawCount * sizeof(uint32_t));
+        uint32_t* firsts = mAllocator.AllocateData<uint32_t>(drawCount);
+        memcpy(firsts, firstVertices, drawCount * sizeof(uint32_t));
+    }
+
+    void CommandBufferBuilder::MultiDrawElements(uint32_t drawCount,
+                                                 uint32_t const* indexCounts,
+                                                 uint32_t const* firstIndices,
+                                                 uint32_t instanceCount,
+                                                 uint32_t firstInstance) {
+        if (drawCount > 0 && (indexCounts == nullptr || firstIndices == nullptr)) {
+            HandleError("MultiDrawElements needs an array element per draw");
+            return;
+        }
+
+        MultiDrawElementsCmd* cmd =
+            mAllocator.Allocate<MultiDrawElementsCmd>(Command::MultiDrawElements);
+        new (cmd) MultiDrawElementsCmd;
+        cmd->drawCount = drawCount;
+        cmd->instanceCount = instanceCount;
+        cmd->firstInstance = firstInstance;
+
+        uint32_t* counts = mAllocator.AllocateData<uint32_t>(drawCount);
+        memcpy(counts, indexCounts, drawCount * sizeof(uint32_t));
+        uint32_t* firsts = mAllocator.AllocateData<uint32_t>(drawCount);
+        memcpy(firsts, firstIndices, drawCount * sizeof(uint32_t));
+    }
+
     void CommandBufferBuilder::SetComputePipeline(ComputePipelineBase* pipeline) {
         SetComputePipelineCmd* cmd =
             mAllocator.Allocate<SetComputePipelineCmd>(Command::SetComputePipeline);
@@ -784,6 +1084,34 @@ namespace backend {
         cmd->a = a;
     }
 
+    void CommandBufferBuilder::SetViewport(float x,
+                                           float y,
+                                           float width,
+                                           float height,
+                                           float minDepth,
+                                           float maxDepth) {
+        SetViewportCmd* cmd = mAllocator.Allocate<SetViewportCmd>(Command::SetViewport);
+        new (cmd) SetViewportCmd;
+        cmd->x = x;
+        cmd->y = y;
+        cmd->width = width;
+        cmd->height = height;
+        cmd->minDepth = minDepth;
+        cmd->maxDepth = maxDepth;
+    }
+
+    void CommandBufferBuilder::SetScissorRect(uint32_t x,
+                                              uint32_t y,
+                                              uint32_t width,
+                                              uint32_t height) {
+        SetScissorRectCmd* cmd = mAllocator.Allocate<SetScissorRectCmd>(Command::SetScissorRect);
+        new (cmd) SetScissorRectCmd;
+        cmd->x = x;
+        cmd->y = y;
+        cmd->width = width;
+        cmd->height = height;
+    }
+
     void CommandBufferBuilder::SetBindGroup(uint32_t groupIndex, BindGroupBase* group) {
         if (groupIndex >= kMaxBindGroups) {
             HandleError("Setting bind group over the max");
@@ -841,6 +1169,21 @@ namespace backend {
             mAllocator.Allocate<TransitionTextureUsageCmd>(Command::TransitionTextureUsage);
         new (cmd) TransitionTextureUsageCmd;
         cmd->texture = texture;
+        cmd->baseLevel = 0;
+        cmd->levelCount = texture->GetNumMipLevels();
+        cmd->usage = usage;
+    }
+
+    void CommandBufferBuilder::TransitionTextureLevelsUsage(TextureBase* texture,
+                                                            uint32_t baseLevel,
+                                                            uint32_t levelCount,
+                                                            nxt::TextureUsageBit usage) {
+        TransitionTextureUsageCmd* cmd =
+            mAllocator.Allocate<TransitionTextureUsageCmd>(Command::TransitionTextureUsage);
+        new (cmd) TransitionTextureUsageCmd;
+        cmd->texture = texture;
+        cmd->baseLevel = baseLevel;
+        cmd->levelCount = levelCount;
         cmd->usage = usage;
     }
 
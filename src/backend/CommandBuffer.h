@@ -103,6 +103,17 @@ namespace backend {
         void EndComputePass();
         void EndRenderPass();
         void EndRenderSubpass();
+        void GenerateMipmaps(TextureBase* texture, uint32_t baseLevel, uint32_t levelCount);
+        void MultiDrawArrays(uint32_t drawCount,
+                             uint32_t const* vertexCounts,
+                             uint32_t const* firstVertices,
+                             uint32_t instanceCount,
+                             uint32_t firstInstance);
+        void MultiDrawElements(uint32_t drawCount,
+                               uint32_t const* indexCounts,
+                               uint32_t const* firstIndices,
+                               uint32_t instanceCount,
+                               uint32_t firstInstance);
         void SetPushConstants(nxt::ShaderStageBit stages,
                               uint32_t offset,
                               uint32_t count,
@@ -111,6 +122,13 @@ namespace backend {
         void SetRenderPipeline(RenderPipelineBase* pipeline);
         void SetStencilReference(uint32_t reference);
         void SetBlendColor(float r, float g, float b, float a);
+        void SetViewport(float x,
+                         float y,
+                         float width,
+                         float height,
+                         float minDepth,
+                         float maxDepth);
+        void SetScissorRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
         void SetBindGroup(uint32_t groupIndex, BindGroupBase* group);
         void SetIndexBuffer(BufferBase* buffer, uint32_t offset);
 
@@ -130,6 +148,10 @@ namespace backend {
 
         void TransitionBufferUsage(BufferBase* buffer, nxt::BufferUsageBit usage);
         void TransitionTextureUsage(TextureBase* texture, nxt::TextureUsageBit usage);
+        void TransitionTextureLevelsUsage(TextureBase* texture,
+                                          uint32_t baseLevel,
+                                          uint32_t levelCount,
+                                          nxt::TextureUsageBit usage);
 
       private:
         friend class CommandBufferBase;
@@ -28,6 +28,8 @@
 #include "common/Assert.h"
 #include "common/BitSetIterator.h"
 
+#include <algorithm>
+
 namespace backend {
     CommandBufferStateTracker::CommandBufferStateTracker(CommandBufferBuilder* mBuilder)
         : mBuilder(mBuilder) {
@@ -59,11 +61,16 @@ namespace backend {
     }
 
     bool CommandBufferStateTracker::ValidateCanUseTextureAs(TextureBase* texture,
+                                                            uint32_t level,
                                                             nxt::TextureUsageBit usage) const {
-        if (!TextureHasGuaranteedUsageBit(texture, usage)) {
+        if (!TextureLevelsHaveGuaranteedUsageBit(texture, level, 1, usage)) {
             mBuilder->HandleError("Texture is not in the necessary usage");
             return false;
         }
+        if (usage == nxt::TextureUsageBit::TransferSrc &&
+            !ValidateTextureContentsNotDiscarded(texture, TextureAspects().set())) {
+            return false;
+        }
         return true;
     }
 
@@ -88,6 +95,31 @@ namespace backend {
         return true;
     }
 
+    bool CommandBufferStateTracker::ValidateCanGenerateMipmaps(TextureBase* texture,
+                                                               uint32_t baseLevel,
+                                                               uint32_t levelCount) const {
+        if (mCurrentRenderPass) {
+            mBuilder->HandleError("Mipmap generation cannot occur during a render pass");
+            return false;
+        }
+        // Lower levels are written while the level above them is read, so the levels are kept in
+        // the TransferDst usage but the texture must also be allowed to be used as TransferSrc.
+        // Levels outside of the range can be in any usage.
+        if (!(texture->GetAllowedUsage() & nxt::TextureUsageBit::TransferSrc)) {
+            mBuilder->HandleError("Mipmap generation requires the TransferSrc allowed usage");
+            return false;
+        }
+        if (!ValidateTextureContentsNotDiscarded(texture, TextureAspects().set())) {
+            return false;
+        }
+        if (!TextureLevelsHaveGuaranteedUsageBit(texture, baseLevel, levelCount,
+                                                 nxt::TextureUsageBit::TransferDst)) {
+            mBuilder->HandleError("Texture is not in the necessary usage");
+            return false;
+        }
+        return true;
+    }
+
     bool CommandBufferStateTracker::ValidateCanDrawArrays() {
         // TODO(kainino@chromium.org): Check for a current render pass
         constexpr ValidationAspects requiredAspects =
@@ -151,6 +183,56 @@ namespace backend {
         return true;
     }
 
+    bool CommandBufferStateTracker::ValidateSetViewport(float x,
+                                                        float y,
+                                                        float width,
+                                                        float height,
+                                                        float minDepth,
+                                                        float maxDepth) const {
+        if (!mAspects[VALIDATION_ASPECT_RENDER_SUBPASS]) {
+            mBuilder->HandleError("Can't set the viewport without an active render subpass");
+            return false;
+        }
+
+        // The comparisons are written so that NaNs fail them.
+        float framebufferWidth = static_cast<float>(mCurrentFramebuffer->GetWidth());
+        float framebufferHeight = static_cast<float>(mCurrentFramebuffer->GetHeight());
+        if (!(width > 0.0f && height > 0.0f)) {
+            mBuilder->HandleError("Viewport must not be empty");
+            return false;
+        }
+        if (!(x >= 0.0f && y >= 0.0f && x + width <= framebufferWidth &&
+              y + height <= framebufferHeight)) {
+            mBuilder->HandleError("Viewport must be contained in the framebuffer");
+            return false;
+        }
+        if (!(minDepth >= 0.0f && minDepth <= 1.0f && maxDepth >= 0.0f && maxDepth <= 1.0f)) {
+            mBuilder->HandleError("Viewport depth range must be in [0, 1]");
+            return false;
+        }
+        return true;
+    }
+
+    bool CommandBufferStateTracker::ValidateSetScissorRect(uint32_t x,
+                                                           uint32_t y,
+                                                           uint32_t width,
+                                                           uint32_t height) const {
+        if (!mAspects[VALIDATION_ASPECT_RENDER_SUBPASS]) {
+            mBuilder->HandleError("Can't set the scissor rect without an active render subpass");
+            return false;
+        }
+
+        // Written to avoid overflows of x + width and y + height.
+        uint32_t framebufferWidth = mCurrentFramebuffer->GetWidth();
+        uint32_t framebufferHeight = mCurrentFramebuffer->GetHeight();
+        if (width > framebufferWidth || x > framebufferWidth - width ||
+            height > framebufferHeight || y > framebufferHeight - height) {
+            mBuilder->HandleError("Scissor rect must be contained in the framebuffer");
+            return false;
+        }
+        return true;
+    }
+
     bool CommandBufferStateTracker::BeginComputePass() {
         if (mCurrentRenderPass != nullptr) {
             mBuilder->HandleError("Cannot begin a compute pass while a render pass is active");
@@ -195,6 +277,15 @@ namespace backend {
             }
             mTexturesAttached.insert(texture);
         }
+        for (auto location : IterateBitSet(subpassInfo.resolveAttachmentsSet)) {
+            auto attachmentSlot = subpassInfo.resolveAttachments[location];
+            auto* texture = mCurrentFramebuffer->GetTextureView(attachmentSlot)->GetTexture();
+            if (!EnsureTextureUsage(texture, nxt::TextureUsageBit::OutputAttachment)) {
+                mBuilder->HandleError("Unable to ensure texture has OutputAttachment usage");
+                return false;
+            }
+            mTexturesAttached.insert(texture);
+        }
 
         mAspects.set(VALIDATION_ASPECT_RENDER_SUBPASS);
         return true;
@@ -242,6 +333,30 @@ namespace backend {
             return false;
         }
 
+        // Attachments that are loaded must not have had their contents discarded.
+        for (uint32_t i = 0; i < renderPass->GetAttachmentCount(); ++i) {
+            const auto& attachmentInfo = renderPass->GetAttachmentInfo(i);
+            if (attachmentInfo.firstSubpass == UINT32_MAX) {
+                continue;
+            }
+
+            TextureAspects loadedAspects;
+            if (TextureFormatHasDepthOrStencil(attachmentInfo.format)) {
+                loadedAspects.set(TEXTURE_ASPECT_COLOR_OR_DEPTH,
+                                  attachmentInfo.depthLoadOp == nxt::LoadOp::Load);
+                loadedAspects.set(TEXTURE_ASPECT_STENCIL,
+                                  attachmentInfo.stencilLoadOp == nxt::LoadOp::Load);
+            } else {
+                loadedAspects.set(TEXTURE_ASPECT_COLOR_OR_DEPTH,
+                                  attachmentInfo.colorLoadOp == nxt::LoadOp::Load);
+            }
+
+            TextureBase* texture = framebuffer->GetTextureView(i)->GetTexture();
+            if (!ValidateTextureContentsNotDiscarded(texture, loadedAspects)) {
+                return false;
+            }
+        }
+
         mCurrentRenderPass = renderPass;
         mCurrentFramebuffer = framebuffer;
         mCurrentSubpass = 0;
@@ -262,6 +377,37 @@ namespace backend {
             mBuilder->HandleError("Can't end a render pass before the last subpass");
             return false;
         }
+
+        // All the attachments were either loaded or cleared, so the only contents that are
+        // undefined after the render pass are the ones it discards.
+        for (uint32_t i = 0; i < mCurrentRenderPass->GetAttachmentCount(); ++i) {
+            const auto& attachmentInfo = mCurrentRenderPass->GetAttachmentInfo(i);
+            if (attachmentInfo.firstSubpass == UINT32_MAX) {
+                continue;
+            }
+
+            nxt::TextureFormat format = attachmentInfo.format;
+            TextureAspects discardedAspects;
+            if (TextureFormatHasDepthOrStencil(format)) {
+                discardedAspects.set(TEXTURE_ASPECT_COLOR_OR_DEPTH,
+                                     TextureFormatHasDepth(format) &&
+                                         attachmentInfo.depthStoreOp == nxt::StoreOp::Discard);
+                discardedAspects.set(TEXTURE_ASPECT_STENCIL,
+                                     TextureFormatHasStencil(format) &&
+                                         attachmentInfo.stencilStoreOp == nxt::StoreOp::Discard);
+            } else {
+                discardedAspects.set(TEXTURE_ASPECT_COLOR_OR_DEPTH,
+                                     attachmentInfo.colorStoreOp == nxt::StoreOp::Discard);
+            }
+
+            TextureBase* texture = mCurrentFramebuffer->GetTextureView(i)->GetTexture();
+            if (discardedAspects.any()) {
+                mDiscardedTextureAspects[texture] = discardedAspects;
+            } else {
+                mDiscardedTextureAspects.erase(texture);
+            }
+        }
+
         mCurrentRenderPass = nullptr;
         mCurrentFramebuffer = nullptr;
 
@@ -360,6 +506,8 @@ namespace backend {
     }
 
     bool CommandBufferStateTracker::TransitionTextureUsage(TextureBase* texture,
+                                                           uint32_t baseLevel,
+                                                           uint32_t levelCount,
                                                            nxt::TextureUsageBit usage) {
         if (!IsExplicitTextureTransitionPossible(texture, usage)) {
             if (texture->IsFrozen()) {
@@ -376,7 +524,9 @@ namespace backend {
             return false;
         }
 
-        mMostRecentTextureUsages[texture] = usage;
+        auto& levelUsages = mMostRecentTextureUsages[texture];
+        levelUsages.resize(texture->GetNumMipLevels(), nxt::TextureUsageBit::None);
+        std::fill_n(levelUsages.begin() + baseLevel, levelCount, usage);
         mTexturesTransitioned.insert(texture);
         return true;
     }
@@ -389,11 +539,15 @@ namespace backend {
         if (!IsInternalTextureTransitionPossible(texture, usage)) {
             return false;
         }
-        mMostRecentTextureUsages[texture] = usage;
+        mMostRecentTextureUsages[texture].assign(texture->GetNumMipLevels(), usage);
         mTexturesTransitioned.insert(texture);
         return true;
     }
 
+    void CommandBufferStateTracker::SetTextureContentsWritten(TextureBase* texture) {
+        mDiscardedTextureAspects.erase(texture);
+    }
+
     bool CommandBufferStateTracker::BufferHasGuaranteedUsageBit(BufferBase* buffer,
                                                                 nxt::BufferUsageBit usage) const {
         ASSERT(usage != nxt::BufferUsageBit::None && nxt::HasZeroOrOneBits(usage));
@@ -406,12 +560,28 @@ namespace backend {
 
     bool CommandBufferStateTracker::TextureHasGuaranteedUsageBit(TextureBase* texture,
                                                                  nxt::TextureUsageBit usage) const {
+        return TextureLevelsHaveGuaranteedUsageBit(texture, 0, texture->GetNumMipLevels(), usage);
+    }
+
+    bool CommandBufferStateTracker::TextureLevelsHaveGuaranteedUsageBit(
+        TextureBase* texture,
+        uint32_t baseLevel,
+        uint32_t levelCount,
+        nxt::TextureUsageBit usage) const {
         ASSERT(usage != nxt::TextureUsageBit::None && nxt::HasZeroOrOneBits(usage));
         if (texture->HasFrozenUsage(usage)) {
             return true;
         }
         auto it = mMostRecentTextureUsages.find(texture);
-        return it != mMostRecentTextureUsages.end() && (it->second & usage);
+        if (it == mMostRecentTextureUsages.end()) {
+            return false;
+        }
+        for (uint32_t level = baseLevel; level < baseLevel + levelCount; ++level) {
+            if (!(it->second[level] & usage)) {
+                return false;
+            }
+        }
+        return true;
     }
 
     bool CommandBufferStateTracker::IsInternalTextureTransitionPossible(
@@ -434,6 +604,17 @@ namespace backend {
         return IsInternalTextureTransitionPossible(texture, usage);
     }
 
+    bool CommandBufferStateTracker::ValidateTextureContentsNotDiscarded(
+        TextureBase* texture,
+        TextureAspects aspects) const {
+        auto it = mDiscardedTextureAspects.find(texture);
+        if (it != mDiscardedTextureAspects.end() && (it->second & aspects).any()) {
+            mBuilder->HandleError("Texture contents were discarded by a render pass store op");
+            return false;
+        }
+        return true;
+    }
+
     bool CommandBufferStateTracker::RecomputeHaveAspectBindGroups() {
         if (mAspects[VALIDATION_ASPECT_BIND_GROUPS]) {
             return true;
@@ -512,6 +693,9 @@ namespace backend {
                         mBuilder->HandleError("Can't guarantee texture usage needed by bind group");
                         return false;
                     }
+                    if (!ValidateTextureContentsNotDiscarded(texture, TextureAspects().set())) {
+                        return false;
+                    }
                 } break;
                 case nxt::BindingType::Sampler:
                     continue;
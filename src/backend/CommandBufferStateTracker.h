@@ -22,6 +22,7 @@
 #include <bitset>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace backend {
     class CommandBufferStateTracker {
@@ -33,12 +34,24 @@ namespace backend {
         bool HaveRenderSubpass() const;
         bool ValidateCanCopy() const;
         bool ValidateCanUseBufferAs(BufferBase* buffer, nxt::BufferUsageBit usage) const;
-        bool ValidateCanUseTextureAs(TextureBase* texture, nxt::TextureUsageBit usage) const;
+        bool ValidateCanUseTextureAs(TextureBase* texture,
+                                     uint32_t level,
+                                     nxt::TextureUsageBit usage) const;
         bool ValidateCanDispatch();
+        bool ValidateCanGenerateMipmaps(TextureBase* texture,
+                                        uint32_t baseLevel,
+                                        uint32_t levelCount) const;
         bool ValidateCanDrawArrays();
         bool ValidateCanDrawElements();
         bool ValidateEndCommandBuffer() const;
         bool ValidateSetPushConstants(nxt::ShaderStageBit stages);
+        bool ValidateSetViewport(float x,
+                                 float y,
+                                 float width,
+                                 float height,
+                                 float minDepth,
+                                 float maxDepth) const;
+        bool ValidateSetScissorRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const;
 
         // State-modifying methods
         bool BeginComputePass();
@@ -53,8 +66,12 @@ namespace backend {
         bool SetIndexBuffer(BufferBase* buffer);
         bool SetVertexBuffer(uint32_t index, BufferBase* buffer);
         bool TransitionBufferUsage(BufferBase* buffer, nxt::BufferUsageBit usage);
-        bool TransitionTextureUsage(TextureBase* texture, nxt::TextureUsageBit usage);
+        bool TransitionTextureUsage(TextureBase* texture,
+                                    uint32_t baseLevel,
+                                    uint32_t levelCount,
+                                    nxt::TextureUsageBit usage);
         bool EnsureTextureUsage(TextureBase* texture, nxt::TextureUsageBit usage);
+        void SetTextureContentsWritten(TextureBase* texture);
 
         // These collections are copied to the CommandBuffer at build time. These pointers will
         // remain valid since they are referenced by the bind groups which are referenced by this
@@ -77,13 +94,28 @@ namespace backend {
         };
         using ValidationAspects = std::bitset<VALIDATION_ASPECT_COUNT>;
 
+        // The parts of a texture's contents that render pass store ops can discard separately.
+        enum TextureAspect {
+            TEXTURE_ASPECT_COLOR_OR_DEPTH,
+            TEXTURE_ASPECT_STENCIL,
+
+            TEXTURE_ASPECT_COUNT
+        };
+        using TextureAspects = std::bitset<TEXTURE_ASPECT_COUNT>;
+
         // Usage helper functions
         bool BufferHasGuaranteedUsageBit(BufferBase* buffer, nxt::BufferUsageBit usage) const;
         bool TextureHasGuaranteedUsageBit(TextureBase* texture, nxt::TextureUsageBit usage) const;
+        bool TextureLevelsHaveGuaranteedUsageBit(TextureBase* texture,
+                                                 uint32_t baseLevel,
+                                                 uint32_t levelCount,
+                                                 nxt::TextureUsageBit usage) const;
         bool IsInternalTextureTransitionPossible(TextureBase* texture,
                                                  nxt::TextureUsageBit usage) const;
         bool IsExplicitTextureTransitionPossible(TextureBase* texture,
                                                  nxt::TextureUsageBit usage) const;
+        bool ValidateTextureContentsNotDiscarded(TextureBase* texture,
+                                                 TextureAspects aspects) const;
 
         // Queries for lazily evaluated aspects
         bool RecomputeHaveAspectBindGroups();
@@ -106,8 +138,14 @@ namespace backend {
         PipelineBase* mLastPipeline = nullptr;
         RenderPipelineBase* mLastRenderPipeline = nullptr;
 
+        // Buffers are tracked as a whole, unlike textures. Tracking ranges would also require
+        // validating the ranges used by vertex, index and bind group buffers.
         std::map<BufferBase*, nxt::BufferUsageBit> mMostRecentBufferUsages;
-        std::map<TextureBase*, nxt::TextureUsageBit> mMostRecentTextureUsages;
+        // The usage of each mip level, None for levels not transitioned in this command buffer.
+        std::map<TextureBase*, std::vector<nxt::TextureUsageBit>> mMostRecentTextureUsages;
+        // Textures whose contents were discarded by a render pass earlier in the command buffer
+        // and haven't been written since.
+        std::map<TextureBase*, TextureAspects> mDiscardedTextureAspects;
 
         RenderPassBase* mCurrentRenderPass = nullptr;
         FramebufferBase* mCurrentFramebuffer = nullptr;
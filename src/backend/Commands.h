@@ -21,6 +21,8 @@
 
 #include "nxt/nxtcpp.h"
 
+#include <vector>
+
 namespace backend {
 
     // Definition of the commands that are present in the CommandIterator given by the
@@ -40,11 +42,16 @@ namespace backend {
         EndComputePass,
         EndRenderPass,
         EndRenderSubpass,
+        GenerateMipmaps,
+        MultiDrawArrays,
+        MultiDrawElements,
         SetComputePipeline,
         SetRenderPipeline,
         SetPushConstants,
         SetStencilReference,
         SetBlendColor,
+        SetViewport,
+        SetScissorRect,
         SetBindGroup,
         SetIndexBuffer,
         SetVertexBuffers,
@@ -117,6 +124,28 @@ namespace backend {
 
     struct EndRenderSubpassCmd {};
 
+    struct GenerateMipmapsCmd {
+        Ref<TextureBase> texture;
+        uint32_t baseLevel;
+        uint32_t levelCount;
+    };
+
+    // Followed by the vertex counts and then the first vertices of the draws, both arrays of
+    // drawCount uint32_t.
+    struct MultiDrawArraysCmd {
+        uint32_t drawCount;
+        uint32_t instanceCount;
+        uint32_t firstInstance;
+    };
+
+    // Followed by the index counts and then the first indices of the draws, both arrays of
+    // drawCount uint32_t.
+    struct MultiDrawElementsCmd {
+        uint32_t drawCount;
+        uint32_t instanceCount;
+        uint32_t firstInstance;
+    };
+
     struct SetComputePipelineCmd {
         Ref<ComputePipelineBase> pipeline;
     };
@@ -139,6 +168,15 @@ namespace backend {
         float r, g, b, a;
     };
 
+    struct SetViewportCmd {
+        float x, y, width, height;
+        float minDepth, maxDepth;
+    };
+
+    struct SetScissorRectCmd {
+        uint32_t x, y, width, height;
+    };
+
     struct SetBindGroupCmd {
         uint32_t index;
         Ref<BindGroupBase> group;
@@ -161,7 +199,7 @@ namespace backend {
 
     struct TransitionTextureUsageCmd {
         Ref<TextureBase> texture;
-        uint32_t startLevel;
+        uint32_t baseLevel;
         uint32_t levelCount;
         nxt::TextureUsageBit usage;
     };
@@ -172,6 +210,32 @@ namespace backend {
     void FreeCommands(CommandIterator* commands);
     void SkipCommand(CommandIterator* commands, Command type);
 
+    // Consecutive CopyBufferToBuffer commands between the same two buffers gathered so that
+    // backends can record them with a single multi-region copy instead of one call per command.
+    struct BufferCopyRegion {
+        uint32_t sourceOffset;
+        uint32_t destinationOffset;
+        uint32_t size;
+    };
+
+    struct BufferCopyBatch {
+        BufferBase* source = nullptr;
+        BufferBase* destination = nullptr;
+        uint32_t commandCount = 0;
+
+        // The regions never overlap in the destination buffer so they can be copied in any order.
+        // Copies of contiguous ranges are merged in a single region and empty copies are dropped.
+        std::vector<BufferCopyRegion> regions;
+        uint32_t destinationStart = 0;
+        uint32_t destinationEnd = 0;
+    };
+
+    // Gathers `first`, the CopyBufferToBuffer command that was just read from `commands`, and
+    // the CopyBufferToBuffer commands directly following it that can be batched with it.
+    void GatherBufferCopies(CommandIterator* commands,
+                            CopyBufferToBufferCmd* first,
+                            BufferCopyBatch* batch);
+
 }  // namespace backend
 
 #endif  // BACKEND_COMMANDS_H_
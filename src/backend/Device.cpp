@@ -43,14 +43,17 @@ namespace backend {
     using BindGroupLayoutCache = std::
         unordered_set<BindGroupLayoutBase*, BindGroupLayoutCacheFuncs, BindGroupLayoutCacheFuncs>;
 
+    using BindGroupCache =
+        std::unordered_set<BindGroupBase*, BindGroupCacheFuncs, BindGroupCacheFuncs>;
+
     struct DeviceBase::Caches {
         BindGroupLayoutCache bindGroupLayouts;
+        BindGroupCache bindGroups;
     };
 
     // DeviceBase
 
     DeviceBase::DeviceBase() {
-        mCaches = new DeviceBase::Caches();
     }
 
     DeviceBase::~DeviceBase() {
@@ -73,6 +76,27 @@ namespace backend {
         return this;
     }
 
+    bool DeviceBase::IsTextureFormatSupported(nxt::TextureFormat format) const {
+        return !TextureFormatIsCompressed(format);
+    }
+
+    bool DeviceBase::IsMipmapGenerationSupported() const {
+        return true;
+    }
+
+    bool DeviceBase::IsPartialTextureViewSupported() const {
+        return true;
+    }
+
+    const BackendCallCounters& DeviceBase::GetBackendCallCounters() const {
+        return mBackendCallCounters;
+    }
+
+    void DeviceBase::CountBufferCopies(uint32_t commandCount, uint32_t callCount) {
+        mBackendCallCounters.bufferCopyCommands += commandCount;
+        mBackendCallCounters.bufferCopyCalls += callCount;
+    }
+
     BindGroupLayoutBase* DeviceBase::GetOrCreateBindGroupLayout(
         const BindGroupLayoutBase* blueprint,
         BindGroupLayoutBuilder* builder) {
@@ -80,18 +104,46 @@ namespace backend {
         // objects can be modified, and unordered_set cannot search for a const pointer in a non
         // const pointer set. That's why we do a const_cast here, but the blueprint won't be
         // modified.
-        auto iter = mCaches->bindGroupLayouts.find(const_cast<BindGroupLayoutBase*>(blueprint));
-        if (iter != mCaches->bindGroupLayouts.end()) {
+        Caches* caches = GetCaches();
+        auto iter = caches->bindGroupLayouts.find(const_cast<BindGroupLayoutBase*>(blueprint));
+        if (iter != caches->bindGroupLayouts.end()) {
             return *iter;
         }
 
         BindGroupLayoutBase* backendObj = CreateBindGroupLayout(builder);
-        mCaches->bindGroupLayouts.insert(backendObj);
+        caches->bindGroupLayouts.insert(backendObj);
         return backendObj;
     }
 
     void DeviceBase::UncacheBindGroupLayout(BindGroupLayoutBase* obj) {
-        mCaches->bindGroupLayouts.erase(obj);
+        GetCaches()->bindGroupLayouts.erase(obj);
+    }
+
+    BindGroupBase* DeviceBase::GetOrCreateBindGroup(const BindGroupBase* blueprint,
+                                                    BindGroupBuilder* builder) {
+        // See GetOrCreateBindGroupLayout for why the const_cast is needed.
+        Caches* caches = GetCaches();
+        auto iter = caches->bindGroups.find(const_cast<BindGroupBase*>(blueprint));
+        if (iter != caches->bindGroups.end()) {
+            (*iter)->Reference();
+            return *iter;
+        }
+
+        BindGroupBase* backendObj = CreateBindGroup(builder);
+        caches->bindGroups.insert(backendObj);
+        return backendObj;
+    }
+
+    void DeviceBase::UncacheBindGroup(BindGroupBase* obj) {
+        GetCaches()->bindGroups.erase(obj);
+    }
+
+    DeviceBase::Caches* DeviceBase::GetCaches() {
+        // Created on first use so that devices that never cache objects don't pay for it.
+        if (mCaches == nullptr) {
+            mCaches = new DeviceBase::Caches();
+        }
+        return mCaches;
     }
 
     BindGroupBuilder* DeviceBase::CreateBindGroupBuilder() {
@@ -24,6 +24,14 @@ namespace backend {
 
     using ErrorCallback = void (*)(const char* errorMessage, void* userData);
 
+    // Counts how many calls to the backing API are made to execute NXT commands, to measure the
+    // effect of batching commands together.
+    struct BackendCallCounters {
+        // CopyBufferToBuffer commands executed and the copy calls recorded for them.
+        uint64_t bufferCopyCommands = 0;
+        uint64_t bufferCopyCalls = 0;
+    };
+
     class DeviceBase {
       public:
         DeviceBase();
@@ -57,6 +65,17 @@ namespace backend {
 
         virtual void TickImpl() = 0;
 
+        // Compressed texture formats are optional in the backing APIs, other formats are always
+        // supported.
+        virtual bool IsTextureFormatSupported(nxt::TextureFormat format) const;
+        // Backends without a way to generate mipmaps reject the GenerateMipmaps command.
+        virtual bool IsMipmapGenerationSupported() const;
+        // Whether texture views can select part of the layers or another dimension of a texture.
+        virtual bool IsPartialTextureViewSupported() const;
+
+        const BackendCallCounters& GetBackendCallCounters() const;
+        void CountBufferCopies(uint32_t commandCount, uint32_t callCount);
+
         // Many NXT objects are completely immutable once created which means that if two
         // builders are given the same arguments, they can return the same object. Reusing
         // objects will help make comparisons between objects by a single pointer comparison.
@@ -75,6 +94,13 @@ namespace backend {
                                                         BindGroupLayoutBuilder* builder);
         void UncacheBindGroupLayout(BindGroupLayoutBase* obj);
 
+        // Frozen bind groups are cached the same way. Bind groups are created often, sometimes
+        // for each draw, so unlike bind group layouts the returned object already has the
+        // external reference for the builder's result.
+        BindGroupBase* GetOrCreateBindGroup(const BindGroupBase* blueprint,
+                                            BindGroupBuilder* builder);
+        void UncacheBindGroup(BindGroupBase* obj);
+
         // NXT API
         BindGroupBuilder* CreateBindGroupBuilder();
         BindGroupLayoutBuilder* CreateBindGroupLayoutBuilder();
@@ -103,8 +129,11 @@ namespace backend {
         // The object caches aren't exposed in the header as they would require a lot of
         // additional includes.
         struct Caches;
+        Caches* GetCaches();
         Caches* mCaches = nullptr;
 
+        BackendCallCounters mBackendCallCounters;
+
         nxt::DeviceErrorCallback mErrorCallback = nullptr;
         nxt::CallbackUserdata mErrorUserdata = 0;
         uint32_t mRefCount = 1;
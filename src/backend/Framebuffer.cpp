@@ -19,6 +19,7 @@
 #include "backend/RenderPass.h"
 #include "backend/Texture.h"
 #include "common/Assert.h"
+#include "common/BitSetIterator.h"
 
 namespace backend {
 
@@ -128,6 +129,20 @@ namespace backend {
             }
         }
 
+        // Backends resolve into the first layer of the texture so resolve targets can't select
+        // other layers.
+        for (uint32_t subpass = 0; subpass < mRenderPass->GetSubpassCount(); ++subpass) {
+            const auto& subpassInfo = mRenderPass->GetSubpassInfo(subpass);
+            for (uint32_t location : IterateBitSet(subpassInfo.resolveAttachmentsSet)) {
+                const TextureViewBase* view =
+                    mTextureViews[subpassInfo.resolveAttachments[location]].Get();
+                if (view->GetBaseArrayLayer() != 0 || view->GetLayerCount() != 1) {
+                    HandleError("Resolve targets must be views of the first layer of a texture");
+                    return nullptr;
+                }
+            }
+        }
+
         return mDevice->CreateFramebuffer(this);
     }
 
@@ -177,7 +192,10 @@ namespace backend {
             HandleError("Texture format does not match attachment format");
             return;
         }
-        // TODO(kainino@chromium.org): also check attachment samples, etc.
+        if (attachmentInfo.sampleCount != texture->GetSampleCount()) {
+            HandleError("Texture sample count does not match attachment sample count");
+            return;
+        }
 
         mTextureViews[attachmentSlot] = textureView;
     }
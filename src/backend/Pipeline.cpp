@@ -34,8 +34,8 @@ namespace backend {
                           ->GetResult();
         }
 
-        auto FillPushConstants = [](const ShaderModuleBase* module, PushConstantInfo* info) {
-            const auto& moduleInfo = module->GetPushConstants();
+        auto FillPushConstants = [](const ShaderModuleBase::PushConstantInfo& moduleInfo,
+                                    PushConstantInfo* info) {
             info->mask = moduleInfo.mask;
 
             for (uint32_t i = 0; i < moduleInfo.names.size(); i++) {
@@ -52,12 +52,15 @@ namespace backend {
         };
 
         for (auto stageBit : IterateStages(builder->mStageMask)) {
-            if (!builder->mStages[stageBit].module->IsCompatibleWithPipelineLayout(mLayout.Get())) {
+            ShaderModuleBase* module = builder->mStages[stageBit].module.Get();
+            const std::string& entryPoint = builder->mStages[stageBit].entryPoint;
+            if (!module->IsCompatibleWithPipelineLayout(entryPoint, mLayout.Get())) {
                 builder->GetParentBuilder()->HandleError("Stage not compatible with layout");
                 return;
             }
 
-            FillPushConstants(builder->mStages[stageBit].module.Get(), &mPushConstants[stageBit]);
+            FillPushConstants(module->GetEntryPointInfo(entryPoint).pushConstants,
+                              &mPushConstants[stageBit]);
         }
     }
 
@@ -77,10 +80,12 @@ namespace backend {
     // PipelineBuilder
 
     PipelineBuilder::PipelineBuilder(BuilderBase* parentBuilder)
-        : mParentBuilder(parentBuilder), mStageMask(static_cast<nxt::ShaderStageBit>(0)) {
+        : mParentBuilder(parentBuilder),
+          mStageMask(static_cast<nxt::ShaderStageBit>(0)),
+          mSpecializedStageMask(static_cast<nxt::ShaderStageBit>(0)) {
     }
 
-    const PipelineBuilder::StageInfo& PipelineBuilder::GetStageInfo(nxt::ShaderStage stage) const {
+    PipelineBuilder::StageInfo& PipelineBuilder::GetStageInfo(nxt::ShaderStage stage) {
         ASSERT(mStageMask & StageBit(stage));
         return mStages[stage];
     }
@@ -96,13 +101,19 @@ namespace backend {
     void PipelineBuilder::SetStage(nxt::ShaderStage stage,
                                    ShaderModuleBase* module,
                                    const char* entryPoint) {
-        if (entryPoint != std::string("main")) {
-            mParentBuilder->HandleError("Currently the entry point has to be main()");
+        if (!module->HasEntryPoint(entryPoint)) {
+            mParentBuilder->HandleError("Entry point not found in the module");
             return;
         }
 
-        if (stage != module->GetExecutionModel()) {
-            mParentBuilder->HandleError("Setting module with wrong execution model");
+        const auto& entryPointInfo = module->GetEntryPointInfo(entryPoint);
+        if (!entryPointInfo.error.empty()) {
+            mParentBuilder->HandleError(entryPointInfo.error.c_str());
+            return;
+        }
+
+        if (stage != entryPointInfo.stage) {
+            mParentBuilder->HandleError("Setting entry point with wrong execution model");
             return;
         }
 
@@ -117,4 +128,35 @@ namespace backend {
         mStages[stage].entryPoint = entryPoint;
     }
 
+    void PipelineBuilder::SetStageSpecialization(nxt::ShaderStage stage,
+                                                 uint32_t count,
+                                                 const uint32_t* constantIds,
+                                                 const uint32_t* values) {
+        nxt::ShaderStageBit bit = StageBit(stage);
+        if (!(mStageMask & bit)) {
+            mParentBuilder->HandleError("Setting specialization of a stage that isn't set");
+            return;
+        }
+        if (mSpecializedStageMask & bit) {
+            mParentBuilder->HandleError("Setting already set stage specialization");
+            return;
+        }
+
+        const auto& moduleConstants = mStages[stage].module->GetSpecializationConstants();
+        SpecializationValues specialization;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (moduleConstants.count(constantIds[i]) == 0) {
+                mParentBuilder->HandleError("Specialization constant not in the shader module");
+                return;
+            }
+            if (!specialization.emplace(constantIds[i], values[i]).second) {
+                mParentBuilder->HandleError("Specialization constant set twice");
+                return;
+            }
+        }
+        mSpecializedStageMask |= bit;
+
+        mStages[stage].specialization = std::move(specialization);
+    }
+
 }  // namespace backend
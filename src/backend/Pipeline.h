@@ -63,13 +63,19 @@ namespace backend {
         struct StageInfo {
             std::string entryPoint;
             Ref<ShaderModuleBase> module;
+            SpecializationValues specialization;
         };
-        const StageInfo& GetStageInfo(nxt::ShaderStage stage) const;
+        // The stage info isn't const because the modules compute their reflection lazily.
+        StageInfo& GetStageInfo(nxt::ShaderStage stage);
         BuilderBase* GetParentBuilder() const;
 
         // NXT API
         void SetLayout(PipelineLayoutBase* layout);
         void SetStage(nxt::ShaderStage stage, ShaderModuleBase* module, const char* entryPoint);
+        void SetStageSpecialization(nxt::ShaderStage stage,
+                                    uint32_t count,
+                                    const uint32_t* constantIds,
+                                    const uint32_t* values);
 
       private:
         friend class PipelineBase;
@@ -77,6 +83,7 @@ namespace backend {
         BuilderBase* mParentBuilder;
         Ref<PipelineLayoutBase> mLayout;
         nxt::ShaderStageBit mStageMask;
+        nxt::ShaderStageBit mSpecializedStageMask;
         PerStage<StageInfo> mStages;
     };
 
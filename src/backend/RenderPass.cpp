@@ -35,6 +35,15 @@ namespace backend {
                 if (firstSubpass == UINT32_MAX) {
                     firstSubpass = s;
                 }
+                mAttachments[attachmentSlot].lastSubpass = s;
+            }
+            for (auto location : IterateBitSet(subpass.resolveAttachmentsSet)) {
+                auto attachmentSlot = subpass.resolveAttachments[location];
+                auto& firstSubpass = mAttachments[attachmentSlot].firstSubpass;
+                if (firstSubpass == UINT32_MAX) {
+                    firstSubpass = s;
+                }
+                mAttachments[attachmentSlot].lastSubpass = s;
             }
             if (subpass.depthStencilAttachmentSet) {
                 auto attachmentSlot = subpass.depthStencilAttachment;
@@ -42,6 +51,7 @@ namespace backend {
                 if (firstSubpass == UINT32_MAX) {
                     firstSubpass = s;
                 }
+                mAttachments[attachmentSlot].lastSubpass = s;
             }
         }
     }
@@ -96,13 +106,28 @@ namespace backend {
             }
         }
 
-        for (const auto& subpass : mSubpasses) {
+        for (auto& subpass : mSubpasses) {
+            // All the attachments rendered to in a subpass have the same sample count, a subpass
+            // without attachments is single-sampled.
+            uint32_t sampleCount = 0;
+            auto CheckSampleCount = [&sampleCount](uint32_t attachmentSampleCount) -> bool {
+                if (sampleCount != 0 && sampleCount != attachmentSampleCount) {
+                    return false;
+                }
+                sampleCount = attachmentSampleCount;
+                return true;
+            };
+
             for (unsigned int location : IterateBitSet(subpass.colorAttachmentsSet)) {
                 uint32_t slot = subpass.colorAttachments[location];
                 if (TextureFormatHasDepthOrStencil(mAttachments[slot].format)) {
                     HandleError("Render pass color attachment is not of a color format");
                     return nullptr;
                 }
+                if (!CheckSampleCount(mAttachments[slot].sampleCount)) {
+                    HandleError("Render pass subpass attachments have different sample counts");
+                    return nullptr;
+                }
             }
             if (subpass.depthStencilAttachmentSet) {
                 uint32_t slot = subpass.depthStencilAttachment;
@@ -111,6 +136,48 @@ namespace backend {
                         "Render pass depth/stencil attachment is not of a depth/stencil format");
                     return nullptr;
                 }
+                if (!CheckSampleCount(mAttachments[slot].sampleCount)) {
+                    HandleError("Render pass subpass attachments have different sample counts");
+                    return nullptr;
+                }
+            }
+            subpass.sampleCount = sampleCount == 0 ? 1 : sampleCount;
+
+            for (unsigned int location : IterateBitSet(subpass.resolveAttachmentsSet)) {
+                if (!subpass.colorAttachmentsSet[location]) {
+                    HandleError("Render pass resolve attachment set without a color attachment");
+                    return nullptr;
+                }
+
+                const auto& source = mAttachments[subpass.colorAttachments[location]];
+                uint32_t slot = subpass.resolveAttachments[location];
+                const auto& target = mAttachments[slot];
+                if (source.sampleCount == 1 || target.sampleCount != 1) {
+                    HandleError(
+                        "Render pass resolves must be from a multisampled attachment to a "
+                        "single-sampled attachment");
+                    return nullptr;
+                }
+                if (source.format != target.format) {
+                    HandleError("Render pass resolve attachment format doesn't match");
+                    return nullptr;
+                }
+                // Integer formats can't be averaged, the formats that can be resolved are the
+                // same as the ones that can be filtered.
+                if (!TextureFormatIsFilterable(target.format)) {
+                    HandleError("Render pass resolve attachment format can't be resolved");
+                    return nullptr;
+                }
+
+                bool usedInSubpass =
+                    subpass.depthStencilAttachmentSet && subpass.depthStencilAttachment == slot;
+                for (unsigned int colorLocation : IterateBitSet(subpass.colorAttachmentsSet)) {
+                    usedInSubpass |= subpass.colorAttachments[colorLocation] == slot;
+                }
+                if (usedInSubpass) {
+                    HandleError("Render pass resolve attachment is also used in the subpass");
+                    return nullptr;
+                }
             }
         }
 
@@ -147,6 +214,24 @@ namespace backend {
         mAttachmentProperties[attachmentSlot].set(ATTACHMENT_PROPERTY_FORMAT);
     }
 
+    void RenderPassBuilder::AttachmentSetSampleCount(uint32_t attachmentSlot,
+                                                     uint32_t sampleCount) {
+        if ((mPropertiesSet & RENDERPASS_PROPERTY_ATTACHMENT_COUNT) == 0) {
+            HandleError("Render pass attachment count not set yet");
+            return;
+        }
+        if (attachmentSlot >= mAttachments.size()) {
+            HandleError("Render pass attachment slot out of bounds");
+            return;
+        }
+        if (!IsValidSampleCount(sampleCount)) {
+            HandleError("Render pass attachment sample count is not supported");
+            return;
+        }
+
+        mAttachments[attachmentSlot].sampleCount = sampleCount;
+    }
+
     void RenderPassBuilder::AttachmentSetColorLoadOp(uint32_t attachmentSlot, nxt::LoadOp op) {
         if ((mPropertiesSet & RENDERPASS_PROPERTY_ATTACHMENT_COUNT) == 0) {
             HandleError("Render pass attachment count not set yet");
@@ -176,6 +261,35 @@ namespace backend {
         mAttachments[attachmentSlot].stencilLoadOp = stencilOp;
     }
 
+    void RenderPassBuilder::AttachmentSetColorStoreOp(uint32_t attachmentSlot, nxt::StoreOp op) {
+        if ((mPropertiesSet & RENDERPASS_PROPERTY_ATTACHMENT_COUNT) == 0) {
+            HandleError("Render pass attachment count not set yet");
+            return;
+        }
+        if (attachmentSlot >= mAttachments.size()) {
+            HandleError("Render pass attachment slot out of bounds");
+            return;
+        }
+
+        mAttachments[attachmentSlot].colorStoreOp = op;
+    }
+
+    void RenderPassBuilder::AttachmentSetDepthStencilStoreOps(uint32_t attachmentSlot,
+                                                              nxt::StoreOp depthOp,
+                                                              nxt::StoreOp stencilOp) {
+        if ((mPropertiesSet & RENDERPASS_PROPERTY_ATTACHMENT_COUNT) == 0) {
+            HandleError("Render pass attachment count not set yet");
+            return;
+        }
+        if (attachmentSlot >= mAttachments.size()) {
+            HandleError("Render pass attachment slot out of bounds");
+            return;
+        }
+
+        mAttachments[attachmentSlot].depthStoreOp = depthOp;
+        mAttachments[attachmentSlot].stencilStoreOp = stencilOp;
+    }
+
     void RenderPassBuilder::SetSubpassCount(uint32_t subpassCount) {
         if ((mPropertiesSet & RENDERPASS_PROPERTY_SUBPASS_COUNT) != 0) {
             HandleError("Render pass subpass count property set multiple times");
@@ -222,6 +336,38 @@ namespace backend {
         mSubpasses[subpass].colorAttachments[outputAttachmentLocation] = attachmentSlot;
     }
 
+    void RenderPassBuilder::SubpassSetResolveAttachment(uint32_t subpass,
+                                                        uint32_t outputAttachmentLocation,
+                                                        uint32_t attachmentSlot) {
+        if ((mPropertiesSet & RENDERPASS_PROPERTY_SUBPASS_COUNT) == 0) {
+            HandleError("Render pass subpass count not set yet");
+            return;
+        }
+        if ((mPropertiesSet & RENDERPASS_PROPERTY_ATTACHMENT_COUNT) == 0) {
+            HandleError("Render pass attachment count not set yet");
+            return;
+        }
+        if (subpass >= mSubpasses.size()) {
+            HandleError("Subpass index out of bounds");
+            return;
+        }
+        if (outputAttachmentLocation >= kMaxColorAttachments) {
+            HandleError("Subpass output attachment location out of bounds");
+            return;
+        }
+        if (attachmentSlot >= mAttachments.size()) {
+            HandleError("Subpass attachment slot out of bounds");
+            return;
+        }
+        if (mSubpasses[subpass].resolveAttachmentsSet[outputAttachmentLocation]) {
+            HandleError("Subpass resolve attachment already set");
+            return;
+        }
+
+        mSubpasses[subpass].resolveAttachmentsSet.set(outputAttachmentLocation);
+        mSubpasses[subpass].resolveAttachments[outputAttachmentLocation] = attachmentSlot;
+    }
+
     void RenderPassBuilder::SubpassSetDepthStencilAttachment(uint32_t subpass,
                                                              uint32_t attachmentSlot) {
         if ((mPropertiesSet & RENDERPASS_PROPERTY_SUBPASS_COUNT) == 0) {
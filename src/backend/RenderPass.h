@@ -34,12 +34,18 @@ namespace backend {
 
         struct AttachmentInfo {
             nxt::TextureFormat format;
+            uint32_t sampleCount = 1;
             nxt::LoadOp colorLoadOp = nxt::LoadOp::Load;
             nxt::LoadOp depthLoadOp = nxt::LoadOp::Load;
             nxt::LoadOp stencilLoadOp = nxt::LoadOp::Load;
+            nxt::StoreOp colorStoreOp = nxt::StoreOp::Store;
+            nxt::StoreOp depthStoreOp = nxt::StoreOp::Store;
+            nxt::StoreOp stencilStoreOp = nxt::StoreOp::Store;
             // The first subpass that this attachment is used in. This is used to determine, for
             // each subpass, whether each of its attachments is being used for the first time.
             uint32_t firstSubpass = UINT32_MAX;
+            // The last subpass that this attachment is used in, store ops are applied after it.
+            uint32_t lastSubpass = UINT32_MAX;
         };
 
         struct SubpassInfo {
@@ -47,8 +53,14 @@ namespace backend {
             std::bitset<kMaxColorAttachments> colorAttachmentsSet;
             // Mapping from location to attachment slot
             std::array<uint32_t, kMaxColorAttachments> colorAttachments;
+            // Set of locations whose color attachment is resolved at the end of the subpass
+            std::bitset<kMaxColorAttachments> resolveAttachmentsSet;
+            // Mapping from location to the slot of the attachment it is resolved to
+            std::array<uint32_t, kMaxColorAttachments> resolveAttachments;
             bool depthStencilAttachmentSet = false;
             uint32_t depthStencilAttachment = 0;
+            // The sample count of all the color and depth-stencil attachments of the subpass
+            uint32_t sampleCount = 1;
         };
 
         uint32_t GetAttachmentCount() const;
@@ -70,14 +82,22 @@ namespace backend {
         RenderPassBase* GetResultImpl() override;
         void SetAttachmentCount(uint32_t attachmentCount);
         void AttachmentSetFormat(uint32_t attachmentSlot, nxt::TextureFormat format);
+        void AttachmentSetSampleCount(uint32_t attachmentSlot, uint32_t sampleCount);
         void AttachmentSetColorLoadOp(uint32_t attachmentSlot, nxt::LoadOp op);
         void AttachmentSetDepthStencilLoadOps(uint32_t attachmentSlot,
                                               nxt::LoadOp depthOp,
                                               nxt::LoadOp stencilOp);
+        void AttachmentSetColorStoreOp(uint32_t attachmentSlot, nxt::StoreOp op);
+        void AttachmentSetDepthStencilStoreOps(uint32_t attachmentSlot,
+                                               nxt::StoreOp depthOp,
+                                               nxt::StoreOp stencilOp);
         void SetSubpassCount(uint32_t subpassCount);
         void SubpassSetColorAttachment(uint32_t subpass,
                                        uint32_t outputAttachmentLocation,
                                        uint32_t attachmentSlot);
+        void SubpassSetResolveAttachment(uint32_t subpass,
+                                         uint32_t outputAttachmentLocation,
+                                         uint32_t attachmentSlot);
         void SubpassSetDepthStencilAttachment(uint32_t subpass, uint32_t attachmentSlot);
 
       private:
@@ -19,6 +19,7 @@
 #include "backend/Device.h"
 #include "backend/InputState.h"
 #include "backend/RenderPass.h"
+#include "backend/Texture.h"
 #include "common/BitSetIterator.h"
 
 namespace backend {
@@ -32,6 +33,7 @@ namespace backend {
           mInputState(std::move(builder->mInputState)),
           mPrimitiveTopology(builder->mPrimitiveTopology),
           mBlendStates(builder->mBlendStates),
+          mSampleCount(builder->mSampleCount),
           mRenderPass(std::move(builder->mRenderPass)),
           mSubpass(builder->mSubpass) {
         if (GetStageMask() != (nxt::ShaderStageBit::Vertex | nxt::ShaderStageBit::Fragment)) {
@@ -41,9 +43,9 @@ namespace backend {
 
         // TODO(kainino@chromium.org): Need to verify the pipeline against its render subpass.
 
-        if ((builder->GetStageInfo(nxt::ShaderStage::Vertex).module->GetUsedVertexAttributes() &
-             ~mInputState->GetAttributesSetMask())
-                .any()) {
+        auto& vertexStage = builder->GetStageInfo(nxt::ShaderStage::Vertex);
+        const auto& vertexInfo = vertexStage.module->GetEntryPointInfo(vertexStage.entryPoint);
+        if ((vertexInfo.usedVertexAttributes & ~mInputState->GetAttributesSetMask()).any()) {
             builder->HandleError("Pipeline vertex stage uses inputs not in the input state");
             return;
         }
@@ -70,6 +72,10 @@ namespace backend {
         return mPrimitiveTopology;
     }
 
+    uint32_t RenderPipelineBase::GetSampleCount() const {
+        return mSampleCount;
+    }
+
     RenderPassBase* RenderPipelineBase::GetRenderPass() {
         return mRenderPass.Get();
     }
@@ -103,6 +109,10 @@ namespace backend {
             HandleError("Blend state set on unset color attachment");
             return nullptr;
         }
+        if (mSampleCount != subpassInfo.sampleCount) {
+            HandleError("Pipeline sample count doesn't match the subpass sample count");
+            return nullptr;
+        }
 
         // Assign all color attachments without a blend state the default state
         // TODO(enga@google.com): Put the default objects in the device
@@ -145,6 +155,14 @@ namespace backend {
         mPrimitiveTopology = primitiveTopology;
     }
 
+    void RenderPipelineBuilder::SetSampleCount(uint32_t sampleCount) {
+        if (!IsValidSampleCount(sampleCount)) {
+            HandleError("Pipeline sample count is not supported");
+            return;
+        }
+        mSampleCount = sampleCount;
+    }
+
     void RenderPipelineBuilder::SetSubpass(RenderPassBase* renderPass, uint32_t subpass) {
         mRenderPass = renderPass;
         mSubpass = subpass;
@@ -33,6 +33,7 @@ namespace backend {
         nxt::IndexFormat GetIndexFormat() const;
         InputStateBase* GetInputState();
         nxt::PrimitiveTopology GetPrimitiveTopology() const;
+        uint32_t GetSampleCount() const;
         RenderPassBase* GetRenderPass();
         uint32_t GetSubPass();
 
@@ -42,6 +43,7 @@ namespace backend {
         Ref<InputStateBase> mInputState;
         nxt::PrimitiveTopology mPrimitiveTopology;
         std::array<Ref<BlendStateBase>, kMaxColorAttachments> mBlendStates;
+        uint32_t mSampleCount;
         Ref<RenderPassBase> mRenderPass;
         uint32_t mSubpass;
     };
@@ -54,6 +56,7 @@ namespace backend {
         void SetColorAttachmentBlendState(uint32_t attachmentSlot, BlendStateBase* blendState);
         void SetDepthStencilState(DepthStencilStateBase* depthStencilState);
         void SetPrimitiveTopology(nxt::PrimitiveTopology primitiveTopology);
+        void SetSampleCount(uint32_t sampleCount);
         void SetIndexFormat(nxt::IndexFormat format);
         void SetInputState(InputStateBase* inputState);
         void SetSubpass(RenderPassBase* renderPass, uint32_t subpass);
@@ -71,6 +74,7 @@ namespace backend {
         nxt::IndexFormat mIndexFormat = nxt::IndexFormat::Uint32;
         std::bitset<kMaxColorAttachments> mBlendStatesSet;
         std::array<Ref<BlendStateBase>, kMaxColorAttachments> mBlendStates;
+        uint32_t mSampleCount = 1;
         Ref<RenderPassBase> mRenderPass;
         uint32_t mSubpass;
     };
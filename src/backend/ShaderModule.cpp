@@ -23,36 +23,118 @@
 
 namespace backend {
 
-    ShaderModuleBase::ShaderModuleBase(ShaderModuleBuilder* builder) : mDevice(builder->mDevice) {
+    ShaderModuleBase::ShaderModuleBase(ShaderModuleBuilder* builder)
+        : mDevice(builder->mDevice), mSpirv(std::move(builder->mSpirv)) {
+    }
+
+    ShaderModuleBase::~ShaderModuleBase() {
     }
 
     DeviceBase* ShaderModuleBase::GetDevice() const {
         return mDevice;
     }
 
-    void ShaderModuleBase::ExtractSpirvInfo(const spirv_cross::Compiler& compiler) {
-        // TODO(cwallez@chromium.org): make errors here builder-level
-        // currently errors here do not prevent the shadermodule from being used
-        const auto& resources = compiler.get_shader_resources();
+    const std::vector<uint32_t>& ShaderModuleBase::GetSpirv() const {
+        return mSpirv;
+    }
+
+    spirv_cross::Compiler* ShaderModuleBase::GetCompiler() {
+        if (mCompiler != nullptr) {
+            return mCompiler.get();
+        }
+
+        mCompiler = std::make_unique<spirv_cross::Compiler>(mSpirv);
+
+        // Extract the specialization constants, only 32-bit scalars are supported so that their
+        // values can always be given as uint32_t bit patterns.
+        for (const auto& constant : mCompiler->get_specialization_constants()) {
+            const auto& spirvConstant = mCompiler->get_constant(constant.id);
+            const auto& constantType = mCompiler->get_type(spirvConstant.constant_type);
+            if (constantType.width != 32 &&
+                constantType.basetype != spirv_cross::SPIRType::Boolean) {
+                mHasUnsupportedSpecializationConstant = true;
+                continue;
+            }
+
+            auto& info = mSpecializationConstants[constant.constant_id];
+            info.id = constant.id;
+            info.defaultValue = spirvConstant.scalar();
+        }
+
+        return mCompiler.get();
+    }
+
+    bool ShaderModuleBase::HasEntryPoint(const std::string& entryPoint) {
+        if (mEntryPoints.count(entryPoint) != 0) {
+            return true;
+        }
+
+        for (const auto& name : GetCompiler()->get_entry_points()) {
+            if (name == entryPoint) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const ShaderModuleBase::EntryPointInfo& ShaderModuleBase::GetEntryPointInfo(
+        const std::string& entryPoint) {
+        auto it = mEntryPoints.find(entryPoint);
+        if (it != mEntryPoints.end()) {
+            return it->second;
+        }
+
+        ASSERT(HasEntryPoint(entryPoint));
+        EntryPointInfo& info = mEntryPoints[entryPoint];
+        ExtractEntryPointInfo(entryPoint, &info);
+        return info;
+    }
+
+    const ShaderModuleBase::SpecializationConstants&
+    ShaderModuleBase::GetSpecializationConstants() {
+        GetCompiler();
+        return mSpecializationConstants;
+    }
+
+    void ShaderModuleBase::SelectEntryPoint(spirv_cross::Compiler* compiler,
+                                            const std::string& entryPoint) {
+        compiler->set_entry_point(entryPoint);
+        compiler->set_enabled_interface_variables(compiler->get_active_interface_variables());
+    }
+
+    void ShaderModuleBase::ExtractEntryPointInfo(const std::string& entryPoint,
+                                                 EntryPointInfo* info) {
+        spirv_cross::Compiler& compiler = *GetCompiler();
+        if (mHasUnsupportedSpecializationConstant) {
+            info->error = "Specialization constants must be 32-bit scalars";
+            return;
+        }
+        SelectEntryPoint(&compiler, entryPoint);
+
+        // Only the resources statically used by the entry point are reflected.
+        const auto& resources =
+            compiler.get_shader_resources(compiler.get_active_interface_variables());
 
         switch (compiler.get_execution_model()) {
             case spv::ExecutionModelVertex:
-                mExecutionModel = nxt::ShaderStage::Vertex;
+                info->stage = nxt::ShaderStage::Vertex;
                 break;
             case spv::ExecutionModelFragment:
-                mExecutionModel = nxt::ShaderStage::Fragment;
+                info->stage = nxt::ShaderStage::Fragment;
                 break;
             case spv::ExecutionModelGLCompute:
-                mExecutionModel = nxt::ShaderStage::Compute;
+                info->stage = nxt::ShaderStage::Compute;
                 break;
             default:
-                UNREACHABLE();
+                info->error = "Unsupported execution model for the entry point";
+                return;
         }
 
         // Extract push constants
-        mPushConstants.mask.reset();
-        mPushConstants.sizes.fill(0);
-        mPushConstants.types.fill(PushConstantType::Int);
+        PushConstantInfo& pushConstants = info->pushConstants;
+        pushConstants.mask.reset();
+        pushConstants.sizes.fill(0);
+        pushConstants.types.fill(PushConstantType::Int);
 
         if (resources.push_constant_buffers.size() > 0) {
             auto interfaceBlock = resources.push_constant_buffers[0];
@@ -88,20 +170,20 @@ namespace backend {
                 }
 
                 if (offset + size > kMaxPushConstants) {
-                    mDevice->HandleError("Push constant block too big in the SPIRV");
+                    info->error = "Push constant block too big in the SPIRV";
                     return;
                 }
 
-                mPushConstants.mask.set(offset);
-                mPushConstants.names[offset] =
+                pushConstants.mask.set(offset);
+                pushConstants.names[offset] =
                     interfaceBlock.name + "." + compiler.get_member_name(blockType.self, i);
-                mPushConstants.sizes[offset] = size;
-                mPushConstants.types[offset] = constantType;
+                pushConstants.sizes[offset] = size;
+                pushConstants.types[offset] = constantType;
             }
         }
 
         // Fill in bindingInfo with the SPIRV bindings
-        auto ExtractResourcesBinding = [this](const std::vector<spirv_cross::Resource>& resources,
+        auto ExtractResourcesBinding = [info](const std::vector<spirv_cross::Resource>& resources,
                                               const spirv_cross::Compiler& compiler,
                                               nxt::BindingType bindingType) {
             constexpr uint64_t requiredBindingDecorationMask =
@@ -114,15 +196,15 @@ namespace backend {
                 uint32_t set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
 
                 if (binding >= kMaxBindingsPerGroup || set >= kMaxBindGroups) {
-                    mDevice->HandleError("Binding over limits in the SPIRV");
+                    info->error = "Binding over limits in the SPIRV";
                     continue;
                 }
 
-                auto& info = mBindingInfo[set][binding];
-                info.used = true;
-                info.id = resource.id;
-                info.base_type_id = resource.base_type_id;
-                info.type = bindingType;
+                auto& bindingInfo = info->bindingInfo[set][binding];
+                bindingInfo.used = true;
+                bindingInfo.id = resource.id;
+                bindingInfo.base_type_id = resource.base_type_id;
+                bindingInfo.type = bindingType;
             }
         };
 
@@ -135,17 +217,17 @@ namespace backend {
                                 nxt::BindingType::StorageBuffer);
 
         // Extract the vertex attributes
-        if (mExecutionModel == nxt::ShaderStage::Vertex) {
+        if (info->stage == nxt::ShaderStage::Vertex) {
             for (const auto& attrib : resources.stage_inputs) {
                 ASSERT(compiler.get_decoration_mask(attrib.id) & (1ull << spv::DecorationLocation));
                 uint32_t location = compiler.get_decoration(attrib.id, spv::DecorationLocation);
 
                 if (location >= kMaxVertexAttributes) {
-                    mDevice->HandleError("Attribute location over limits in the SPIRV");
+                    info->error = "Attribute location over limits in the SPIRV";
                     return;
                 }
 
-                mUsedVertexAttributes.set(location);
+                info->usedVertexAttributes.set(location);
             }
 
             // Without a location qualifier on vertex outputs, spirv_cross::CompilerMSL gives them
@@ -153,55 +235,51 @@ namespace backend {
             for (const auto& attrib : resources.stage_outputs) {
                 if (!(compiler.get_decoration_mask(attrib.id) &
                       (1ull << spv::DecorationLocation))) {
-                    mDevice->HandleError("Need location qualifier on vertex output");
+                    info->error = "Need location qualifier on vertex output";
                     return;
                 }
             }
         }
 
-        if (mExecutionModel == nxt::ShaderStage::Fragment) {
+        if (info->stage == nxt::ShaderStage::Fragment) {
             // Without a location qualifier on vertex inputs, spirv_cross::CompilerMSL gives them
             // all the location 0, causing a compile error.
             for (const auto& attrib : resources.stage_inputs) {
                 if (!(compiler.get_decoration_mask(attrib.id) &
                       (1ull << spv::DecorationLocation))) {
-                    mDevice->HandleError("Need location qualifier on fragment input");
+                    info->error = "Need location qualifier on fragment input";
                     return;
                 }
             }
         }
     }
 
-    const ShaderModuleBase::PushConstantInfo& ShaderModuleBase::GetPushConstants() const {
-        return mPushConstants;
-    }
-
-    const ShaderModuleBase::ModuleBindingInfo& ShaderModuleBase::GetBindingInfo() const {
-        return mBindingInfo;
-    }
-
-    const std::bitset<kMaxVertexAttributes>& ShaderModuleBase::GetUsedVertexAttributes() const {
-        return mUsedVertexAttributes;
-    }
-
-    nxt::ShaderStage ShaderModuleBase::GetExecutionModel() const {
-        return mExecutionModel;
+    void ShaderModuleBase::ApplySpecialization(spirv_cross::Compiler* compiler,
+                                               const SpecializationValues& specialization) const {
+        for (const auto& it : specialization) {
+            auto constant = mSpecializationConstants.find(it.first);
+            ASSERT(constant != mSpecializationConstants.end());
+            compiler->get_constant(constant->second.id).m.c[0].r[0].u32 = it.second;
+        }
     }
 
-    bool ShaderModuleBase::IsCompatibleWithPipelineLayout(const PipelineLayoutBase* layout) {
+    bool ShaderModuleBase::IsCompatibleWithPipelineLayout(const std::string& entryPoint,
+                                                          const PipelineLayoutBase* layout) {
+        const EntryPointInfo& info = GetEntryPointInfo(entryPoint);
         for (size_t group = 0; group < kMaxBindGroups; ++group) {
-            if (!IsCompatibleWithBindGroupLayout(group, layout->GetBindGroupLayout(group))) {
+            if (!IsCompatibleWithBindGroupLayout(info, group, layout->GetBindGroupLayout(group))) {
                 return false;
             }
         }
         return true;
     }
 
-    bool ShaderModuleBase::IsCompatibleWithBindGroupLayout(size_t group,
+    bool ShaderModuleBase::IsCompatibleWithBindGroupLayout(const EntryPointInfo& info,
+                                                           size_t group,
                                                            const BindGroupLayoutBase* layout) {
         const auto& layoutInfo = layout->GetBindingInfo();
         for (size_t i = 0; i < kMaxBindingsPerGroup; ++i) {
-            const auto& moduleInfo = mBindingInfo[group][i];
+            const auto& moduleInfo = info.bindingInfo[group][i];
 
             if (!moduleInfo.used) {
                 continue;
@@ -210,7 +288,7 @@ namespace backend {
             if (moduleInfo.type != layoutInfo.types[i]) {
                 return false;
             }
-            if ((layoutInfo.visibilities[i] & StageBit(mExecutionModel)) == 0) {
+            if ((layoutInfo.visibilities[i] & StageBit(info.stage)) == 0) {
                 return false;
             }
         }
@@ -221,10 +299,6 @@ namespace backend {
     ShaderModuleBuilder::ShaderModuleBuilder(DeviceBase* device) : Builder(device) {
     }
 
-    std::vector<uint32_t> ShaderModuleBuilder::AcquireSpirv() {
-        return std::move(mSpirv);
-    }
-
     ShaderModuleBase* ShaderModuleBuilder::GetResultImpl() {
         if (mSpirv.size() == 0) {
             HandleError("Shader module needs to have the source set");
@@ -24,6 +24,9 @@
 
 #include <array>
 #include <bitset>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace spirv_cross {
@@ -32,13 +35,20 @@ namespace spirv_cross {
 
 namespace backend {
 
+    // The values given to the specialization constants of a stage, as the bit pattern of their
+    // 32-bit value indexed by their SpecId.
+    using SpecializationValues = std::map<uint32_t, uint32_t>;
+
+    // Shader modules can contain any number of entry points. The SPIRV is only parsed when it is
+    // first reflected and the reflection of each entry point is computed the first time a pipeline
+    // uses it, so that large shader libraries stay cheap to create.
     class ShaderModuleBase : public RefCounted {
       public:
         ShaderModuleBase(ShaderModuleBuilder* builder);
+        ~ShaderModuleBase();
 
         DeviceBase* GetDevice() const;
-
-        void ExtractSpirvInfo(const spirv_cross::Compiler& compiler);
+        const std::vector<uint32_t>& GetSpirv() const;
 
         struct PushConstantInfo {
             std::bitset<kMaxPushConstants> mask;
@@ -58,29 +68,62 @@ namespace backend {
         using ModuleBindingInfo =
             std::array<std::array<BindingInfo, kMaxBindingsPerGroup>, kMaxBindGroups>;
 
-        const PushConstantInfo& GetPushConstants() const;
-        const ModuleBindingInfo& GetBindingInfo() const;
-        const std::bitset<kMaxVertexAttributes>& GetUsedVertexAttributes() const;
-        nxt::ShaderStage GetExecutionModel() const;
+        struct EntryPointInfo {
+            nxt::ShaderStage stage;
+            PushConstantInfo pushConstants = {};
+            ModuleBindingInfo bindingInfo;
+            std::bitset<kMaxVertexAttributes> usedVertexAttributes;
+            // Non-empty if the entry point can't be used in a pipeline.
+            std::string error;
+        };
+
+        struct SpecializationConstantInfo {
+            // The SPIRV ID of the constant.
+            uint32_t id;
+            uint32_t defaultValue;
+        };
+        // Indexed by the SpecId of the constants.
+        using SpecializationConstants = std::map<uint32_t, SpecializationConstantInfo>;
+
+        bool HasEntryPoint(const std::string& entryPoint);
+        const EntryPointInfo& GetEntryPointInfo(const std::string& entryPoint);
+        const SpecializationConstants& GetSpecializationConstants();
+
+        // Makes the compiler translate only the entry point and the resources it uses.
+        static void SelectEntryPoint(spirv_cross::Compiler* compiler,
+                                     const std::string& entryPoint);
+
+        // Overrides the value of the specialization constants in the compiler so that SPIRV-Cross
+        // emits the specialized values as regular constants.
+        void ApplySpecialization(spirv_cross::Compiler* compiler,
+                                 const SpecializationValues& specialization) const;
 
-        bool IsCompatibleWithPipelineLayout(const PipelineLayoutBase* layout);
+        bool IsCompatibleWithPipelineLayout(const std::string& entryPoint,
+                                            const PipelineLayoutBase* layout);
 
       private:
-        bool IsCompatibleWithBindGroupLayout(size_t group, const BindGroupLayoutBase* layout);
+        spirv_cross::Compiler* GetCompiler();
+        void ExtractEntryPointInfo(const std::string& entryPoint, EntryPointInfo* info);
+        bool IsCompatibleWithBindGroupLayout(const EntryPointInfo& info,
+                                             size_t group,
+                                             const BindGroupLayoutBase* layout);
 
         DeviceBase* mDevice;
-        PushConstantInfo mPushConstants = {};
-        ModuleBindingInfo mBindingInfo;
-        std::bitset<kMaxVertexAttributes> mUsedVertexAttributes;
-        nxt::ShaderStage mExecutionModel;
+        std::vector<uint32_t> mSpirv;
+
+        // Created when the module is first reflected, and shared by all the entry points.
+        std::unique_ptr<spirv_cross::Compiler> mCompiler;
+        std::map<std::string, EntryPointInfo> mEntryPoints;
+        SpecializationConstants mSpecializationConstants;
+        // Set when reflection finds constants that can't be specialized. Reported as the error of
+        // every entry point, since the module isn't usable.
+        bool mHasUnsupportedSpecializationConstant = false;
     };
 
     class ShaderModuleBuilder : public Builder<ShaderModuleBase> {
       public:
         ShaderModuleBuilder(DeviceBase* device);
 
-        std::vector<uint32_t> AcquireSpirv();
-
         // NXT API
         void SetSource(uint32_t codeSize, const uint32_t* code);
 
@@ -17,6 +17,8 @@
 #include "backend/Device.h"
 #include "common/Assert.h"
 
+#include <algorithm>
+
 namespace backend {
 
     uint32_t TextureFormatPixelSize(nxt::TextureFormat format) {
@@ -27,16 +29,87 @@ namespace backend {
                 return 4;
             case nxt::TextureFormat::D32FloatS8Uint:
                 return 8;
+            default:
+                // Compressed formats don't have a size per pixel, use TextureFormatBlockSize
+                UNREACHABLE();
+        }
+    }
+
+    bool TextureFormatIsCompressed(nxt::TextureFormat format) {
+        switch (format) {
+            case nxt::TextureFormat::R8G8B8A8Unorm:
+            case nxt::TextureFormat::R8G8B8A8Uint:
+            case nxt::TextureFormat::B8G8R8A8Unorm:
+            case nxt::TextureFormat::D32FloatS8Uint:
+                return false;
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return true;
             default:
                 UNREACHABLE();
         }
     }
 
+    uint32_t TextureFormatBlockWidth(nxt::TextureFormat format) {
+        return TextureFormatIsCompressed(format) ? 4 : 1;
+    }
+
+    uint32_t TextureFormatBlockHeight(nxt::TextureFormat format) {
+        return TextureFormatIsCompressed(format) ? 4 : 1;
+    }
+
+    uint32_t TextureFormatBlockSize(nxt::TextureFormat format) {
+        switch (format) {
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+                return 8;
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return 16;
+            default:
+                return TextureFormatPixelSize(format);
+        }
+    }
+
+    uint32_t ComputeTextureRowSize(nxt::TextureFormat format, uint32_t width) {
+        uint32_t blockWidth = TextureFormatBlockWidth(format);
+        return (width + blockWidth - 1) / blockWidth * TextureFormatBlockSize(format);
+    }
+
+    uint32_t ComputeTextureRowCount(nxt::TextureFormat format, uint32_t height) {
+        uint32_t blockHeight = TextureFormatBlockHeight(format);
+        return (height + blockHeight - 1) / blockHeight;
+    }
+
     bool TextureFormatHasDepth(nxt::TextureFormat format) {
         switch (format) {
             case nxt::TextureFormat::R8G8B8A8Unorm:
             case nxt::TextureFormat::R8G8B8A8Uint:
             case nxt::TextureFormat::B8G8R8A8Unorm:
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
                 return false;
             case nxt::TextureFormat::D32FloatS8Uint:
                 return true;
@@ -50,6 +123,16 @@ namespace backend {
             case nxt::TextureFormat::R8G8B8A8Unorm:
             case nxt::TextureFormat::R8G8B8A8Uint:
             case nxt::TextureFormat::B8G8R8A8Unorm:
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
                 return false;
             case nxt::TextureFormat::D32FloatS8Uint:
                 return true;
@@ -63,6 +146,16 @@ namespace backend {
             case nxt::TextureFormat::R8G8B8A8Unorm:
             case nxt::TextureFormat::R8G8B8A8Uint:
             case nxt::TextureFormat::B8G8R8A8Unorm:
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
                 return false;
             case nxt::TextureFormat::D32FloatS8Uint:
                 return true;
@@ -71,6 +164,35 @@ namespace backend {
         }
     }
 
+    bool TextureFormatIsFilterable(nxt::TextureFormat format) {
+        switch (format) {
+            case nxt::TextureFormat::R8G8B8A8Unorm:
+            case nxt::TextureFormat::B8G8R8A8Unorm:
+                return true;
+            // Compressed formats can be sampled with filtering but can't be rendered to so mipmaps
+            // can't be generated for them.
+            case nxt::TextureFormat::R8G8B8A8Uint:
+            case nxt::TextureFormat::D32FloatS8Uint:
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return false;
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    bool IsValidSampleCount(uint32_t sampleCount) {
+        return sampleCount == 1 || sampleCount == 4;
+    }
+
     // TextureBase
 
     TextureBase::TextureBase(TextureBuilder* builder)
@@ -81,8 +203,9 @@ namespace backend {
           mHeight(builder->mHeight),
           mDepth(builder->mDepth),
           mNumMipLevels(builder->mNumMipLevels),
+          mSampleCount(builder->mSampleCount),
           mAllowedUsage(builder->mAllowedUsage),
-          mCurrentUsage(builder->mCurrentUsage) {
+          mLevelUsages(builder->mNumMipLevels, builder->mCurrentUsage) {
     }
 
     DeviceBase* TextureBase::GetDevice() const {
@@ -104,20 +227,141 @@ namespace backend {
     uint32_t TextureBase::GetDepth() const {
         return mDepth;
     }
+    uint32_t TextureBase::GetLevelDepth(uint32_t level) const {
+        if (mDimension == nxt::TextureDimension::e3D) {
+            return std::max(mDepth >> level, 1u);
+        }
+        return mDepth;
+    }
     uint32_t TextureBase::GetNumMipLevels() const {
         return mNumMipLevels;
     }
+    uint32_t TextureBase::GetSampleCount() const {
+        return mSampleCount;
+    }
     nxt::TextureUsageBit TextureBase::GetAllowedUsage() const {
         return mAllowedUsage;
     }
     nxt::TextureUsageBit TextureBase::GetUsage() const {
-        return mCurrentUsage;
+        ASSERT(GetLevelUsageRanges(0, mNumMipLevels).size() == 1);
+        return mLevelUsages[0];
+    }
+    nxt::TextureUsageBit TextureBase::GetLevelUsage(uint32_t level) const {
+        ASSERT(level < mNumMipLevels);
+        return mLevelUsages[level];
+    }
+
+    std::vector<TextureBase::LevelUsageRange> TextureBase::GetLevelUsageRanges(
+        uint32_t baseLevel,
+        uint32_t levelCount) const {
+        ASSERT(levelCount > 0 && baseLevel + levelCount <= mNumMipLevels);
+
+        std::vector<LevelUsageRange> ranges;
+        ranges.push_back({baseLevel, 1, mLevelUsages[baseLevel]});
+        for (uint32_t level = baseLevel + 1; level < baseLevel + levelCount; ++level) {
+            if (mLevelUsages[level] == ranges.back().usage) {
+                ranges.back().levelCount++;
+            } else {
+                ranges.push_back({level, 1, mLevelUsages[level]});
+            }
+        }
+        return ranges;
     }
 
     TextureViewBuilder* TextureBase::CreateTextureViewBuilder() {
         return new TextureViewBuilder(mDevice, this);
     }
 
+    void TextureBase::SetSubData(uint32_t level,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 uint32_t rowPitch,
+                                 uint32_t size,
+                                 const uint8_t* data) {
+        if (level >= mNumMipLevels) {
+            mDevice->HandleError("Texture subdata level out of range");
+            return;
+        }
+
+        // Use 64 bit arithmetic to avoid overflows
+        uint64_t levelWidth = std::max(mWidth >> level, 1u);
+        uint64_t levelHeight = std::max(mHeight >> level, 1u);
+        if (uint64_t(x) + uint64_t(width) > levelWidth ||
+            uint64_t(y) + uint64_t(height) > levelHeight) {
+            mDevice->HandleError("Texture subdata region out of range");
+            return;
+        }
+
+        if (!IsRegionBlockAligned(level, x, y, width, height)) {
+            mDevice->HandleError("Texture subdata region isn't aligned to the format's blocks");
+            return;
+        }
+
+        if (TextureFormatHasDepthOrStencil(mFormat)) {
+            mDevice->HandleError("Texture subdata isn't supported for depth stencil formats");
+            return;
+        }
+
+        if (mDimension != nxt::TextureDimension::e2D) {
+            mDevice->HandleError("Texture subdata is only supported for 2D textures");
+            return;
+        }
+
+        uint32_t blockSize = TextureFormatBlockSize(mFormat);
+        uint64_t rowSize = ComputeTextureRowSize(mFormat, width);
+        if (rowPitch == 0) {
+            rowPitch = static_cast<uint32_t>(rowSize);
+        }
+        if (rowPitch < rowSize || rowPitch % blockSize != 0) {
+            mDevice->HandleError("Texture subdata row pitch is invalid");
+            return;
+        }
+
+        if (!(mLevelUsages[level] & nxt::TextureUsageBit::TransferDst)) {
+            mDevice->HandleError("Texture needs the transfer dst usage bit");
+            return;
+        }
+
+        if (width == 0 || height == 0) {
+            return;
+        }
+
+        uint64_t rowCount = ComputeTextureRowCount(mFormat, height);
+        uint64_t requiredSize = uint64_t(rowPitch) * (rowCount - 1) + rowSize;
+        if (requiredSize > size) {
+            mDevice->HandleError("Texture subdata doesn't contain enough data");
+            return;
+        }
+
+        SetSubDataImpl(level, x, y, width, height, rowPitch, data);
+    }
+
+    bool TextureBase::IsRegionBlockAligned(uint32_t level,
+                                           uint32_t x,
+                                           uint32_t y,
+                                           uint32_t width,
+                                           uint32_t height) const {
+        // Regions must start on block boundaries and can only end in the middle of a block when
+        // that block is at the edge of the mip level.
+        uint32_t blockWidth = TextureFormatBlockWidth(mFormat);
+        uint32_t blockHeight = TextureFormatBlockHeight(mFormat);
+        uint64_t levelWidth = std::max(mWidth >> level, 1u);
+        uint64_t levelHeight = std::max(mHeight >> level, 1u);
+
+        if (x % blockWidth != 0 || y % blockHeight != 0) {
+            return false;
+        }
+        if (width % blockWidth != 0 && uint64_t(x) + uint64_t(width) != levelWidth) {
+            return false;
+        }
+        if (height % blockHeight != 0 && uint64_t(y) + uint64_t(height) != levelHeight) {
+            return false;
+        }
+        return true;
+    }
+
     bool TextureBase::IsFrozen() const {
         return mIsFrozen;
     }
@@ -137,15 +381,24 @@ namespace backend {
         if (mIsFrozen) {
             return false;
         }
-        if (mCurrentUsage == nxt::TextureUsageBit::Present) {
-            return false;
+        for (nxt::TextureUsageBit levelUsage : mLevelUsages) {
+            if (levelUsage == nxt::TextureUsageBit::Present) {
+                return false;
+            }
         }
         return IsUsagePossible(mAllowedUsage, usage);
     }
 
     void TextureBase::UpdateUsageInternal(nxt::TextureUsageBit usage) {
+        UpdateLevelsUsageInternal(0, mNumMipLevels, usage);
+    }
+
+    void TextureBase::UpdateLevelsUsageInternal(uint32_t baseLevel,
+                                                uint32_t levelCount,
+                                                nxt::TextureUsageBit usage) {
         ASSERT(IsTransitionPossible(usage));
-        mCurrentUsage = usage;
+        ASSERT(baseLevel + levelCount <= mNumMipLevels);
+        std::fill_n(mLevelUsages.begin() + baseLevel, levelCount, usage);
     }
 
     void TextureBase::TransitionUsage(nxt::TextureUsageBit usage) {
@@ -153,7 +406,9 @@ namespace backend {
             mDevice->HandleError("Texture frozen or usage not allowed");
             return;
         }
-        TransitionUsageImpl(mCurrentUsage, usage);
+        for (const auto& range : GetLevelUsageRanges(0, mNumMipLevels)) {
+            TransitionUsageImpl(range.baseLevel, range.levelCount, range.usage, usage);
+        }
         UpdateUsageInternal(usage);
     }
 
@@ -163,7 +418,9 @@ namespace backend {
             return;
         }
         mAllowedUsage = usage;
-        TransitionUsageImpl(mCurrentUsage, usage);
+        for (const auto& range : GetLevelUsageRanges(0, mNumMipLevels)) {
+            TransitionUsageImpl(range.baseLevel, range.levelCount, range.usage, usage);
+        }
         UpdateUsageInternal(usage);
         mIsFrozen = true;
     }
@@ -177,6 +434,7 @@ namespace backend {
         TEXTURE_PROPERTY_MIP_LEVELS = 0x8,
         TEXTURE_PROPERTY_ALLOWED_USAGE = 0x10,
         TEXTURE_PROPERTY_INITIAL_USAGE = 0x20,
+        TEXTURE_PROPERTY_SAMPLE_COUNT = 0x40,
     };
 
     TextureBuilder::TextureBuilder(DeviceBase* device) : Builder(device) {
@@ -191,12 +449,81 @@ namespace backend {
             return nullptr;
         }
 
+        if (mNumMipLevels == 0) {
+            HandleError("Texture must have at least one mip level");
+            return nullptr;
+        }
+
         if (!TextureBase::IsUsagePossible(mAllowedUsage, mCurrentUsage)) {
             HandleError("Initial texture usage is not allowed");
             return nullptr;
         }
 
-        // TODO(cwallez@chromium.org): check stuff based on the dimension
+        if (!mDevice->IsTextureFormatSupported(mFormat)) {
+            HandleError("Texture format is not supported by the device");
+            return nullptr;
+        }
+
+        if (TextureFormatIsCompressed(mFormat)) {
+            if (mWidth % TextureFormatBlockWidth(mFormat) != 0 ||
+                mHeight % TextureFormatBlockHeight(mFormat) != 0) {
+                HandleError("Compressed texture size must be a multiple of the block size");
+                return nullptr;
+            }
+
+            const nxt::TextureUsageBit compressedUsages = nxt::TextureUsageBit::TransferSrc |
+                                                          nxt::TextureUsageBit::TransferDst |
+                                                          nxt::TextureUsageBit::Sampled;
+            if (mAllowedUsage & ~compressedUsages) {
+                HandleError("Compressed textures can only be used for transfers and sampling");
+                return nullptr;
+            }
+        }
+
+        if (mSampleCount > 1) {
+            // Multisampled textures are only rendered to and then resolved to single-sampled
+            // textures, which lets backends use storage that can't be sampled or copied.
+            if (mDimension != nxt::TextureDimension::e2D || mNumMipLevels != 1) {
+                HandleError("Multisampled textures must be 2D with a single mip level");
+                return nullptr;
+            }
+            if (mAllowedUsage & ~nxt::TextureUsageBit::OutputAttachment) {
+                HandleError("Multisampled textures can only be used as output attachments");
+                return nullptr;
+            }
+        }
+
+        switch (mDimension) {
+            case nxt::TextureDimension::e2D:
+                if (mDepth != 1) {
+                    HandleError("2D textures must have a depth of 1");
+                    return nullptr;
+                }
+                break;
+
+            case nxt::TextureDimension::e2DArray:
+            case nxt::TextureDimension::e3D: {
+                // Rendering to and storing in layers of textures isn't supported yet.
+                const nxt::TextureUsageBit layeredUsages = nxt::TextureUsageBit::TransferSrc |
+                                                           nxt::TextureUsageBit::TransferDst |
+                                                           nxt::TextureUsageBit::Sampled;
+                if (mAllowedUsage & ~layeredUsages) {
+                    HandleError(
+                        "Array and 3D textures can only be used for transfers and sampling");
+                    return nullptr;
+                }
+                bool hasBlockOrDepthFormat =
+                    TextureFormatIsCompressed(mFormat) || TextureFormatHasDepthOrStencil(mFormat);
+                if (mDimension == nxt::TextureDimension::e3D && hasBlockOrDepthFormat) {
+                    HandleError("3D textures can't have compressed or depth stencil formats");
+                    return nullptr;
+                }
+            } break;
+
+            default:
+                HandleError("Invalid texture dimension");
+                return nullptr;
+        }
 
         return mDevice->CreateTexture(this);
     }
@@ -248,6 +575,21 @@ namespace backend {
         mNumMipLevels = numMipLevels;
     }
 
+    void TextureBuilder::SetSampleCount(uint32_t sampleCount) {
+        if ((mPropertiesSet & TEXTURE_PROPERTY_SAMPLE_COUNT) != 0) {
+            HandleError("Texture sample count property set multiple times");
+            return;
+        }
+
+        if (!IsValidSampleCount(sampleCount)) {
+            HandleError("Texture sample count is not supported");
+            return;
+        }
+
+        mPropertiesSet |= TEXTURE_PROPERTY_SAMPLE_COUNT;
+        mSampleCount = sampleCount;
+    }
+
     void TextureBuilder::SetAllowedUsage(nxt::TextureUsageBit usage) {
         if ((mPropertiesSet & TEXTURE_PROPERTY_ALLOWED_USAGE) != 0) {
             HandleError("Texture allowed usage property set multiple times");
@@ -270,21 +612,116 @@ namespace backend {
 
     // TextureViewBase
 
-    TextureViewBase::TextureViewBase(TextureViewBuilder* builder) : mTexture(builder->mTexture) {
+    namespace {
+
+        bool IsFullView(const TextureBase* texture,
+                        nxt::TextureDimension dimension,
+                        uint32_t baseArrayLayer,
+                        uint32_t layerCount) {
+            return dimension == texture->GetDimension() && baseArrayLayer == 0 &&
+                   layerCount == texture->GetLevelDepth(0);
+        }
+
+    }  // anonymous namespace
+
+    TextureViewBase::TextureViewBase(TextureViewBuilder* builder)
+        : mTexture(builder->mTexture),
+          mDimension(builder->mDimension),
+          mBaseArrayLayer(builder->mBaseArrayLayer),
+          mLayerCount(builder->mLayerCount) {
     }
 
     TextureBase* TextureViewBase::GetTexture() {
         return mTexture.Get();
     }
 
+    nxt::TextureDimension TextureViewBase::GetDimension() const {
+        return mDimension;
+    }
+
+    uint32_t TextureViewBase::GetBaseArrayLayer() const {
+        return mBaseArrayLayer;
+    }
+
+    uint32_t TextureViewBase::GetLayerCount() const {
+        return mLayerCount;
+    }
+
+    bool TextureViewBase::IsFullTextureView() const {
+        return IsFullView(mTexture.Get(), mDimension, mBaseArrayLayer, mLayerCount);
+    }
+
     // TextureViewBuilder
 
+    enum TextureViewSetProperties {
+        TEXTURE_VIEW_PROPERTY_DIMENSION = 0x1,
+        TEXTURE_VIEW_PROPERTY_ARRAY_LAYERS = 0x2,
+    };
+
     TextureViewBuilder::TextureViewBuilder(DeviceBase* device, TextureBase* texture)
-        : Builder(device), mTexture(texture) {
+        : Builder(device),
+          mTexture(texture),
+          mDimension(texture->GetDimension()),
+          mLayerCount(texture->GetLevelDepth(0)) {
     }
 
     TextureViewBase* TextureViewBuilder::GetResultImpl() {
+        // Views of 2D array textures can be a single layer seen as a 2D texture or a range of
+        // layers, other textures can only be viewed whole.
+        bool dimensionCompatible = mDimension == mTexture->GetDimension() ||
+                                   (mDimension == nxt::TextureDimension::e2D &&
+                                    mTexture->GetDimension() == nxt::TextureDimension::e2DArray);
+        if (!dimensionCompatible) {
+            HandleError("Texture view dimension is incompatible with the texture");
+            return nullptr;
+        }
+
+        if ((mPropertiesSet & TEXTURE_VIEW_PROPERTY_ARRAY_LAYERS) != 0 &&
+            mTexture->GetDimension() != nxt::TextureDimension::e2DArray) {
+            HandleError("Only views of 2D array textures can select array layers");
+            return nullptr;
+        }
+
+        // Use 64 bit arithmetic to avoid overflows
+        if (mLayerCount == 0 || uint64_t(mBaseArrayLayer) + uint64_t(mLayerCount) >
+                                    uint64_t(mTexture->GetLevelDepth(0))) {
+            HandleError("Texture view array layers out of range");
+            return nullptr;
+        }
+
+        if (mDimension == nxt::TextureDimension::e2D && mLayerCount != 1) {
+            HandleError("2D texture views must have exactly one layer");
+            return nullptr;
+        }
+
+        if (!IsFullView(mTexture.Get(), mDimension, mBaseArrayLayer, mLayerCount) &&
+            !mDevice->IsPartialTextureViewSupported()) {
+            HandleError("Views of part of a texture aren't supported by this device");
+            return nullptr;
+        }
+
         return mDevice->CreateTextureView(this);
     }
 
+    void TextureViewBuilder::SetDimension(nxt::TextureDimension dimension) {
+        if ((mPropertiesSet & TEXTURE_VIEW_PROPERTY_DIMENSION) != 0) {
+            HandleError("Texture view dimension property set multiple times");
+            return;
+        }
+
+        mPropertiesSet |= TEXTURE_VIEW_PROPERTY_DIMENSION;
+        mDimension = dimension;
+    }
+
+    void TextureViewBuilder::SetArrayLayers(uint32_t baseArrayLayer, uint32_t layerCount) {
+        if ((mPropertiesSet & TEXTURE_VIEW_PROPERTY_ARRAY_LAYERS) != 0) {
+            HandleError("Texture view array layers property set multiple times");
+            return;
+        }
+
+        mPropertiesSet |= TEXTURE_VIEW_PROPERTY_ARRAY_LAYERS;
+        mBaseArrayLayer = baseArrayLayer;
+        mLayerCount = layerCount;
+    }
+
 }  // namespace backend
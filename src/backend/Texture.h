@@ -21,12 +21,25 @@
 
 #include "nxt/nxtcpp.h"
 
+#include <vector>
+
 namespace backend {
 
     uint32_t TextureFormatPixelSize(nxt::TextureFormat format);
+    bool TextureFormatIsCompressed(nxt::TextureFormat format);
+    // Compressed formats are stored in blocks of texels, uncompressed formats use 1x1 blocks.
+    uint32_t TextureFormatBlockWidth(nxt::TextureFormat format);
+    uint32_t TextureFormatBlockHeight(nxt::TextureFormat format);
+    uint32_t TextureFormatBlockSize(nxt::TextureFormat format);
+    // Bytes in a row of blocks covering `width` texels, and rows of blocks covering `height` texels
+    uint32_t ComputeTextureRowSize(nxt::TextureFormat format, uint32_t width);
+    uint32_t ComputeTextureRowCount(nxt::TextureFormat format, uint32_t height);
     bool TextureFormatHasDepth(nxt::TextureFormat format);
     bool TextureFormatHasStencil(nxt::TextureFormat format);
     bool TextureFormatHasDepthOrStencil(nxt::TextureFormat format);
+    bool TextureFormatIsFilterable(nxt::TextureFormat format);
+    // Sample counts that all the backends support for rendering
+    bool IsValidSampleCount(uint32_t sampleCount);
 
     class TextureBase : public RefCounted {
       public:
@@ -37,25 +50,69 @@ namespace backend {
         uint32_t GetWidth() const;
         uint32_t GetHeight() const;
         uint32_t GetDepth() const;
+        // The depth of a level of 3D textures, or the number of layers of 2D array textures
+        uint32_t GetLevelDepth(uint32_t level) const;
         uint32_t GetNumMipLevels() const;
+        uint32_t GetSampleCount() const;
         nxt::TextureUsageBit GetAllowedUsage() const;
+        // The usage is tracked per mip level. GetUsage can only be used when all the levels are
+        // in the same usage, for example for single-level textures or frozen textures.
         nxt::TextureUsageBit GetUsage() const;
+        nxt::TextureUsageBit GetLevelUsage(uint32_t level) const;
+
+        // Consecutive levels in the same usage, that backends can transition with a single barrier
+        struct LevelUsageRange {
+            uint32_t baseLevel;
+            uint32_t levelCount;
+            nxt::TextureUsageBit usage;
+        };
+        std::vector<LevelUsageRange> GetLevelUsageRanges(uint32_t baseLevel,
+                                                         uint32_t levelCount) const;
         bool IsFrozen() const;
         bool HasFrozenUsage(nxt::TextureUsageBit usage) const;
         static bool IsUsagePossible(nxt::TextureUsageBit allowedUsage, nxt::TextureUsageBit usage);
         bool IsTransitionPossible(nxt::TextureUsageBit usage) const;
+        bool IsRegionBlockAligned(uint32_t level,
+                                  uint32_t x,
+                                  uint32_t y,
+                                  uint32_t width,
+                                  uint32_t height) const;
         void UpdateUsageInternal(nxt::TextureUsageBit usage);
+        void UpdateLevelsUsageInternal(uint32_t baseLevel,
+                                       uint32_t levelCount,
+                                       nxt::TextureUsageBit usage);
 
         DeviceBase* GetDevice() const;
 
         // NXT API
         TextureViewBuilder* CreateTextureViewBuilder();
+        void SetSubData(uint32_t level,
+                        uint32_t x,
+                        uint32_t y,
+                        uint32_t width,
+                        uint32_t height,
+                        uint32_t rowPitch,
+                        uint32_t size,
+                        const uint8_t* data);
         void TransitionUsage(nxt::TextureUsageBit usage);
         void FreezeUsage(nxt::TextureUsageBit usage);
 
-        virtual void TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+        // Transitions levels [baseLevel, baseLevel + levelCount) that are all in currentUsage.
+        virtual void TransitionUsageImpl(uint32_t baseLevel,
+                                         uint32_t levelCount,
+                                         nxt::TextureUsageBit currentUsage,
                                          nxt::TextureUsageBit targetUsage) = 0;
 
+      protected:
+        // The region has been validated to fit in the mip level and rowPitch is never 0.
+        virtual void SetSubDataImpl(uint32_t level,
+                                    uint32_t x,
+                                    uint32_t y,
+                                    uint32_t width,
+                                    uint32_t height,
+                                    uint32_t rowPitch,
+                                    const uint8_t* data) = 0;
+
       private:
         DeviceBase* mDevice;
 
@@ -63,8 +120,9 @@ namespace backend {
         nxt::TextureFormat mFormat;
         uint32_t mWidth, mHeight, mDepth;
         uint32_t mNumMipLevels;
+        uint32_t mSampleCount;
         nxt::TextureUsageBit mAllowedUsage = nxt::TextureUsageBit::None;
-        nxt::TextureUsageBit mCurrentUsage = nxt::TextureUsageBit::None;
+        std::vector<nxt::TextureUsageBit> mLevelUsages;
         bool mIsFrozen = false;
     };
 
@@ -77,6 +135,7 @@ namespace backend {
         void SetExtent(uint32_t width, uint32_t height, uint32_t depth);
         void SetFormat(nxt::TextureFormat format);
         void SetMipLevels(uint32_t numMipLevels);
+        void SetSampleCount(uint32_t sampleCount);
         void SetAllowedUsage(nxt::TextureUsageBit usage);
         void SetInitialUsage(nxt::TextureUsageBit usage);
 
@@ -91,6 +150,7 @@ namespace backend {
         uint32_t mWidth, mHeight, mDepth;
         nxt::TextureFormat mFormat;
         uint32_t mNumMipLevels;
+        uint32_t mSampleCount = 1;
         nxt::TextureUsageBit mAllowedUsage = nxt::TextureUsageBit::None;
         nxt::TextureUsageBit mCurrentUsage = nxt::TextureUsageBit::None;
     };
@@ -100,21 +160,39 @@ namespace backend {
         TextureViewBase(TextureViewBuilder* builder);
 
         TextureBase* GetTexture();
+        nxt::TextureDimension GetDimension() const;
+        uint32_t GetBaseArrayLayer() const;
+        uint32_t GetLayerCount() const;
+        // Whether the view covers the whole texture with the texture's dimension, in which case
+        // backends can use the texture directly.
+        bool IsFullTextureView() const;
 
       private:
         Ref<TextureBase> mTexture;
+        nxt::TextureDimension mDimension;
+        uint32_t mBaseArrayLayer;
+        uint32_t mLayerCount;
     };
 
     class TextureViewBuilder : public Builder<TextureViewBase> {
       public:
         TextureViewBuilder(DeviceBase* device, TextureBase* texture);
 
+        // NXT API
+        void SetDimension(nxt::TextureDimension dimension);
+        void SetArrayLayers(uint32_t baseArrayLayer, uint32_t layerCount);
+
       private:
         friend class TextureViewBase;
 
         TextureViewBase* GetResultImpl() override;
 
+        int mPropertiesSet = 0;
+
         Ref<TextureBase> mTexture;
+        nxt::TextureDimension mDimension;
+        uint32_t mBaseArrayLayer = 0;
+        uint32_t mLayerCount;
     };
 
 }  // namespace backend
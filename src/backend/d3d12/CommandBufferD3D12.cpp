@@ -34,6 +34,51 @@
 namespace backend { namespace d3d12 {
 
     namespace {
+        // Splits a buffer <-> texture copy into the pieces that can each be expressed as a
+        // single call to ComputeTextureCopySplit. Each layer of a 2D array texture is its own
+        // subresource, so layers are copied one by one. 3D textures are copied in one go when
+        // the buffer offset is aligned, and slice by slice otherwise because the copy split
+        // would skew the slice pitch of the footprint.
+        struct TextureCopySlices {
+            TextureCopySlices(Texture* texture,
+                              const TextureCopyLocation& location,
+                              uint32_t bufferOffset,
+                              uint32_t rowPitch)
+                : texture(texture), location(location), bufferOffset(bufferOffset) {
+                imageSize =
+                    rowPitch * ComputeTextureRowCount(texture->GetFormat(), location.height);
+                bool copyAllSlices = texture->GetDimension() != nxt::TextureDimension::e2DArray &&
+                                     bufferOffset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT == 0;
+                count = copyAllSlices ? 1 : location.depth;
+                depthPerSlice = copyAllSlices ? location.depth : 1;
+            }
+
+            uint32_t GetSubresource(uint32_t slice) const {
+                if (texture->GetDimension() == nxt::TextureDimension::e2DArray) {
+                    return location.level + (location.z + slice) * texture->GetNumMipLevels();
+                }
+                return location.level;
+            }
+
+            uint32_t GetZ(uint32_t slice) const {
+                if (texture->GetDimension() == nxt::TextureDimension::e2DArray) {
+                    return 0;
+                }
+                return location.z + slice;
+            }
+
+            uint32_t GetBufferOffset(uint32_t slice) const {
+                return bufferOffset + slice * imageSize;
+            }
+
+            Texture* texture;
+            const TextureCopyLocation& location;
+            uint32_t bufferOffset;
+            uint32_t imageSize;
+            uint32_t count;
+            uint32_t depthPerSlice;
+        };
+
         DXGI_FORMAT DXGIIndexFormat(nxt::IndexFormat format) {
             switch (format) {
                 case nxt::IndexFormat::Uint16:
@@ -252,6 +297,7 @@ namespace backend { namespace d3d12 {
         }
 
         Command type;
+        BufferCopyBatch bufferCopies;
         RenderPipeline* lastRenderPipeline = nullptr;
         PipelineLayout* lastLayout = nullptr;
 
@@ -272,15 +318,6 @@ namespace backend { namespace d3d12 {
                     currentRenderPass = ToBackend(beginRenderPassCmd->renderPass.Get());
                     currentFramebuffer = ToBackend(beginRenderPassCmd->framebuffer.Get());
                     currentSubpass = 0;
-
-                    uint32_t width = currentFramebuffer->GetWidth();
-                    uint32_t height = currentFramebuffer->GetHeight();
-                    D3D12_VIEWPORT viewport = {
-                        0.f, 0.f, static_cast<float>(width), static_cast<float>(height), 0.f, 1.f};
-                    D3D12_RECT scissorRect = {0, 0, static_cast<long>(width),
-                                              static_cast<long>(height)};
-                    commandList->RSSetViewports(1, &viewport);
-                    commandList->RSSetScissorRects(1, &scissorRect);
                 } break;
 
                 case Command::BeginRenderSubpass: {
@@ -310,8 +347,8 @@ namespace backend { namespace d3d12 {
                         // It's already validated that this texture is either frozen to the correct
                         // usage, or not frozen.
                         if (!texture->IsFrozen()) {
-                            texture->TransitionUsageImpl(texture->GetUsage(), usage);
-                            texture->UpdateUsageInternal(usage);
+                            texture->TransitionLevelsNow(commandList, 0,
+                                                         texture->GetNumMipLevels(), usage);
                         }
 
                         // Only perform load op on first use
@@ -362,56 +399,77 @@ namespace backend { namespace d3d12 {
 
                     static constexpr std::array<float, 4> defaultBlendFactor = {0, 0, 0, 0};
                     commandList->OMSetBlendFactor(&defaultBlendFactor[0]);
+
+                    // The viewport and scissor are reset to the whole framebuffer for each
+                    // subpass.
+                    uint32_t width = currentFramebuffer->GetWidth();
+                    uint32_t height = currentFramebuffer->GetHeight();
+                    D3D12_VIEWPORT viewport = {
+                        0.f, 0.f, static_cast<float>(width), static_cast<float>(height), 0.f, 1.f};
+                    D3D12_RECT scissorRect = {0, 0, static_cast<long>(width),
+                                              static_cast<long>(height)};
+                    commandList->RSSetViewports(1, &viewport);
+                    commandList->RSSetScissorRects(1, &scissorRect);
                 } break;
 
                 case Command::CopyBufferToBuffer: {
                     CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    auto src = ToBackend(copy->source.buffer.Get())->GetD3D12Resource();
-                    auto dst = ToBackend(copy->destination.buffer.Get())->GetD3D12Resource();
-                    commandList->CopyBufferRegion(dst.Get(), copy->destination.offset, src.Get(),
-                                                  copy->source.offset, copy->size);
+                    GatherBufferCopies(&mCommands, copy, &bufferCopies);
+                    mDevice->CountBufferCopies(bufferCopies.commandCount,
+                                               static_cast<uint32_t>(bufferCopies.regions.size()));
+
+                    auto src = ToBackend(bufferCopies.source)->GetD3D12Resource();
+                    auto dst = ToBackend(bufferCopies.destination)->GetD3D12Resource();
+                    for (const auto& region : bufferCopies.regions) {
+                        commandList->CopyBufferRegion(dst.Get(), region.destinationOffset,
+                                                      src.Get(), region.sourceOffset, region.size);
+                    }
                 } break;
 
                 case Command::CopyBufferToTexture: {
                     CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
                     Buffer* buffer = ToBackend(copy->source.buffer.Get());
                     Texture* texture = ToBackend(copy->destination.texture.Get());
-
-                    auto copySplit = ComputeTextureCopySplit(
-                        copy->destination.x, copy->destination.y, copy->destination.z,
-                        copy->destination.width, copy->destination.height, copy->destination.depth,
-                        static_cast<uint32_t>(TextureFormatPixelSize(texture->GetFormat())),
-                        copy->source.offset, copy->rowPitch);
-
-                    D3D12_TEXTURE_COPY_LOCATION textureLocation;
-                    textureLocation.pResource = texture->GetD3D12Resource();
-                    textureLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-                    textureLocation.SubresourceIndex = copy->destination.level;
-
-                    for (uint32_t i = 0; i < copySplit.count; ++i) {
-                        auto& info = copySplit.copies[i];
-
-                        D3D12_TEXTURE_COPY_LOCATION bufferLocation;
-                        bufferLocation.pResource = buffer->GetD3D12Resource().Get();
-                        bufferLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-                        bufferLocation.PlacedFootprint.Offset = copySplit.offset;
-                        bufferLocation.PlacedFootprint.Footprint.Format = texture->GetD3D12Format();
-                        bufferLocation.PlacedFootprint.Footprint.Width = info.bufferSize.width;
-                        bufferLocation.PlacedFootprint.Footprint.Height = info.bufferSize.height;
-                        bufferLocation.PlacedFootprint.Footprint.Depth = info.bufferSize.depth;
-                        bufferLocation.PlacedFootprint.Footprint.RowPitch = copy->rowPitch;
-
-                        D3D12_BOX sourceRegion;
-                        sourceRegion.left = info.bufferOffset.x;
-                        sourceRegion.top = info.bufferOffset.y;
-                        sourceRegion.front = info.bufferOffset.z;
-                        sourceRegion.right = info.bufferOffset.x + info.copySize.width;
-                        sourceRegion.bottom = info.bufferOffset.y + info.copySize.height;
-                        sourceRegion.back = info.bufferOffset.z + info.copySize.depth;
-
-                        commandList->CopyTextureRegion(&textureLocation, info.textureOffset.x,
-                                                       info.textureOffset.y, info.textureOffset.z,
-                                                       &bufferLocation, &sourceRegion);
+                    auto& dst = copy->destination;
+
+                    TextureCopySlices slices(texture, dst, copy->source.offset, copy->rowPitch);
+                    for (uint32_t slice = 0; slice < slices.count; ++slice) {
+                        auto copySplit = ComputeTextureCopySplitForFormat(
+                            dst.x, dst.y, slices.GetZ(slice), dst.width, dst.height,
+                            slices.depthPerSlice, texture->GetFormat(),
+                            slices.GetBufferOffset(slice), copy->rowPitch);
+
+                        D3D12_TEXTURE_COPY_LOCATION textureLocation;
+                        textureLocation.pResource = texture->GetD3D12Resource();
+                        textureLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                        textureLocation.SubresourceIndex = slices.GetSubresource(slice);
+
+                        for (uint32_t i = 0; i < copySplit.count; ++i) {
+                            auto& info = copySplit.copies[i];
+
+                            D3D12_TEXTURE_COPY_LOCATION bufferLocation;
+                            bufferLocation.pResource = buffer->GetD3D12Resource().Get();
+                            bufferLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                            bufferLocation.PlacedFootprint.Offset = copySplit.offset;
+                            auto& footprint = bufferLocation.PlacedFootprint.Footprint;
+                            footprint.Format = texture->GetD3D12Format();
+                            footprint.Width = info.bufferSize.width;
+                            footprint.Height = info.bufferSize.height;
+                            footprint.Depth = info.bufferSize.depth;
+                            footprint.RowPitch = copy->rowPitch;
+
+                            D3D12_BOX sourceRegion;
+                            sourceRegion.left = info.bufferOffset.x;
+                            sourceRegion.top = info.bufferOffset.y;
+                            sourceRegion.front = info.bufferOffset.z;
+                            sourceRegion.right = info.bufferOffset.x + info.copySize.width;
+                            sourceRegion.bottom = info.bufferOffset.y + info.copySize.height;
+                            sourceRegion.back = info.bufferOffset.z + info.copySize.depth;
+
+                            commandList->CopyTextureRegion(
+                                &textureLocation, info.textureOffset.x, info.textureOffset.y,
+                                info.textureOffset.z, &bufferLocation, &sourceRegion);
+                        }
                     }
                 } break;
 
@@ -419,42 +477,47 @@ namespace backend { namespace d3d12 {
                     CopyTextureToBufferCmd* copy = mCommands.NextCommand<CopyTextureToBufferCmd>();
                     Texture* texture = ToBackend(copy->source.texture.Get());
                     Buffer* buffer = ToBackend(copy->destination.buffer.Get());
-
-                    auto copySplit = ComputeTextureCopySplit(
-                        copy->source.x, copy->source.y, copy->source.z, copy->source.width,
-                        copy->source.height, copy->source.depth,
-                        static_cast<uint32_t>(TextureFormatPixelSize(texture->GetFormat())),
-                        copy->destination.offset, copy->rowPitch);
-
-                    D3D12_TEXTURE_COPY_LOCATION textureLocation;
-                    textureLocation.pResource = texture->GetD3D12Resource();
-                    textureLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-                    textureLocation.SubresourceIndex = copy->source.level;
-
-                    for (uint32_t i = 0; i < copySplit.count; ++i) {
-                        auto& info = copySplit.copies[i];
-
-                        D3D12_TEXTURE_COPY_LOCATION bufferLocation;
-                        bufferLocation.pResource = buffer->GetD3D12Resource().Get();
-                        bufferLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-                        bufferLocation.PlacedFootprint.Offset = copySplit.offset;
-                        bufferLocation.PlacedFootprint.Footprint.Format = texture->GetD3D12Format();
-                        bufferLocation.PlacedFootprint.Footprint.Width = info.bufferSize.width;
-                        bufferLocation.PlacedFootprint.Footprint.Height = info.bufferSize.height;
-                        bufferLocation.PlacedFootprint.Footprint.Depth = info.bufferSize.depth;
-                        bufferLocation.PlacedFootprint.Footprint.RowPitch = copy->rowPitch;
-
-                        D3D12_BOX sourceRegion;
-                        sourceRegion.left = info.textureOffset.x;
-                        sourceRegion.top = info.textureOffset.y;
-                        sourceRegion.front = info.textureOffset.z;
-                        sourceRegion.right = info.textureOffset.x + info.copySize.width;
-                        sourceRegion.bottom = info.textureOffset.y + info.copySize.height;
-                        sourceRegion.back = info.textureOffset.z + info.copySize.depth;
-
-                        commandList->CopyTextureRegion(&bufferLocation, info.bufferOffset.x,
-                                                       info.bufferOffset.y, info.bufferOffset.z,
-                                                       &textureLocation, &sourceRegion);
+                    auto& src = copy->source;
+
+                    TextureCopySlices slices(texture, src, copy->destination.offset,
+                                             copy->rowPitch);
+                    for (uint32_t slice = 0; slice < slices.count; ++slice) {
+                        auto copySplit = ComputeTextureCopySplitForFormat(
+                            src.x, src.y, slices.GetZ(slice), src.width, src.height,
+                            slices.depthPerSlice, texture->GetFormat(),
+                            slices.GetBufferOffset(slice), copy->rowPitch);
+
+                        D3D12_TEXTURE_COPY_LOCATION textureLocation;
+                        textureLocation.pResource = texture->GetD3D12Resource();
+                        textureLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                        textureLocation.SubresourceIndex = slices.GetSubresource(slice);
+
+                        for (uint32_t i = 0; i < copySplit.count; ++i) {
+                            auto& info = copySplit.copies[i];
+
+                            D3D12_TEXTURE_COPY_LOCATION bufferLocation;
+                            bufferLocation.pResource = buffer->GetD3D12Resource().Get();
+                            bufferLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                            bufferLocation.PlacedFootprint.Offset = copySplit.offset;
+                            auto& footprint = bufferLocation.PlacedFootprint.Footprint;
+                            footprint.Format = texture->GetD3D12Format();
+                            footprint.Width = info.bufferSize.width;
+                            footprint.Height = info.bufferSize.height;
+                            footprint.Depth = info.bufferSize.depth;
+                            footprint.RowPitch = copy->rowPitch;
+
+                            D3D12_BOX sourceRegion;
+                            sourceRegion.left = info.textureOffset.x;
+                            sourceRegion.top = info.textureOffset.y;
+                            sourceRegion.front = info.textureOffset.z;
+                            sourceRegion.right = info.textureOffset.x + info.copySize.width;
+                            sourceRegion.bottom = info.textureOffset.y + info.copySize.height;
+                            sourceRegion.back = info.textureOffset.z + info.copySize.depth;
+
+                            commandList->CopyTextureRegion(
+                                &bufferLocation, info.bufferOffset.x, info.bufferOffset.y,
+                                info.bufferOffset.z, &textureLocation, &sourceRegion);
+                        }
                     }
                 } break;
 
@@ -487,9 +550,80 @@ namespace backend { namespace d3d12 {
 
                 case Command::EndRenderSubpass: {
                     mCommands.NextCommand<EndRenderSubpassCmd>();
+                    const auto& subpass = currentRenderPass->GetSubpassInfo(currentSubpass);
+
+                    // Resolve before the multisampled attachments can be discarded below.
+                    for (unsigned int location : IterateBitSet(subpass.resolveAttachmentsSet)) {
+                        Texture* source = ToBackend(
+                            currentFramebuffer->GetTextureView(subpass.colorAttachments[location])
+                                ->GetTexture());
+                        Texture* target = ToBackend(
+                            currentFramebuffer->GetTextureView(subpass.resolveAttachments[location])
+                                ->GetTexture());
+                        source->RecordResolve(commandList, target);
+                    }
+
+                    // Store op - discard the attachments after their last use
+                    for (unsigned int location : IterateBitSet(subpass.colorAttachmentsSet)) {
+                        uint32_t attachmentSlot = subpass.colorAttachments[location];
+                        const auto& attachmentInfo =
+                            currentRenderPass->GetAttachmentInfo(attachmentSlot);
+                        if (attachmentInfo.lastSubpass == currentSubpass &&
+                            attachmentInfo.colorStoreOp == nxt::StoreOp::Discard) {
+                            Texture* texture = ToBackend(
+                                currentFramebuffer->GetTextureView(attachmentSlot)->GetTexture());
+                            commandList->DiscardResource(texture->GetD3D12Resource(), nullptr);
+                        }
+                    }
+
+                    if (subpass.depthStencilAttachmentSet) {
+                        uint32_t attachmentSlot = subpass.depthStencilAttachment;
+                        const auto& attachmentInfo =
+                            currentRenderPass->GetAttachmentInfo(attachmentSlot);
+
+                        // DiscardResource discards both depth and stencil so it is only used
+                        // when none of them is stored.
+                        bool storeDepth = TextureFormatHasDepth(attachmentInfo.format) &&
+                                          attachmentInfo.depthStoreOp == nxt::StoreOp::Store;
+                        bool storeStencil = TextureFormatHasStencil(attachmentInfo.format) &&
+                                            attachmentInfo.stencilStoreOp == nxt::StoreOp::Store;
+                        if (attachmentInfo.lastSubpass == currentSubpass && !storeDepth &&
+                            !storeStencil) {
+                            Texture* texture = ToBackend(
+                                currentFramebuffer->GetTextureView(attachmentSlot)->GetTexture());
+                            commandList->DiscardResource(texture->GetD3D12Resource(), nullptr);
+                        }
+                    }
+
                     currentSubpass += 1;
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    // Rejected at validation, see Device::IsMipmapGenerationSupported.
+                    mCommands.NextCommand<GenerateMipmapsCmd>();
+                    UNREACHABLE();
+                } break;
+
+                case Command::MultiDrawArrays: {
+                    MultiDrawArraysCmd* draw = mCommands.NextCommand<MultiDrawArraysCmd>();
+                    uint32_t* vertexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstVertices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        commandList->DrawInstanced(vertexCounts[i], draw->instanceCount,
+                                                   firstVertices[i], draw->firstInstance);
+                    }
+                } break;
+
+                case Command::MultiDrawElements: {
+                    MultiDrawElementsCmd* draw = mCommands.NextCommand<MultiDrawElementsCmd>();
+                    uint32_t* indexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstIndices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        commandList->DrawIndexedInstanced(indexCounts[i], draw->instanceCount,
+                                                          firstIndices[i], 0, draw->firstInstance);
+                    }
+                } break;
+
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
                     ComputePipeline* pipeline = ToBackend(cmd->pipeline).Get();
@@ -534,6 +668,21 @@ namespace backend { namespace d3d12 {
                     commandList->OMSetBlendFactor(static_cast<const FLOAT*>(&cmd->r));
                 } break;
 
+                case Command::SetViewport: {
+                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
+                    D3D12_VIEWPORT viewport = {cmd->x,     cmd->y,        cmd->width,
+                                               cmd->height, cmd->minDepth, cmd->maxDepth};
+                    commandList->RSSetViewports(1, &viewport);
+                } break;
+
+                case Command::SetScissorRect: {
+                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
+                    D3D12_RECT scissorRect = {static_cast<long>(cmd->x), static_cast<long>(cmd->y),
+                                              static_cast<long>(cmd->x + cmd->width),
+                                              static_cast<long>(cmd->y + cmd->height)};
+                    commandList->RSSetScissorRects(1, &scissorRect);
+                } break;
+
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
                     BindGroup* group = ToBackend(cmd->group.Get());
@@ -595,14 +744,8 @@ namespace backend { namespace d3d12 {
                         mCommands.NextCommand<TransitionTextureUsageCmd>();
 
                     Texture* texture = ToBackend(cmd->texture.Get());
-
-                    D3D12_RESOURCE_BARRIER barrier;
-                    if (texture->GetResourceTransitionBarrier(texture->GetUsage(), cmd->usage,
-                                                              &barrier)) {
-                        commandList->ResourceBarrier(1, &barrier);
-                    }
-
-                    texture->UpdateUsageInternal(cmd->usage);
+                    texture->TransitionLevelsNow(commandList, cmd->baseLevel, cmd->levelCount,
+                                                 cmd->usage);
                 } break;
             }
         }
@@ -33,16 +33,16 @@ namespace backend { namespace d3d12 {
         // SPRIV-cross does matrix multiplication expecting row major matrices
         compileFlags |= D3DCOMPILE_PACK_MATRIX_ROW_MAJOR;
 
-        const auto& module = ToBackend(builder->GetStageInfo(nxt::ShaderStage::Compute).module);
-        const auto& entryPoint = builder->GetStageInfo(nxt::ShaderStage::Compute).entryPoint;
-        const auto& hlslSource = module->GetHLSLSource();
+        const auto& stageInfo = builder->GetStageInfo(nxt::ShaderStage::Compute);
+        const auto& module = ToBackend(stageInfo.module);
+        const std::string hlslSource =
+            module->GetHLSLSource(stageInfo.entryPoint, stageInfo.specialization);
 
         ComPtr<ID3DBlob> compiledShader;
         ComPtr<ID3DBlob> errors;
 
         if (FAILED(D3DCompile(hlslSource.c_str(), hlslSource.length(), nullptr, {nullptr}, nullptr,
-                              entryPoint.c_str(), "cs_5_1", compileFlags, 0, &compiledShader,
-                              &errors))) {
+                              "main", "cs_5_1", compileFlags, 0, &compiledShader, &errors))) {
             printf("%s\n", reinterpret_cast<char*>(errors->GetBufferPointer()));
             ASSERT(false);
         }
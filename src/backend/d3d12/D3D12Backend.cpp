@@ -172,6 +172,24 @@ namespace backend { namespace d3d12 {
         NextSerial();
     }
 
+    bool Device::IsTextureFormatSupported(nxt::TextureFormat format) const {
+        // All feature levels we run on support the BC formats, but D3D12 has no ETC2.
+        switch (format) {
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return false;
+            default:
+                return true;
+        }
+    }
+
+    bool Device::IsMipmapGenerationSupported() const {
+        // D3D12 has no fixed-function mipmap generation and the backend doesn't support compute
+        // pipelines yet to implement it with a downsampling shader.
+        return false;
+    }
+
     uint64_t Device::GetSerial() const {
         return mSerial;
     }
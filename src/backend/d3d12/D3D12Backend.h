@@ -110,6 +110,8 @@ namespace backend { namespace d3d12 {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        bool IsTextureFormatSupported(nxt::TextureFormat format) const override;
+        bool IsMipmapGenerationSupported() const override;
 
         ComPtr<ID3D12Device> GetD3D12Device();
         ComPtr<ID3D12CommandQueue> GetCommandQueue();
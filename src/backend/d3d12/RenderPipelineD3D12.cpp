@@ -79,9 +79,10 @@ namespace backend { namespace d3d12 {
         ComPtr<ID3DBlob> errors;
 
         for (auto stage : IterateStages(GetStageMask())) {
-            const auto& module = ToBackend(builder->GetStageInfo(stage).module);
-            const auto& entryPoint = builder->GetStageInfo(stage).entryPoint;
-            const auto& hlslSource = module->GetHLSLSource();
+            const auto& stageInfo = builder->GetStageInfo(stage);
+            const auto& module = ToBackend(stageInfo.module);
+            const std::string hlslSource =
+                module->GetHLSLSource(stageInfo.entryPoint, stageInfo.specialization);
 
             const char* compileTarget = nullptr;
 
@@ -101,7 +102,7 @@ namespace backend { namespace d3d12 {
             }
 
             if (FAILED(D3DCompile(hlslSource.c_str(), hlslSource.length(), nullptr, nullptr,
-                                  nullptr, entryPoint.c_str(), compileTarget, compileFlags, 0,
+                                  nullptr, "main", compileTarget, compileFlags, 0,
                                   &compiledShader[stage], &errors))) {
                 printf("%s\n", reinterpret_cast<char*>(errors->GetBufferPointer()));
                 ASSERT(false);
@@ -164,7 +165,7 @@ namespace backend { namespace d3d12 {
 
         descriptor.SampleMask = UINT_MAX;
         descriptor.PrimitiveTopologyType = D3D12PrimitiveTopologyType(GetPrimitiveTopology());
-        descriptor.SampleDesc.Count = 1;
+        descriptor.SampleDesc.Count = GetSampleCount();
 
         Device* device = ToBackend(builder->GetDevice());
         ASSERT_SUCCESS(device->GetD3D12Device()->CreateGraphicsPipelineState(
@@ -16,6 +16,8 @@
 
 #include "backend/d3d12/D3D12Backend.h"
 #include "backend/d3d12/ResourceAllocator.h"
+#include "backend/d3d12/TextureD3D12.h"
+#include "common/Math.h"
 
 namespace backend { namespace d3d12 {
 
@@ -37,6 +39,51 @@ namespace backend { namespace d3d12 {
         Release(uploadHandle);
     }
 
+    void ResourceUploader::TextureSubData(Texture* texture,
+                                          uint32_t level,
+                                          uint32_t x,
+                                          uint32_t y,
+                                          uint32_t width,
+                                          uint32_t height,
+                                          uint32_t rowPitch,
+                                          const uint8_t* data) {
+        // D3D12 requires the row pitch of the upload buffer to be aligned, repack the rows while
+        // copying them in the upload buffer. For compressed formats a row is a row of blocks.
+        nxt::TextureFormat format = texture->GetFormat();
+        uint32_t rowSize = ComputeTextureRowSize(format, width);
+        uint32_t rowCount = ComputeTextureRowCount(format, height);
+        uint32_t uploadRowPitch = Align(rowSize, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+
+        UploadHandle uploadHandle = GetUploadBuffer(uploadRowPitch * rowCount);
+        for (uint32_t row = 0; row < rowCount; ++row) {
+            memcpy(uploadHandle.mappedBuffer + row * uploadRowPitch, data + row * rowPitch,
+                   rowSize);
+        }
+
+        D3D12_TEXTURE_COPY_LOCATION textureLocation;
+        textureLocation.pResource = texture->GetD3D12Resource();
+        textureLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        textureLocation.SubresourceIndex = level;
+
+        D3D12_TEXTURE_COPY_LOCATION bufferLocation;
+        bufferLocation.pResource = uploadHandle.resource.Get();
+        bufferLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        bufferLocation.PlacedFootprint.Offset = 0;
+        bufferLocation.PlacedFootprint.Footprint.Format = texture->GetD3D12Format();
+        // The footprint of compressed formats covers whole blocks.
+        bufferLocation.PlacedFootprint.Footprint.Width =
+            Align(width, TextureFormatBlockWidth(format));
+        bufferLocation.PlacedFootprint.Footprint.Height = rowCount * TextureFormatBlockHeight(format);
+        bufferLocation.PlacedFootprint.Footprint.Depth = 1;
+        bufferLocation.PlacedFootprint.Footprint.RowPitch = uploadRowPitch;
+
+        // The frontend checked the texture has the TransferDst usage so it is in the COPY_DEST
+        // state
+        mDevice->GetPendingCommandList()->CopyTextureRegion(&textureLocation, x, y, 0,
+                                                            &bufferLocation, nullptr);
+        Release(uploadHandle);
+    }
+
     ResourceUploader::UploadHandle ResourceUploader::GetUploadBuffer(uint32_t requiredSize) {
         // TODO(enga@google.com): This will find or create a mapped buffer of sufficient size and
         // return a handle to a mapped range
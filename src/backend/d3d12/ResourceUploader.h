@@ -22,6 +22,7 @@
 namespace backend { namespace d3d12 {
 
     class Device;
+    class Texture;
 
     class ResourceUploader {
       public:
@@ -31,6 +32,14 @@ namespace backend { namespace d3d12 {
                            uint32_t start,
                            uint32_t count,
                            const void* data);
+        void TextureSubData(Texture* texture,
+                            uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data);
 
       private:
         struct UploadHandle {
@@ -20,7 +20,13 @@ namespace backend { namespace d3d12 {
 
     ShaderModule::ShaderModule(Device* device, ShaderModuleBuilder* builder)
         : ShaderModuleBase(builder), mDevice(device) {
-        spirv_cross::CompilerHLSL compiler(builder->AcquireSpirv());
+    }
+
+    std::string ShaderModule::GetHLSLSource(const std::string& entryPoint,
+                                            const SpecializationValues& specialization) const {
+        spirv_cross::CompilerHLSL compiler(GetSpirv());
+        SelectEntryPoint(&compiler, entryPoint);
+        ApplySpecialization(&compiler, specialization);
 
         spirv_cross::CompilerGLSL::Options options_glsl;
         options_glsl.vertex.flip_vert_y = false;
@@ -31,8 +37,6 @@ namespace backend { namespace d3d12 {
         options_hlsl.shader_model = 51;
         compiler.spirv_cross::CompilerHLSL::set_options(options_hlsl);
 
-        ExtractSpirvInfo(compiler);
-
         // rename bindings so that each register type b/u/t/s starts at 0 and then offset by
         // kMaxBindingsPerGroup * bindGroupIndex
         auto RenumberBindings = [&](std::vector<spirv_cross::Resource> resources) {
@@ -54,11 +58,7 @@ namespace backend { namespace d3d12 {
         RenumberBindings(resources.separate_images);    // t
         RenumberBindings(resources.separate_samplers);  // s
 
-        mHlslSource = compiler.compile();
-    }
-
-    const std::string& ShaderModule::GetHLSLSource() const {
-        return mHlslSource;
+        return compiler.compile();
     }
 
 }}  // namespace backend::d3d12
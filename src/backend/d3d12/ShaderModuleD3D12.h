@@ -25,12 +25,12 @@ namespace backend { namespace d3d12 {
       public:
         ShaderModule(Device* device, ShaderModuleBuilder* builder);
 
-        const std::string& GetHLSLSource() const;
+        // SPIRV-Cross always names the HLSL entry point main().
+        std::string GetHLSLSource(const std::string& entryPoint,
+                                  const SpecializationValues& specialization) const;
 
       private:
         Device* mDevice;
-
-        std::string mHlslSource;
     };
 
 }}  // namespace backend::d3d12
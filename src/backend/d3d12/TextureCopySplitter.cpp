@@ -14,6 +14,7 @@
 
 #include "backend/d3d12/TextureCopySplitter.h"
 
+#include "backend/Texture.h"
 #include "backend/d3d12/d3d12_platform.h"
 #include "common/Assert.h"
 
@@ -49,16 +50,15 @@ namespace backend { namespace d3d12 {
                                              uint32_t rowPitch) {
         TextureCopySplit copy;
 
-        if (z != 0 || depth > 1) {
-            // TODO(enga@google.com): Handle 3D / 2D arrays
-            ASSERT(false);
-            return copy;
-        }
-
         ASSERT(rowPitch % texelSize == 0);
 
         uint32_t alignedOffset = offset & ~(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
 
+        // When the offset isn't aligned, the footprint is moved back to the aligned offset, which
+        // would skew the slice pitch of the footprint. Callers copy such regions one slice at a
+        // time.
+        ASSERT(depth == 1 || offset == alignedOffset);
+
         copy.offset = alignedOffset;
         if (offset == alignedOffset) {
             copy.count = 1;
@@ -206,4 +206,37 @@ namespace backend { namespace d3d12 {
         return copy;
     }
 
+    TextureCopySplit ComputeTextureCopySplitForFormat(uint32_t x,
+                                                      uint32_t y,
+                                                      uint32_t z,
+                                                      uint32_t width,
+                                                      uint32_t height,
+                                                      uint32_t depth,
+                                                      nxt::TextureFormat format,
+                                                      uint32_t offset,
+                                                      uint32_t rowPitch) {
+        uint32_t blockWidth = TextureFormatBlockWidth(format);
+        uint32_t blockHeight = TextureFormatBlockHeight(format);
+        ASSERT(x % blockWidth == 0 && y % blockHeight == 0);
+
+        TextureCopySplit copy = ComputeTextureCopySplit(
+            x / blockWidth, y / blockHeight, z, (width + blockWidth - 1) / blockWidth,
+            (height + blockHeight - 1) / blockHeight, depth, TextureFormatBlockSize(format),
+            offset, rowPitch);
+
+        for (uint32_t i = 0; i < copy.count; ++i) {
+            auto& info = copy.copies[i];
+            info.textureOffset.x *= blockWidth;
+            info.textureOffset.y *= blockHeight;
+            info.bufferOffset.x *= blockWidth;
+            info.bufferOffset.y *= blockHeight;
+            info.bufferSize.width *= blockWidth;
+            info.bufferSize.height *= blockHeight;
+            info.copySize.width *= blockWidth;
+            info.copySize.height *= blockHeight;
+        }
+
+        return copy;
+    }
+
 }}  // namespace backend::d3d12
@@ -59,6 +59,19 @@ namespace backend { namespace d3d12 {
                                              uint32_t offset,
                                              uint32_t rowPitch);
 
+    // Same as ComputeTextureCopySplit but for a region of a texture of the given format. Block
+    // compressed formats are split in units of blocks and the result is converted back to texels,
+    // with regions at the edge of small mips rounded up to whole blocks like D3D12 expects.
+    TextureCopySplit ComputeTextureCopySplitForFormat(uint32_t x,
+                                                      uint32_t y,
+                                                      uint32_t z,
+                                                      uint32_t width,
+                                                      uint32_t height,
+                                                      uint32_t depth,
+                                                      nxt::TextureFormat format,
+                                                      uint32_t offset,
+                                                      uint32_t rowPitch);
+
 }}  // namespace backend::d3d12
 
 #endif  // BACKEND_D3D12_TEXTURECOPYSPLITTER_H_
@@ -16,6 +16,10 @@
 
 #include "backend/d3d12/D3D12Backend.h"
 #include "backend/d3d12/ResourceAllocator.h"
+#include "backend/d3d12/ResourceUploader.h"
+
+#include <array>
+#include <utility>
 
 namespace backend { namespace d3d12 {
 
@@ -71,7 +75,10 @@ namespace backend { namespace d3d12 {
         D3D12_RESOURCE_DIMENSION D3D12TextureDimension(nxt::TextureDimension dimension) {
             switch (dimension) {
                 case nxt::TextureDimension::e2D:
+                case nxt::TextureDimension::e2DArray:
                     return D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+                case nxt::TextureDimension::e3D:
+                    return D3D12_RESOURCE_DIMENSION_TEXTURE3D;
                 default:
                     UNREACHABLE();
             }
@@ -89,6 +96,20 @@ namespace backend { namespace d3d12 {
                 return DXGI_FORMAT_B8G8R8A8_UNORM;
             case nxt::TextureFormat::D32FloatS8Uint:
                 return DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+                return DXGI_FORMAT_BC1_UNORM;
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+                return DXGI_FORMAT_BC2_UNORM;
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+                return DXGI_FORMAT_BC3_UNORM;
+            case nxt::TextureFormat::Bc4RUnorm:
+                return DXGI_FORMAT_BC4_UNORM;
+            case nxt::TextureFormat::Bc5RGUnorm:
+                return DXGI_FORMAT_BC5_UNORM;
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+                return DXGI_FORMAT_BC6H_UF16;
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+                return DXGI_FORMAT_BC7_UNORM;
             default:
                 UNREACHABLE();
         }
@@ -104,7 +125,7 @@ namespace backend { namespace d3d12 {
         resourceDescriptor.DepthOrArraySize = static_cast<UINT16>(GetDepth());
         resourceDescriptor.MipLevels = static_cast<UINT16>(GetNumMipLevels());
         resourceDescriptor.Format = D3D12TextureFormat(GetFormat());
-        resourceDescriptor.SampleDesc.Count = 1;
+        resourceDescriptor.SampleDesc.Count = GetSampleCount();
         resourceDescriptor.SampleDesc.Quality = 0;
         resourceDescriptor.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
         resourceDescriptor.Flags = D3D12ResourceFlags(GetAllowedUsage(), GetFormat());
@@ -137,45 +158,154 @@ namespace backend { namespace d3d12 {
         return mResourcePtr;
     }
 
-    bool Texture::GetResourceTransitionBarrier(nxt::TextureUsageBit currentUsage,
-                                               nxt::TextureUsageBit targetUsage,
-                                               D3D12_RESOURCE_BARRIER* barrier) {
+    void Texture::AppendResourceTransitionBarriers(
+        uint32_t baseLevel,
+        uint32_t levelCount,
+        nxt::TextureUsageBit currentUsage,
+        nxt::TextureUsageBit targetUsage,
+        std::vector<D3D12_RESOURCE_BARRIER>* barriers) {
         D3D12_RESOURCE_STATES stateBefore = D3D12TextureUsage(currentUsage, GetFormat());
         D3D12_RESOURCE_STATES stateAfter = D3D12TextureUsage(targetUsage, GetFormat());
 
         if (stateBefore == stateAfter) {
-            return false;
+            return;
         }
 
-        barrier->Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        barrier->Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-        barrier->Transition.pResource = mResourcePtr;
-        barrier->Transition.StateBefore = stateBefore;
-        barrier->Transition.StateAfter = stateAfter;
-        barrier->Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        D3D12_RESOURCE_BARRIER barrier;
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        barrier.Transition.pResource = mResourcePtr;
+        barrier.Transition.StateBefore = stateBefore;
+        barrier.Transition.StateAfter = stateAfter;
+
+        if (baseLevel == 0 && levelCount == GetNumMipLevels()) {
+            barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            barriers->push_back(barrier);
+            return;
+        }
 
-        return true;
+        // Depth-stencil formats store stencil in a second plane that needs its own barriers.
+        uint32_t arraySize =
+            GetDimension() == nxt::TextureDimension::e2DArray ? GetDepth() : 1;
+        uint32_t planeCount = TextureFormatHasStencil(GetFormat()) ? 2 : 1;
+        for (uint32_t plane = 0; plane < planeCount; ++plane) {
+            for (uint32_t layer = 0; layer < arraySize; ++layer) {
+                for (uint32_t level = baseLevel; level < baseLevel + levelCount; ++level) {
+                    barrier.Transition.Subresource =
+                        D3D12CalcSubresource(level, layer, plane, GetNumMipLevels(), arraySize);
+                    barriers->push_back(barrier);
+                }
+            }
+        }
     }
 
-    void Texture::TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+    void Texture::TransitionLevelsNow(ComPtr<ID3D12GraphicsCommandList> commandList,
+                                      uint32_t baseLevel,
+                                      uint32_t levelCount,
                                       nxt::TextureUsageBit targetUsage) {
-        D3D12_RESOURCE_BARRIER barrier;
-        if (GetResourceTransitionBarrier(currentUsage, targetUsage, &barrier)) {
-            mDevice->GetPendingCommandList()->ResourceBarrier(1, &barrier);
+        std::vector<D3D12_RESOURCE_BARRIER> barriers;
+        for (const auto& range : GetLevelUsageRanges(baseLevel, levelCount)) {
+            AppendResourceTransitionBarriers(range.baseLevel, range.levelCount, range.usage,
+                                             targetUsage, &barriers);
+        }
+        if (!barriers.empty()) {
+            commandList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+        }
+        UpdateLevelsUsageInternal(baseLevel, levelCount, targetUsage);
+    }
+
+    void Texture::RecordResolve(ComPtr<ID3D12GraphicsCommandList> commandList, Texture* target) {
+        ASSERT(GetSampleCount() > 1 && target->GetSampleCount() == 1);
+
+        // Only the first level of the target is an attachment so it is the only one that is
+        // resolved to.
+        std::array<D3D12_RESOURCE_BARRIER, 2> barriers;
+        for (auto& barrier : barriers) {
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+            barrier.Transition.Subresource = 0;
+        }
+        barriers[0].Transition.pResource = mResourcePtr;
+        barriers[0].Transition.StateBefore = D3D12TextureUsage(GetUsage(), GetFormat());
+        barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_RESOLVE_SOURCE;
+        barriers[1].Transition.pResource = target->GetD3D12Resource();
+        barriers[1].Transition.StateBefore =
+            D3D12TextureUsage(target->GetLevelUsage(0), target->GetFormat());
+        barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_RESOLVE_DEST;
+        commandList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+
+        commandList->ResolveSubresource(target->GetD3D12Resource(), 0, mResourcePtr, 0,
+                                        GetD3D12Format());
+
+        for (auto& barrier : barriers) {
+            std::swap(barrier.Transition.StateBefore, barrier.Transition.StateAfter);
+        }
+        commandList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+    }
+
+    void Texture::SetSubDataImpl(uint32_t level,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 uint32_t rowPitch,
+                                 const uint8_t* data) {
+        mDevice->GetResourceUploader()->TextureSubData(this, level, x, y, width, height, rowPitch,
+                                                       data);
+    }
+
+    void Texture::TransitionUsageImpl(uint32_t baseLevel,
+                                      uint32_t levelCount,
+                                      nxt::TextureUsageBit currentUsage,
+                                      nxt::TextureUsageBit targetUsage) {
+        std::vector<D3D12_RESOURCE_BARRIER> barriers;
+        AppendResourceTransitionBarriers(baseLevel, levelCount, currentUsage, targetUsage,
+                                         &barriers);
+        if (!barriers.empty()) {
+            mDevice->GetPendingCommandList()->ResourceBarrier(static_cast<UINT>(barriers.size()),
+                                                              barriers.data());
         }
     }
 
     TextureView::TextureView(TextureViewBuilder* builder) : TextureViewBase(builder) {
         mSrvDesc.Format = D3D12TextureFormat(GetTexture()->GetFormat());
         mSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        switch (GetTexture()->GetDimension()) {
+        switch (GetDimension()) {
             case nxt::TextureDimension::e2D:
+                // 2D views of 2D array textures need an array SRV to select the layer.
+                if (GetTexture()->GetDimension() == nxt::TextureDimension::e2DArray) {
+                    mSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                    mSrvDesc.Texture2DArray.MostDetailedMip = 0;
+                    mSrvDesc.Texture2DArray.MipLevels = GetTexture()->GetNumMipLevels();
+                    mSrvDesc.Texture2DArray.FirstArraySlice = GetBaseArrayLayer();
+                    mSrvDesc.Texture2DArray.ArraySize = 1;
+                    mSrvDesc.Texture2DArray.PlaneSlice = 0;
+                    mSrvDesc.Texture2DArray.ResourceMinLODClamp = 0;
+                    break;
+                }
                 mSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
                 mSrvDesc.Texture2D.MostDetailedMip = 0;
                 mSrvDesc.Texture2D.MipLevels = GetTexture()->GetNumMipLevels();
                 mSrvDesc.Texture2D.PlaneSlice = 0;
                 mSrvDesc.Texture2D.ResourceMinLODClamp = 0;
                 break;
+            case nxt::TextureDimension::e2DArray:
+                mSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                mSrvDesc.Texture2DArray.MostDetailedMip = 0;
+                mSrvDesc.Texture2DArray.MipLevels = GetTexture()->GetNumMipLevels();
+                mSrvDesc.Texture2DArray.FirstArraySlice = GetBaseArrayLayer();
+                mSrvDesc.Texture2DArray.ArraySize = GetLayerCount();
+                mSrvDesc.Texture2DArray.PlaneSlice = 0;
+                mSrvDesc.Texture2DArray.ResourceMinLODClamp = 0;
+                break;
+            case nxt::TextureDimension::e3D:
+                mSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+                mSrvDesc.Texture3D.MostDetailedMip = 0;
+                mSrvDesc.Texture3D.MipLevels = GetTexture()->GetNumMipLevels();
+                mSrvDesc.Texture3D.ResourceMinLODClamp = 0;
+                break;
+            default:
+                UNREACHABLE();
         }
     }
 
@@ -186,6 +316,10 @@ namespace backend { namespace d3d12 {
     D3D12_RENDER_TARGET_VIEW_DESC TextureView::GetRTVDescriptor() {
         D3D12_RENDER_TARGET_VIEW_DESC rtvDesc;
         rtvDesc.Format = ToBackend(GetTexture())->GetD3D12Format();
+        if (GetTexture()->GetSampleCount() > 1) {
+            rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DMS;
+            return rtvDesc;
+        }
         rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
         rtvDesc.Texture2D.MipSlice = 0;
         rtvDesc.Texture2D.PlaneSlice = 0;
@@ -195,9 +329,13 @@ namespace backend { namespace d3d12 {
     D3D12_DEPTH_STENCIL_VIEW_DESC TextureView::GetDSVDescriptor() {
         D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc;
         dsvDesc.Format = ToBackend(GetTexture())->GetD3D12Format();
+        dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+        if (GetTexture()->GetSampleCount() > 1) {
+            dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DMS;
+            return dsvDesc;
+        }
         dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
         dsvDesc.Texture2D.MipSlice = 0;
-        dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
         return dsvDesc;
     }
 
@@ -19,6 +19,8 @@
 
 #include "backend/d3d12/d3d12_platform.h"
 
+#include <vector>
+
 namespace backend { namespace d3d12 {
 
     class Device;
@@ -33,14 +35,36 @@ namespace backend { namespace d3d12 {
 
         DXGI_FORMAT GetD3D12Format() const;
         ID3D12Resource* GetD3D12Resource();
-        bool GetResourceTransitionBarrier(nxt::TextureUsageBit currentUsage,
-                                          nxt::TextureUsageBit targetUsage,
-                                          D3D12_RESOURCE_BARRIER* barrier);
+        // Appends the barriers for levels [baseLevel, baseLevel + levelCount) that are all in
+        // currentUsage, one per subresource unless the whole texture is transitioned.
+        void AppendResourceTransitionBarriers(uint32_t baseLevel,
+                                              uint32_t levelCount,
+                                              nxt::TextureUsageBit currentUsage,
+                                              nxt::TextureUsageBit targetUsage,
+                                              std::vector<D3D12_RESOURCE_BARRIER>* barriers);
+        // Records the barriers for levels [baseLevel, baseLevel + levelCount) that can be in
+        // different usages, and updates their usage.
+        void TransitionLevelsNow(ComPtr<ID3D12GraphicsCommandList> commandList,
+                                 uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit targetUsage);
+        // Records the resolve of this multisampled texture to the first level of `target`.
+        void RecordResolve(ComPtr<ID3D12GraphicsCommandList> commandList, Texture* target);
 
-        void TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+        void TransitionUsageImpl(uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit currentUsage,
                                  nxt::TextureUsageBit targetUsage) override;
 
       private:
+        void SetSubDataImpl(uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data) override;
+
         Device* mDevice;
         ComPtr<ID3D12Resource> mResource = {};
         ID3D12Resource* mResourcePtr = nullptr;
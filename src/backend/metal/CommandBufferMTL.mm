@@ -28,6 +28,14 @@
 namespace backend { namespace metal {
 
     namespace {
+        // Attachments are stored at the end of every subpass but the last one that uses them.
+        MTLStoreAction MetalStoreAction(bool isLastUse, nxt::StoreOp storeOp) {
+            if (isLastUse && storeOp == nxt::StoreOp::Discard) {
+                return MTLStoreActionDontCare;
+            }
+            return MTLStoreActionStore;
+        }
+
         struct CurrentEncoders {
             Device* device;
 
@@ -86,6 +94,7 @@ namespace backend { namespace metal {
                     auto texture = ToBackend(textureView->GetTexture())->GetMTLTexture();
 
                     bool isFirstUse = attachmentInfo.firstSubpass == subpass;
+                    bool isLastUse = attachmentInfo.lastSubpass == subpass;
                     bool shouldClearOnFirstUse = attachmentInfo.colorLoadOp == nxt::LoadOp::Clear;
                     if (isFirstUse && shouldClearOnFirstUse) {
                         auto clearValue = currentFramebuffer->GetClearColor(location);
@@ -98,7 +107,24 @@ namespace backend { namespace metal {
                     }
 
                     descriptor.colorAttachments[location].texture = texture;
-                    descriptor.colorAttachments[location].storeAction = MTLStoreActionStore;
+                    descriptor.colorAttachments[location].storeAction =
+                        MetalStoreAction(isLastUse, attachmentInfo.colorStoreOp);
+
+                    // Metal resolves at the end of the encoder, which is the end of the subpass.
+                    if (info.resolveAttachmentsSet[location]) {
+                        auto resolveView =
+                            currentFramebuffer->GetTextureView(info.resolveAttachments[location]);
+                        descriptor.colorAttachments[location].resolveTexture =
+                            ToBackend(resolveView->GetTexture())->GetMTLTexture();
+                        if (descriptor.colorAttachments[location].storeAction ==
+                            MTLStoreActionStore) {
+                            descriptor.colorAttachments[location].storeAction =
+                                MTLStoreActionStoreAndMultisampleResolve;
+                        } else {
+                            descriptor.colorAttachments[location].storeAction =
+                                MTLStoreActionMultisampleResolve;
+                        }
+                    }
                 }
                 if (info.depthStencilAttachmentSet) {
                     uint32_t attachment = info.depthStencilAttachment;
@@ -109,11 +135,13 @@ namespace backend { namespace metal {
                     nxt::TextureFormat format = textureView->GetTexture()->GetFormat();
 
                     bool isFirstUse = attachmentInfo.firstSubpass == subpass;
+                    bool isLastUse = attachmentInfo.lastSubpass == subpass;
                     const auto& clearValues = currentFramebuffer->GetClearDepthStencil(attachment);
 
                     if (TextureFormatHasDepth(format)) {
                         descriptor.depthAttachment.texture = texture;
-                        descriptor.depthAttachment.storeAction = MTLStoreActionStore;
+                        descriptor.depthAttachment.storeAction =
+                            MetalStoreAction(isLastUse, attachmentInfo.depthStoreOp);
 
                         bool shouldClearDepthOnFirstUse =
                             attachmentInfo.depthLoadOp == nxt::LoadOp::Clear;
@@ -127,7 +155,8 @@ namespace backend { namespace metal {
 
                     if (TextureFormatHasStencil(format)) {
                         descriptor.stencilAttachment.texture = texture;
-                        descriptor.stencilAttachment.storeAction = MTLStoreActionStore;
+                        descriptor.stencilAttachment.storeAction =
+                            MetalStoreAction(isLastUse, attachmentInfo.stencilStoreOp);
 
                         bool shouldClearStencilOnFirstUse =
                             attachmentInfo.stencilLoadOp == nxt::LoadOp::Clear;
@@ -150,6 +179,33 @@ namespace backend { namespace metal {
                 render = nil;
             }
         };
+
+        // Metal copies a single array slice at a time, so copies to 2D array textures are
+        // done layer by layer while 3D textures are copied in one go.
+        struct TextureCopySlices {
+            TextureCopySlices(Texture* texture,
+                              const TextureCopyLocation& location,
+                              uint32_t rowPitch) {
+                bool isArray = texture->GetDimension() == nxt::TextureDimension::e2DArray;
+                baseSlice = isArray ? location.z : 0;
+                count = isArray ? location.depth : 1;
+                bytesPerImage =
+                    rowPitch * ComputeTextureRowCount(texture->GetFormat(), location.height);
+
+                origin = MTLOriginMake(location.x, location.y, isArray ? 0 : location.z);
+                size = MTLSizeMake(location.width, location.height, isArray ? 1 : location.depth);
+            }
+
+            NSUInteger GetSlice(uint32_t slice) const {
+                return baseSlice + slice;
+            }
+
+            uint32_t baseSlice;
+            uint32_t count;
+            uint32_t bytesPerImage;
+            MTLOrigin origin;
+            MTLSize size;
+        };
     }
 
     CommandBuffer::CommandBuffer(CommandBufferBuilder* builder)
@@ -172,6 +228,8 @@ namespace backend { namespace metal {
         CurrentEncoders encoders;
         encoders.device = mDevice;
 
+        BufferCopyBatch bufferCopies;
+
         PerStage<std::array<uint32_t, kMaxPushConstants>> pushConstants;
 
         uint32_t currentSubpass = 0;
@@ -213,15 +271,20 @@ namespace backend { namespace metal {
 
                 case Command::CopyBufferToBuffer: {
                     CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
+                    GatherBufferCopies(&mCommands, copy, &bufferCopies);
+                    mDevice->CountBufferCopies(bufferCopies.commandCount,
+                                               static_cast<uint32_t>(bufferCopies.regions.size()));
 
+                    id<MTLBuffer> src = ToBackend(bufferCopies.source)->GetMTLBuffer();
+                    id<MTLBuffer> dst = ToBackend(bufferCopies.destination)->GetMTLBuffer();
                     encoders.EnsureBlit(commandBuffer);
-                    [encoders.blit copyFromBuffer:ToBackend(src.buffer)->GetMTLBuffer()
-                                     sourceOffset:src.offset
-                                         toBuffer:ToBackend(dst.buffer)->GetMTLBuffer()
-                                destinationOffset:dst.offset
-                                             size:copy->size];
+                    for (const auto& region : bufferCopies.regions) {
+                        [encoders.blit copyFromBuffer:src
+                                         sourceOffset:region.sourceOffset
+                                             toBuffer:dst
+                                    destinationOffset:region.destinationOffset
+                                                 size:region.size];
+                    }
                 } break;
 
                 case Command::CopyBufferToTexture: {
@@ -231,26 +294,19 @@ namespace backend { namespace metal {
                     Buffer* buffer = ToBackend(src.buffer.Get());
                     Texture* texture = ToBackend(dst.texture.Get());
 
-                    MTLOrigin origin;
-                    origin.x = dst.x;
-                    origin.y = dst.y;
-                    origin.z = dst.z;
-
-                    MTLSize size;
-                    size.width = dst.width;
-                    size.height = dst.height;
-                    size.depth = dst.depth;
-
+                    TextureCopySlices slices(texture, dst, copy->rowPitch);
                     encoders.EnsureBlit(commandBuffer);
-                    [encoders.blit copyFromBuffer:buffer->GetMTLBuffer()
-                                     sourceOffset:src.offset
-                                sourceBytesPerRow:copy->rowPitch
-                              sourceBytesPerImage:(copy->rowPitch * dst.height)
-                                       sourceSize:size
-                                        toTexture:texture->GetMTLTexture()
-                                 destinationSlice:0
-                                 destinationLevel:dst.level
-                                destinationOrigin:origin];
+                    for (uint32_t slice = 0; slice < slices.count; ++slice) {
+                        [encoders.blit copyFromBuffer:buffer->GetMTLBuffer()
+                                         sourceOffset:src.offset + slice * slices.bytesPerImage
+                                    sourceBytesPerRow:copy->rowPitch
+                                  sourceBytesPerImage:slices.bytesPerImage
+                                           sourceSize:slices.size
+                                            toTexture:texture->GetMTLTexture()
+                                     destinationSlice:slices.GetSlice(slice)
+                                     destinationLevel:dst.level
+                                    destinationOrigin:slices.origin];
+                    }
                 } break;
 
                 case Command::CopyTextureToBuffer: {
@@ -260,26 +316,19 @@ namespace backend { namespace metal {
                     Texture* texture = ToBackend(src.texture.Get());
                     Buffer* buffer = ToBackend(dst.buffer.Get());
 
-                    MTLOrigin origin;
-                    origin.x = src.x;
-                    origin.y = src.y;
-                    origin.z = src.z;
-
-                    MTLSize size;
-                    size.width = src.width;
-                    size.height = src.height;
-                    size.depth = src.depth;
-
+                    TextureCopySlices slices(texture, src, copy->rowPitch);
                     encoders.EnsureBlit(commandBuffer);
-                    [encoders.blit copyFromTexture:texture->GetMTLTexture()
-                                       sourceSlice:0
-                                       sourceLevel:src.level
-                                      sourceOrigin:origin
-                                        sourceSize:size
-                                          toBuffer:buffer->GetMTLBuffer()
-                                 destinationOffset:dst.offset
-                            destinationBytesPerRow:copy->rowPitch
-                          destinationBytesPerImage:copy->rowPitch * src.height];
+                    for (uint32_t slice = 0; slice < slices.count; ++slice) {
+                        [encoders.blit copyFromTexture:texture->GetMTLTexture()
+                                           sourceSlice:slices.GetSlice(slice)
+                                           sourceLevel:src.level
+                                          sourceOrigin:slices.origin
+                                            sourceSize:slices.size
+                                              toBuffer:buffer->GetMTLBuffer()
+                                     destinationOffset:dst.offset + slice * slices.bytesPerImage
+                                destinationBytesPerRow:copy->rowPitch
+                              destinationBytesPerImage:slices.bytesPerImage];
+                    }
                 } break;
 
                 case Command::Dispatch: {
@@ -332,6 +381,71 @@ namespace backend { namespace metal {
                     currentSubpass += 1;
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    Texture* texture = ToBackend(cmd->texture.Get());
+                    if (cmd->levelCount <= 1) {
+                        break;
+                    }
+
+                    // generateMipmapsForTexture always fills the whole mip chain so use a view
+                    // restricted to the requested levels if needed.
+                    id<MTLTexture> mtlTexture = texture->GetMTLTexture();
+                    bool needsView =
+                        cmd->baseLevel != 0 || cmd->levelCount != texture->GetNumMipLevels();
+                    if (needsView) {
+                        mtlTexture = [mtlTexture
+                            newTextureViewWithPixelFormat:[mtlTexture pixelFormat]
+                                              textureType:[mtlTexture textureType]
+                                                   levels:NSMakeRange(cmd->baseLevel,
+                                                                      cmd->levelCount)
+                                                   slices:NSMakeRange(0, 1)];
+                    }
+
+                    encoders.EnsureBlit(commandBuffer);
+                    [encoders.blit generateMipmapsForTexture:mtlTexture];
+
+                    if (needsView) {
+                        [mtlTexture release];
+                    }
+                } break;
+
+                case Command::MultiDrawArrays: {
+                    MultiDrawArraysCmd* draw = mCommands.NextCommand<MultiDrawArraysCmd>();
+                    uint32_t* vertexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstVertices = mCommands.NextData<uint32_t>(draw->drawCount);
+
+                    ASSERT(encoders.render);
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        [encoders.render
+                            drawPrimitives:lastRenderPipeline->GetMTLPrimitiveTopology()
+                               vertexStart:firstVertices[i]
+                               vertexCount:vertexCounts[i]
+                             instanceCount:draw->instanceCount
+                              baseInstance:draw->firstInstance];
+                    }
+                } break;
+
+                case Command::MultiDrawElements: {
+                    MultiDrawElementsCmd* draw = mCommands.NextCommand<MultiDrawElementsCmd>();
+                    uint32_t* indexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstIndices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    size_t formatSize = IndexFormatSize(lastRenderPipeline->GetIndexFormat());
+
+                    ASSERT(encoders.render);
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        [encoders.render
+                            drawIndexedPrimitives:lastRenderPipeline->GetMTLPrimitiveTopology()
+                                       indexCount:indexCounts[i]
+                                        indexType:lastRenderPipeline->GetMTLIndexType()
+                                      indexBuffer:indexBuffer
+                                indexBufferOffset:indexBufferOffset + firstIndices[i] * formatSize
+                                    instanceCount:draw->instanceCount
+                                       baseVertex:0
+                                     baseInstance:draw->firstInstance];
+                    }
+                } break;
+
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
                     lastComputePipeline = ToBackend(cmd->pipeline).Get();
@@ -404,6 +518,36 @@ namespace backend { namespace metal {
                     [encoders.render setBlendColorRed:cmd->r green:cmd->g blue:cmd->b alpha:cmd->a];
                 } break;
 
+                // Each subpass has its own render encoder, which starts with a viewport and
+                // scissor covering the whole framebuffer.
+                case Command::SetViewport: {
+                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
+
+                    ASSERT(encoders.render);
+
+                    MTLViewport viewport;
+                    viewport.originX = cmd->x;
+                    viewport.originY = cmd->y;
+                    viewport.width = cmd->width;
+                    viewport.height = cmd->height;
+                    viewport.znear = cmd->minDepth;
+                    viewport.zfar = cmd->maxDepth;
+                    [encoders.render setViewport:viewport];
+                } break;
+
+                case Command::SetScissorRect: {
+                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
+
+                    ASSERT(encoders.render);
+
+                    MTLScissorRect rect;
+                    rect.x = cmd->x;
+                    rect.y = cmd->y;
+                    rect.width = cmd->width;
+                    rect.height = cmd->height;
+                    [encoders.render setScissorRect:rect];
+                } break;
+
                 case Command::SetBindGroup: {
                     SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
                     BindGroup* group = ToBackend(cmd->group.Get());
@@ -493,18 +637,18 @@ namespace backend { namespace metal {
                             } break;
 
                             case nxt::BindingType::SampledTexture: {
-                                auto texture = ToBackend(
-                                    group->GetBindingAsTextureView(binding)->GetTexture());
+                                auto textureView =
+                                    ToBackend(group->GetBindingAsTextureView(binding));
                                 if (vertStage) {
-                                    [encoders.render setVertexTexture:texture->GetMTLTexture()
+                                    [encoders.render setVertexTexture:textureView->GetMTLTexture()
                                                               atIndex:vertIndex];
                                 }
                                 if (fragStage) {
-                                    [encoders.render setFragmentTexture:texture->GetMTLTexture()
+                                    [encoders.render setFragmentTexture:textureView->GetMTLTexture()
                                                                 atIndex:fragIndex];
                                 }
                                 if (computeStage) {
-                                    [encoders.compute setTexture:texture->GetMTLTexture()
+                                    [encoders.compute setTexture:textureView->GetMTLTexture()
                                                          atIndex:computeIndex];
                                 }
                             } break;
@@ -554,7 +698,8 @@ namespace backend { namespace metal {
                     TransitionTextureUsageCmd* cmd =
                         mCommands.NextCommand<TransitionTextureUsageCmd>();
 
-                    cmd->texture->UpdateUsageInternal(cmd->usage);
+                    cmd->texture->UpdateLevelsUsageInternal(cmd->baseLevel, cmd->levelCount,
+                                                            cmd->usage);
                 } break;
             }
         }
@@ -23,10 +23,11 @@ namespace backend { namespace metal {
         : ComputePipelineBase(builder) {
         auto mtlDevice = ToBackend(builder->GetDevice())->GetMTLDevice();
 
-        const auto& module = ToBackend(builder->GetStageInfo(nxt::ShaderStage::Compute).module);
-        const auto& entryPoint = builder->GetStageInfo(nxt::ShaderStage::Compute).entryPoint;
+        const auto& stageInfo = builder->GetStageInfo(nxt::ShaderStage::Compute);
+        const auto& module = ToBackend(stageInfo.module);
 
-        auto compilationData = module->GetFunction(entryPoint.c_str(), ToBackend(GetLayout()));
+        auto compilationData = module->GetFunction(
+            stageInfo.entryPoint.c_str(), stageInfo.specialization, ToBackend(GetLayout()));
 
         NSError* error = nil;
         mMtlComputePipelineState =
@@ -110,6 +110,7 @@ namespace backend { namespace metal {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        bool IsTextureFormatSupported(nxt::TextureFormat format) const override;
 
         id<MTLDevice> GetMTLDevice();
 
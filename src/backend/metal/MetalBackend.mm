@@ -145,6 +145,18 @@ namespace backend { namespace metal {
         SubmitPendingCommandBuffer();
     }
 
+    bool Device::IsTextureFormatSupported(nxt::TextureFormat format) const {
+        // The BC formats are always supported on macOS but ETC2 is iOS-only.
+        switch (format) {
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return false;
+            default:
+                return true;
+        }
+    }
+
     id<MTLDevice> Device::GetMTLDevice() {
         return mMtlDevice;
     }
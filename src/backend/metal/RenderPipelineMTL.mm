@@ -73,11 +73,14 @@ namespace backend { namespace metal {
         MTLRenderPipelineDescriptor* descriptor = [MTLRenderPipelineDescriptor new];
 
         for (auto stage : IterateStages(GetStageMask())) {
-            const auto& module = ToBackend(builder->GetStageInfo(stage).module);
+            const auto& stageInfo = builder->GetStageInfo(stage);
+            const auto& module = ToBackend(stageInfo.module);
 
-            const auto& entryPoint = builder->GetStageInfo(stage).entryPoint;
             id<MTLFunction> function =
-                module->GetFunction(entryPoint.c_str(), ToBackend(GetLayout())).function;
+                module
+                    ->GetFunction(stageInfo.entryPoint.c_str(), stageInfo.specialization,
+                                  ToBackend(GetLayout()))
+                    .function;
 
             switch (stage) {
                 case nxt::ShaderStage::Vertex:
@@ -112,6 +115,7 @@ namespace backend { namespace metal {
         }
 
         descriptor.inputPrimitiveTopology = MTLInputPrimitiveTopology(GetPrimitiveTopology());
+        descriptor.sampleCount = GetSampleCount();
 
         InputState* inputState = ToBackend(GetInputState());
         descriptor.vertexDescriptor = inputState->GetMTLVertexDescriptor();
@@ -30,6 +30,16 @@ namespace backend { namespace metal {
         ~ResourceUploader();
 
         void BufferSubData(id<MTLBuffer> buffer, uint32_t start, uint32_t size, const void* data);
+        void TextureSubData(id<MTLTexture> texture,
+                            uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            uint32_t bytesPerImage,
+                            uint32_t size,
+                            const void* data);
         void Tick(Serial finishedSerial);
 
       private:
@@ -47,6 +47,37 @@ namespace backend { namespace metal {
         mInflightUploadBuffers.Enqueue(uploadBuffer, mDevice->GetPendingCommandSerial());
     }
 
+    void ResourceUploader::TextureSubData(id<MTLTexture> texture,
+                                          uint32_t level,
+                                          uint32_t x,
+                                          uint32_t y,
+                                          uint32_t width,
+                                          uint32_t height,
+                                          uint32_t rowPitch,
+                                          uint32_t bytesPerImage,
+                                          uint32_t size,
+                                          const void* data) {
+        // Like BufferSubData, this creates a small staging buffer for each update.
+        id<MTLBuffer> uploadBuffer =
+            [mDevice->GetMTLDevice() newBufferWithLength:size options:MTLResourceStorageModeShared];
+        memcpy([uploadBuffer contents], data, size);
+
+        id<MTLCommandBuffer> commandBuffer = mDevice->GetPendingCommandBuffer();
+        id<MTLBlitCommandEncoder> encoder = [commandBuffer blitCommandEncoder];
+        [encoder copyFromBuffer:uploadBuffer
+                   sourceOffset:0
+              sourceBytesPerRow:rowPitch
+            sourceBytesPerImage:bytesPerImage
+                     sourceSize:MTLSizeMake(width, height, 1)
+                      toTexture:texture
+               destinationSlice:0
+               destinationLevel:level
+              destinationOrigin:MTLOriginMake(x, y, 0)];
+        [encoder endEncoding];
+
+        mInflightUploadBuffers.Enqueue(uploadBuffer, mDevice->GetPendingCommandSerial());
+    }
+
     void ResourceUploader::Tick(Serial finishedSerial) {
         for (id<MTLBuffer> buffer : mInflightUploadBuffers.IterateUpTo(finishedSerial)) {
             [buffer release];
@@ -35,13 +35,9 @@ namespace backend { namespace metal {
             id<MTLFunction> function;
             MTLSize localWorkgroupSize;
         };
-        MetalFunctionData GetFunction(const char* functionName, const PipelineLayout* layout) const;
-
-      private:
-        // Calling compile on CompilerMSL somehow changes internal state that makes subsequent
-        // compiles return invalid MSL. We keep the spirv around and recreate the compiler everytime
-        // we need to use it.
-        std::vector<uint32_t> mSpirv;
+        MetalFunctionData GetFunction(const char* functionName,
+                                      const SpecializationValues& specialization,
+                                      const PipelineLayout* layout) const;
     };
 
 }}  // namespace backend::metal
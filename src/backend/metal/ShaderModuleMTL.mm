@@ -39,15 +39,18 @@ namespace backend { namespace metal {
         }
     }
 
-    ShaderModule::ShaderModule(ShaderModuleBuilder* builder)
-        : ShaderModuleBase(builder), mSpirv(builder->AcquireSpirv()) {
-        spirv_cross::CompilerMSL compiler(mSpirv);
-        ExtractSpirvInfo(compiler);
+    ShaderModule::ShaderModule(ShaderModuleBuilder* builder) : ShaderModuleBase(builder) {
     }
 
-    ShaderModule::MetalFunctionData ShaderModule::GetFunction(const char* functionName,
-                                                              const PipelineLayout* layout) const {
-        spirv_cross::CompilerMSL compiler(mSpirv);
+    ShaderModule::MetalFunctionData ShaderModule::GetFunction(
+        const char* functionName,
+        const SpecializationValues& specialization,
+        const PipelineLayout* layout) const {
+        // Calling compile on CompilerMSL somehow changes internal state that makes subsequent
+        // compiles return invalid MSL. The compiler is recreated every time it is needed.
+        spirv_cross::CompilerMSL compiler(GetSpirv());
+        SelectEntryPoint(&compiler, functionName);
+        ApplySpecialization(&compiler, specialization);
 
         // By default SPIRV-Cross will give MSL resources indices in increasing order.
         // To make the MSL indices match the indices chosen in the PipelineLayout, we build
@@ -31,16 +31,32 @@ namespace backend { namespace metal {
 
         id<MTLTexture> GetMTLTexture();
 
-        void TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+        void TransitionUsageImpl(uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit currentUsage,
                                  nxt::TextureUsageBit targetUsage) override;
 
       private:
+        void SetSubDataImpl(uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data) override;
+
         id<MTLTexture> mMtlTexture = nil;
     };
 
     class TextureView : public TextureViewBase {
       public:
         TextureView(TextureViewBuilder* builder);
+        ~TextureView();
+
+        id<MTLTexture> GetMTLTexture();
+
+      private:
+        id<MTLTexture> mMtlTexture = nil;
     };
 
 }}  // namespace backend::metal
@@ -15,6 +15,7 @@
 #include "backend/metal/TextureMTL.h"
 
 #include "backend/metal/MetalBackend.h"
+#include "backend/metal/ResourceUploader.h"
 
 namespace backend { namespace metal {
 
@@ -28,6 +29,23 @@ namespace backend { namespace metal {
                 return MTLPixelFormatBGRA8Unorm;
             case nxt::TextureFormat::D32FloatS8Uint:
                 return MTLPixelFormatDepth32Float_Stencil8;
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+                return MTLPixelFormatBC1_RGBA;
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+                return MTLPixelFormatBC2_RGBA;
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+                return MTLPixelFormatBC3_RGBA;
+            case nxt::TextureFormat::Bc4RUnorm:
+                return MTLPixelFormatBC4_RUnorm;
+            case nxt::TextureFormat::Bc5RGUnorm:
+                return MTLPixelFormatBC5_RGUnorm;
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+                return MTLPixelFormatBC6H_RGBUfloat;
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+                return MTLPixelFormatBC7_RGBAUnorm;
+            // ETC2 formats are only available on iOS and are rejected by IsTextureFormatSupported
+            default:
+                UNREACHABLE();
         }
     }
 
@@ -54,6 +72,12 @@ namespace backend { namespace metal {
             switch (dimension) {
                 case nxt::TextureDimension::e2D:
                     return MTLTextureType2D;
+                case nxt::TextureDimension::e2DArray:
+                    return MTLTextureType2DArray;
+                case nxt::TextureDimension::e3D:
+                    return MTLTextureType3D;
+                default:
+                    UNREACHABLE();
             }
         }
     }
@@ -61,14 +85,25 @@ namespace backend { namespace metal {
     Texture::Texture(TextureBuilder* builder) : TextureBase(builder) {
         auto desc = [MTLTextureDescriptor new];
         [desc autorelease];
-        desc.textureType = MetalTextureType(GetDimension());
+        if (GetSampleCount() > 1) {
+            desc.textureType = MTLTextureType2DMultisample;
+        } else {
+            desc.textureType = MetalTextureType(GetDimension());
+        }
+        desc.sampleCount = GetSampleCount();
         desc.usage = MetalTextureUsage(GetUsage());
         desc.pixelFormat = MetalPixelFormat(GetFormat());
         desc.width = GetWidth();
         desc.height = GetHeight();
-        desc.depth = GetDepth();
         desc.mipmapLevelCount = GetNumMipLevels();
-        desc.arrayLength = 1;
+        // Metal counts array layers separately from the depth
+        if (GetDimension() == nxt::TextureDimension::e2DArray) {
+            desc.depth = 1;
+            desc.arrayLength = GetDepth();
+        } else {
+            desc.depth = GetDepth();
+            desc.arrayLength = 1;
+        }
         desc.storageMode = MTLStorageModePrivate;
 
         auto mtlDevice = ToBackend(builder->GetDevice())->GetMTLDevice();
@@ -88,10 +123,46 @@ namespace backend { namespace metal {
         return mMtlTexture;
     }
 
-    void Texture::TransitionUsageImpl(nxt::TextureUsageBit, nxt::TextureUsageBit) {
+    void Texture::SetSubDataImpl(uint32_t level,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 uint32_t rowPitch,
+                                 const uint8_t* data) {
+        nxt::TextureFormat format = GetFormat();
+        uint32_t rowCount = ComputeTextureRowCount(format, height);
+        uint32_t size = rowPitch * (rowCount - 1) + ComputeTextureRowSize(format, width);
+        auto* uploader = ToBackend(GetDevice())->GetResourceUploader();
+        uploader->TextureSubData(mMtlTexture, level, x, y, width, height, rowPitch,
+                                 rowPitch * rowCount, size, data);
+    }
+
+    void Texture::TransitionUsageImpl(uint32_t,
+                                      uint32_t,
+                                      nxt::TextureUsageBit,
+                                      nxt::TextureUsageBit) {
     }
 
     TextureView::TextureView(TextureViewBuilder* builder) : TextureViewBase(builder) {
+        id<MTLTexture> mtlTexture = ToBackend(GetTexture())->GetMTLTexture();
+        if (IsFullTextureView()) {
+            mMtlTexture = [mtlTexture retain];
+        } else {
+            mMtlTexture = [mtlTexture
+                newTextureViewWithPixelFormat:[mtlTexture pixelFormat]
+                                  textureType:MetalTextureType(GetDimension())
+                                       levels:NSMakeRange(0, GetTexture()->GetNumMipLevels())
+                                       slices:NSMakeRange(GetBaseArrayLayer(), GetLayerCount())];
+        }
+    }
+
+    TextureView::~TextureView() {
+        [mMtlTexture release];
+    }
+
+    id<MTLTexture> TextureView::GetMTLTexture() {
+        return mMtlTexture;
     }
 
 }}  // namespace backend::metal
@@ -0,0 +1,239 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/null/MemoryAllocator.h"
+
+#include "common/Assert.h"
+#include "common/Math.h"
+#include "common/Platform.h"
+
+#include <cstring>
+
+#if NXT_PLATFORM_WINDOWS
+#    include <windows.h>
+#elif NXT_PLATFORM_POSIX
+#    include <sys/mman.h>
+#    include <unistd.h>
+#else
+#    error "Unsupported platform for the null backend memory allocator"
+#endif
+
+namespace backend { namespace null {
+
+    namespace {
+
+        size_t GetPageSize() {
+#if NXT_PLATFORM_WINDOWS
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#elif NXT_PLATFORM_POSIX
+            return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        }
+
+        // Reserves zero-filled memory, physical pages are only committed when first touched.
+        // Windows has no overcommit so the memory is charged against the commit limit, but
+        // pages are still only made resident on first access.
+        uint8_t* ReserveMemory(size_t size) {
+#if NXT_PLATFORM_WINDOWS
+            return static_cast<uint8_t*>(
+                VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#elif NXT_PLATFORM_POSIX
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#    if defined(MAP_NORESERVE)
+            flags |= MAP_NORESERVE;
+#    endif
+            void* pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if (pointer == MAP_FAILED) {
+                return nullptr;
+            }
+            return static_cast<uint8_t*>(pointer);
+#endif
+        }
+
+        void ReleaseMemory(uint8_t* pointer, size_t size) {
+#if NXT_PLATFORM_WINDOWS
+            (void)size;
+            VirtualFree(pointer, 0, MEM_RELEASE);
+#elif NXT_PLATFORM_POSIX
+            munmap(pointer, size);
+#endif
+        }
+
+        // Gives the physical pages of a page-aligned range back to the OS while keeping the
+        // range reserved. The range reads as zeros afterwards.
+        void DiscardMemory(uint8_t* pointer, size_t size) {
+#if NXT_PLATFORM_WINDOWS
+            VirtualFree(pointer, size, MEM_DECOMMIT);
+            VirtualAlloc(pointer, size, MEM_COMMIT, PAGE_READWRITE);
+#elif NXT_PLATFORM_LINUX
+            madvise(pointer, size, MADV_DONTNEED);
+#elif NXT_PLATFORM_POSIX
+            // MADV_DONTNEED doesn't guarantee that the pages are zeroed on other POSIX systems,
+            // map fresh anonymous pages over the range instead.
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+#    if defined(MAP_NORESERVE)
+            flags |= MAP_NORESERVE;
+#    endif
+            mmap(pointer, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+#endif
+        }
+
+        size_t AlignSize(size_t size, size_t alignment) {
+            ASSERT(IsPowerOfTwo(alignment));
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+    }  // anonymous namespace
+
+    // MemoryAllocation
+
+    MemoryAllocation::~MemoryAllocation() {
+        ASSERT(mPointer == nullptr);
+    }
+
+    MemoryAllocation::MemoryAllocation(MemoryAllocation&& other)
+        : mPointer(other.mPointer), mSize(other.mSize), mSizeClass(other.mSizeClass) {
+        other.mPointer = nullptr;
+        other.mSize = 0;
+        other.mSizeClass = 0;
+    }
+
+    MemoryAllocation& MemoryAllocation::operator=(MemoryAllocation&& other) {
+        // The allocation being overwritten would leak.
+        ASSERT(mPointer == nullptr);
+        if (this != &other) {
+            mPointer = other.mPointer;
+            mSize = other.mSize;
+            mSizeClass = other.mSizeClass;
+            other.mPointer = nullptr;
+            other.mSize = 0;
+            other.mSizeClass = 0;
+        }
+        return *this;
+    }
+
+    uint8_t* MemoryAllocation::GetPointer() const {
+        return mPointer;
+    }
+
+    // MemoryAllocator
+
+    static_assert(MemoryAllocator::kMaxArenaAllocationSize == size_t(1) << 16,
+                  "kMaxArenaAllocationSize must match the largest size class");
+
+    MemoryAllocator::MemoryAllocator() : mPageSize(GetPageSize()) {
+        ASSERT(IsPowerOfTwo(mPageSize));
+    }
+
+    MemoryAllocator::~MemoryAllocator() {
+        for (uint8_t* arena : mArenas) {
+            ReleaseMemory(arena, kArenaSize);
+        }
+    }
+
+    bool MemoryAllocator::Allocate(size_t size, MemoryAllocation* allocation) {
+        ASSERT(allocation->mPointer == nullptr);
+
+        if (size > kMaxArenaAllocationSize) {
+            size_t reservationSize = AlignSize(size, mPageSize);
+            uint8_t* pointer = ReserveMemory(reservationSize);
+            if (pointer == nullptr) {
+                return false;
+            }
+
+            allocation->mPointer = pointer;
+            allocation->mSize = reservationSize;
+            allocation->mSizeClass = kDedicatedSizeClass;
+            return true;
+        }
+
+        uint32_t sizeClass = 0;
+        if (size > (size_t(1) << kMinBlockSizeLog2)) {
+            sizeClass = Log2(static_cast<uint32_t>(size - 1)) + 1 - kMinBlockSizeLog2;
+        }
+        size_t blockSize = size_t(1) << (sizeClass + kMinBlockSizeLog2);
+
+        uint8_t* block = nullptr;
+        std::vector<uint8_t*>& freeBlocks = mFreeBlocks[sizeClass];
+        if (!freeBlocks.empty()) {
+            block = freeBlocks.back();
+            freeBlocks.pop_back();
+
+            // Blocks spanning whole pages were discarded when freed and already read as zeros.
+            if (blockSize < mPageSize) {
+                memset(block, 0, blockSize);
+            }
+        } else {
+            block = AllocateFromArena(blockSize);
+            if (block == nullptr) {
+                return false;
+            }
+        }
+
+        allocation->mPointer = block;
+        allocation->mSize = blockSize;
+        allocation->mSizeClass = sizeClass;
+        return true;
+    }
+
+    void MemoryAllocator::Free(MemoryAllocation* allocation) {
+        if (allocation->mPointer == nullptr) {
+            return;
+        }
+
+        if (allocation->mSizeClass == kDedicatedSizeClass) {
+            ReleaseMemory(allocation->mPointer, allocation->mSize);
+        } else {
+            // Blocks smaller than a page share their pages with other blocks and can't be
+            // discarded on their own, they are cleared when they get reused instead.
+            if (allocation->mSize >= mPageSize) {
+                DiscardMemory(allocation->mPointer, allocation->mSize);
+            }
+            mFreeBlocks[allocation->mSizeClass].push_back(allocation->mPointer);
+        }
+
+        allocation->mPointer = nullptr;
+        allocation->mSize = 0;
+        allocation->mSizeClass = 0;
+    }
+
+    uint8_t* MemoryAllocator::AllocateFromArena(size_t blockSize) {
+        // Blocks are aligned to their size, up to a page, so that page-sized blocks and larger
+        // can be discarded without touching their neighbours.
+        size_t alignment = blockSize < mPageSize ? blockSize : mPageSize;
+
+        if (mArenaCursor != nullptr) {
+            uint8_t* block = AlignPtr(mArenaCursor, alignment);
+            if (block + blockSize <= mArenaEnd) {
+                mArenaCursor = block + blockSize;
+                return block;
+            }
+        }
+
+        // The remainder of the current arena is left unused. It was never touched so it only
+        // costs address space.
+        uint8_t* arena = ReserveMemory(kArenaSize);
+        if (arena == nullptr) {
+            return nullptr;
+        }
+        mArenas.push_back(arena);
+
+        mArenaCursor = arena + blockSize;
+        mArenaEnd = arena + kArenaSize;
+        return arena;
+    }
+
+}}  // namespace backend::null
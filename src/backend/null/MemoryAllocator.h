@@ -0,0 +1,84 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_NULL_MEMORYALLOCATOR_H_
+#define BACKEND_NULL_MEMORYALLOCATOR_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace backend { namespace null {
+
+    class MemoryAllocator;
+
+    // An allocation must be freed by the allocator that made it before it is destroyed. Moving
+    // an allocation transfers that responsibility, copies aren't allowed.
+    class MemoryAllocation {
+      public:
+        MemoryAllocation() = default;
+        ~MemoryAllocation();
+
+        MemoryAllocation(const MemoryAllocation& other) = delete;
+        MemoryAllocation& operator=(const MemoryAllocation& other) = delete;
+        MemoryAllocation(MemoryAllocation&& other);
+        MemoryAllocation& operator=(MemoryAllocation&& other);
+
+        uint8_t* GetPointer() const;
+
+      private:
+        friend class MemoryAllocator;
+        uint8_t* mPointer = nullptr;
+        size_t mSize = 0;
+        uint32_t mSizeClass = 0;
+    };
+
+    // Storage for the contents of null backend resources. Memory is reserved as anonymous
+    // mappings that the OS only commits when pages are first written, so creating huge or many
+    // resources is cheap as long as their contents aren't touched. Small allocations are carved
+    // out of shared arenas in power-of-two size classes, large ones get their own mapping.
+    // Allocations always start zero-filled.
+    class MemoryAllocator {
+      public:
+        MemoryAllocator();
+        ~MemoryAllocator();
+
+        bool Allocate(size_t size, MemoryAllocation* allocation);
+        void Free(MemoryAllocation* allocation);
+
+        static constexpr size_t kMaxArenaAllocationSize = 64 * 1024;
+
+      private:
+        static constexpr uint32_t kMinBlockSizeLog2 = 4;
+        static constexpr uint32_t kMaxBlockSizeLog2 = 16;
+        static constexpr uint32_t kNumSizeClasses = kMaxBlockSizeLog2 - kMinBlockSizeLog2 + 1;
+        static constexpr uint32_t kDedicatedSizeClass = kNumSizeClasses;
+        static constexpr size_t kArenaSize = 64 * 1024 * 1024;
+
+        uint8_t* AllocateFromArena(size_t blockSize);
+
+        size_t mPageSize = 0;
+
+        std::vector<uint8_t*> mArenas;
+        uint8_t* mArenaCursor = nullptr;
+        uint8_t* mArenaEnd = nullptr;
+
+        // Freed blocks of each size class, ready to be reused.
+        std::array<std::vector<uint8_t*>, kNumSizeClasses> mFreeBlocks;
+    };
+
+}}  // namespace backend::null
+
+#endif  // BACKEND_NULL_MEMORYALLOCATOR_H_
@@ -16,7 +16,9 @@
 
 #include "backend/Commands.h"
 
-#include <spirv-cross/spirv_cross.hpp>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 
 namespace backend { namespace null {
 
@@ -82,12 +84,7 @@ namespace backend { namespace null {
         return new Sampler(builder);
     }
     ShaderModuleBase* Device::CreateShaderModule(ShaderModuleBuilder* builder) {
-        auto module = new ShaderModule(builder);
-
-        spirv_cross::Compiler compiler(builder->AcquireSpirv());
-        module->ExtractSpirvInfo(compiler);
-
-        return module;
+        return new ShaderModule(builder);
     }
     SwapChainBase* Device::CreateSwapChain(SwapChainBuilder* builder) {
         return new SwapChain(builder);
@@ -102,6 +99,10 @@ namespace backend { namespace null {
     void Device::TickImpl() {
     }
 
+    bool Device::IsTextureFormatSupported(nxt::TextureFormat) const {
+        return true;
+    }
+
     void Device::AddPendingOperation(std::unique_ptr<PendingOperation> operation) {
         mPendingOperations.emplace_back(std::move(operation));
     }
@@ -109,6 +110,10 @@ namespace backend { namespace null {
         return std::move(mPendingOperations);
     }
 
+    MemoryAllocator* Device::GetMemoryAllocator() {
+        return &mMemoryAllocator;
+    }
+
     // Buffer
 
     struct BufferMapReadOperation : PendingOperation {
@@ -122,13 +127,26 @@ namespace backend { namespace null {
     };
 
     Buffer::Buffer(BufferBuilder* builder) : BufferBase(builder) {
-        if (GetAllowedUsage() & (nxt::BufferUsageBit::TransferDst | nxt::BufferUsageBit::MapRead |
-                                 nxt::BufferUsageBit::MapWrite)) {
-            mBackingData = std::unique_ptr<char[]>(new char[GetSize()]);
+        const nxt::BufferUsageBit usagesWithData =
+            nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst |
+            nxt::BufferUsageBit::MapRead | nxt::BufferUsageBit::MapWrite;
+        if (GetAllowedUsage() & usagesWithData) {
+            MemoryAllocator* allocator = ToBackend(GetDevice())->GetMemoryAllocator();
+            if (!allocator->Allocate(GetSize(), &mBackingData)) {
+                builder->HandleError("Failed to allocate the buffer's memory");
+            }
         }
     }
 
     Buffer::~Buffer() {
+        ToBackend(GetDevice())->GetMemoryAllocator()->Free(&mBackingData);
+    }
+
+    void Buffer::CopyFromBuffer(Buffer* source, const BufferCopyRegion& region) {
+        ASSERT(source->mBackingData.GetPointer() != nullptr &&
+               mBackingData.GetPointer() != nullptr);
+        memcpy(mBackingData.GetPointer() + region.destinationOffset,
+               source->mBackingData.GetPointer() + region.sourceOffset, region.size);
     }
 
     void Buffer::MapReadOperationCompleted(uint32_t serial, const void* ptr) {
@@ -136,18 +154,19 @@ namespace backend { namespace null {
     }
 
     void Buffer::SetSubDataImpl(uint32_t start, uint32_t count, const uint32_t* data) {
-        ASSERT(start + count <= GetSize());
-        ASSERT(mBackingData);
-        memcpy(mBackingData.get() + start, data, count);
+        ASSERT((start + count) * sizeof(uint32_t) <= GetSize());
+        ASSERT(mBackingData.GetPointer() != nullptr);
+        memcpy(mBackingData.GetPointer() + start * sizeof(uint32_t), data,
+               count * sizeof(uint32_t));
     }
 
     void Buffer::MapReadAsyncImpl(uint32_t serial, uint32_t start, uint32_t count) {
         ASSERT(start + count <= GetSize());
-        ASSERT(mBackingData);
+        ASSERT(mBackingData.GetPointer() != nullptr);
 
         auto operation = new BufferMapReadOperation;
         operation->buffer = this;
-        operation->ptr = mBackingData.get() + start;
+        operation->ptr = mBackingData.GetPointer() + start;
         operation->serial = serial;
 
         ToBackend(GetDevice())->AddPendingOperation(std::unique_ptr<PendingOperation>(operation));
@@ -171,8 +190,26 @@ namespace backend { namespace null {
 
     void CommandBuffer::Execute() {
         Command type;
+        BufferCopyBatch bufferCopies;
         while (mCommands.NextCommandId(&type)) {
             switch (type) {
+                case Command::CopyBufferToBuffer: {
+                    CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
+                    GatherBufferCopies(&mCommands, copy, &bufferCopies);
+                    GetDevice()->CountBufferCopies(
+                        bufferCopies.commandCount,
+                        static_cast<uint32_t>(bufferCopies.regions.size()));
+
+                    Buffer* source = ToBackend(bufferCopies.source);
+                    Buffer* destination = ToBackend(bufferCopies.destination);
+                    for (const auto& region : bufferCopies.regions) {
+                        destination->CopyFromBuffer(source, region);
+                    }
+                } break;
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    ToBackend(cmd->texture)->GenerateMipmaps(cmd->baseLevel, cmd->levelCount);
+                } break;
                 case Command::TransitionBufferUsage: {
                     TransitionBufferUsageCmd* cmd =
                         mCommands.NextCommand<TransitionBufferUsageCmd>();
@@ -181,7 +218,8 @@ namespace backend { namespace null {
                 case Command::TransitionTextureUsage: {
                     TransitionTextureUsageCmd* cmd =
                         mCommands.NextCommand<TransitionTextureUsageCmd>();
-                    cmd->texture->UpdateUsageInternal(cmd->usage);
+                    cmd->texture->UpdateLevelsUsageInternal(cmd->baseLevel, cmd->levelCount,
+                                                            cmd->usage);
                 } break;
                 default:
                     SkipCommand(&mCommands, type);
@@ -215,12 +253,112 @@ namespace backend { namespace null {
     // Texture
 
     Texture::Texture(TextureBuilder* builder) : TextureBase(builder) {
+        if (GetAllowedUsage() & nxt::TextureUsageBit::TransferDst) {
+            MemoryAllocator* allocator = ToBackend(GetDevice())->GetMemoryAllocator();
+            nxt::TextureFormat format = GetFormat();
+
+            mLevelData.resize(GetNumMipLevels());
+            for (uint32_t level = 0; level < GetNumMipLevels(); ++level) {
+                uint32_t width = std::max(GetWidth() >> level, 1u);
+                uint32_t height = std::max(GetHeight() >> level, 1u);
+                size_t levelSize = size_t(ComputeTextureRowSize(format, width)) *
+                                   ComputeTextureRowCount(format, height);
+                if (!allocator->Allocate(levelSize, &mLevelData[level])) {
+                    builder->HandleError("Failed to allocate the texture's memory");
+                    return;
+                }
+            }
+        }
     }
 
     Texture::~Texture() {
+        MemoryAllocator* allocator = ToBackend(GetDevice())->GetMemoryAllocator();
+        for (MemoryAllocation& levelData : mLevelData) {
+            allocator->Free(&levelData);
+        }
+    }
+
+    void Texture::SetSubDataImpl(uint32_t level,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 uint32_t rowPitch,
+                                 const uint8_t* data) {
+        ASSERT(level < mLevelData.size());
+
+        // Rows are rows of blocks for compressed formats.
+        nxt::TextureFormat format = GetFormat();
+        size_t levelRowSize = ComputeTextureRowSize(format, std::max(GetWidth() >> level, 1u));
+        size_t rowSize = ComputeTextureRowSize(format, width);
+        size_t firstRow = y / TextureFormatBlockHeight(format);
+        size_t rowOffset = x / TextureFormatBlockWidth(format) * TextureFormatBlockSize(format);
+
+        for (uint32_t row = 0; row < ComputeTextureRowCount(format, height); ++row) {
+            uint8_t* dst =
+                mLevelData[level].GetPointer() + (firstRow + row) * levelRowSize + rowOffset;
+            memcpy(dst, data + row * rowPitch, rowSize);
+        }
+    }
+
+    void Texture::GenerateMipmaps(uint32_t baseLevel, uint32_t levelCount) {
+        ASSERT(baseLevel + levelCount <= mLevelData.size());
+        // Only 8-bit unorm formats are filterable.
+        ASSERT(TextureFormatPixelSize(GetFormat()) == 4);
+
+        // Below this many texels per level the cost of spawning threads dominates.
+        constexpr uint32_t kMinTexelsPerThread = 64 * 64;
+        uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (uint32_t level = baseLevel + 1; level < baseLevel + levelCount; ++level) {
+            uint32_t srcWidth = std::max(GetWidth() >> (level - 1), 1u);
+            uint32_t srcHeight = std::max(GetHeight() >> (level - 1), 1u);
+            uint32_t dstWidth = std::max(GetWidth() >> level, 1u);
+            uint32_t dstHeight = std::max(GetHeight() >> level, 1u);
+            const uint8_t* src = mLevelData[level - 1].GetPointer();
+            uint8_t* dst = mLevelData[level].GetPointer();
+
+            auto FilterRows = [=](uint32_t startRow, uint32_t endRow) {
+                for (uint32_t y = startRow; y < endRow; ++y) {
+                    uint32_t y0 = std::min(2 * y, srcHeight - 1);
+                    uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+                    for (uint32_t x = 0; x < dstWidth; ++x) {
+                        uint32_t x0 = std::min(2 * x, srcWidth - 1);
+                        uint32_t x1 = std::min(2 * x + 1, srcWidth - 1);
+                        for (uint32_t c = 0; c < 4; ++c) {
+                            uint32_t sum = src[4 * (x0 + y0 * srcWidth) + c] +
+                                           src[4 * (x1 + y0 * srcWidth) + c] +
+                                           src[4 * (x0 + y1 * srcWidth) + c] +
+                                           src[4 * (x1 + y1 * srcWidth) + c];
+                            dst[4 * (x + y * dstWidth) + c] = static_cast<uint8_t>((sum + 2) / 4);
+                        }
+                    }
+                }
+            };
+
+            uint32_t threadCount =
+                std::min({maxThreads, dstHeight, dstWidth * dstHeight / kMinTexelsPerThread});
+            if (threadCount <= 1) {
+                FilterRows(0, dstHeight);
+                continue;
+            }
+
+            std::vector<std::thread> threads;
+            uint32_t rowsPerThread = (dstHeight + threadCount - 1) / threadCount;
+            for (uint32_t startRow = 0; startRow < dstHeight; startRow += rowsPerThread) {
+                threads.emplace_back(FilterRows, startRow,
+                                     std::min(startRow + rowsPerThread, dstHeight));
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
     }
 
-    void Texture::TransitionUsageImpl(nxt::TextureUsageBit, nxt::TextureUsageBit) {
+    void Texture::TransitionUsageImpl(uint32_t,
+                                      uint32_t,
+                                      nxt::TextureUsageBit,
+                                      nxt::TextureUsageBit) {
     }
 
     // SwapChain
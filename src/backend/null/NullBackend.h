@@ -36,6 +36,11 @@
 #include "backend/SwapChain.h"
 #include "backend/Texture.h"
 #include "backend/ToBackend.h"
+#include "backend/null/MemoryAllocator.h"
+
+namespace backend {
+    struct BufferCopyRegion;
+}
 
 namespace backend { namespace null {
 
@@ -119,11 +124,16 @@ namespace backend { namespace null {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        bool IsTextureFormatSupported(nxt::TextureFormat format) const override;
 
         void AddPendingOperation(std::unique_ptr<PendingOperation> operation);
         std::vector<std::unique_ptr<PendingOperation>> AcquirePendingOperations();
 
+        MemoryAllocator* GetMemoryAllocator();
+
       private:
+        // Declared first so that it outlives the resources referenced by pending operations.
+        MemoryAllocator mMemoryAllocator;
         std::vector<std::unique_ptr<PendingOperation>> mPendingOperations;
     };
 
@@ -133,6 +143,7 @@ namespace backend { namespace null {
         ~Buffer();
 
         void MapReadOperationCompleted(uint32_t serial, const void* ptr);
+        void CopyFromBuffer(Buffer* source, const BufferCopyRegion& region);
 
       private:
         void SetSubDataImpl(uint32_t start, uint32_t count, const uint32_t* data) override;
@@ -141,7 +152,7 @@ namespace backend { namespace null {
         void TransitionUsageImpl(nxt::BufferUsageBit currentUsage,
                                  nxt::BufferUsageBit targetUsage) override;
 
-        std::unique_ptr<char[]> mBackingData;
+        MemoryAllocation mBackingData;
     };
 
     class CommandBuffer : public CommandBufferBase {
@@ -169,8 +180,25 @@ namespace backend { namespace null {
         Texture(TextureBuilder* builder);
         ~Texture();
 
-        void TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+        void TransitionUsageImpl(uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit currentUsage,
                                  nxt::TextureUsageBit targetUsage) override;
+
+        // Fills levels [baseLevel + 1, baseLevel + levelCount) with a 2x2 box filter
+        void GenerateMipmaps(uint32_t baseLevel, uint32_t levelCount);
+
+      private:
+        void SetSubDataImpl(uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data) override;
+
+        // Tightly packed data for each of the mip levels
+        std::vector<MemoryAllocation> mLevelData;
     };
 
     class SwapChain : public SwapChainBase {
@@ -14,6 +14,7 @@
 
 #include "backend/opengl/BufferGL.h"
 
+#include "backend/opengl/FencedDeleterGL.h"
 #include "backend/opengl/OpenGLBackend.h"
 
 namespace backend { namespace opengl {
@@ -26,6 +27,11 @@ namespace backend { namespace opengl {
         glBufferData(GL_ARRAY_BUFFER, GetSize(), nullptr, GL_STATIC_DRAW);
     }
 
+    Buffer::~Buffer() {
+        ToBackend(GetDevice())->GetFencedDeleter()->DeleteBufferWhenUnused(mBuffer);
+        mBuffer = 0;
+    }
+
     GLuint Buffer::GetHandle() const {
         return mBuffer;
     }
@@ -26,6 +26,7 @@ namespace backend { namespace opengl {
     class Buffer : public BufferBase {
       public:
         Buffer(BufferBuilder* builder);
+        ~Buffer();
 
         GLuint GetHandle() const;
 
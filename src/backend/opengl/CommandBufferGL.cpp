@@ -17,6 +17,7 @@
 #include "backend/Commands.h"
 #include "backend/opengl/BufferGL.h"
 #include "backend/opengl/ComputePipelineGL.h"
+#include "backend/opengl/FencedDeleterGL.h"
 #include "backend/opengl/InputStateGL.h"
 #include "backend/opengl/OpenGLBackend.h"
 #include "backend/opengl/PersistentPipelineStateGL.h"
@@ -25,7 +26,10 @@
 #include "backend/opengl/SamplerGL.h"
 #include "backend/opengl/TextureGL.h"
 
+#include <algorithm>
 #include <cstring>
+#include <map>
+#include <vector>
 
 namespace backend { namespace opengl {
 
@@ -206,6 +210,300 @@ namespace backend { namespace opengl {
             InputState* mLastInputState = nullptr;
         };
 
+        RefCounted* GetBindingObject(BindGroup* group, uint32_t binding, nxt::BindingType type) {
+            switch (type) {
+                case nxt::BindingType::UniformBuffer:
+                case nxt::BindingType::StorageBuffer:
+                    return group->GetBindingAsBufferView(binding);
+                case nxt::BindingType::Sampler:
+                    return group->GetBindingAsSampler(binding);
+                case nxt::BindingType::SampledTexture:
+                    return group->GetBindingAsTextureView(binding);
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        // Bind groups are implemented by binding their resources to indexed buffer binding points
+        // chosen by the pipeline layout and to texture units chosen by the program of the
+        // pipeline. Applying them when they are set would re-bind everything even for groups that
+        // are overwritten before the next draw or that mostly contain the resources already bound.
+        //
+        // This structure tracks the current bind groups as well as dirty bits for the bindings
+        // that should be applied before the next draw or dispatch.
+        class BindGroupTracker {
+          public:
+            void OnBeginPass() {
+                // Bind groups have to be set again in each pass. Also we don't know what happened
+                // between this pass and the last one, so everything set in this pass is applied.
+                mGroups.fill(nullptr);
+                for (auto& dirtyBindings : mDirtyBindings) {
+                    dirtyBindings.reset();
+                }
+                mLayout = nullptr;
+                mPipeline = nullptr;
+            }
+
+            void OnSetBindGroup(uint32_t index, BindGroup* group) {
+                BindGroup* lastGroup = mGroups[index];
+                mGroups[index] = group;
+                if (group == lastGroup) {
+                    return;
+                }
+
+                const auto& layout = group->GetLayout()->GetBindingInfo();
+                if (lastGroup == nullptr || lastGroup->GetLayout() != group->GetLayout()) {
+                    mDirtyBindings[index] = layout.mask;
+                    return;
+                }
+
+                // Only the bindings whose resources changed need to be applied again. Bindings
+                // that are still dirty from the last group stay dirty.
+                for (uint32_t binding : IterateBitSet(layout.mask)) {
+                    nxt::BindingType type = layout.types[binding];
+                    if (GetBindingObject(group, binding, type) !=
+                        GetBindingObject(lastGroup, binding, type)) {
+                        mDirtyBindings[index].set(binding);
+                    }
+                }
+            }
+
+            void OnSetPipeline(PipelineBase* pipeline, PipelineGL* glPipeline) {
+                PipelineLayout* layout = ToBackend(pipeline->GetLayout());
+
+                // The buffer binding points of a group only depend on the layouts of the groups
+                // up to it so they stay valid for groups inherited from the last layout.
+                uint32_t inheritedGroups = 0;
+                if (mLayout != nullptr) {
+                    inheritedGroups = std::min(layout->GroupsInheritUpTo(mLayout),
+                                               static_cast<uint32_t>(kMaxBindGroups));
+                }
+                for (uint32_t index = inheritedGroups; index < kMaxBindGroups; ++index) {
+                    MarkBindingsDirty(index, kAllBindingTypes);
+                }
+
+                // Texture units are chosen by the program, pipelines that share their program
+                // also share the samplers and textures bound to their units.
+                if (mPipeline == nullptr ||
+                    mPipeline->GetProgramHandle() != glPipeline->GetProgramHandle()) {
+                    for (uint32_t index = 0; index < kMaxBindGroups; ++index) {
+                        MarkBindingsDirty(index, kSamplerAndTextureBindingTypes);
+                    }
+                }
+
+                mLayout = layout;
+                mPipeline = glPipeline;
+            }
+
+            // Called when a command rebinds textures on texture units for its own use.
+            void OnTextureUnitsClobbered() {
+                for (uint32_t index = 0; index < kMaxBindGroups; ++index) {
+                    MarkBindingsDirty(index, kTextureBindingTypes);
+                }
+            }
+
+            void Apply() {
+                for (uint32_t index : IterateBitSet(mLayout->GetBindGroupsLayoutMask())) {
+                    if (mDirtyBindings[index].none()) {
+                        continue;
+                    }
+                    ApplyBindGroup(index);
+                    mDirtyBindings[index].reset();
+                }
+            }
+
+            // Appends the buffers bound as storage buffers in the groups used by the current
+            // pipeline.
+            void GetStorageBuffers(std::vector<Buffer*>* buffers) const {
+                for (uint32_t index : IterateBitSet(mLayout->GetBindGroupsLayoutMask())) {
+                    BindGroup* group = mGroups[index];
+                    const auto& layout = group->GetLayout()->GetBindingInfo();
+                    for (uint32_t binding : IterateBitSet(layout.mask)) {
+                        if (layout.types[binding] == nxt::BindingType::StorageBuffer) {
+                            BufferView* view = ToBackend(group->GetBindingAsBufferView(binding));
+                            buffers->push_back(ToBackend(view->GetBuffer()));
+                        }
+                    }
+                }
+            }
+
+          private:
+            using BindingTypeMask = uint32_t;
+            static constexpr BindingTypeMask kTextureBindingTypes =
+                1 << static_cast<uint32_t>(nxt::BindingType::SampledTexture);
+            static constexpr BindingTypeMask kSamplerAndTextureBindingTypes =
+                kTextureBindingTypes | 1 << static_cast<uint32_t>(nxt::BindingType::Sampler);
+            static constexpr BindingTypeMask kAllBindingTypes = ~0u;
+
+            void MarkBindingsDirty(uint32_t index, BindingTypeMask types) {
+                BindGroup* group = mGroups[index];
+                if (group == nullptr) {
+                    return;
+                }
+
+                const auto& layout = group->GetLayout()->GetBindingInfo();
+                for (uint32_t binding : IterateBitSet(layout.mask)) {
+                    if (types & (1 << static_cast<uint32_t>(layout.types[binding]))) {
+                        mDirtyBindings[index].set(binding);
+                    }
+                }
+            }
+
+            void ApplyBindGroup(uint32_t index) {
+                BindGroup* group = mGroups[index];
+                const auto& indices = mLayout->GetBindingIndexInfo()[index];
+                const auto& layout = group->GetLayout()->GetBindingInfo();
+
+                for (uint32_t binding : IterateBitSet(mDirtyBindings[index])) {
+                    switch (layout.types[binding]) {
+                        case nxt::BindingType::UniformBuffer: {
+                            BufferView* view = ToBackend(group->GetBindingAsBufferView(binding));
+                            GLuint buffer = ToBackend(view->GetBuffer())->GetHandle();
+                            GLuint uboIndex = indices[binding];
+
+                            glBindBufferRange(GL_UNIFORM_BUFFER, uboIndex, buffer,
+                                              view->GetOffset(), view->GetSize());
+                        } break;
+
+                        case nxt::BindingType::Sampler: {
+                            GLuint sampler =
+                                ToBackend(group->GetBindingAsSampler(binding))->GetHandle();
+                            GLuint samplerIndex = indices[binding];
+
+                            for (auto unit : mPipeline->GetTextureUnitsForSampler(samplerIndex)) {
+                                glBindSampler(unit, sampler);
+                            }
+                        } break;
+
+                        case nxt::BindingType::SampledTexture: {
+                            TextureView* view = ToBackend(group->GetBindingAsTextureView(binding));
+                            GLuint handle = view->GetHandle();
+                            GLenum target = view->GetGLTarget();
+                            GLuint textureIndex = indices[binding];
+
+                            for (auto unit : mPipeline->GetTextureUnitsForTexture(textureIndex)) {
+                                glActiveTexture(GL_TEXTURE0 + unit);
+                                glBindTexture(target, handle);
+                            }
+                        } break;
+
+                        case nxt::BindingType::StorageBuffer: {
+                            BufferView* view = ToBackend(group->GetBindingAsBufferView(binding));
+                            GLuint buffer = ToBackend(view->GetBuffer())->GetHandle();
+                            GLuint ssboIndex = indices[binding];
+
+                            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, ssboIndex, buffer,
+                                              view->GetOffset(), view->GetSize());
+                        } break;
+                    }
+                }
+            }
+
+            std::array<BindGroup*, kMaxBindGroups> mGroups = {};
+            std::array<std::bitset<kMaxBindingsPerGroup>, kMaxBindGroups> mDirtyBindings;
+
+            PipelineLayout* mLayout = nullptr;
+            PipelineGL* mPipeline = nullptr;
+        };
+
+        // Returns the glMemoryBarrier bits making shader writes visible to the accesses of a
+        // buffer with this usage.
+        GLbitfield MemoryBarrierBitsForUsage(nxt::BufferUsageBit usage) {
+            GLbitfield bits = 0;
+            if (usage & (nxt::BufferUsageBit::MapRead | nxt::BufferUsageBit::MapWrite)) {
+                bits |= GL_BUFFER_UPDATE_BARRIER_BIT;
+            }
+            // Copies use glCopyBufferSubData or pixel pack and unpack buffers.
+            if (usage & (nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)) {
+                bits |= GL_BUFFER_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+            }
+            if (usage & nxt::BufferUsageBit::Index) {
+                bits |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+            }
+            if (usage & nxt::BufferUsageBit::Vertex) {
+                bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+            }
+            if (usage & nxt::BufferUsageBit::Uniform) {
+                bits |= GL_UNIFORM_BARRIER_BIT;
+            }
+            if (usage & nxt::BufferUsageBit::Storage) {
+                bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+            }
+            return bits;
+        }
+
+        // Writes of compute shaders to storage buffers are only made visible to later accesses by
+        // glMemoryBarrier with the bits for the kinds of these accesses. Issuing a barrier with
+        // all the bits after each dispatch serializes chains of independent dispatches and
+        // flushes caches that nothing written by the dispatch goes through.
+        //
+        // This structure tracks the buffers written by dispatches along with the barrier bits
+        // issued since, and batches the bits needed by the following accesses to them in a
+        // barrier applied before the next operation. Storage is an exclusive buffer usage, so
+        // accesses other than through storage buffers always follow a usage transition which
+        // tells how the buffer is accessed next.
+        class MemoryBarrierTracker {
+          public:
+            // Storage buffers can be both read and written by shaders so the writes of previous
+            // dispatches must be visible to any shader using them.
+            void OnShaderStorageAccess(const BindGroupTracker& bindGroups) {
+                mStorageBuffers.clear();
+                bindGroups.GetStorageBuffers(&mStorageBuffers);
+                for (Buffer* buffer : mStorageBuffers) {
+                    Require(buffer, GL_SHADER_STORAGE_BARRIER_BIT);
+                }
+            }
+
+            // Called after a dispatch, following OnShaderStorageAccess, to record the buffers it
+            // may have written.
+            void OnDispatchDone() {
+                for (Buffer* buffer : mStorageBuffers) {
+                    mWrittenBuffers[buffer] = 0;
+                }
+            }
+
+            void OnTransitionBufferUsage(Buffer* buffer, nxt::BufferUsageBit usage) {
+                Require(buffer, MemoryBarrierBitsForUsage(usage));
+            }
+
+            // Later command buffers and the operations on the buffers themselves aren't tracked,
+            // so the writes are made visible to every usage the written buffers allow.
+            void OnEndCommandBuffer() {
+                for (const auto& written : mWrittenBuffers) {
+                    Require(written.first, MemoryBarrierBitsForUsage(
+                                               written.first->GetAllowedUsage()));
+                }
+                Apply();
+                mWrittenBuffers.clear();
+            }
+
+            void Apply() {
+                if (mPendingBits == 0) {
+                    return;
+                }
+
+                glMemoryBarrier(mPendingBits);
+                for (auto& written : mWrittenBuffers) {
+                    written.second |= mPendingBits;
+                }
+                mPendingBits = 0;
+            }
+
+          private:
+            void Require(Buffer* buffer, GLbitfield bits) {
+                auto it = mWrittenBuffers.find(buffer);
+                if (it != mWrittenBuffers.end()) {
+                    mPendingBits |= bits & ~it->second;
+                }
+            }
+
+            // The written buffers and the barrier bits issued since they were last written.
+            std::map<Buffer*, GLbitfield> mWrittenBuffers;
+            GLbitfield mPendingBits = 0;
+
+            std::vector<Buffer*> mStorageBuffers;
+        };
+
     }  // namespace
 
     CommandBuffer::CommandBuffer(CommandBufferBuilder* builder)
@@ -218,27 +516,34 @@ namespace backend { namespace opengl {
 
     void CommandBuffer::Execute() {
         Command type;
+        BufferCopyBatch bufferCopies;
         PipelineBase* lastPipeline = nullptr;
         PipelineGL* lastGLPipeline = nullptr;
         RenderPipeline* lastRenderPipeline = nullptr;
         uint32_t indexBufferOffset = 0;
+        std::vector<const void*> multiDrawIndexOffsets;
 
         PersistentPipelineState persistentPipelineState;
         persistentPipelineState.SetDefaultState();
 
         PushConstantTracker pushConstants;
         InputBufferTracker inputBuffers;
+        BindGroupTracker bindGroups;
+        MemoryBarrierTracker barriers;
 
         RenderPass* currentRenderPass = nullptr;
         Framebuffer* currentFramebuffer = nullptr;
         uint32_t currentSubpass = 0;
         GLuint currentFBO = 0;
 
+        FencedDeleter* deleter = ToBackend(GetDevice())->GetFencedDeleter();
+
         while (mCommands.NextCommandId(&type)) {
             switch (type) {
                 case Command::BeginComputePass: {
                     mCommands.NextCommand<BeginComputePassCmd>();
                     pushConstants.OnBeginPass();
+                    bindGroups.OnBeginPass();
                 } break;
 
                 case Command::BeginRenderPass: {
@@ -252,6 +557,7 @@ namespace backend { namespace opengl {
                     mCommands.NextCommand<BeginRenderSubpassCmd>();
                     pushConstants.OnBeginPass();
                     inputBuffers.OnBeginPass();
+                    bindGroups.OnBeginPass();
 
                     // TODO(kainino@chromium.org): This is added to possibly
                     // work around an issue seen on Windows/Intel. It should
@@ -280,11 +586,11 @@ namespace backend { namespace opengl {
                         uint32_t attachment = subpass.colorAttachments[location];
 
                         auto textureView = currentFramebuffer->GetTextureView(attachment);
-                        GLuint texture = ToBackend(textureView->GetTexture())->GetHandle();
+                        Texture* texture = ToBackend(textureView->GetTexture());
 
                         // Attach color buffers.
                         glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + location,
-                                               GL_TEXTURE_2D, texture, 0);
+                                               texture->GetGLTarget(), texture->GetHandle(), 0);
                         drawBuffers[location] = GL_COLOR_ATTACHMENT0 + location;
                         attachmentCount = location + 1;
 
@@ -299,8 +605,8 @@ namespace backend { namespace opengl {
                         uint32_t attachmentSlot = subpass.depthStencilAttachment;
 
                         auto textureView = currentFramebuffer->GetTextureView(attachmentSlot);
-                        GLuint texture = ToBackend(textureView->GetTexture())->GetHandle();
-                        nxt::TextureFormat format = textureView->GetTexture()->GetFormat();
+                        Texture* texture = ToBackend(textureView->GetTexture());
+                        nxt::TextureFormat format = texture->GetFormat();
 
                         // Attach depth/stencil buffer.
                         GLenum glAttachment = 0;
@@ -316,14 +622,25 @@ namespace backend { namespace opengl {
                             glAttachment = GL_STENCIL_ATTACHMENT;
                         }
 
-                        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, glAttachment, GL_TEXTURE_2D,
-                                               texture, 0);
+                        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, glAttachment,
+                                               texture->GetGLTarget(), texture->GetHandle(), 0);
 
                         // TODO(kainino@chromium.org): the depth/stencil clears (later in
                         // this function) may be undefined for other texture formats.
                         ASSERT(format == nxt::TextureFormat::D32FloatS8Uint);
                     }
 
+                    // The viewport and scissor are reset to the whole framebuffer for each
+                    // subpass. The scissor test is only enabled inside subpasses and the clears
+                    // below honor it, so they always cover the whole framebuffer like the load
+                    // ops of the other backends.
+                    GLsizei width = currentFramebuffer->GetWidth();
+                    GLsizei height = currentFramebuffer->GetHeight();
+                    glViewport(0, 0, width, height);
+                    glDepthRangef(0.0f, 1.0f);
+                    glScissor(0, 0, width, height);
+                    glEnable(GL_SCISSOR_TEST);
+
                     // Clear framebuffer attachments as needed
 
                     for (unsigned int location : IterateBitSet(subpass.colorAttachmentsSet)) {
@@ -368,19 +685,29 @@ namespace backend { namespace opengl {
                     }
 
                     glBlendColor(0, 0, 0, 0);
-                    glViewport(0, 0, currentFramebuffer->GetWidth(),
-                               currentFramebuffer->GetHeight());
                 } break;
 
                 case Command::CopyBufferToBuffer: {
                     CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
-
-                    glBindBuffer(GL_PIXEL_PACK_BUFFER, ToBackend(src.buffer)->GetHandle());
-                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ToBackend(dst.buffer)->GetHandle());
-                    glCopyBufferSubData(GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, src.offset,
-                                        dst.offset, copy->size);
+                    GatherBufferCopies(&mCommands, copy, &bufferCopies);
+                    GetDevice()->CountBufferCopies(
+                        bufferCopies.commandCount,
+                        static_cast<uint32_t>(bufferCopies.regions.size()));
+                    if (bufferCopies.regions.empty()) {
+                        break;
+                    }
+                    barriers.Apply();
+
+                    // Bind the buffers once for the whole batch of copies.
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER,
+                                 ToBackend(bufferCopies.source)->GetHandle());
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER,
+                                 ToBackend(bufferCopies.destination)->GetHandle());
+                    for (const auto& region : bufferCopies.regions) {
+                        glCopyBufferSubData(GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
+                                            region.sourceOffset, region.destinationOffset,
+                                            region.size);
+                    }
 
                     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
@@ -388,72 +715,106 @@ namespace backend { namespace opengl {
 
                 case Command::CopyBufferToTexture: {
                     CopyBufferToTextureCmd* copy = mCommands.NextCommand<CopyBufferToTextureCmd>();
+                    barriers.Apply();
                     auto& src = copy->source;
                     auto& dst = copy->destination;
                     Buffer* buffer = ToBackend(src.buffer.Get());
                     Texture* texture = ToBackend(dst.texture.Get());
-                    GLenum target = texture->GetGLTarget();
-                    auto format = texture->GetGLFormat();
 
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->GetHandle());
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(target, texture->GetHandle());
 
-                    ASSERT(texture->GetDimension() == nxt::TextureDimension::e2D);
-                    glPixelStorei(GL_UNPACK_ROW_LENGTH,
-                                  copy->rowPitch / TextureFormatPixelSize(texture->GetFormat()));
-                    glTexSubImage2D(target, dst.level, dst.x, dst.y, dst.width, dst.height,
-                                    format.format, format.type,
-                                    reinterpret_cast<void*>(static_cast<uintptr_t>(src.offset)));
-                    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                    void* offset = reinterpret_cast<void*>(static_cast<uintptr_t>(src.offset));
+                    texture->UploadRegion(dst.level, dst.x, dst.y, dst.z, dst.width, dst.height,
+                                          dst.depth, copy->rowPitch, offset);
                     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                    bindGroups.OnTextureUnitsClobbered();
                 } break;
 
                 case Command::CopyTextureToBuffer: {
                     CopyTextureToBufferCmd* copy = mCommands.NextCommand<CopyTextureToBufferCmd>();
+                    barriers.Apply();
                     auto& src = copy->source;
                     auto& dst = copy->destination;
                     Texture* texture = ToBackend(src.texture.Get());
                     Buffer* buffer = ToBackend(dst.buffer.Get());
                     auto format = texture->GetGLFormat();
+                    nxt::TextureFormat textureFormat = texture->GetFormat();
+
+                    uint32_t rowCount = ComputeTextureRowCount(textureFormat, src.height);
+                    uintptr_t imageSize = uintptr_t(copy->rowPitch) * rowCount;
+
+                    // Compressed textures can't be attached to a framebuffer, read their blocks
+                    // directly instead, one row of blocks at a time to honor the row pitch.
+                    if (TextureFormatIsCompressed(textureFormat)) {
+                        uint32_t blockHeight = TextureFormatBlockHeight(textureFormat);
+                        uint32_t rowSize = ComputeTextureRowSize(textureFormat, src.width);
+
+                        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer->GetHandle());
+                        for (uint32_t layer = 0; layer < src.depth; ++layer) {
+                            for (uint32_t row = 0; row < rowCount; ++row) {
+                                uint32_t rowY = row * blockHeight;
+                                uint32_t rowHeight = std::min(blockHeight, src.height - rowY);
+                                uintptr_t rowOffset = dst.offset + layer * imageSize +
+                                                      uintptr_t(row) * copy->rowPitch;
+                                glGetCompressedTextureSubImage(
+                                    texture->GetHandle(), src.level, src.x, src.y + rowY,
+                                    src.z + layer, src.width, rowHeight, 1, rowSize,
+                                    reinterpret_cast<void*>(rowOffset));
+                            }
+                        }
+                        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                        break;
+                    }
 
                     // The only way to move data from a texture to a buffer in GL is via
-                    // glReadPixels with a pack buffer. Create a temporary FBO for the copy.
-                    ASSERT(texture->GetDimension() == nxt::TextureDimension::e2D);
-                    glBindTexture(GL_TEXTURE_2D, texture->GetHandle());
-
+                    // glReadPixels with a pack buffer. Create a temporary FBO for the copy and
+                    // attach each layer or slice to it in turn.
                     GLuint readFBO = 0;
                     glGenFramebuffers(1, &readFBO);
                     glBindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
 
-                    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
-                                           texture->GetHandle(), src.level);
-
                     glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer->GetHandle());
                     glPixelStorei(GL_PACK_ROW_LENGTH,
                                   copy->rowPitch / TextureFormatPixelSize(texture->GetFormat()));
-                    ASSERT(src.depth == 1 && src.z == 0);
-                    void* offset = reinterpret_cast<void*>(static_cast<uintptr_t>(dst.offset));
-                    glReadPixels(src.x, src.y, src.width, src.height, format.format, format.type,
-                                 offset);
+                    for (uint32_t layer = 0; layer < src.depth; ++layer) {
+                        if (texture->GetDimension() == nxt::TextureDimension::e2D) {
+                            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                                   GL_TEXTURE_2D, texture->GetHandle(),
+                                                   src.level);
+                        } else {
+                            glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                                      texture->GetHandle(), src.level,
+                                                      src.z + layer);
+                        }
+
+                        void* offset = reinterpret_cast<void*>(
+                            static_cast<uintptr_t>(dst.offset + layer * imageSize));
+                        glReadPixels(src.x, src.y, src.width, src.height, format.format,
+                                     format.type, offset);
+                    }
                     glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
                     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-                    glDeleteFramebuffers(1, &readFBO);
+                    deleter->DeleteFramebufferWhenUnused(readFBO);
                 } break;
 
                 case Command::Dispatch: {
                     DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
                     pushConstants.Apply(lastPipeline, lastGLPipeline);
+                    bindGroups.Apply();
+                    barriers.OnShaderStorageAccess(bindGroups);
+                    barriers.Apply();
                     glDispatchCompute(dispatch->x, dispatch->y, dispatch->z);
-                    // TODO(cwallez@chromium.org): add barriers to the API
-                    glMemoryBarrier(GL_ALL_BARRIER_BITS);
+                    barriers.OnDispatchDone();
                 } break;
 
                 case Command::DrawArrays: {
                     DrawArraysCmd* draw = mCommands.NextCommand<DrawArraysCmd>();
                     pushConstants.Apply(lastPipeline, lastGLPipeline);
                     inputBuffers.Apply();
+                    bindGroups.Apply();
+                    barriers.OnShaderStorageAccess(bindGroups);
+                    barriers.Apply();
 
                     if (draw->firstInstance > 0) {
                         glDrawArraysInstancedBaseInstance(
@@ -471,6 +832,9 @@ namespace backend { namespace opengl {
                     DrawElementsCmd* draw = mCommands.NextCommand<DrawElementsCmd>();
                     pushConstants.Apply(lastPipeline, lastGLPipeline);
                     inputBuffers.Apply();
+                    bindGroups.Apply();
+                    barriers.OnShaderStorageAccess(bindGroups);
+                    barriers.Apply();
 
                     nxt::IndexFormat indexFormat = lastRenderPipeline->GetIndexFormat();
                     size_t formatSize = IndexFormatSize(indexFormat);
@@ -504,17 +868,184 @@ namespace backend { namespace opengl {
 
                 case Command::EndRenderSubpass: {
                     mCommands.NextCommand<EndRenderSubpassCmd>();
-                    glDeleteFramebuffers(1, &currentFBO);
+                    const auto& subpass = currentRenderPass->GetSubpassInfo(currentSubpass);
+
+                    // The resolve blits below and the operations outside of subpasses must not
+                    // be scissored.
+                    glDisable(GL_SCISSOR_TEST);
+
+                    // Resolve the multisampled color attachments by blitting them to their
+                    // resolve attachments. This must happen before the multisampled attachments
+                    // are invalidated, which is the common case since only the resolved result
+                    // is used after the subpass.
+                    if (subpass.resolveAttachmentsSet.any()) {
+                        GLint width = currentFramebuffer->GetWidth();
+                        GLint height = currentFramebuffer->GetHeight();
+
+                        GLuint resolveFBO = 0;
+                        glGenFramebuffers(1, &resolveFBO);
+                        glBindFramebuffer(GL_READ_FRAMEBUFFER, currentFBO);
+                        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFBO);
+
+                        for (unsigned int location :
+                             IterateBitSet(subpass.resolveAttachmentsSet)) {
+                            uint32_t attachmentSlot = subpass.resolveAttachments[location];
+                            Texture* texture = ToBackend(
+                                currentFramebuffer->GetTextureView(attachmentSlot)->GetTexture());
+                            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                                   texture->GetGLTarget(), texture->GetHandle(),
+                                                   0);
+                            glReadBuffer(GL_COLOR_ATTACHMENT0 + location);
+                            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+                                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                        }
+
+                        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+                        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, currentFBO);
+                        deleter->DeleteFramebufferWhenUnused(resolveFBO);
+                    }
+
+                    // Store op - invalidate the attachments discarded after their last use.
+                    // glInvalidateFramebuffer is only core since OpenGL 4.3, without it
+                    // discarded attachments are stored instead.
+                    if (glInvalidateFramebuffer != nullptr) {
+                        std::array<GLenum, kMaxColorAttachments + 2> discarded;
+                        GLsizei discardedCount = 0;
+
+                        for (unsigned int location : IterateBitSet(subpass.colorAttachmentsSet)) {
+                            uint32_t attachmentSlot = subpass.colorAttachments[location];
+                            const auto& attachmentInfo =
+                                currentRenderPass->GetAttachmentInfo(attachmentSlot);
+                            if (attachmentInfo.lastSubpass == currentSubpass &&
+                                attachmentInfo.colorStoreOp == nxt::StoreOp::Discard) {
+                                discarded[discardedCount++] = GL_COLOR_ATTACHMENT0 + location;
+                            }
+                        }
+
+                        if (subpass.depthStencilAttachmentSet) {
+                            const auto& attachmentInfo = currentRenderPass->GetAttachmentInfo(
+                                subpass.depthStencilAttachment);
+                            if (attachmentInfo.lastSubpass == currentSubpass) {
+                                if (TextureFormatHasDepth(attachmentInfo.format) &&
+                                    attachmentInfo.depthStoreOp == nxt::StoreOp::Discard) {
+                                    discarded[discardedCount++] = GL_DEPTH_ATTACHMENT;
+                                }
+                                if (TextureFormatHasStencil(attachmentInfo.format) &&
+                                    attachmentInfo.stencilStoreOp == nxt::StoreOp::Discard) {
+                                    discarded[discardedCount++] = GL_STENCIL_ATTACHMENT;
+                                }
+                            }
+                        }
+
+                        if (discardedCount > 0) {
+                            glInvalidateFramebuffer(GL_DRAW_FRAMEBUFFER, discardedCount,
+                                                    discarded.data());
+                        }
+                    }
+
+                    deleter->DeleteFramebufferWhenUnused(currentFBO);
                     currentFBO = 0;
                     currentSubpass += 1;
                 } break;
 
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    Texture* texture = ToBackend(cmd->texture.Get());
+                    GLenum target = texture->GetGLTarget();
+
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(target, texture->GetHandle());
+
+                    // glGenerateMipmap fills every level after BASE_LEVEL up to MAX_LEVEL so
+                    // restrict the range to the requested levels for the duration of the call.
+                    glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, cmd->baseLevel);
+                    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL,
+                                    cmd->baseLevel + cmd->levelCount - 1);
+                    glGenerateMipmap(target);
+                    glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+                    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, texture->GetNumMipLevels() - 1);
+                    bindGroups.OnTextureUnitsClobbered();
+                } break;
+
+                case Command::MultiDrawArrays: {
+                    MultiDrawArraysCmd* draw = mCommands.NextCommand<MultiDrawArraysCmd>();
+                    uint32_t* vertexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstVertices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    pushConstants.Apply(lastPipeline, lastGLPipeline);
+                    inputBuffers.Apply();
+                    bindGroups.Apply();
+                    barriers.OnShaderStorageAccess(bindGroups);
+                    barriers.Apply();
+
+                    GLenum topology = lastRenderPipeline->GetGLPrimitiveTopology();
+                    // There is no instanced version of glMultiDrawArrays, other draws are
+                    // submitted one by one.
+                    if (draw->instanceCount == 1 && draw->firstInstance == 0) {
+                        glMultiDrawArrays(topology, reinterpret_cast<const GLint*>(firstVertices),
+                                          reinterpret_cast<const GLsizei*>(vertexCounts),
+                                          draw->drawCount);
+                    } else if (draw->firstInstance > 0) {
+                        for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                            glDrawArraysInstancedBaseInstance(topology, firstVertices[i],
+                                                              vertexCounts[i], draw->instanceCount,
+                                                              draw->firstInstance);
+                        }
+                    } else {
+                        // This branch is only needed on OpenGL < 4.2
+                        for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                            glDrawArraysInstanced(topology, firstVertices[i], vertexCounts[i],
+                                                  draw->instanceCount);
+                        }
+                    }
+                } break;
+
+                case Command::MultiDrawElements: {
+                    MultiDrawElementsCmd* draw = mCommands.NextCommand<MultiDrawElementsCmd>();
+                    uint32_t* indexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstIndices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    pushConstants.Apply(lastPipeline, lastGLPipeline);
+                    inputBuffers.Apply();
+                    bindGroups.Apply();
+                    barriers.OnShaderStorageAccess(bindGroups);
+                    barriers.Apply();
+
+                    GLenum topology = lastRenderPipeline->GetGLPrimitiveTopology();
+                    nxt::IndexFormat indexFormat = lastRenderPipeline->GetIndexFormat();
+                    size_t formatSize = IndexFormatSize(indexFormat);
+                    GLenum formatType = IndexFormatType(indexFormat);
+
+                    multiDrawIndexOffsets.resize(draw->drawCount);
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        multiDrawIndexOffsets[i] = reinterpret_cast<void*>(
+                            firstIndices[i] * formatSize + indexBufferOffset);
+                    }
+
+                    if (draw->instanceCount == 1 && draw->firstInstance == 0) {
+                        glMultiDrawElements(topology, reinterpret_cast<const GLsizei*>(indexCounts),
+                                            formatType, multiDrawIndexOffsets.data(),
+                                            draw->drawCount);
+                    } else if (draw->firstInstance > 0) {
+                        for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                            glDrawElementsInstancedBaseInstance(
+                                topology, indexCounts[i], formatType, multiDrawIndexOffsets[i],
+                                draw->instanceCount, draw->firstInstance);
+                        }
+                    } else {
+                        // This branch is only needed on OpenGL < 4.2
+                        for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                            glDrawElementsInstanced(topology, indexCounts[i], formatType,
+                                                    multiDrawIndexOffsets[i], draw->instanceCount);
+                        }
+                    }
+                } break;
+
                 case Command::SetComputePipeline: {
                     SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
                     ToBackend(cmd->pipeline)->ApplyNow();
                     lastGLPipeline = ToBackend(cmd->pipeline).Get();
                     lastPipeline = ToBackend(cmd->pipeline).Get();
                     pushConstants.OnSetPipeline(lastPipeline);
+                    bindGroups.OnSetPipeline(lastPipeline, lastGLPipeline);
                 } break;
 
                 case Command::SetRenderPipeline: {
@@ -526,6 +1057,7 @@ namespace backend { namespace opengl {
 
                     pushConstants.OnSetPipeline(lastPipeline);
                     inputBuffers.OnSetPipeline(lastRenderPipeline);
+                    bindGroups.OnSetPipeline(lastPipeline, lastGLPipeline);
                 } break;
 
                 case Command::SetPushConstants: {
@@ -544,64 +1076,22 @@ namespace backend { namespace opengl {
                     glBlendColor(cmd->r, cmd->g, cmd->b, cmd->a);
                 } break;
 
-                case Command::SetBindGroup: {
-                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
-                    size_t groupIndex = cmd->index;
-                    BindGroup* group = ToBackend(cmd->group.Get());
-
-                    const auto& indices =
-                        ToBackend(lastPipeline->GetLayout())->GetBindingIndexInfo()[groupIndex];
-                    const auto& layout = group->GetLayout()->GetBindingInfo();
-
-                    for (uint32_t binding : IterateBitSet(layout.mask)) {
-                        switch (layout.types[binding]) {
-                            case nxt::BindingType::UniformBuffer: {
-                                BufferView* view =
-                                    ToBackend(group->GetBindingAsBufferView(binding));
-                                GLuint buffer = ToBackend(view->GetBuffer())->GetHandle();
-                                GLuint uboIndex = indices[binding];
-
-                                glBindBufferRange(GL_UNIFORM_BUFFER, uboIndex, buffer,
-                                                  view->GetOffset(), view->GetSize());
-                            } break;
-
-                            case nxt::BindingType::Sampler: {
-                                GLuint sampler =
-                                    ToBackend(group->GetBindingAsSampler(binding))->GetHandle();
-                                GLuint samplerIndex = indices[binding];
-
-                                for (auto unit :
-                                     lastGLPipeline->GetTextureUnitsForSampler(samplerIndex)) {
-                                    glBindSampler(unit, sampler);
-                                }
-                            } break;
-
-                            case nxt::BindingType::SampledTexture: {
-                                TextureView* view =
-                                    ToBackend(group->GetBindingAsTextureView(binding));
-                                Texture* texture = ToBackend(view->GetTexture());
-                                GLuint handle = texture->GetHandle();
-                                GLenum target = texture->GetGLTarget();
-                                GLuint textureIndex = indices[binding];
-
-                                for (auto unit :
-                                     lastGLPipeline->GetTextureUnitsForTexture(textureIndex)) {
-                                    glActiveTexture(GL_TEXTURE0 + unit);
-                                    glBindTexture(target, handle);
-                                }
-                            } break;
+                // NXT's framebuffer coordinates match GL's window coordinates because the
+                // vertex shaders flip the Y axis, so the rectangles are used as is.
+                case Command::SetViewport: {
+                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
+                    glViewportIndexedf(0, cmd->x, cmd->y, cmd->width, cmd->height);
+                    glDepthRangef(cmd->minDepth, cmd->maxDepth);
+                } break;
 
-                            case nxt::BindingType::StorageBuffer: {
-                                BufferView* view =
-                                    ToBackend(group->GetBindingAsBufferView(binding));
-                                GLuint buffer = ToBackend(view->GetBuffer())->GetHandle();
-                                GLuint ssboIndex = indices[binding];
+                case Command::SetScissorRect: {
+                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
+                    glScissor(cmd->x, cmd->y, cmd->width, cmd->height);
+                } break;
 
-                                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, ssboIndex, buffer,
-                                                  view->GetOffset(), view->GetSize());
-                            } break;
-                        }
-                    }
+                case Command::SetBindGroup: {
+                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
+                    bindGroups.OnSetBindGroup(cmd->index, ToBackend(cmd->group.Get()));
                 } break;
 
                 case Command::SetIndexBuffer: {
@@ -622,17 +1112,21 @@ namespace backend { namespace opengl {
                         mCommands.NextCommand<TransitionBufferUsageCmd>();
 
                     cmd->buffer->UpdateUsageInternal(cmd->usage);
+                    barriers.OnTransitionBufferUsage(ToBackend(cmd->buffer.Get()), cmd->usage);
                 } break;
 
                 case Command::TransitionTextureUsage: {
                     TransitionTextureUsageCmd* cmd =
                         mCommands.NextCommand<TransitionTextureUsageCmd>();
 
-                    cmd->texture->UpdateUsageInternal(cmd->usage);
+                    cmd->texture->UpdateLevelsUsageInternal(cmd->baseLevel, cmd->levelCount,
+                                                            cmd->usage);
                 } break;
             }
         }
 
+        barriers.OnEndCommandBuffer();
+
         // HACK: cleanup a tiny bit of state to make this work with
         // virtualized contexts enabled in Chromium
         glBindSampler(0, 0);
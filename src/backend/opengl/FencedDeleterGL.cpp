@@ -0,0 +1,92 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "backend/opengl/FencedDeleterGL.h"
+
+#include "backend/opengl/OpenGLBackend.h"
+
+namespace backend { namespace opengl {
+
+    FencedDeleter::FencedDeleter(Device* device) : mDevice(device) {
+    }
+
+    FencedDeleter::~FencedDeleter() {
+        ASSERT(mBuffersToDelete.Empty());
+        ASSERT(mFramebuffersToDelete.Empty());
+        ASSERT(mProgramsToDelete.Empty());
+        ASSERT(mSamplersToDelete.Empty());
+        ASSERT(mTexturesToDelete.Empty());
+        ASSERT(mVertexArraysToDelete.Empty());
+    }
+
+    void FencedDeleter::DeleteBufferWhenUnused(GLuint buffer) {
+        mBuffersToDelete.Enqueue(buffer, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteFramebufferWhenUnused(GLuint framebuffer) {
+        mFramebuffersToDelete.Enqueue(framebuffer, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteProgramWhenUnused(GLuint program) {
+        mProgramsToDelete.Enqueue(program, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteSamplerWhenUnused(GLuint sampler) {
+        mSamplersToDelete.Enqueue(sampler, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteTextureWhenUnused(GLuint texture) {
+        mTexturesToDelete.Enqueue(texture, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteVertexArrayWhenUnused(GLuint vertexArray) {
+        mVertexArraysToDelete.Enqueue(vertexArray, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::Tick(Serial completedSerial) {
+        // Framebuffers and vertex arrays are containers referencing textures and buffers so they
+        // are deleted first, even though GL would keep the attachments alive for us.
+        for (GLuint framebuffer : mFramebuffersToDelete.IterateUpTo(completedSerial)) {
+            glDeleteFramebuffers(1, &framebuffer);
+        }
+        mFramebuffersToDelete.ClearUpTo(completedSerial);
+
+        for (GLuint vertexArray : mVertexArraysToDelete.IterateUpTo(completedSerial)) {
+            glDeleteVertexArrays(1, &vertexArray);
+        }
+        mVertexArraysToDelete.ClearUpTo(completedSerial);
+
+        for (GLuint program : mProgramsToDelete.IterateUpTo(completedSerial)) {
+            glDeleteProgram(program);
+        }
+        mProgramsToDelete.ClearUpTo(completedSerial);
+
+        for (GLuint sampler : mSamplersToDelete.IterateUpTo(completedSerial)) {
+            glDeleteSamplers(1, &sampler);
+        }
+        mSamplersToDelete.ClearUpTo(completedSerial);
+
+        for (GLuint buffer : mBuffersToDelete.IterateUpTo(completedSerial)) {
+            glDeleteBuffers(1, &buffer);
+        }
+        mBuffersToDelete.ClearUpTo(completedSerial);
+
+        for (GLuint texture : mTexturesToDelete.IterateUpTo(completedSerial)) {
+            glDeleteTextures(1, &texture);
+        }
+        mTexturesToDelete.ClearUpTo(completedSerial);
+    }
+
+}}  // namespace backend::opengl
@@ -0,0 +1,56 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef BACKEND_OPENGL_FENCEDDELETERGL_H_
+#define BACKEND_OPENGL_FENCEDDELETERGL_H_
+
+#include "common/SerialQueue.h"
+
+#include "glad/glad.h"
+
+namespace backend { namespace opengl {
+
+    class Device;
+
+    // Defers the deletion of GL objects until the commands submitted before the deletion request
+    // have completed on the GPU, as tracked by the device's fences. All the GL object names share
+    // the GLuint type so each kind of object gets its own entry point.
+    class FencedDeleter {
+      public:
+        FencedDeleter(Device* device);
+        ~FencedDeleter();
+
+        void DeleteBufferWhenUnused(GLuint buffer);
+        void DeleteFramebufferWhenUnused(GLuint framebuffer);
+        void DeleteProgramWhenUnused(GLuint program);
+        void DeleteSamplerWhenUnused(GLuint sampler);
+        void DeleteTextureWhenUnused(GLuint texture);
+        void DeleteVertexArrayWhenUnused(GLuint vertexArray);
+
+        void Tick(Serial completedSerial);
+
+      private:
+        Device* mDevice = nullptr;
+        SerialQueue<GLuint> mBuffersToDelete;
+        SerialQueue<GLuint> mFramebuffersToDelete;
+        SerialQueue<GLuint> mProgramsToDelete;
+        SerialQueue<GLuint> mSamplersToDelete;
+        SerialQueue<GLuint> mTexturesToDelete;
+        SerialQueue<GLuint> mVertexArraysToDelete;
+    };
+
+}}  // namespace backend::opengl
+
+#endif  // BACKEND_OPENGL_FENCEDDELETERGL_H_
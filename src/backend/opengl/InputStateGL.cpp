@@ -14,12 +14,14 @@
 
 #include "backend/opengl/InputStateGL.h"
 
+#include "backend/opengl/FencedDeleterGL.h"
 #include "backend/opengl/OpenGLBackend.h"
 #include "common/Assert.h"
 
 namespace backend { namespace opengl {
 
-    InputState::InputState(InputStateBuilder* builder) : InputStateBase(builder) {
+    InputState::InputState(InputStateBuilder* builder)
+        : InputStateBase(builder), mDevice(ToBackend(builder->GetDevice())) {
         glGenVertexArrays(1, &mVertexArrayObject);
         glBindVertexArray(mVertexArrayObject);
         auto& attributesSetMask = GetAttributesSetMask();
@@ -51,6 +53,10 @@ namespace backend { namespace opengl {
         }
     }
 
+    InputState::~InputState() {
+        mDevice->GetFencedDeleter()->DeleteVertexArrayWhenUnused(mVertexArrayObject);
+    }
+
     std::bitset<kMaxVertexAttributes> InputState::GetAttributesUsingInput(uint32_t slot) const {
         return attributesUsingInput[slot];
     }
@@ -26,11 +26,13 @@ namespace backend { namespace opengl {
     class InputState : public InputStateBase {
       public:
         InputState(InputStateBuilder* builder);
+        ~InputState();
 
         std::bitset<kMaxVertexAttributes> GetAttributesUsingInput(uint32_t slot) const;
         GLuint GetVAO();
 
       private:
+        Device* mDevice;
         GLuint mVertexArrayObject;
         std::array<std::bitset<kMaxVertexAttributes>, kMaxVertexInputs> attributesUsingInput;
     };
@@ -19,13 +19,20 @@
 #include "backend/opengl/CommandBufferGL.h"
 #include "backend/opengl/ComputePipelineGL.h"
 #include "backend/opengl/DepthStencilStateGL.h"
+#include "backend/opengl/FencedDeleterGL.h"
 #include "backend/opengl/InputStateGL.h"
 #include "backend/opengl/PipelineLayoutGL.h"
+#include "backend/opengl/ProgramCacheGL.h"
 #include "backend/opengl/RenderPipelineGL.h"
 #include "backend/opengl/SamplerGL.h"
 #include "backend/opengl/ShaderModuleGL.h"
 #include "backend/opengl/SwapChainGL.h"
 #include "backend/opengl/TextureGL.h"
+#include "backend/opengl/TextureUploaderGL.h"
+#include "common/Assert.h"
+
+#include <string>
+#include <unordered_set>
 
 namespace backend { namespace opengl {
     nxtProcTable GetNonValidatingProcs();
@@ -45,6 +52,33 @@ namespace backend { namespace opengl {
 
     // Device
 
+    Device::Device() {
+        mDeleter = new FencedDeleter(this);
+    }
+
+    Device::~Device() {
+        // Wait for all the GPU work to be done so that every object pending deletion can be freed.
+        glFinish();
+        CheckPassedFences();
+        ASSERT(mFencesInFlight.empty());
+
+        // Objects might have been released since the last submit and are waiting on a serial
+        // that doesn't have a corresponding fence. Force them to look completed (because they are).
+        mCompletedSerial = mNextSerial;
+        Tick();
+
+        delete mProgramCache;
+        mProgramCache = nullptr;
+
+        // The uploader releases its GL objects in its destructor so tick the deleter once more.
+        delete mTextureUploader;
+        mTextureUploader = nullptr;
+        mDeleter->Tick(mCompletedSerial);
+
+        delete mDeleter;
+        mDeleter = nullptr;
+    }
+
     BindGroupBase* Device::CreateBindGroup(BindGroupBuilder* builder) {
         return new BindGroup(builder);
     }
@@ -104,6 +138,126 @@ namespace backend { namespace opengl {
     }
 
     void Device::TickImpl() {
+        CheckPassedFences();
+        if (mTextureUploader != nullptr) {
+            mTextureUploader->Tick(mCompletedSerial);
+        }
+        mDeleter->Tick(mCompletedSerial);
+
+        if (mCompletedSerial == mNextSerial - 1) {
+            // If there's no GPU work in flight we still need to move to the next serial so that
+            // work done outside of submits (texture uploads, object deletions) is tracked. GL
+            // commands are executed in order so a fence is enough to know when they complete.
+            SubmitFenceSync();
+        }
+    }
+
+    bool Device::IsTextureFormatSupported(nxt::TextureFormat format) const {
+        switch (format) {
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+                GatherCompressedFormatSupport();
+                return mSupportsS3TC;
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+                GatherCompressedFormatSupport();
+                return mSupportsRGTC;
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+                GatherCompressedFormatSupport();
+                return mSupportsBPTC;
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                GatherCompressedFormatSupport();
+                return mSupportsETC2;
+            default:
+                return DeviceBase::IsTextureFormatSupported(format);
+        }
+    }
+
+    bool Device::IsPartialTextureViewSupported() const {
+        // Views of part of a texture need ARB_texture_view, which is core since OpenGL 4.3.
+        return glTextureView != nullptr;
+    }
+
+    FencedDeleter* Device::GetFencedDeleter() const {
+        return mDeleter;
+    }
+
+    ProgramCache* Device::GetProgramCache() {
+        if (mProgramCache == nullptr) {
+            mProgramCache = new ProgramCache(this);
+        }
+        return mProgramCache;
+    }
+
+    TextureUploader* Device::GetTextureUploader() {
+        if (mTextureUploader == nullptr) {
+            mTextureUploader = new TextureUploader(this);
+        }
+        return mTextureUploader;
+    }
+
+    Serial Device::GetSerial() const {
+        return mNextSerial;
+    }
+
+    void Device::SubmitFenceSync() {
+        GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        mFencesInFlight.emplace(sync, mNextSerial);
+        mNextSerial++;
+    }
+
+    void Device::GatherCompressedFormatSupport() const {
+        // Listing the extensions is slow and most devices never use compressed textures so this
+        // is only done the first time a compressed format is queried.
+        if (mCompressedFormatSupportGathered) {
+            return;
+        }
+        mCompressedFormatSupportGathered = true;
+
+        // Copying compressed textures to buffers needs glGetCompressedTextureSubImage so we don't
+        // expose any compressed format without it.
+        if (glGetCompressedTextureSubImage == nullptr) {
+            return;
+        }
+
+        std::unordered_set<std::string> extensions;
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        for (GLint i = 0; i < extensionCount; ++i) {
+            extensions.insert(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)));
+        }
+        auto HasExtension = [&extensions](const char* name) {
+            return extensions.find(name) != extensions.end();
+        };
+
+        mSupportsS3TC = HasExtension("GL_EXT_texture_compression_s3tc");
+        mSupportsRGTC = true;  // Core since OpenGL 3.0
+        mSupportsBPTC = GLAD_GL_VERSION_4_2 || HasExtension("GL_ARB_texture_compression_bptc");
+        mSupportsETC2 = GLAD_GL_VERSION_4_3 || HasExtension("GL_ARB_ES3_compatibility");
+    }
+
+    void Device::CheckPassedFences() {
+        while (!mFencesInFlight.empty()) {
+            GLsync sync = mFencesInFlight.front().first;
+            Serial fenceSerial = mFencesInFlight.front().second;
+
+            // A timeout of 0 only polls the status of the fence.
+            GLenum result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return;
+            }
+            ASSERT(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED);
+
+            glDeleteSync(sync);
+
+            ASSERT(fenceSerial > mCompletedSerial);
+            mCompletedSerial = fenceSerial;
+            mFencesInFlight.pop();
+        }
     }
 
     // Bind Group
@@ -131,6 +285,8 @@ namespace backend { namespace opengl {
         for (uint32_t i = 0; i < numCommands; ++i) {
             commands[i]->Execute();
         }
+
+        ToBackend(GetDevice())->SubmitFenceSync();
     }
 
     // RenderPass
@@ -28,9 +28,12 @@
 #include "backend/Queue.h"
 #include "backend/RenderPass.h"
 #include "backend/ToBackend.h"
+#include "common/Serial.h"
 
 #include "glad/glad.h"
 
+#include <queue>
+
 namespace backend { namespace opengl {
 
     class BindGroup;
@@ -42,10 +45,12 @@ namespace backend { namespace opengl {
     class ComputePipeline;
     class DepthStencilState;
     class Device;
+    class FencedDeleter;
     class Framebuffer;
     class InputState;
     class PersistentPipelineState;
     class PipelineLayout;
+    class ProgramCache;
     class Queue;
     class RenderPass;
     class RenderPipeline;
@@ -53,6 +58,7 @@ namespace backend { namespace opengl {
     class ShaderModule;
     class SwapChain;
     class Texture;
+    class TextureUploader;
     class TextureView;
 
     struct OpenGLBackendTraits {
@@ -86,6 +92,9 @@ namespace backend { namespace opengl {
     // Definition of backend types
     class Device : public DeviceBase {
       public:
+        Device();
+        ~Device();
+
         BindGroupBase* CreateBindGroup(BindGroupBuilder* builder) override;
         BindGroupLayoutBase* CreateBindGroupLayout(BindGroupLayoutBuilder* builder) override;
         BlendStateBase* CreateBlendState(BlendStateBuilder* builder) override;
@@ -107,6 +116,36 @@ namespace backend { namespace opengl {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        bool IsTextureFormatSupported(nxt::TextureFormat format) const override;
+        bool IsPartialTextureViewSupported() const override;
+
+        FencedDeleter* GetFencedDeleter() const;
+        // Created the first time they are needed.
+        ProgramCache* GetProgramCache();
+        TextureUploader* GetTextureUploader();
+        Serial GetSerial() const;
+
+        // Inserts a fence after the commands submitted so far and moves on to the next serial.
+        void SubmitFenceSync();
+
+      private:
+        void CheckPassedFences();
+        void GatherCompressedFormatSupport() const;
+
+        FencedDeleter* mDeleter = nullptr;
+        ProgramCache* mProgramCache = nullptr;
+        TextureUploader* mTextureUploader = nullptr;
+
+        std::queue<std::pair<GLsync, Serial>> mFencesInFlight;
+        Serial mNextSerial = 1;
+        Serial mCompletedSerial = 0;
+
+        // Gathered by the first compressed format query.
+        mutable bool mCompressedFormatSupportGathered = false;
+        mutable bool mSupportsS3TC = false;
+        mutable bool mSupportsRGTC = false;
+        mutable bool mSupportsBPTC = false;
+        mutable bool mSupportsETC2 = false;
     };
 
     class BindGroup : public BindGroupBase {
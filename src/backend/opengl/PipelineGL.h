@@ -16,6 +16,7 @@
 #define BACKEND_OPENGL_PIPELINEGL_H_
 
 #include "backend/Pipeline.h"
+#include "backend/opengl/ProgramCacheGL.h"
 
 #include "glad/glad.h"
 
@@ -27,11 +28,13 @@ namespace backend { namespace opengl {
     class PersistentPipelineState;
     class ShaderModule;
 
+    // The program of the pipeline is shared with all the pipelines of the device that have the
+    // same shaders and pipeline layout, see ProgramCache.
     class PipelineGL {
       public:
         PipelineGL(PipelineBase* parent, PipelineBuilder* builder);
 
-        using GLPushConstantInfo = std::array<GLint, kMaxPushConstants>;
+        using GLPushConstantInfo = Program::GLPushConstantInfo;
         using BindingLocations =
             std::array<std::array<GLint, kMaxBindingsPerGroup>, kMaxBindGroups>;
 
@@ -43,10 +46,7 @@ namespace backend { namespace opengl {
         void ApplyNow();
 
       private:
-        GLuint mProgram;
-        PerStage<GLPushConstantInfo> mGlPushConstants;
-        std::vector<std::vector<GLuint>> mUnitsForSamplers;
-        std::vector<std::vector<GLuint>> mUnitsForTextures;
+        Ref<Program> mProgram;
     };
 
 }}  // namespace backend::opengl
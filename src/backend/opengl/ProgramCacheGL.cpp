@@ -0,0 +1,332 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/opengl/ProgramCacheGL.h"
+
+#include "backend/opengl/FencedDeleterGL.h"
+#include "backend/opengl/OpenGLBackend.h"
+#include "backend/opengl/PipelineLayoutGL.h"
+#include "backend/opengl/ShaderModuleGL.h"
+#include "common/HashUtils.h"
+
+#include <iostream>
+#include <set>
+
+namespace backend { namespace opengl {
+
+    namespace {
+
+        GLenum GLShaderType(nxt::ShaderStage stage) {
+            switch (stage) {
+                case nxt::ShaderStage::Vertex:
+                    return GL_VERTEX_SHADER;
+                case nxt::ShaderStage::Fragment:
+                    return GL_FRAGMENT_SHADER;
+                case nxt::ShaderStage::Compute:
+                    return GL_COMPUTE_SHADER;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+    }  // namespace
+
+    // ProgramCacheQuery
+
+    ProgramCacheQuery::ProgramCacheQuery(PipelineBase* parent, PipelineBuilder* builder)
+        : stages(parent->GetStageMask()) {
+        for (auto stage : IterateStages(kAllStages)) {
+            modules[stage] = nullptr;
+        }
+        for (auto stage : IterateStages(stages)) {
+            const auto& stageInfo = builder->GetStageInfo(stage);
+            modules[stage] = stageInfo.module.Get();
+            entryPoints[stage] = stageInfo.entryPoint;
+            specializations[stage] = stageInfo.specialization;
+        }
+
+        PipelineLayoutBase* layout = parent->GetLayout();
+        for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
+            bindGroupLayouts[group] = layout->GetBindGroupLayout(group);
+        }
+    }
+
+    // Program
+
+    Program::Program(ProgramCache* cache,
+                     const ProgramCacheQuery& query,
+                     PipelineBase* parent,
+                     PipelineBuilder* builder)
+        : mCache(cache), mQuery(query), mLayout(parent->GetLayout()) {
+        auto CreateShader = [](GLenum type, const char* source) -> GLuint {
+            GLuint shader = glCreateShader(type);
+            glShaderSource(shader, 1, &source, nullptr);
+            glCompileShader(shader);
+
+            GLint compileStatus = GL_FALSE;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+            if (compileStatus == GL_FALSE) {
+                GLint infoLogLength = 0;
+                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+                if (infoLogLength > 1) {
+                    std::vector<char> buffer(infoLogLength);
+                    glGetShaderInfoLog(shader, infoLogLength, nullptr, &buffer[0]);
+                    std::cout << source << std::endl;
+                    std::cout << "Program compilation failed:\n";
+                    std::cout << buffer.data() << std::endl;
+                }
+            }
+            return shader;
+        };
+
+        auto FillPushConstants = [](const ShaderModule::PushConstantInfo& moduleInfo,
+                                    nxt::ShaderStage stage, GLPushConstantInfo* info,
+                                    GLuint program) {
+            std::string prefix = GetPushConstantBlockPrefix(stage);
+            for (uint32_t i = 0; i < moduleInfo.names.size(); i++) {
+                (*info)[i] = -1;
+
+                unsigned int size = moduleInfo.sizes[i];
+                if (size == 0) {
+                    continue;
+                }
+
+                std::string name = prefix + moduleInfo.names[i];
+                GLint location = glGetUniformLocation(program, name.c_str());
+                if (location == -1) {
+                    continue;
+                }
+
+                for (uint32_t offset = 0; offset < size; offset++) {
+                    (*info)[i + offset] = location + offset;
+                }
+                i += size - 1;
+            }
+        };
+
+        for (auto stage : IterateStages(query.stages)) {
+            mModules[stage] = builder->GetStageInfo(stage).module;
+        }
+
+        mProgram = glCreateProgram();
+
+        std::vector<GLuint> shaders;
+        for (auto stage : IterateStages(query.stages)) {
+            ShaderModule* module = ToBackend(mModules[stage].Get());
+
+            std::string source =
+                module->GetSource(query.entryPoints[stage], query.specializations[stage]);
+            GLuint shader = CreateShader(GLShaderType(stage), source.c_str());
+            glAttachShader(mProgram, shader);
+            shaders.push_back(shader);
+        }
+
+        glLinkProgram(mProgram);
+
+        // The shaders are not needed once the program is linked, and are never used by GPU
+        // commands directly so they can be deleted immediately.
+        for (GLuint shader : shaders) {
+            glDetachShader(mProgram, shader);
+            glDeleteShader(shader);
+        }
+
+        GLint linkStatus = GL_FALSE;
+        glGetProgramiv(mProgram, GL_LINK_STATUS, &linkStatus);
+        if (linkStatus == GL_FALSE) {
+            GLint infoLogLength = 0;
+            glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+            if (infoLogLength > 1) {
+                std::vector<char> buffer(infoLogLength);
+                glGetProgramInfoLog(mProgram, infoLogLength, nullptr, &buffer[0]);
+                std::cout << "Program link failed:\n";
+                std::cout << buffer.data() << std::endl;
+            }
+        }
+
+        for (auto stage : IterateStages(query.stages)) {
+            const auto& entryPointInfo =
+                mModules[stage]->GetEntryPointInfo(query.entryPoints[stage]);
+            FillPushConstants(entryPointInfo.pushConstants, stage, &mGlPushConstants[stage],
+                              mProgram);
+        }
+
+        glUseProgram(mProgram);
+
+        // The uniforms are part of the program state so we can pre-bind buffer units, texture units
+        // etc.
+        const auto& layout = ToBackend(mLayout.Get());
+        const auto& indices = layout->GetBindingIndexInfo();
+
+        for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
+            const auto& groupInfo = layout->GetBindGroupLayout(group)->GetBindingInfo();
+
+            for (uint32_t binding = 0; binding < kMaxBindingsPerGroup; ++binding) {
+                if (!groupInfo.mask[binding]) {
+                    continue;
+                }
+
+                std::string name = GetBindingName(group, binding);
+                switch (groupInfo.types[binding]) {
+                    case nxt::BindingType::UniformBuffer: {
+                        GLint location = glGetUniformBlockIndex(mProgram, name.c_str());
+                        glUniformBlockBinding(mProgram, location, indices[group][binding]);
+                    } break;
+
+                    case nxt::BindingType::StorageBuffer: {
+                        GLuint location = glGetProgramResourceIndex(
+                            mProgram, GL_SHADER_STORAGE_BLOCK, name.c_str());
+                        glShaderStorageBlockBinding(mProgram, location, indices[group][binding]);
+                    } break;
+
+                    case nxt::BindingType::Sampler:
+                    case nxt::BindingType::SampledTexture:
+                        // These binding types are handled in the separate sampler and texture
+                        // emulation
+                        break;
+                }
+            }
+        }
+
+        // Compute links between stages for combined samplers, then bind them to texture units
+        {
+            std::set<CombinedSampler> combinedSamplersSet;
+            for (auto stage : IterateStages(query.stages)) {
+                ShaderModule* module = ToBackend(mModules[stage].Get());
+
+                for (const auto& combined :
+                     module->GetCombinedSamplerInfo(query.entryPoints[stage])) {
+                    combinedSamplersSet.insert(combined);
+                }
+            }
+
+            mUnitsForSamplers.resize(layout->GetNumSamplers());
+            mUnitsForTextures.resize(layout->GetNumSampledTextures());
+
+            GLuint textureUnit = layout->GetTextureUnitsUsed();
+            for (const auto& combined : combinedSamplersSet) {
+                std::string name = combined.GetName();
+                GLint location = glGetUniformLocation(mProgram, name.c_str());
+                glUniform1i(location, textureUnit);
+
+                GLuint samplerIndex =
+                    indices[combined.samplerLocation.group][combined.samplerLocation.binding];
+                mUnitsForSamplers[samplerIndex].push_back(textureUnit);
+
+                GLuint textureIndex =
+                    indices[combined.textureLocation.group][combined.textureLocation.binding];
+                mUnitsForTextures[textureIndex].push_back(textureUnit);
+
+                textureUnit++;
+            }
+        }
+    }
+
+    Program::~Program() {
+        mCache->UncacheProgram(this);
+        mCache->mDevice->GetFencedDeleter()->DeleteProgramWhenUnused(mProgram);
+    }
+
+    const Program::GLPushConstantInfo& Program::GetGLPushConstants(nxt::ShaderStage stage) const {
+        return mGlPushConstants[stage];
+    }
+
+    const std::vector<GLuint>& Program::GetTextureUnitsForSampler(GLuint index) const {
+        ASSERT(index < mUnitsForSamplers.size());
+        return mUnitsForSamplers[index];
+    }
+
+    const std::vector<GLuint>& Program::GetTextureUnitsForTexture(GLuint index) const {
+        ASSERT(index < mUnitsForTextures.size());
+        return mUnitsForTextures[index];
+    }
+
+    GLuint Program::GetHandle() const {
+        return mProgram;
+    }
+
+    // ProgramCache
+
+    ProgramCache::ProgramCache(Device* device) : mDevice(device) {
+    }
+
+    ProgramCache::~ProgramCache() {
+        // Programs are referenced by pipelines, which must all have been destroyed by now.
+        ASSERT(mCache.empty());
+    }
+
+    Ref<Program> ProgramCache::GetProgram(PipelineBase* parent, PipelineBuilder* builder) {
+        ProgramCacheQuery query(parent, builder);
+
+        auto it = mCache.find(query);
+        if (it != mCache.end()) {
+            return it->second;
+        }
+
+        // The program starts with an external reference that isn't owned by anyone, the
+        // returned Ref holds the only reference to it.
+        Program* program = new Program(this, query, parent, builder);
+        Ref<Program> result = program;
+        program->Release();
+
+        mCache.emplace(query, program);
+        return result;
+    }
+
+    size_t ProgramCache::GetProgramCount() const {
+        return mCache.size();
+    }
+
+    void ProgramCache::UncacheProgram(Program* program) {
+        size_t removedCount = mCache.erase(program->mQuery);
+        ASSERT(removedCount == 1);
+    }
+
+    size_t ProgramCache::CacheFuncs::operator()(const ProgramCacheQuery& query) const {
+        size_t hash = std::hash<uint32_t>()(static_cast<uint32_t>(query.stages));
+
+        for (auto stage : IterateStages(query.stages)) {
+            CombineHashes(&hash, std::hash<const ShaderModuleBase*>()(query.modules[stage]));
+            CombineHashes(&hash, std::hash<std::string>()(query.entryPoints[stage]));
+            for (const auto& it : query.specializations[stage]) {
+                CombineHashes(&hash, std::hash<uint32_t>()(it.first));
+                CombineHashes(&hash, std::hash<uint32_t>()(it.second));
+            }
+        }
+        for (const BindGroupLayoutBase* layout : query.bindGroupLayouts) {
+            CombineHashes(&hash, std::hash<const BindGroupLayoutBase*>()(layout));
+        }
+
+        return hash;
+    }
+
+    bool ProgramCache::CacheFuncs::operator()(const ProgramCacheQuery& a,
+                                              const ProgramCacheQuery& b) const {
+        if (a.stages != b.stages || a.bindGroupLayouts != b.bindGroupLayouts) {
+            return false;
+        }
+
+        for (auto stage : IterateStages(a.stages)) {
+            if (a.modules[stage] != b.modules[stage] ||
+                a.entryPoints[stage] != b.entryPoints[stage] ||
+                a.specializations[stage] != b.specializations[stage]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}}  // namespace backend::opengl
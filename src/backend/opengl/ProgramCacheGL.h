@@ -0,0 +1,106 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_OPENGL_PROGRAMCACHEGL_H_
+#define BACKEND_OPENGL_PROGRAMCACHEGL_H_
+
+#include "backend/Pipeline.h"
+#include "backend/RefCounted.h"
+
+#include "glad/glad.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace backend { namespace opengl {
+
+    class Device;
+    class PipelineLayout;
+    class ProgramCache;
+
+    // Everything that the GL program of a pipeline depends on. Pipelines that only differ by
+    // fixed-function state have the same query and share their program while each specialization
+    // of the shaders gets its own program. Bind group layouts are
+    // deduplicated by the device so comparing their pointers is enough to know the binding
+    // remapping done by the pipeline layout is the same.
+    struct ProgramCacheQuery {
+        ProgramCacheQuery(PipelineBase* parent, PipelineBuilder* builder);
+
+        nxt::ShaderStageBit stages;
+        PerStage<const ShaderModuleBase*> modules;
+        PerStage<std::string> entryPoints;
+        PerStage<SpecializationValues> specializations;
+        std::array<const BindGroupLayoutBase*, kMaxBindGroups> bindGroupLayouts;
+    };
+
+    // A linked GL program along with the reflection data used to bind resources and push constants
+    // to it.
+    class Program : public RefCounted {
+      public:
+        Program(ProgramCache* cache,
+                const ProgramCacheQuery& query,
+                PipelineBase* parent,
+                PipelineBuilder* builder);
+        ~Program();
+
+        using GLPushConstantInfo = std::array<GLint, kMaxPushConstants>;
+
+        const GLPushConstantInfo& GetGLPushConstants(nxt::ShaderStage stage) const;
+        const std::vector<GLuint>& GetTextureUnitsForSampler(GLuint index) const;
+        const std::vector<GLuint>& GetTextureUnitsForTexture(GLuint index) const;
+        GLuint GetHandle() const;
+
+      private:
+        friend class ProgramCache;
+
+        ProgramCache* mCache = nullptr;
+        ProgramCacheQuery mQuery;
+        // Keep the objects whose pointers are in the query alive so that they can't be reused
+        // for other objects while the program is in the cache.
+        PerStage<Ref<ShaderModuleBase>> mModules;
+        Ref<PipelineLayoutBase> mLayout;
+
+        GLuint mProgram = 0;
+        PerStage<GLPushConstantInfo> mGlPushConstants;
+        std::vector<std::vector<GLuint>> mUnitsForSamplers;
+        std::vector<std::vector<GLuint>> mUnitsForTextures;
+    };
+
+    // Deduplicates the GL programs of the pipelines of a device, compiling and linking GLSL only
+    // once for pipelines with the same shaders and pipeline layout.
+    class ProgramCache {
+      public:
+        ProgramCache(Device* device);
+        ~ProgramCache();
+
+        Ref<Program> GetProgram(PipelineBase* parent, PipelineBuilder* builder);
+        size_t GetProgramCount() const;
+
+      private:
+        friend class Program;
+        void UncacheProgram(Program* program);
+
+        struct CacheFuncs {
+            size_t operator()(const ProgramCacheQuery& query) const;
+            bool operator()(const ProgramCacheQuery& a, const ProgramCacheQuery& b) const;
+        };
+        using Cache = std::unordered_map<ProgramCacheQuery, Program*, CacheFuncs, CacheFuncs>;
+
+        Device* mDevice = nullptr;
+        Cache mCache;
+    };
+
+}}  // namespace backend::opengl
+
+#endif  // BACKEND_OPENGL_PROGRAMCACHEGL_H_
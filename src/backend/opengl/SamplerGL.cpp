@@ -14,6 +14,8 @@
 
 #include "backend/opengl/SamplerGL.h"
 
+#include "backend/opengl/FencedDeleterGL.h"
+#include "backend/opengl/OpenGLBackend.h"
 #include "common/Assert.h"
 
 namespace backend { namespace opengl {
@@ -56,13 +58,18 @@ namespace backend { namespace opengl {
         }
     }  // namespace
 
-    Sampler::Sampler(SamplerBuilder* builder) : SamplerBase(builder) {
+    Sampler::Sampler(SamplerBuilder* builder)
+        : SamplerBase(builder), mDevice(ToBackend(builder->GetDevice())) {
         glGenSamplers(1, &mHandle);
         glSamplerParameteri(mHandle, GL_TEXTURE_MAG_FILTER, MagFilterMode(builder->GetMagFilter()));
         glSamplerParameteri(mHandle, GL_TEXTURE_MIN_FILTER,
                             MinFilterMode(builder->GetMinFilter(), builder->GetMipMapFilter()));
     }
 
+    Sampler::~Sampler() {
+        mDevice->GetFencedDeleter()->DeleteSamplerWhenUnused(mHandle);
+    }
+
     GLuint Sampler::GetHandle() const {
         return mHandle;
     }
@@ -26,10 +26,12 @@ namespace backend { namespace opengl {
     class Sampler : public SamplerBase {
       public:
         Sampler(SamplerBuilder* builder);
+        ~Sampler();
 
         GLuint GetHandle() const;
 
       private:
+        Device* mDevice;
         GLuint mHandle;
     };
 
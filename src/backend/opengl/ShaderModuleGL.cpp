@@ -29,6 +29,19 @@ namespace backend { namespace opengl {
         return o.str();
     }
 
+    std::string GetPushConstantBlockPrefix(nxt::ShaderStage stage) {
+        switch (stage) {
+            case nxt::ShaderStage::Vertex:
+                return "vs_";
+            case nxt::ShaderStage::Fragment:
+                return "fs_";
+            case nxt::ShaderStage::Compute:
+                return "cs_";
+            default:
+                UNREACHABLE();
+        }
+    }
+
     bool operator<(const BindingLocation& a, const BindingLocation& b) {
         return std::tie(a.group, a.binding) < std::tie(b.group, b.binding);
     }
@@ -47,7 +60,48 @@ namespace backend { namespace opengl {
     }
 
     ShaderModule::ShaderModule(ShaderModuleBuilder* builder) : ShaderModuleBase(builder) {
-        spirv_cross::CompilerGLSL compiler(builder->AcquireSpirv());
+    }
+
+    std::string ShaderModule::GetSource(const std::string& entryPoint,
+                                        const SpecializationValues& specialization) {
+        if (specialization.empty()) {
+            return GetTranslation(entryPoint).source;
+        }
+
+        // Desktop GLSL has no specialization constants, instead the specialized values are given
+        // to SPIRV-Cross that emits them as regular constants the GLSL compiler can fold.
+        spirv_cross::CompilerGLSL compiler(GetSpirv());
+        ApplySpecialization(&compiler, specialization);
+
+        // The combined samplers don't depend on the specialization and are gathered with the
+        // unspecialized translation.
+        return TranslateToGLSL(&compiler, entryPoint, nullptr);
+    }
+
+    const ShaderModule::CombinedSamplerInfo& ShaderModule::GetCombinedSamplerInfo(
+        const std::string& entryPoint) {
+        return GetTranslation(entryPoint).combinedInfo;
+    }
+
+    const ShaderModule::Translation& ShaderModule::GetTranslation(const std::string& entryPoint) {
+        auto it = mTranslations.find(entryPoint);
+        if (it != mTranslations.end()) {
+            return it->second;
+        }
+
+        Translation& translation = mTranslations[entryPoint];
+        spirv_cross::CompilerGLSL compiler(GetSpirv());
+        translation.source = TranslateToGLSL(&compiler, entryPoint, &translation.combinedInfo);
+        return translation;
+    }
+
+    std::string ShaderModule::TranslateToGLSL(spirv_cross::CompilerGLSL* compiler,
+                                              const std::string& entryPoint,
+                                              CombinedSamplerInfo* combinedInfo) {
+        // GLSL only supports one entry point called main(), SPIRV-Cross renames the selected entry
+        // point.
+        SelectEntryPoint(compiler, entryPoint);
+
         spirv_cross::CompilerGLSL::Options options;
 
         // TODO(cwallez@chromium.org): discover the backing context version and use that.
@@ -57,77 +111,58 @@ namespace backend { namespace opengl {
         options.version = 440;
 #endif
         options.vertex.flip_vert_y = true;
-        compiler.set_options(options);
+        compiler->set_options(options);
+
+        const EntryPointInfo& entryPointInfo = GetEntryPointInfo(entryPoint);
 
         // Rename the push constant block to be prefixed with the shader stage type so that uniform
         // names don't match between the FS and the VS.
-        const auto& resources = compiler.get_shader_resources();
+        const auto& resources =
+            compiler->get_shader_resources(compiler->get_active_interface_variables());
         if (resources.push_constant_buffers.size() > 0) {
-            const char* prefix = nullptr;
-            switch (compiler.get_execution_model()) {
-                case spv::ExecutionModelVertex:
-                    prefix = "vs_";
-                    break;
-                case spv::ExecutionModelFragment:
-                    prefix = "fs_";
-                    break;
-                case spv::ExecutionModelGLCompute:
-                    prefix = "cs_";
-                    break;
-                default:
-                    UNREACHABLE();
-            }
             auto interfaceBlock = resources.push_constant_buffers[0];
-            compiler.set_name(interfaceBlock.id, prefix + interfaceBlock.name);
+            std::string prefix = GetPushConstantBlockPrefix(entryPointInfo.stage);
+            compiler->set_name(interfaceBlock.id, prefix + interfaceBlock.name);
         }
 
-        ExtractSpirvInfo(compiler);
-
-        const auto& bindingInfo = GetBindingInfo();
-
         // Extract bindings names so that it can be used to get its location in program.
         // Now translate the separate sampler / textures into combined ones and store their info.
         // We need to do this before removing the set and binding decorations.
-        compiler.build_combined_image_samplers();
+        compiler->build_combined_image_samplers();
 
-        for (const auto& combined : compiler.get_combined_image_samplers()) {
-            mCombinedInfo.emplace_back();
-
-            auto& info = mCombinedInfo.back();
+        for (const auto& combined : compiler->get_combined_image_samplers()) {
+            CombinedSampler info;
             info.samplerLocation.group =
-                compiler.get_decoration(combined.sampler_id, spv::DecorationDescriptorSet);
+                compiler->get_decoration(combined.sampler_id, spv::DecorationDescriptorSet);
             info.samplerLocation.binding =
-                compiler.get_decoration(combined.sampler_id, spv::DecorationBinding);
+                compiler->get_decoration(combined.sampler_id, spv::DecorationBinding);
             info.textureLocation.group =
-                compiler.get_decoration(combined.image_id, spv::DecorationDescriptorSet);
+                compiler->get_decoration(combined.image_id, spv::DecorationDescriptorSet);
             info.textureLocation.binding =
-                compiler.get_decoration(combined.image_id, spv::DecorationBinding);
-            compiler.set_name(combined.combined_id, info.GetName());
+                compiler->get_decoration(combined.image_id, spv::DecorationBinding);
+            compiler->set_name(combined.combined_id, info.GetName());
+
+            if (combinedInfo != nullptr) {
+                combinedInfo->push_back(info);
+            }
         }
 
         // Change binding names to be "nxt_binding_<group>_<binding>".
         // Also unsets the SPIRV "Binding" decoration as it outputs "layout(binding=)" which
         // isn't supported on OSX's OpenGL.
+        const auto& bindingInfo = entryPointInfo.bindingInfo;
         for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
             for (uint32_t binding = 0; binding < kMaxBindingsPerGroup; ++binding) {
                 const auto& info = bindingInfo[group][binding];
                 if (info.used) {
-                    compiler.set_name(info.base_type_id, GetBindingName(group, binding));
-                    compiler.unset_decoration(info.id, spv::DecorationBinding);
-                    compiler.unset_decoration(info.id, spv::DecorationDescriptorSet);
+                    compiler->set_name(info.base_type_id, GetBindingName(group, binding));
+                    compiler->unset_decoration(info.id, spv::DecorationBinding);
+                    compiler->unset_decoration(info.id, spv::DecorationDescriptorSet);
                 }
             }
         }
 
-        mGlslSource = compiler.compile();
-    }
-
-    const char* ShaderModule::GetSource() const {
-        return reinterpret_cast<const char*>(mGlslSource.data());
-    }
-
-    const ShaderModule::CombinedSamplerInfo& ShaderModule::GetCombinedSamplerInfo() const {
-        return mCombinedInfo;
+        return compiler->compile();
     }
 
 }}  // namespace backend::opengl
@@ -19,11 +19,18 @@
 
 #include "glad/glad.h"
 
+namespace spirv_cross {
+    class CompilerGLSL;
+}
+
 namespace backend { namespace opengl {
 
     class Device;
 
     std::string GetBindingName(uint32_t group, uint32_t binding);
+    // The push constant blocks are prefixed by stage so that their uniforms don't collide between
+    // the stages of a program.
+    std::string GetPushConstantBlockPrefix(nxt::ShaderStage stage);
 
     struct BindingLocation {
         uint32_t group;
@@ -44,12 +51,22 @@ namespace backend { namespace opengl {
 
         using CombinedSamplerInfo = std::vector<CombinedSampler>;
 
-        const char* GetSource() const;
-        const CombinedSamplerInfo& GetCombinedSamplerInfo() const;
+        std::string GetSource(const std::string& entryPoint,
+                              const SpecializationValues& specialization);
+        const CombinedSamplerInfo& GetCombinedSamplerInfo(const std::string& entryPoint);
 
       private:
-        CombinedSamplerInfo mCombinedInfo;
-        std::string mGlslSource;
+        // The unspecialized translation of an entry point, computed when it is first used.
+        struct Translation {
+            std::string source;
+            CombinedSamplerInfo combinedInfo;
+        };
+        const Translation& GetTranslation(const std::string& entryPoint);
+        std::string TranslateToGLSL(spirv_cross::CompilerGLSL* compiler,
+                                    const std::string& entryPoint,
+                                    CombinedSamplerInfo* combinedInfo);
+
+        std::map<std::string, Translation> mTranslations;
     };
 
 }}  // namespace backend::opengl
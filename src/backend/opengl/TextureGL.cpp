@@ -14,6 +14,9 @@
 
 #include "backend/opengl/TextureGL.h"
 
+#include "backend/opengl/FencedDeleterGL.h"
+#include "backend/opengl/OpenGLBackend.h"
+#include "backend/opengl/TextureUploaderGL.h"
 #include "common/Assert.h"
 
 #include <algorithm>
@@ -23,10 +26,20 @@ namespace backend { namespace opengl {
 
     namespace {
 
+        // The S3TC formats are only available through GL_EXT_texture_compression_s3tc which isn't
+        // in our GL loader.
+        constexpr GLenum kCompressedRGBAS3TCDXT1 = 0x83F1;
+        constexpr GLenum kCompressedRGBAS3TCDXT3 = 0x83F2;
+        constexpr GLenum kCompressedRGBAS3TCDXT5 = 0x83F3;
+
         GLenum TargetForDimension(nxt::TextureDimension dimension) {
             switch (dimension) {
                 case nxt::TextureDimension::e2D:
                     return GL_TEXTURE_2D;
+                case nxt::TextureDimension::e2DArray:
+                    return GL_TEXTURE_2D_ARRAY;
+                case nxt::TextureDimension::e3D:
+                    return GL_TEXTURE_3D;
                 default:
                     UNREACHABLE();
             }
@@ -39,11 +52,33 @@ namespace backend { namespace opengl {
                 case nxt::TextureFormat::R8G8B8A8Uint:
                     return {GL_RGBA8UI, GL_RGBA, GL_UNSIGNED_INT};
                 case nxt::TextureFormat::B8G8R8A8Unorm:
-                    // This doesn't have an enum for the internal format in OpenGL.
-                    return {GL_NONE, GL_BGRA, GL_UNSIGNED_BYTE};
+                    // OpenGL doesn't have a BGRA internal format, the swizzle happens when data
+                    // is transferred using the GL_BGRA format.
+                    return {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE};
                 case nxt::TextureFormat::D32FloatS8Uint:
                     return {GL_DEPTH32F_STENCIL8, GL_DEPTH_STENCIL,
                             GL_FLOAT_32_UNSIGNED_INT_24_8_REV};
+                // Compressed formats are always transferred in their internal format.
+                case nxt::TextureFormat::Bc1RGBAUnorm:
+                    return {kCompressedRGBAS3TCDXT1, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Bc2RGBAUnorm:
+                    return {kCompressedRGBAS3TCDXT3, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Bc3RGBAUnorm:
+                    return {kCompressedRGBAS3TCDXT5, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Bc4RUnorm:
+                    return {GL_COMPRESSED_RED_RGTC1, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Bc5RGUnorm:
+                    return {GL_COMPRESSED_RG_RGTC2, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Bc6hRGBUfloat:
+                    return {GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Bc7RGBAUnorm:
+                    return {GL_COMPRESSED_RGBA_BPTC_UNORM, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Etc2R8G8B8Unorm:
+                    return {GL_COMPRESSED_RGB8_ETC2, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+                    return {GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, GL_NONE, GL_NONE};
+                case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                    return {GL_COMPRESSED_RGBA8_ETC2_EAC, GL_NONE, GL_NONE};
                 default:
                     UNREACHABLE();
             }
@@ -60,25 +95,64 @@ namespace backend { namespace opengl {
     // Texture
 
     Texture::Texture(TextureBuilder* builder) : Texture(builder, GenTexture()) {
-    }
-
-    Texture::Texture(TextureBuilder* builder, GLuint handle)
-        : TextureBase(builder), mHandle(handle) {
-        mTarget = TargetForDimension(GetDimension());
+        mOwnsHandle = true;
 
         uint32_t width = GetWidth();
         uint32_t height = GetHeight();
         uint32_t levels = GetNumMipLevels();
+        bool is2D = mTarget == GL_TEXTURE_2D;
 
         auto formatInfo = GetGLFormatInfo(GetFormat());
 
-        glBindTexture(mTarget, handle);
+        glBindTexture(mTarget, mHandle);
 
-        for (uint32_t i = 0; i < levels; ++i) {
-            glTexImage2D(mTarget, i, formatInfo.internalFormat, width, height, 0, formatInfo.format,
-                         formatInfo.type, nullptr);
-            width = std::max(uint32_t(1), width / 2);
-            height = std::max(uint32_t(1), height / 2);
+        // Multisampled textures always have a single 2D level and are only used as render
+        // targets, so sampler state like GL_TEXTURE_MAX_LEVEL doesn't apply to them.
+        if (mTarget == GL_TEXTURE_2D_MULTISAMPLE) {
+            GLsizei samples = GetSampleCount();
+            if (glTexStorage2DMultisample != nullptr) {
+                glTexStorage2DMultisample(mTarget, samples, formatInfo.internalFormat, width,
+                                          height, GL_TRUE);
+            } else {
+                glTexImage2DMultisample(mTarget, samples, formatInfo.internalFormat, width, height,
+                                        GL_TRUE);
+            }
+            return;
+        }
+
+        // Immutable storage lets the driver allocate all the levels at once and skip the
+        // completeness checks, but isn't available on all the GL versions we run on.
+        if (glTexStorage2D != nullptr) {
+            if (is2D) {
+                glTexStorage2D(mTarget, levels, formatInfo.internalFormat, width, height);
+            } else {
+                glTexStorage3D(mTarget, levels, formatInfo.internalFormat, width, height,
+                               GetDepth());
+            }
+        } else {
+            nxt::TextureFormat format = GetFormat();
+            for (uint32_t i = 0; i < levels; ++i) {
+                uint32_t depth = GetLevelDepth(i);
+                if (TextureFormatIsCompressed(format)) {
+                    GLsizei imageSize = ComputeTextureRowSize(format, width) *
+                                        ComputeTextureRowCount(format, height);
+                    if (is2D) {
+                        glCompressedTexImage2D(mTarget, i, formatInfo.internalFormat, width,
+                                               height, 0, imageSize, nullptr);
+                    } else {
+                        glCompressedTexImage3D(mTarget, i, formatInfo.internalFormat, width,
+                                               height, depth, 0, imageSize * depth, nullptr);
+                    }
+                } else if (is2D) {
+                    glTexImage2D(mTarget, i, formatInfo.internalFormat, width, height, 0,
+                                 formatInfo.format, formatInfo.type, nullptr);
+                } else {
+                    glTexImage3D(mTarget, i, formatInfo.internalFormat, width, height, depth, 0,
+                                 formatInfo.format, formatInfo.type, nullptr);
+                }
+                width = std::max(uint32_t(1), width / 2);
+                height = std::max(uint32_t(1), height / 2);
+            }
         }
 
         // The texture is not complete if it uses mipmapping and not all levels up to
@@ -86,9 +160,21 @@ namespace backend { namespace opengl {
         glTexParameteri(mTarget, GL_TEXTURE_MAX_LEVEL, levels - 1);
     }
 
+    // The storage of textures wrapping a native handle is owned by whoever created the handle.
+    Texture::Texture(TextureBuilder* builder, GLuint handle)
+        : TextureBase(builder), mHandle(handle) {
+        if (GetSampleCount() > 1) {
+            mTarget = GL_TEXTURE_2D_MULTISAMPLE;
+        } else {
+            mTarget = TargetForDimension(GetDimension());
+        }
+    }
+
     Texture::~Texture() {
-        // TODO(kainino@chromium.org): delete texture (but only when not using the native texture
-        // constructor?)
+        if (mOwnsHandle) {
+            ToBackend(GetDevice())->GetFencedDeleter()->DeleteTextureWhenUnused(mHandle);
+        }
+        mHandle = 0;
     }
 
     GLuint Texture::GetHandle() const {
@@ -103,12 +189,118 @@ namespace backend { namespace opengl {
         return GetGLFormatInfo(GetFormat());
     }
 
-    void Texture::TransitionUsageImpl(nxt::TextureUsageBit, nxt::TextureUsageBit) {
+    void Texture::UploadRegion(uint32_t level,
+                               uint32_t x,
+                               uint32_t y,
+                               uint32_t z,
+                               uint32_t width,
+                               uint32_t height,
+                               uint32_t depth,
+                               uint32_t rowPitch,
+                               const void* source) {
+        nxt::TextureFormat format = GetFormat();
+        auto formatInfo = GetGLFormat();
+        bool is2D = mTarget == GL_TEXTURE_2D;
+        ASSERT(!is2D || (z == 0 && depth == 1));
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(mTarget, mHandle);
+
+        if (!TextureFormatIsCompressed(format)) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, rowPitch / TextureFormatPixelSize(format));
+            if (is2D) {
+                glTexSubImage2D(mTarget, level, x, y, width, height, formatInfo.format,
+                                formatInfo.type, source);
+            } else {
+                // All the layers or slices are uploaded at once, with images packed every
+                // `height` rows.
+                glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, height);
+                glTexSubImage3D(mTarget, level, x, y, z, width, height, depth, formatInfo.format,
+                                formatInfo.type, source);
+                glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+            }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+            return;
+        }
+
+        // The compressed block unpack parameters aren't reliably supported so each row of blocks
+        // is uploaded separately instead.
+        uint32_t blockHeight = TextureFormatBlockHeight(format);
+        uint32_t rowSize = ComputeTextureRowSize(format, width);
+        uint32_t rowCount = ComputeTextureRowCount(format, height);
+        size_t imageSize = size_t(rowPitch) * rowCount;
+        for (uint32_t layer = 0; layer < depth; ++layer) {
+            for (uint32_t row = 0; row < rowCount; ++row) {
+                uint32_t rowY = row * blockHeight;
+                uint32_t rowHeight = std::min(blockHeight, height - rowY);
+                const uint8_t* rowSource = static_cast<const uint8_t*>(source) +
+                                           layer * imageSize + size_t(row) * rowPitch;
+                if (is2D) {
+                    glCompressedTexSubImage2D(mTarget, level, x, y + rowY, width, rowHeight,
+                                              formatInfo.internalFormat, rowSize, rowSource);
+                } else {
+                    glCompressedTexSubImage3D(mTarget, level, x, y + rowY, z + layer, width,
+                                              rowHeight, 1, formatInfo.internalFormat, rowSize,
+                                              rowSource);
+                }
+            }
+        }
+    }
+
+    void Texture::SetSubDataImpl(uint32_t level,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 uint32_t rowPitch,
+                                 const uint8_t* data) {
+        ToBackend(GetDevice())
+            ->GetTextureUploader()
+            ->TextureSubData(this, level, x, y, width, height, rowPitch, data);
+    }
+
+    void Texture::TransitionUsageImpl(uint32_t,
+                                      uint32_t,
+                                      nxt::TextureUsageBit,
+                                      nxt::TextureUsageBit) {
     }
 
     // TextureView
 
     TextureView::TextureView(TextureViewBuilder* builder) : TextureViewBase(builder) {
+        Texture* texture = ToBackend(GetTexture());
+
+        // Views of part of a texture are rejected at validation without ARB_texture_view.
+        if (IsFullTextureView()) {
+            mHandle = texture->GetHandle();
+            mTarget = texture->GetGLTarget();
+            return;
+        }
+
+        // glTextureView requires immutable storage which is always available with GL 4.3.
+        mOwnsHandle = true;
+        mHandle = GenTexture();
+        mTarget = TargetForDimension(GetDimension());
+        glTextureView(mHandle, mTarget, texture->GetHandle(),
+                      texture->GetGLFormat().internalFormat, 0, texture->GetNumMipLevels(),
+                      GetBaseArrayLayer(), GetLayerCount());
+    }
+
+    TextureView::~TextureView() {
+        if (mOwnsHandle) {
+            ToBackend(GetTexture()->GetDevice())
+                ->GetFencedDeleter()
+                ->DeleteTextureWhenUnused(mHandle);
+        }
+        mHandle = 0;
+    }
+
+    GLuint TextureView::GetHandle() const {
+        return mHandle;
+    }
+
+    GLenum TextureView::GetGLTarget() const {
+        return mTarget;
     }
 
 }}  // namespace backend::opengl
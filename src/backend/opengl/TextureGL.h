@@ -39,17 +39,52 @@ namespace backend { namespace opengl {
         GLenum GetGLTarget() const;
         TextureFormatInfo GetGLFormat() const;
 
-        void TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+        // Uploads a region of a level from the currently bound GL_PIXEL_UNPACK_BUFFER, or from
+        // client memory when none is bound. z and depth select layers for 2D array textures.
+        void UploadRegion(uint32_t level,
+                          uint32_t x,
+                          uint32_t y,
+                          uint32_t z,
+                          uint32_t width,
+                          uint32_t height,
+                          uint32_t depth,
+                          uint32_t rowPitch,
+                          const void* source);
+
+        void TransitionUsageImpl(uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit currentUsage,
                                  nxt::TextureUsageBit targetUsage) override;
 
       private:
+        void SetSubDataImpl(uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data) override;
+
         GLuint mHandle;
         GLenum mTarget;
+        // Textures wrapping a native handle (for example swapchain images) are owned externally
+        // and must not be deleted.
+        bool mOwnsHandle = false;
     };
 
     class TextureView : public TextureViewBase {
       public:
         TextureView(TextureViewBuilder* builder);
+        ~TextureView();
+
+        GLuint GetHandle() const;
+        GLenum GetGLTarget() const;
+
+      private:
+        GLuint mHandle = 0;
+        GLenum mTarget;
+        // Views of the whole texture use the texture's handle, other views own a GL texture view.
+        bool mOwnsHandle = false;
     };
 
 }}  // namespace backend::opengl
@@ -0,0 +1,115 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "backend/opengl/TextureUploaderGL.h"
+
+#include "backend/opengl/FencedDeleterGL.h"
+#include "backend/opengl/OpenGLBackend.h"
+#include "backend/opengl/TextureGL.h"
+
+#include <cstring>
+
+namespace backend { namespace opengl {
+
+    namespace {
+        constexpr size_t kRingBufferSize = 4 * 1024 * 1024;
+    }  // namespace
+
+    TextureUploader::TextureUploader(Device* device) : mDevice(device) {
+    }
+
+    TextureUploader::~TextureUploader() {
+        ASSERT(mInflightAllocations.Empty());
+        if (mRingBuffer != 0) {
+            mDevice->GetFencedDeleter()->DeleteBufferWhenUnused(mRingBuffer);
+            mRingBuffer = 0;
+        }
+    }
+
+    void TextureUploader::TextureSubData(Texture* texture,
+                                         uint32_t level,
+                                         uint32_t x,
+                                         uint32_t y,
+                                         uint32_t width,
+                                         uint32_t height,
+                                         uint32_t rowPitch,
+                                         const uint8_t* data) {
+        nxt::TextureFormat format = texture->GetFormat();
+        size_t size = size_t(rowPitch) * (ComputeTextureRowCount(format, height) - 1) +
+                      ComputeTextureRowSize(format, width);
+
+        // Uploads that don't fit in the ring go directly from client memory, which makes the
+        // driver do the copy synchronously.
+        size_t offset = 0;
+        const void* source = data;
+        if (Allocate(size, &offset)) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mRingBuffer);
+            void* mapped = glMapBufferRange(
+                GL_PIXEL_UNPACK_BUFFER, offset, size,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            memcpy(mapped, data, size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            source = reinterpret_cast<void*>(static_cast<uintptr_t>(offset));
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        texture->UploadRegion(level, x, y, 0, width, height, 1, rowPitch, source);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    void TextureUploader::Tick(Serial completedSerial) {
+        for (size_t allocationSize : mInflightAllocations.IterateUpTo(completedSerial)) {
+            ASSERT(allocationSize <= mRingUsedSize);
+            mRingUsedSize -= allocationSize;
+        }
+        mInflightAllocations.ClearUpTo(completedSerial);
+    }
+
+    bool TextureUploader::Allocate(size_t size, size_t* offset) {
+        if (size > kRingBufferSize) {
+            return false;
+        }
+
+        if (mRingBuffer == 0) {
+            glGenBuffers(1, &mRingBuffer);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mRingBuffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, kRingBufferSize, nullptr, GL_STREAM_DRAW);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        // Allocations are contiguous so skip the end of the ring if the data doesn't fit there.
+        size_t start = mRingHead;
+        size_t wastedSize = 0;
+        if (start + size > kRingBufferSize) {
+            wastedSize = kRingBufferSize - start;
+            start = 0;
+        }
+
+        // Memory is released in the order it was allocated so the used part of the ring is a
+        // single range ending at mRingHead.
+        if (mRingUsedSize + wastedSize + size > kRingBufferSize) {
+            return false;
+        }
+
+        mRingHead = start + size;
+        mRingUsedSize += wastedSize + size;
+        mInflightAllocations.Enqueue(wastedSize + size, mDevice->GetSerial());
+
+        *offset = start;
+        return true;
+    }
+
+}}  // namespace backend::opengl
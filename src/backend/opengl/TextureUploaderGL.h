@@ -0,0 +1,64 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef BACKEND_OPENGL_TEXTUREUPLOADERGL_H_
+#define BACKEND_OPENGL_TEXTUREUPLOADERGL_H_
+
+#include "common/SerialQueue.h"
+
+#include "glad/glad.h"
+
+namespace backend { namespace opengl {
+
+    class Device;
+    class Texture;
+
+    // Uploads texture data through a ring of pixel unpack buffer memory. Regions of the ring are
+    // reused once the fence for the serial that used them has passed, which lets the uploader map
+    // them unsynchronized instead of stalling on the GPU.
+    class TextureUploader {
+      public:
+        TextureUploader(Device* device);
+        ~TextureUploader();
+
+        void TextureSubData(Texture* texture,
+                            uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data);
+
+        void Tick(Serial completedSerial);
+
+      private:
+        // Returns false when there isn't enough space in the ring for the allocation.
+        bool Allocate(size_t size, size_t* offset);
+
+        Device* mDevice = nullptr;
+
+        // The ring buffer is created lazily so applications that never upload don't pay for it.
+        GLuint mRingBuffer = 0;
+        size_t mRingHead = 0;
+        size_t mRingUsedSize = 0;
+        // For each serial, the amount of ring memory to release once it is completed, including
+        // the space skipped when an allocation wraps around.
+        SerialQueue<size_t> mInflightAllocations;
+    };
+
+}}  // namespace backend::opengl
+
+#endif  // BACKEND_OPENGL_TEXTUREUPLOADERGL_H_
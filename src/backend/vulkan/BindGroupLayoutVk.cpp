@@ -0,0 +1,192 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/BindGroupLayoutVk.h"
+
+#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/VulkanBackend.h"
+#include "common/BitSetIterator.h"
+
+#include <algorithm>
+
+namespace backend { namespace vulkan {
+
+    namespace {
+        // Pools are allocated with an increasing number of sets so that layouts used for a few
+        // bind groups don't waste memory while the ones used a lot don't need many pools.
+        constexpr uint32_t kMinSetsPerPool = 16;
+        constexpr uint32_t kMaxSetsPerPool = 512;
+    }  // anonymous namespace
+
+    VkShaderStageFlags VulkanShaderStageFlags(nxt::ShaderStageBit stages) {
+        VkShaderStageFlags flags = 0;
+
+        if (stages & nxt::ShaderStageBit::Vertex) {
+            flags |= VK_SHADER_STAGE_VERTEX_BIT;
+        }
+        if (stages & nxt::ShaderStageBit::Fragment) {
+            flags |= VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
+        if (stages & nxt::ShaderStageBit::Compute) {
+            flags |= VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        return flags;
+    }
+
+    VkDescriptorType VulkanDescriptorType(nxt::BindingType type) {
+        switch (type) {
+            case nxt::BindingType::UniformBuffer:
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            case nxt::BindingType::Sampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case nxt::BindingType::SampledTexture:
+                return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            case nxt::BindingType::StorageBuffer:
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    BindGroupLayout::BindGroupLayout(Device* device, BindGroupLayoutBuilder* builder)
+        : BindGroupLayoutBase(builder), mDevice(device), mNextPoolSetCount(kMinSetsPerPool) {
+        const auto& info = GetBindingInfo();
+
+        std::array<VkDescriptorSetLayoutBinding, kMaxBindingsPerGroup> bindings;
+        uint32_t numBindings = 0;
+        for (uint32_t bindingIndex : IterateBitSet(info.mask)) {
+            VkDescriptorType type = VulkanDescriptorType(info.types[bindingIndex]);
+
+            auto& binding = bindings[numBindings];
+            binding.binding = bindingIndex;
+            binding.descriptorType = type;
+            binding.descriptorCount = 1;
+            binding.stageFlags = VulkanShaderStageFlags(info.visibilities[bindingIndex]);
+            binding.pImmutableSamplers = nullptr;
+            numBindings++;
+
+            auto poolSize = std::find_if(
+                mPoolSizesPerSet.begin(), mPoolSizesPerSet.end(),
+                [type](const VkDescriptorPoolSize& size) { return size.type == type; });
+            if (poolSize == mPoolSizesPerSet.end()) {
+                mPoolSizesPerSet.push_back({type, 1});
+            } else {
+                poolSize->descriptorCount++;
+            }
+        }
+
+        VkDescriptorSetLayoutCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.bindingCount = numBindings;
+        createInfo.pBindings = bindings.data();
+
+        if (device->fn.CreateDescriptorSetLayout(device->GetVkDevice(), &createInfo, nullptr,
+                                                 &mHandle) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+    }
+
+    BindGroupLayout::~BindGroupLayout() {
+        // All the bind groups using this layout have been destroyed but their descriptor sets
+        // might still be used by commands in flight. Destroying the pools frees the sets so it is
+        // done when these commands have completed.
+        mFreeSets.clear();
+        mSetsInFlight.ClearUpTo(mDevice->GetSerial());
+        for (VkDescriptorPool pool : mPools) {
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(pool);
+        }
+        mPools.clear();
+
+        // Descriptor set layouts are only used when creating objects so this one can be destroyed
+        // immediately.
+        if (mHandle != VK_NULL_HANDLE) {
+            mDevice->fn.DestroyDescriptorSetLayout(mDevice->GetVkDevice(), mHandle, nullptr);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkDescriptorSetLayout BindGroupLayout::GetHandle() const {
+        return mHandle;
+    }
+
+    VkDescriptorSet BindGroupLayout::AllocateDescriptorSet() {
+        Serial completedSerial = mDevice->GetCompletedSerial();
+        for (VkDescriptorSet set : mSetsInFlight.IterateUpTo(completedSerial)) {
+            mFreeSets.push_back(set);
+        }
+        mSetsInFlight.ClearUpTo(completedSerial);
+
+        if (mFreeSets.empty()) {
+            AllocateDescriptorPool();
+        }
+
+        VkDescriptorSet set = mFreeSets.back();
+        mFreeSets.pop_back();
+        return set;
+    }
+
+    void BindGroupLayout::DeallocateDescriptorSet(VkDescriptorSet set) {
+        mSetsInFlight.Enqueue(set, mDevice->GetSerial());
+    }
+
+    void BindGroupLayout::AllocateDescriptorPool() {
+        uint32_t setCount = mNextPoolSetCount;
+        mNextPoolSetCount = std::min(mNextPoolSetCount * 2, kMaxSetsPerPool);
+
+        std::vector<VkDescriptorPoolSize> poolSizes = mPoolSizesPerSet;
+        for (auto& poolSize : poolSizes) {
+            poolSize.descriptorCount *= setCount;
+        }
+        // Pools must have at least one pool size, even for layouts without bindings.
+        if (poolSizes.empty()) {
+            poolSizes.push_back({VK_DESCRIPTOR_TYPE_SAMPLER, 1});
+        }
+
+        VkDescriptorPoolCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.maxSets = setCount;
+        createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        createInfo.pPoolSizes = poolSizes.data();
+
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        if (mDevice->fn.CreateDescriptorPool(mDevice->GetVkDevice(), &createInfo, nullptr,
+                                             &pool) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+        mPools.push_back(pool);
+
+        // Allocate all the sets of the pool at once, they are never freed individually.
+        std::vector<VkDescriptorSetLayout> layouts(setCount, mHandle);
+
+        VkDescriptorSetAllocateInfo allocateInfo;
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.pNext = nullptr;
+        allocateInfo.descriptorPool = pool;
+        allocateInfo.descriptorSetCount = setCount;
+        allocateInfo.pSetLayouts = layouts.data();
+
+        size_t firstNewSet = mFreeSets.size();
+        mFreeSets.resize(firstNewSet + setCount);
+        if (mDevice->fn.AllocateDescriptorSets(mDevice->GetVkDevice(), &allocateInfo,
+                                               &mFreeSets[firstNewSet]) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+    }
+
+}}  // namespace backend::vulkan
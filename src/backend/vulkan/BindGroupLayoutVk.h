@@ -0,0 +1,63 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_BINDGROUPLAYOUTVK_H_
+#define BACKEND_VULKAN_BINDGROUPLAYOUTVK_H_
+
+#include "backend/BindGroupLayout.h"
+
+#include "backend/vulkan/vulkan_platform.h"
+#include "common/SerialQueue.h"
+
+#include <vector>
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    VkShaderStageFlags VulkanShaderStageFlags(nxt::ShaderStageBit stages);
+    VkDescriptorType VulkanDescriptorType(nxt::BindingType type);
+
+    // The descriptor sets of bind groups are allocated from descriptor pools owned by their layout.
+    // Pools are sized for this layout only and allocate all their sets at once. When a bind group
+    // is destroyed its set is kept until the commands using it have completed and is then reused
+    // for the next bind group, which avoids allocating and freeing sets individually.
+    class BindGroupLayout : public BindGroupLayoutBase {
+      public:
+        BindGroupLayout(Device* device, BindGroupLayoutBuilder* builder);
+        ~BindGroupLayout();
+
+        VkDescriptorSetLayout GetHandle() const;
+
+        VkDescriptorSet AllocateDescriptorSet();
+        void DeallocateDescriptorSet(VkDescriptorSet set);
+
+      private:
+        void AllocateDescriptorPool();
+
+        Device* mDevice = nullptr;
+        VkDescriptorSetLayout mHandle = VK_NULL_HANDLE;
+
+        // The number of descriptors of each type needed by a single set.
+        std::vector<VkDescriptorPoolSize> mPoolSizesPerSet;
+        std::vector<VkDescriptorPool> mPools;
+        uint32_t mNextPoolSetCount;
+
+        std::vector<VkDescriptorSet> mFreeSets;
+        SerialQueue<VkDescriptorSet> mSetsInFlight;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_BINDGROUPLAYOUTVK_H_
@@ -0,0 +1,122 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/BindGroupVk.h"
+
+#include "backend/vulkan/BindGroupLayoutVk.h"
+#include "backend/vulkan/BufferVk.h"
+#include "backend/vulkan/SamplerVk.h"
+#include "backend/vulkan/TextureVk.h"
+#include "backend/vulkan/VulkanBackend.h"
+#include "common/BitSetIterator.h"
+
+namespace backend { namespace vulkan {
+
+    BindGroup::BindGroup(Device* device, BindGroupBuilder* builder)
+        : BindGroupBase(builder) {
+        mHandle = GetBackendLayout()->AllocateDescriptorSet();
+
+        // The descriptor set might have been used by a previous bind group, all its bindings are
+        // rewritten so nothing from the previous use leaks in this bind group.
+        std::array<VkWriteDescriptorSet, kMaxBindingsPerGroup> writes;
+        std::array<VkDescriptorBufferInfo, kMaxBindingsPerGroup> writeBufferInfo;
+        std::array<VkDescriptorImageInfo, kMaxBindingsPerGroup> writeImageInfo;
+
+        const auto& layoutInfo = GetLayout()->GetBindingInfo();
+        uint32_t numWrites = 0;
+        for (uint32_t bindingIndex : IterateBitSet(layoutInfo.mask)) {
+            auto& write = writes[numWrites];
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.pNext = nullptr;
+            write.dstSet = mHandle;
+            write.dstBinding = bindingIndex;
+            write.dstArrayElement = 0;
+            write.descriptorCount = 1;
+            write.descriptorType = VulkanDescriptorType(layoutInfo.types[bindingIndex]);
+            write.pImageInfo = nullptr;
+            write.pBufferInfo = nullptr;
+            write.pTexelBufferView = nullptr;
+
+            switch (layoutInfo.types[bindingIndex]) {
+                case nxt::BindingType::UniformBuffer:
+                case nxt::BindingType::StorageBuffer: {
+                    BufferViewBase* view = GetBindingAsBufferView(bindingIndex);
+                    Buffer* buffer = ToBackend(view->GetBuffer());
+
+                    writeBufferInfo[numWrites].buffer = buffer->GetHandle();
+                    writeBufferInfo[numWrites].offset = view->GetOffset();
+                    writeBufferInfo[numWrites].range = view->GetSize();
+
+                    write.pBufferInfo = &writeBufferInfo[numWrites];
+                } break;
+
+                case nxt::BindingType::Sampler: {
+                    Sampler* sampler = ToBackend(GetBindingAsSampler(bindingIndex));
+
+                    writeImageInfo[numWrites].sampler = sampler->GetHandle();
+                    writeImageInfo[numWrites].imageView = VK_NULL_HANDLE;
+                    writeImageInfo[numWrites].imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+                    write.pImageInfo = &writeImageInfo[numWrites];
+                } break;
+
+                case nxt::BindingType::SampledTexture: {
+                    TextureView* view = ToBackend(GetBindingAsTextureView(bindingIndex));
+                    TextureBase* texture = view->GetTexture();
+
+                    // The frontend makes sure the texture is in the Sampled usage when it is used,
+                    // or frozen in a usage containing it.
+                    nxt::TextureUsageBit usage = nxt::TextureUsageBit::Sampled;
+                    if (texture->IsFrozen()) {
+                        usage = texture->GetUsage();
+                    }
+
+                    writeImageInfo[numWrites].sampler = VK_NULL_HANDLE;
+                    writeImageInfo[numWrites].imageView = view->GetSampledHandle();
+                    writeImageInfo[numWrites].imageLayout =
+                        VulkanImageLayout(usage, texture->GetFormat());
+
+                    write.pImageInfo = &writeImageInfo[numWrites];
+                } break;
+
+                default:
+                    UNREACHABLE();
+            }
+
+            numWrites++;
+        }
+
+        if (numWrites > 0) {
+            device->fn.UpdateDescriptorSets(device->GetVkDevice(), numWrites, writes.data(), 0,
+                                            nullptr);
+        }
+    }
+
+    BindGroup::~BindGroup() {
+        if (mHandle != VK_NULL_HANDLE) {
+            GetBackendLayout()->DeallocateDescriptorSet(mHandle);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkDescriptorSet BindGroup::GetHandle() const {
+        return mHandle;
+    }
+
+    BindGroupLayout* BindGroup::GetBackendLayout() {
+        // The descriptor set allocator lives in the layout which is otherwise immutable.
+        return ToBackend(const_cast<BindGroupLayoutBase*>(GetLayout()));
+    }
+
+}}  // namespace backend::vulkan
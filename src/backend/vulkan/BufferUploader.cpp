@@ -16,6 +16,7 @@
 
 #include "backend/vulkan/FencedDeleter.h"
 #include "backend/vulkan/MemoryAllocator.h"
+#include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
 
 #include <cstring>
@@ -32,6 +33,53 @@ namespace backend { namespace vulkan {
                                        VkDeviceSize offset,
                                        VkDeviceSize size,
                                        const void* data) {
+        VkBuffer stagingBuffer = CreateStagingBuffer(size, data);
+
+        VkBufferCopy copy;
+        copy.srcOffset = 0;
+        copy.dstOffset = offset;
+        copy.size = size;
+        mDevice->fn.CmdCopyBuffer(mDevice->GetPendingCommandBuffer(), stagingBuffer, buffer, 1,
+                                  &copy);
+    }
+
+    void BufferUploader::TextureSubData(Texture* texture,
+                                        uint32_t level,
+                                        uint32_t x,
+                                        uint32_t y,
+                                        uint32_t width,
+                                        uint32_t height,
+                                        uint32_t rowPitch,
+                                        const uint8_t* data) {
+        nxt::TextureFormat format = texture->GetFormat();
+        uint32_t rowCount = ComputeTextureRowCount(format, height);
+        VkDeviceSize size =
+            VkDeviceSize(rowPitch) * (rowCount - 1) + ComputeTextureRowSize(format, width);
+        VkBuffer stagingBuffer = CreateStagingBuffer(size, data);
+
+        VkBufferImageCopy region;
+        region.bufferOffset = 0;
+        // In Vulkan the row length is in texels while it is in bytes for NXT
+        region.bufferRowLength =
+            rowPitch / TextureFormatBlockSize(format) * TextureFormatBlockWidth(format);
+        region.bufferImageHeight = rowCount * TextureFormatBlockHeight(format);
+
+        region.imageSubresource.aspectMask = texture->GetVkAspectMask();
+        region.imageSubresource.mipLevel = level;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+
+        region.imageOffset = {static_cast<int32_t>(x), static_cast<int32_t>(y), 0};
+        region.imageExtent = {width, height, 1};
+
+        // The frontend checked the texture has the TransferDst usage so it is in the
+        // TRANSFER_DST_OPTIMAL layout
+        mDevice->fn.CmdCopyBufferToImage(mDevice->GetPendingCommandBuffer(), stagingBuffer,
+                                         texture->GetHandle(),
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+
+    VkBuffer BufferUploader::CreateStagingBuffer(VkDeviceSize size, const void* data) {
         // TODO(cwallez@chromium.org): this is soooooo bad. We should use some sort of ring buffer
         // for this.
 
@@ -71,7 +119,7 @@ namespace backend { namespace vulkan {
         ASSERT(allocation.GetMappedPointer() != nullptr);
         memcpy(allocation.GetMappedPointer(), data, static_cast<size_t>(size));
 
-        // Enqueue host write -> transfer src barrier and copy command
+        // Enqueue host write -> transfer src barrier
         VkCommandBuffer commands = mDevice->GetPendingCommandBuffer();
 
         VkMemoryBarrier barrier;
@@ -84,16 +132,14 @@ namespace backend { namespace vulkan {
                                        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr,
                                        0, nullptr);
 
-        VkBufferCopy copy;
-        copy.srcOffset = 0;
-        copy.dstOffset = offset;
-        copy.size = size;
-        mDevice->fn.CmdCopyBuffer(commands, stagingBuffer, buffer, 1, &copy);
-
+        // The deletions are deferred until the pending commands, including the copy recorded by
+        // the caller, are complete.
         // TODO(cwallez@chromium.org): Buffers must be deleted before the memory.
         // This happens to work for now, but is fragile.
         mDevice->GetMemoryAllocator()->Free(&allocation);
         mDevice->GetFencedDeleter()->DeleteWhenUnused(stagingBuffer);
+
+        return stagingBuffer;
     }
 
     void BufferUploader::Tick(Serial) {
@@ -21,6 +21,7 @@
 namespace backend { namespace vulkan {
 
     class Device;
+    class Texture;
 
     class BufferUploader {
       public:
@@ -31,10 +32,22 @@ namespace backend { namespace vulkan {
                            VkDeviceSize offset,
                            VkDeviceSize size,
                            const void* data);
+        void TextureSubData(Texture* texture,
+                            uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data);
 
         void Tick(Serial completedSerial);
 
       private:
+        // Returns a staging buffer containing data, ready to be used as the source of a transfer
+        // in the pending command buffer. It is deleted when the pending commands complete.
+        VkBuffer CreateStagingBuffer(VkDeviceSize size, const void* data);
+
         Device* mDevice = nullptr;
     };
 
@@ -15,9 +15,20 @@
 #include "backend/vulkan/CommandBufferVk.h"
 
 #include "backend/Commands.h"
+#include "backend/PerStage.h"
+#include "backend/vulkan/BindGroupVk.h"
 #include "backend/vulkan/BufferVk.h"
+#include "backend/vulkan/ComputePipelineVk.h"
+#include "backend/vulkan/FramebufferVk.h"
+#include "backend/vulkan/PipelineLayoutVk.h"
+#include "backend/vulkan/RenderPassCache.h"
+#include "backend/vulkan/RenderPipelineVk.h"
 #include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
+#include "common/BitSetIterator.h"
+
+#include <cstring>
+#include <vector>
 
 namespace backend { namespace vulkan {
 
@@ -27,30 +38,186 @@ namespace backend { namespace vulkan {
                                                        const BufferCopyLocation& bufferLocation,
                                                        const TextureCopyLocation& textureLocation) {
             const Texture* texture = ToBackend(textureLocation.texture).Get();
+            nxt::TextureFormat format = texture->GetFormat();
 
             VkBufferImageCopy region;
 
             region.bufferOffset = bufferLocation.offset;
-            // In Vulkan the row length is in texels while it is in bytes for NXT
-            region.bufferRowLength = rowPitch / TextureFormatPixelSize(texture->GetFormat());
-            region.bufferImageHeight = rowPitch * textureLocation.height;
+            // In Vulkan the row length and image height are in texels while NXT has the row pitch
+            // in bytes. For compressed formats both must be multiples of the block dimensions.
+            region.bufferRowLength =
+                rowPitch / TextureFormatBlockSize(format) * TextureFormatBlockWidth(format);
+            region.bufferImageHeight = ComputeTextureRowCount(format, textureLocation.height) *
+                                       TextureFormatBlockHeight(format);
 
             region.imageSubresource.aspectMask = texture->GetVkAspectMask();
             region.imageSubresource.mipLevel = textureLocation.level;
-            region.imageSubresource.baseArrayLayer = 0;
-            region.imageSubresource.layerCount = 1;
 
             region.imageOffset.x = textureLocation.x;
             region.imageOffset.y = textureLocation.y;
-            region.imageOffset.z = textureLocation.z;
 
             region.imageExtent.width = textureLocation.width;
             region.imageExtent.height = textureLocation.height;
-            region.imageExtent.depth = textureLocation.depth;
+
+            // For 2D arrays z and depth are a range of layers which are all copied by the same
+            // region, each layer's image being bufferImageHeight rows after the previous one.
+            if (texture->GetDimension() == nxt::TextureDimension::e2DArray) {
+                region.imageSubresource.baseArrayLayer = textureLocation.z;
+                region.imageSubresource.layerCount = textureLocation.depth;
+                region.imageOffset.z = 0;
+                region.imageExtent.depth = 1;
+            } else {
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset.z = textureLocation.z;
+                region.imageExtent.depth = textureLocation.depth;
+            }
 
             return region;
         }
 
+        // NXT's Y axis points up in framebuffer coordinates like OpenGL, the viewport is flipped
+        // with a negative height (requires VK_KHR_maintenance1) to match.
+        VkViewport ComputeFlippedViewport(float x,
+                                          float y,
+                                          float width,
+                                          float height,
+                                          float minDepth,
+                                          float maxDepth) {
+            VkViewport viewport;
+            viewport.x = x;
+            viewport.y = y + height;
+            viewport.width = width;
+            viewport.height = -height;
+            viewport.minDepth = minDepth;
+            viewport.maxDepth = maxDepth;
+            return viewport;
+        }
+
+        // Descriptor sets are bound lazily before draws and dispatches because vkCmdBindDescriptorSets
+        // needs a pipeline layout that might not be known when the bind group is set. When the
+        // pipeline layout changes, the sets after the part of the layout that is inherited are
+        // disturbed and need to be bound again.
+        class DescriptorSetTracker {
+          public:
+            void OnBeginPass() {
+                mSets.fill(VK_NULL_HANDLE);
+                mDirtySets.reset();
+                mLayout = nullptr;
+            }
+
+            void OnSetBindGroup(uint32_t index, VkDescriptorSet set) {
+                mSets[index] = set;
+                mDirtySets.set(index);
+            }
+
+            void OnSetPipeline(PipelineBase* pipeline) {
+                PipelineLayout* layout = ToBackend(pipeline->GetLayout());
+
+                std::bitset<kMaxBindGroups> inheritedSets;
+                if (mLayout != nullptr) {
+                    inheritedSets = layout->InheritedGroupsMask(mLayout);
+                }
+                mDirtySets |= layout->GetBindGroupsLayoutMask() & ~inheritedSets;
+                mLayout = layout;
+            }
+
+            void Flush(Device* device, VkCommandBuffer commands, VkPipelineBindPoint bindPoint) {
+                ASSERT(mLayout != nullptr);
+                std::bitset<kMaxBindGroups> setsToBind =
+                    mDirtySets & mLayout->GetBindGroupsLayoutMask();
+
+                for (uint32_t index : IterateBitSet(setsToBind)) {
+                    ASSERT(mSets[index] != VK_NULL_HANDLE);
+                    device->fn.CmdBindDescriptorSets(commands, bindPoint, mLayout->GetHandle(),
+                                                     index, 1, &mSets[index], 0, nullptr);
+                }
+
+                mDirtySets &= ~setsToBind;
+            }
+
+          private:
+            std::array<VkDescriptorSet, kMaxBindGroups> mSets;
+            std::bitset<kMaxBindGroups> mDirtySets;
+            PipelineLayout* mLayout = nullptr;
+        };
+
+        // All pipeline layouts have the same push constant ranges so push constants stay valid
+        // when the pipeline changes, but vkCmdPushConstants needs a pipeline layout so they are
+        // pushed lazily too. Stages only get their own push constants in passes using them because
+        // the vertex and compute stages share the same range.
+        class PushConstantTracker {
+          public:
+            void OnBeginPass(nxt::ShaderStageBit passStages) {
+                for (auto stage : IterateStages(kAllStages)) {
+                    mValues[stage].fill(0);
+                }
+                // The push constants are undefined at the beginning of the command buffer, set
+                // them all to zero.
+                mPassStages = passStages;
+                mDirtyStages = passStages;
+            }
+
+            void OnSetPushConstants(nxt::ShaderStageBit stages,
+                                    uint32_t count,
+                                    uint32_t offset,
+                                    const uint32_t* data) {
+                for (auto stage : IterateStages(stages)) {
+                    memcpy(&mValues[stage][offset], data, count * sizeof(uint32_t));
+                }
+                mDirtyStages |= stages & mPassStages;
+            }
+
+            void Flush(Device* device, VkCommandBuffer commands, PipelineLayout* layout) {
+                for (auto stage : IterateStages(mDirtyStages)) {
+                    device->fn.CmdPushConstants(commands, layout->GetHandle(),
+                                                GetPushConstantRangeStages(stage),
+                                                GetPushConstantStageOffset(stage),
+                                                kPushConstantStageSize, mValues[stage].data());
+                }
+                mDirtyStages = nxt::ShaderStageBit::None;
+            }
+
+          private:
+            PerStage<std::array<uint32_t, kMaxPushConstants>> mValues;
+            nxt::ShaderStageBit mPassStages = nxt::ShaderStageBit::None;
+            nxt::ShaderStageBit mDirtyStages = nxt::ShaderStageBit::None;
+        };
+
+        // The index type is part of the pipeline in NXT but part of vkCmdBindIndexBuffer in Vulkan
+        // so the index buffer is bound before indexed draws once the index type is known.
+        class IndexBufferTracker {
+          public:
+            void OnSetIndexBuffer(Buffer* buffer, uint32_t offset) {
+                mBuffer = buffer;
+                mOffset = offset;
+                mDirty = true;
+            }
+
+            void OnSetPipeline(RenderPipeline* pipeline) {
+                VkIndexType indexType = pipeline->GetVkIndexType();
+                if (indexType != mIndexType) {
+                    mIndexType = indexType;
+                    mDirty = true;
+                }
+            }
+
+            void Flush(Device* device, VkCommandBuffer commands) {
+                if (mDirty) {
+                    ASSERT(mBuffer != nullptr);
+                    device->fn.CmdBindIndexBuffer(commands, mBuffer->GetHandle(), mOffset,
+                                                  mIndexType);
+                    mDirty = false;
+                }
+            }
+
+          private:
+            Buffer* mBuffer = nullptr;
+            uint32_t mOffset = 0;
+            VkIndexType mIndexType = VK_INDEX_TYPE_UINT32;
+            bool mDirty = false;
+        };
+
     }  // anonymous namespace
 
     CommandBuffer::CommandBuffer(CommandBufferBuilder* builder)
@@ -65,21 +232,130 @@ namespace backend { namespace vulkan {
         Device* device = ToBackend(GetDevice());
 
         Command type;
+        BufferCopyBatch bufferCopies;
+        std::vector<VkBufferCopy> regions;
+
+        Framebuffer* currentFramebuffer = nullptr;
+        uint32_t currentSubpass = 0;
+        PipelineBase* lastPipeline = nullptr;
+        DescriptorSetTracker descriptorSets;
+        PushConstantTracker pushConstants;
+        IndexBufferTracker indexBuffer;
+
         while (mCommands.NextCommandId(&type)) {
             switch (type) {
+                case Command::BeginComputePass: {
+                    mCommands.NextCommand<BeginComputePassCmd>();
+                    descriptorSets.OnBeginPass();
+                    pushConstants.OnBeginPass(nxt::ShaderStageBit::Compute);
+                    lastPipeline = nullptr;
+                } break;
+
+                case Command::BeginRenderPass: {
+                    BeginRenderPassCmd* cmd = mCommands.NextCommand<BeginRenderPassCmd>();
+                    RenderPassBase* renderPass = cmd->renderPass.Get();
+                    Framebuffer* framebuffer = ToBackend(cmd->framebuffer.Get());
+                    currentFramebuffer = framebuffer;
+                    currentSubpass = 0;
+
+                    // Attachments must be in the OutputAttachment usage for the whole render
+                    // pass so they are transitioned before it begins. The VkRenderPass depends on
+                    // the layouts of the attachments, which can be different from the optimal
+                    // ones if the texture is frozen in multiple usages.
+                    std::vector<VkImageLayout> layouts;
+                    for (uint32_t i = 0; i < renderPass->GetAttachmentCount(); ++i) {
+                        Texture* texture =
+                            ToBackend(framebuffer->GetTextureView(i)->GetTexture());
+                        constexpr auto usage = nxt::TextureUsageBit::OutputAttachment;
+                        // It's already validated that this texture is either frozen to the correct
+                        // usage, or not frozen.
+                        if (!texture->IsFrozen()) {
+                            texture->TransitionLevelsNow(commands, 0, texture->GetNumMipLevels(),
+                                                         usage, true);
+                        }
+                        layouts.push_back(
+                            VulkanImageLayout(texture->GetUsage(), texture->GetFormat()));
+                    }
+
+                    RenderPassCacheQuery query(renderPass, layouts);
+                    std::vector<VkClearValue> clearValues = framebuffer->GetClearValues();
+                    uint32_t width = framebuffer->GetWidth();
+                    uint32_t height = framebuffer->GetHeight();
+
+                    VkRenderPassBeginInfo beginInfo;
+                    beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                    beginInfo.pNext = nullptr;
+                    beginInfo.renderPass = device->GetRenderPassCache()->GetRenderPass(query);
+                    beginInfo.framebuffer = framebuffer->GetHandle();
+                    beginInfo.renderArea.offset.x = 0;
+                    beginInfo.renderArea.offset.y = 0;
+                    beginInfo.renderArea.extent.width = width;
+                    beginInfo.renderArea.extent.height = height;
+                    beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+                    beginInfo.pClearValues = clearValues.data();
+
+                    device->fn.CmdBeginRenderPass(commands, &beginInfo,
+                                                  VK_SUBPASS_CONTENTS_INLINE);
+
+                    // The dynamic state is undefined at the start of the command buffer, set it
+                    // to NXT's defaults.
+                    const float blendConstants[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                    device->fn.CmdSetBlendConstants(commands, blendConstants);
+                    device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK, 0);
+                } break;
+
+                case Command::BeginRenderSubpass: {
+                    mCommands.NextCommand<BeginRenderSubpassCmd>();
+                    // The first subpass is begun by vkCmdBeginRenderPass.
+                    if (currentSubpass > 0) {
+                        device->fn.CmdNextSubpass(commands, VK_SUBPASS_CONTENTS_INLINE);
+                    }
+
+                    // The viewport and scissor are reset to the whole framebuffer for each
+                    // subpass.
+                    uint32_t width = currentFramebuffer->GetWidth();
+                    uint32_t height = currentFramebuffer->GetHeight();
+                    VkViewport viewport = ComputeFlippedViewport(
+                        0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f,
+                        1.0f);
+                    device->fn.CmdSetViewport(commands, 0, 1, &viewport);
+
+                    VkRect2D scissor;
+                    scissor.offset.x = 0;
+                    scissor.offset.y = 0;
+                    scissor.extent.width = width;
+                    scissor.extent.height = height;
+                    device->fn.CmdSetScissor(commands, 0, 1, &scissor);
+
+                    descriptorSets.OnBeginPass();
+                    pushConstants.OnBeginPass(nxt::ShaderStageBit::Vertex |
+                                              nxt::ShaderStageBit::Fragment);
+                    lastPipeline = nullptr;
+                } break;
+
                 case Command::CopyBufferToBuffer: {
                     CopyBufferToBufferCmd* copy = mCommands.NextCommand<CopyBufferToBufferCmd>();
-                    auto& src = copy->source;
-                    auto& dst = copy->destination;
+                    GatherBufferCopies(&mCommands, copy, &bufferCopies);
+                    if (bufferCopies.regions.empty()) {
+                        device->CountBufferCopies(bufferCopies.commandCount, 0);
+                        break;
+                    }
 
-                    VkBufferCopy region;
-                    region.srcOffset = src.offset;
-                    region.dstOffset = dst.offset;
-                    region.size = copy->size;
+                    regions.clear();
+                    for (const auto& copyRegion : bufferCopies.regions) {
+                        VkBufferCopy region;
+                        region.srcOffset = copyRegion.sourceOffset;
+                        region.dstOffset = copyRegion.destinationOffset;
+                        region.size = copyRegion.size;
+                        regions.push_back(region);
+                    }
 
-                    VkBuffer srcHandle = ToBackend(src.buffer)->GetHandle();
-                    VkBuffer dstHandle = ToBackend(dst.buffer)->GetHandle();
-                    device->fn.CmdCopyBuffer(commands, srcHandle, dstHandle, 1, &region);
+                    VkBuffer srcHandle = ToBackend(bufferCopies.source)->GetHandle();
+                    VkBuffer dstHandle = ToBackend(bufferCopies.destination)->GetHandle();
+                    device->fn.CmdCopyBuffer(commands, srcHandle, dstHandle,
+                                             static_cast<uint32_t>(regions.size()),
+                                             regions.data());
+                    device->CountBufferCopies(bufferCopies.commandCount, 1);
                 } break;
 
                 case Command::CopyBufferToTexture: {
@@ -114,6 +390,158 @@ namespace backend { namespace vulkan {
                                                     dstBuffer, 1, &region);
                 } break;
 
+                case Command::Dispatch: {
+                    DispatchCmd* dispatch = mCommands.NextCommand<DispatchCmd>();
+                    descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_COMPUTE);
+                    pushConstants.Flush(device, commands, ToBackend(lastPipeline->GetLayout()));
+                    device->fn.CmdDispatch(commands, dispatch->x, dispatch->y, dispatch->z);
+                } break;
+
+                case Command::DrawArrays: {
+                    DrawArraysCmd* draw = mCommands.NextCommand<DrawArraysCmd>();
+                    descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Flush(device, commands, ToBackend(lastPipeline->GetLayout()));
+                    device->fn.CmdDraw(commands, draw->vertexCount, draw->instanceCount,
+                                       draw->firstVertex, draw->firstInstance);
+                } break;
+
+                case Command::DrawElements: {
+                    DrawElementsCmd* draw = mCommands.NextCommand<DrawElementsCmd>();
+                    descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Flush(device, commands, ToBackend(lastPipeline->GetLayout()));
+                    indexBuffer.Flush(device, commands);
+                    device->fn.CmdDrawIndexed(commands, draw->indexCount, draw->instanceCount,
+                                              draw->firstIndex, 0, draw->firstInstance);
+                } break;
+
+                case Command::EndComputePass: {
+                    mCommands.NextCommand<EndComputePassCmd>();
+                } break;
+
+                case Command::EndRenderPass: {
+                    mCommands.NextCommand<EndRenderPassCmd>();
+                    device->fn.CmdEndRenderPass(commands);
+                } break;
+
+                case Command::EndRenderSubpass: {
+                    mCommands.NextCommand<EndRenderSubpassCmd>();
+                    currentSubpass++;
+                } break;
+
+                case Command::GenerateMipmaps: {
+                    GenerateMipmapsCmd* cmd = mCommands.NextCommand<GenerateMipmapsCmd>();
+                    ToBackend(cmd->texture)
+                        ->RecordGenerateMipmaps(commands, cmd->baseLevel, cmd->levelCount);
+                } break;
+
+                case Command::MultiDrawArrays: {
+                    MultiDrawArraysCmd* draw = mCommands.NextCommand<MultiDrawArraysCmd>();
+                    uint32_t* vertexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstVertices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Flush(device, commands, ToBackend(lastPipeline->GetLayout()));
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        device->fn.CmdDraw(commands, vertexCounts[i], draw->instanceCount,
+                                           firstVertices[i], draw->firstInstance);
+                    }
+                } break;
+
+                case Command::MultiDrawElements: {
+                    MultiDrawElementsCmd* draw = mCommands.NextCommand<MultiDrawElementsCmd>();
+                    uint32_t* indexCounts = mCommands.NextData<uint32_t>(draw->drawCount);
+                    uint32_t* firstIndices = mCommands.NextData<uint32_t>(draw->drawCount);
+                    descriptorSets.Flush(device, commands, VK_PIPELINE_BIND_POINT_GRAPHICS);
+                    pushConstants.Flush(device, commands, ToBackend(lastPipeline->GetLayout()));
+                    indexBuffer.Flush(device, commands);
+                    for (uint32_t i = 0; i < draw->drawCount; ++i) {
+                        device->fn.CmdDrawIndexed(commands, indexCounts[i], draw->instanceCount,
+                                                  firstIndices[i], 0, draw->firstInstance);
+                    }
+                } break;
+
+                case Command::SetComputePipeline: {
+                    SetComputePipelineCmd* cmd = mCommands.NextCommand<SetComputePipelineCmd>();
+                    ComputePipeline* pipeline = ToBackend(cmd->pipeline.Get());
+
+                    device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                               pipeline->GetHandle());
+                    descriptorSets.OnSetPipeline(pipeline);
+                    lastPipeline = pipeline;
+                } break;
+
+                case Command::SetRenderPipeline: {
+                    SetRenderPipelineCmd* cmd = mCommands.NextCommand<SetRenderPipelineCmd>();
+                    RenderPipeline* pipeline = ToBackend(cmd->pipeline.Get());
+
+                    device->fn.CmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                               pipeline->GetHandle());
+                    descriptorSets.OnSetPipeline(pipeline);
+                    indexBuffer.OnSetPipeline(pipeline);
+                    lastPipeline = pipeline;
+                } break;
+
+                case Command::SetPushConstants: {
+                    SetPushConstantsCmd* cmd = mCommands.NextCommand<SetPushConstantsCmd>();
+                    uint32_t* data = mCommands.NextData<uint32_t>(cmd->count);
+                    pushConstants.OnSetPushConstants(cmd->stages, cmd->count, cmd->offset, data);
+                } break;
+
+                case Command::SetStencilReference: {
+                    SetStencilReferenceCmd* cmd = mCommands.NextCommand<SetStencilReferenceCmd>();
+                    device->fn.CmdSetStencilReference(commands, VK_STENCIL_FRONT_AND_BACK,
+                                                      cmd->reference);
+                } break;
+
+                case Command::SetBlendColor: {
+                    SetBlendColorCmd* cmd = mCommands.NextCommand<SetBlendColorCmd>();
+                    const float blendConstants[4] = {cmd->r, cmd->g, cmd->b, cmd->a};
+                    device->fn.CmdSetBlendConstants(commands, blendConstants);
+                } break;
+
+                case Command::SetViewport: {
+                    SetViewportCmd* cmd = mCommands.NextCommand<SetViewportCmd>();
+                    VkViewport viewport = ComputeFlippedViewport(
+                        cmd->x, cmd->y, cmd->width, cmd->height, cmd->minDepth, cmd->maxDepth);
+                    device->fn.CmdSetViewport(commands, 0, 1, &viewport);
+                } break;
+
+                case Command::SetScissorRect: {
+                    SetScissorRectCmd* cmd = mCommands.NextCommand<SetScissorRectCmd>();
+                    VkRect2D scissor;
+                    scissor.offset.x = static_cast<int32_t>(cmd->x);
+                    scissor.offset.y = static_cast<int32_t>(cmd->y);
+                    scissor.extent.width = cmd->width;
+                    scissor.extent.height = cmd->height;
+                    device->fn.CmdSetScissor(commands, 0, 1, &scissor);
+                } break;
+
+                case Command::SetBindGroup: {
+                    SetBindGroupCmd* cmd = mCommands.NextCommand<SetBindGroupCmd>();
+                    VkDescriptorSet set = ToBackend(cmd->group.Get())->GetHandle();
+                    descriptorSets.OnSetBindGroup(cmd->index, set);
+                } break;
+
+                case Command::SetIndexBuffer: {
+                    SetIndexBufferCmd* cmd = mCommands.NextCommand<SetIndexBufferCmd>();
+                    indexBuffer.OnSetIndexBuffer(ToBackend(cmd->buffer.Get()), cmd->offset);
+                } break;
+
+                case Command::SetVertexBuffers: {
+                    SetVertexBuffersCmd* cmd = mCommands.NextCommand<SetVertexBuffersCmd>();
+                    auto buffers = mCommands.NextData<Ref<BufferBase>>(cmd->count);
+                    auto offsets = mCommands.NextData<uint32_t>(cmd->count);
+
+                    std::array<VkBuffer, kMaxVertexInputs> vkBuffers;
+                    std::array<VkDeviceSize, kMaxVertexInputs> vkOffsets;
+                    for (uint32_t i = 0; i < cmd->count; ++i) {
+                        vkBuffers[i] = ToBackend(buffers[i].Get())->GetHandle();
+                        vkOffsets[i] = offsets[i];
+                    }
+
+                    device->fn.CmdBindVertexBuffers(commands, cmd->startSlot, cmd->count,
+                                                    vkBuffers.data(), vkOffsets.data());
+                } break;
+
                 case Command::TransitionBufferUsage: {
                     TransitionBufferUsageCmd* cmd =
                         mCommands.NextCommand<TransitionBufferUsageCmd>();
@@ -128,8 +556,8 @@ namespace backend { namespace vulkan {
                         mCommands.NextCommand<TransitionTextureUsageCmd>();
 
                     Texture* texture = ToBackend(cmd->texture.Get());
-                    texture->RecordBarrier(commands, texture->GetUsage(), cmd->usage);
-                    texture->UpdateUsageInternal(cmd->usage);
+                    texture->TransitionLevelsNow(commands, cmd->baseLevel, cmd->levelCount,
+                                                 cmd->usage, false);
                 } break;
 
                 default: { UNREACHABLE(); } break;
@@ -0,0 +1,112 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/DepthStencilStateVk.h"
+
+#include "common/Assert.h"
+
+namespace backend { namespace vulkan {
+
+    namespace {
+        VkCompareOp VulkanCompareOp(nxt::CompareFunction op) {
+            switch (op) {
+                case nxt::CompareFunction::Always:
+                    return VK_COMPARE_OP_ALWAYS;
+                case nxt::CompareFunction::Equal:
+                    return VK_COMPARE_OP_EQUAL;
+                case nxt::CompareFunction::Greater:
+                    return VK_COMPARE_OP_GREATER;
+                case nxt::CompareFunction::GreaterEqual:
+                    return VK_COMPARE_OP_GREATER_OR_EQUAL;
+                case nxt::CompareFunction::Less:
+                    return VK_COMPARE_OP_LESS;
+                case nxt::CompareFunction::LessEqual:
+                    return VK_COMPARE_OP_LESS_OR_EQUAL;
+                case nxt::CompareFunction::Never:
+                    return VK_COMPARE_OP_NEVER;
+                case nxt::CompareFunction::NotEqual:
+                    return VK_COMPARE_OP_NOT_EQUAL;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        VkStencilOp VulkanStencilOp(nxt::StencilOperation op) {
+            switch (op) {
+                case nxt::StencilOperation::DecrementClamp:
+                    return VK_STENCIL_OP_DECREMENT_AND_CLAMP;
+                case nxt::StencilOperation::DecrementWrap:
+                    return VK_STENCIL_OP_DECREMENT_AND_WRAP;
+                case nxt::StencilOperation::IncrementClamp:
+                    return VK_STENCIL_OP_INCREMENT_AND_CLAMP;
+                case nxt::StencilOperation::IncrementWrap:
+                    return VK_STENCIL_OP_INCREMENT_AND_WRAP;
+                case nxt::StencilOperation::Invert:
+                    return VK_STENCIL_OP_INVERT;
+                case nxt::StencilOperation::Keep:
+                    return VK_STENCIL_OP_KEEP;
+                case nxt::StencilOperation::Replace:
+                    return VK_STENCIL_OP_REPLACE;
+                case nxt::StencilOperation::Zero:
+                    return VK_STENCIL_OP_ZERO;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        VkStencilOpState VulkanStencilOpState(const DepthStencilStateBase::StencilFaceInfo& face,
+                                              const DepthStencilStateBase::StencilInfo& stencil) {
+            VkStencilOpState state;
+            state.failOp = VulkanStencilOp(face.stencilFail);
+            state.passOp = VulkanStencilOp(face.depthStencilPass);
+            state.depthFailOp = VulkanStencilOp(face.depthFail);
+            state.compareOp = VulkanCompareOp(face.compareFunction);
+            state.compareMask = stencil.readMask;
+            state.writeMask = stencil.writeMask;
+            // The stencil reference is always dynamic
+            state.reference = 0;
+            return state;
+        }
+    }  // anonymous namespace
+
+    DepthStencilState::DepthStencilState(DepthStencilStateBuilder* builder)
+        : DepthStencilStateBase(builder) {
+        const auto& depth = GetDepth();
+        const auto& stencil = GetStencil();
+
+        mCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        mCreateInfo.pNext = nullptr;
+        mCreateInfo.flags = 0;
+
+        // Depth writes only occur if depth is enabled
+        mCreateInfo.depthTestEnable =
+            (depth.compareFunction == nxt::CompareFunction::Always && !depth.depthWriteEnabled)
+                ? VK_FALSE
+                : VK_TRUE;
+        mCreateInfo.depthWriteEnable = depth.depthWriteEnabled ? VK_TRUE : VK_FALSE;
+        mCreateInfo.depthCompareOp = VulkanCompareOp(depth.compareFunction);
+        mCreateInfo.depthBoundsTestEnable = VK_FALSE;
+        mCreateInfo.minDepthBounds = 0.0f;
+        mCreateInfo.maxDepthBounds = 1.0f;
+
+        mCreateInfo.stencilTestEnable = StencilTestEnabled() ? VK_TRUE : VK_FALSE;
+        mCreateInfo.front = VulkanStencilOpState(stencil.front, stencil);
+        mCreateInfo.back = VulkanStencilOpState(stencil.back, stencil);
+    }
+
+    const VkPipelineDepthStencilStateCreateInfo* DepthStencilState::GetCreateInfo() const {
+        return &mCreateInfo;
+    }
+
+}}  // namespace backend::vulkan
@@ -23,22 +23,87 @@ namespace backend { namespace vulkan {
 
     FencedDeleter::~FencedDeleter() {
         ASSERT(mBuffersToDelete.Empty());
+        ASSERT(mDescriptorPoolsToDelete.Empty());
+        ASSERT(mFramebuffersToDelete.Empty());
+        ASSERT(mImagesToDelete.Empty());
+        ASSERT(mImageViewsToDelete.Empty());
         ASSERT(mMemoriesToDelete.Empty());
+        ASSERT(mPipelinesToDelete.Empty());
+        ASSERT(mPipelineLayoutsToDelete.Empty());
+        ASSERT(mSamplersToDelete.Empty());
     }
 
     void FencedDeleter::DeleteWhenUnused(VkBuffer buffer) {
         mBuffersToDelete.Enqueue(buffer, mDevice->GetSerial());
     }
 
+    void FencedDeleter::DeleteWhenUnused(VkDescriptorPool pool) {
+        mDescriptorPoolsToDelete.Enqueue(pool, mDevice->GetSerial());
+    }
+
     void FencedDeleter::DeleteWhenUnused(VkDeviceMemory memory) {
         mMemoriesToDelete.Enqueue(memory, mDevice->GetSerial());
     }
 
+    void FencedDeleter::DeleteWhenUnused(VkFramebuffer framebuffer) {
+        mFramebuffersToDelete.Enqueue(framebuffer, mDevice->GetSerial());
+    }
+
     void FencedDeleter::DeleteWhenUnused(VkImage image) {
         mImagesToDelete.Enqueue(image, mDevice->GetSerial());
     }
 
+    void FencedDeleter::DeleteWhenUnused(VkImageView view) {
+        mImageViewsToDelete.Enqueue(view, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteWhenUnused(VkPipeline pipeline) {
+        mPipelinesToDelete.Enqueue(pipeline, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteWhenUnused(VkPipelineLayout layout) {
+        mPipelineLayoutsToDelete.Enqueue(layout, mDevice->GetSerial());
+    }
+
+    void FencedDeleter::DeleteWhenUnused(VkSampler sampler) {
+        mSamplersToDelete.Enqueue(sampler, mDevice->GetSerial());
+    }
+
     void FencedDeleter::Tick(Serial completedSerial) {
+        VkDevice vkDevice = mDevice->GetVkDevice();
+
+        // Framebuffers reference image views so they are deleted first.
+        for (VkFramebuffer framebuffer : mFramebuffersToDelete.IterateUpTo(completedSerial)) {
+            mDevice->fn.DestroyFramebuffer(vkDevice, framebuffer, nullptr);
+        }
+        mFramebuffersToDelete.ClearUpTo(completedSerial);
+
+        for (VkImageView view : mImageViewsToDelete.IterateUpTo(completedSerial)) {
+            mDevice->fn.DestroyImageView(vkDevice, view, nullptr);
+        }
+        mImageViewsToDelete.ClearUpTo(completedSerial);
+
+        for (VkPipeline pipeline : mPipelinesToDelete.IterateUpTo(completedSerial)) {
+            mDevice->fn.DestroyPipeline(vkDevice, pipeline, nullptr);
+        }
+        mPipelinesToDelete.ClearUpTo(completedSerial);
+
+        for (VkPipelineLayout layout : mPipelineLayoutsToDelete.IterateUpTo(completedSerial)) {
+            mDevice->fn.DestroyPipelineLayout(vkDevice, layout, nullptr);
+        }
+        mPipelineLayoutsToDelete.ClearUpTo(completedSerial);
+
+        // Destroying the pool frees all the descriptor sets allocated from it.
+        for (VkDescriptorPool pool : mDescriptorPoolsToDelete.IterateUpTo(completedSerial)) {
+            mDevice->fn.DestroyDescriptorPool(vkDevice, pool, nullptr);
+        }
+        mDescriptorPoolsToDelete.ClearUpTo(completedSerial);
+
+        for (VkSampler sampler : mSamplersToDelete.IterateUpTo(completedSerial)) {
+            mDevice->fn.DestroySampler(vkDevice, sampler, nullptr);
+        }
+        mSamplersToDelete.ClearUpTo(completedSerial);
+
         // Buffers and images must be deleted before memories because it is invalid to free memory
         // that still have resources bound to it.
         for (VkBuffer buffer : mBuffersToDelete.IterateUpTo(completedSerial)) {
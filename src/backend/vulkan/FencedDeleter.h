@@ -28,16 +28,28 @@ namespace backend { namespace vulkan {
         ~FencedDeleter();
 
         void DeleteWhenUnused(VkBuffer buffer);
+        void DeleteWhenUnused(VkDescriptorPool pool);
         void DeleteWhenUnused(VkDeviceMemory memory);
+        void DeleteWhenUnused(VkFramebuffer framebuffer);
         void DeleteWhenUnused(VkImage image);
+        void DeleteWhenUnused(VkImageView view);
+        void DeleteWhenUnused(VkPipeline pipeline);
+        void DeleteWhenUnused(VkPipelineLayout layout);
+        void DeleteWhenUnused(VkSampler sampler);
 
         void Tick(Serial completedSerial);
 
       private:
         Device* mDevice = nullptr;
         SerialQueue<VkBuffer> mBuffersToDelete;
+        SerialQueue<VkDescriptorPool> mDescriptorPoolsToDelete;
         SerialQueue<VkDeviceMemory> mMemoriesToDelete;
+        SerialQueue<VkFramebuffer> mFramebuffersToDelete;
         SerialQueue<VkImage> mImagesToDelete;
+        SerialQueue<VkImageView> mImageViewsToDelete;
+        SerialQueue<VkPipeline> mPipelinesToDelete;
+        SerialQueue<VkPipelineLayout> mPipelineLayoutsToDelete;
+        SerialQueue<VkSampler> mSamplersToDelete;
     };
 
 }}  // namespace backend::vulkan
@@ -0,0 +1,83 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/FramebufferVk.h"
+
+#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/RenderPassCache.h"
+#include "backend/vulkan/TextureVk.h"
+#include "backend/vulkan/VulkanBackend.h"
+
+namespace backend { namespace vulkan {
+
+    Framebuffer::Framebuffer(FramebufferBuilder* builder) : FramebufferBase(builder) {
+        Device* device = ToBackend(GetDevice());
+        RenderPassBase* renderPass = GetRenderPass();
+
+        std::vector<VkImageView> attachments;
+        for (uint32_t i = 0; i < renderPass->GetAttachmentCount(); ++i) {
+            attachments.push_back(ToBackend(GetTextureView(i))->GetHandle());
+        }
+
+        // Framebuffers can be used with any compatible VkRenderPass so the one with the
+        // attachments in their optimal layout is used regardless of the actual layouts.
+        VkFramebufferCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.renderPass = device->GetRenderPassCache()->GetCompatibleRenderPass(renderPass);
+        createInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        createInfo.pAttachments = attachments.data();
+        createInfo.width = GetWidth();
+        createInfo.height = GetHeight();
+        createInfo.layers = 1;
+
+        if (device->fn.CreateFramebuffer(device->GetVkDevice(), &createInfo, nullptr,
+                                         &mHandle) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+    }
+
+    Framebuffer::~Framebuffer() {
+        if (mHandle != VK_NULL_HANDLE) {
+            ToBackend(GetDevice())->GetFencedDeleter()->DeleteWhenUnused(mHandle);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkFramebuffer Framebuffer::GetHandle() const {
+        return mHandle;
+    }
+
+    std::vector<VkClearValue> Framebuffer::GetClearValues() {
+        RenderPassBase* renderPass = GetRenderPass();
+
+        std::vector<VkClearValue> clearValues(renderPass->GetAttachmentCount());
+        for (uint32_t i = 0; i < renderPass->GetAttachmentCount(); ++i) {
+            if (TextureFormatHasDepthOrStencil(renderPass->GetAttachmentInfo(i).format)) {
+                ClearDepthStencil clear = GetClearDepthStencil(i);
+                clearValues[i].depthStencil.depth = clear.depth;
+                clearValues[i].depthStencil.stencil = clear.stencil;
+            } else {
+                ClearColor clear = GetClearColor(i);
+                for (uint32_t c = 0; c < 4; ++c) {
+                    clearValues[i].color.float32[c] = clear.color[c];
+                }
+            }
+        }
+
+        return clearValues;
+    }
+
+}}  // namespace backend::vulkan
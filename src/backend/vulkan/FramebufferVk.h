@@ -0,0 +1,42 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_FRAMEBUFFERVK_H_
+#define BACKEND_VULKAN_FRAMEBUFFERVK_H_
+
+#include "backend/Framebuffer.h"
+
+#include "backend/vulkan/vulkan_platform.h"
+
+#include <vector>
+
+namespace backend { namespace vulkan {
+
+    class Framebuffer : public FramebufferBase {
+      public:
+        Framebuffer(FramebufferBuilder* builder);
+        ~Framebuffer();
+
+        VkFramebuffer GetHandle() const;
+
+        // Returns the clear value of each attachment, indexed by attachment slot.
+        std::vector<VkClearValue> GetClearValues();
+
+      private:
+        VkFramebuffer mHandle = VK_NULL_HANDLE;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_FRAMEBUFFERVK_H_
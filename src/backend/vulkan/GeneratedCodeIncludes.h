@@ -12,7 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "backend/vulkan/BindGroupLayoutVk.h"
+#include "backend/vulkan/BindGroupVk.h"
+#include "backend/vulkan/BlendStateVk.h"
 #include "backend/vulkan/BufferVk.h"
 #include "backend/vulkan/CommandBufferVk.h"
+#include "backend/vulkan/ComputePipelineVk.h"
+#include "backend/vulkan/DepthStencilStateVk.h"
+#include "backend/vulkan/FramebufferVk.h"
+#include "backend/vulkan/InputStateVk.h"
+#include "backend/vulkan/PipelineLayoutVk.h"
+#include "backend/vulkan/RenderPipelineVk.h"
+#include "backend/vulkan/SamplerVk.h"
+#include "backend/vulkan/ShaderModuleVk.h"
 #include "backend/vulkan/TextureVk.h"
 #include "backend/vulkan/VulkanBackend.h"
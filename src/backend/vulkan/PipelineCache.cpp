@@ -0,0 +1,148 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/PipelineCache.h"
+
+#include "backend/vulkan/VulkanBackend.h"
+#include "common/Platform.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace backend { namespace vulkan {
+
+    namespace {
+        constexpr char kPipelineCacheEnvVar[] = "NXT_VULKAN_PIPELINE_CACHE";
+
+        // The layout of the header of version one of the pipeline cache data, see the
+        // documentation of vkGetPipelineCacheData.
+        struct PipelineCacheHeader {
+            uint32_t headerSize;
+            uint32_t headerVersion;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        };
+        static_assert(sizeof(PipelineCacheHeader) == 16 + VK_UUID_SIZE, "");
+    }  // anonymous namespace
+
+    PipelineCache::PipelineCache(Device* device) : mDevice(device) {
+        const char* path = getenv(kPipelineCacheEnvVar);
+        if (path != nullptr) {
+            mPath = path;
+        }
+
+        std::vector<char> initialData = LoadInitialData();
+
+        VkPipelineCacheCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.initialDataSize = initialData.size();
+        createInfo.pInitialData = initialData.data();
+
+        if (device->fn.CreatePipelineCache(device->GetVkDevice(), &createInfo, nullptr,
+                                           &mHandle) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+    }
+
+    PipelineCache::~PipelineCache() {
+        if (mHandle != VK_NULL_HANDLE) {
+            Save();
+            mDevice->fn.DestroyPipelineCache(mDevice->GetVkDevice(), mHandle, nullptr);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkPipelineCache PipelineCache::GetHandle() const {
+        return mHandle;
+    }
+
+    std::vector<char> PipelineCache::LoadInitialData() const {
+        if (mPath.empty()) {
+            return {};
+        }
+
+        std::ifstream file(mPath, std::ios::binary);
+        if (!file) {
+            return {};
+        }
+        std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+
+        // Drivers should reject data created by other devices or driver versions but some of
+        // them don't, so the header is checked before giving them the data.
+        PipelineCacheHeader header;
+        if (data.size() < sizeof(header)) {
+            return {};
+        }
+        memcpy(&header, data.data(), sizeof(header));
+
+        const VkPhysicalDeviceProperties& properties = mDevice->GetDeviceInfo().properties;
+        if (header.headerSize < sizeof(header) ||
+            header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+            memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            return {};
+        }
+
+        return data;
+    }
+
+    void PipelineCache::Save() const {
+        if (mPath.empty()) {
+            return;
+        }
+
+        size_t size = 0;
+        if (mDevice->fn.GetPipelineCacheData(mDevice->GetVkDevice(), mHandle, &size, nullptr) !=
+            VK_SUCCESS) {
+            return;
+        }
+        std::vector<char> data(size);
+        if (mDevice->fn.GetPipelineCacheData(mDevice->GetVkDevice(), mHandle, &size,
+                                             data.data()) != VK_SUCCESS) {
+            return;
+        }
+
+        // Write to a temporary file that replaces the cache file once complete so that other
+        // devices never load a partially written cache.
+        std::string tempPath = mPath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return;
+            }
+            file.write(data.data(), static_cast<std::streamsize>(size));
+            if (!file) {
+                file.close();
+                std::remove(tempPath.c_str());
+                return;
+            }
+        }
+
+#if NXT_PLATFORM_WINDOWS
+        // rename doesn't replace existing files on Windows.
+        std::remove(mPath.c_str());
+#endif
+        if (std::rename(tempPath.c_str(), mPath.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+        }
+    }
+
+}}  // namespace backend::vulkan
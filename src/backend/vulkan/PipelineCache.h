@@ -0,0 +1,52 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_PIPELINECACHE_H_
+#define BACKEND_VULKAN_PIPELINECACHE_H_
+
+#include "backend/vulkan/vulkan_platform.h"
+
+#include <string>
+#include <vector>
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    // Wraps the VkPipelineCache used to create all the pipelines of a device.
+    //
+    // When the NXT_VULKAN_PIPELINE_CACHE environment variable names a file, the content of the
+    // cache is loaded from it when the device is created and written back when it is destroyed,
+    // so that pipelines created in previous runs of the application are faster to create.
+    // Otherwise the cache only lives in memory for the lifetime of the device.
+    class PipelineCache {
+      public:
+        PipelineCache(Device* device);
+        ~PipelineCache();
+
+        VkPipelineCache GetHandle() const;
+
+      private:
+        // Returns the content of the cache file if it exists and was created by the same device.
+        std::vector<char> LoadInitialData() const;
+        void Save() const;
+
+        Device* mDevice = nullptr;
+        std::string mPath;
+        VkPipelineCache mHandle = VK_NULL_HANDLE;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_PIPELINECACHE_H_
@@ -0,0 +1,96 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/PipelineLayoutVk.h"
+
+#include "backend/vulkan/BindGroupLayoutVk.h"
+#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/VulkanBackend.h"
+
+namespace backend { namespace vulkan {
+
+    uint32_t GetPushConstantStageOffset(nxt::ShaderStage stage) {
+        switch (stage) {
+            case nxt::ShaderStage::Vertex:
+            case nxt::ShaderStage::Compute:
+                return 0;
+            case nxt::ShaderStage::Fragment:
+                return kPushConstantStageSize;
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    VkShaderStageFlags GetPushConstantRangeStages(nxt::ShaderStage stage) {
+        switch (stage) {
+            case nxt::ShaderStage::Vertex:
+            case nxt::ShaderStage::Compute:
+                return VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+            case nxt::ShaderStage::Fragment:
+                return VK_SHADER_STAGE_FRAGMENT_BIT;
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    PipelineLayout::PipelineLayout(Device* device, PipelineLayoutBuilder* builder)
+        : PipelineLayoutBase(builder), mDevice(device) {
+        // Vulkan set layouts are indexed by the set number so unused groups before the last used
+        // one are filled with an empty layout.
+        uint32_t numSetLayouts = 0;
+        std::array<VkDescriptorSetLayout, kMaxBindGroups> setLayouts;
+        for (uint32_t group = 0; group < kMaxBindGroups; ++group) {
+            if (mMask[group]) {
+                setLayouts[group] = ToBackend(mBindGroupLayouts[group])->GetHandle();
+                numSetLayouts = group + 1;
+            } else {
+                setLayouts[group] = device->GetEmptyDescriptorSetLayout();
+            }
+        }
+
+        std::array<VkPushConstantRange, 2> pushConstantRanges;
+        pushConstantRanges[0].stageFlags = GetPushConstantRangeStages(nxt::ShaderStage::Vertex);
+        pushConstantRanges[0].offset = GetPushConstantStageOffset(nxt::ShaderStage::Vertex);
+        pushConstantRanges[0].size = kPushConstantStageSize;
+        pushConstantRanges[1].stageFlags = GetPushConstantRangeStages(nxt::ShaderStage::Fragment);
+        pushConstantRanges[1].offset = GetPushConstantStageOffset(nxt::ShaderStage::Fragment);
+        pushConstantRanges[1].size = kPushConstantStageSize;
+
+        VkPipelineLayoutCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.setLayoutCount = numSetLayouts;
+        createInfo.pSetLayouts = setLayouts.data();
+        createInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+        createInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        if (device->fn.CreatePipelineLayout(device->GetVkDevice(), &createInfo, nullptr,
+                                            &mHandle) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+    }
+
+    PipelineLayout::~PipelineLayout() {
+        if (mHandle != VK_NULL_HANDLE) {
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(mHandle);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkPipelineLayout PipelineLayout::GetHandle() const {
+        return mHandle;
+    }
+
+}}  // namespace backend::vulkan
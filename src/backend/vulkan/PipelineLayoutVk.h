@@ -0,0 +1,51 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_PIPELINELAYOUTVK_H_
+#define BACKEND_VULKAN_PIPELINELAYOUTVK_H_
+
+#include "backend/PipelineLayout.h"
+
+#include "backend/vulkan/vulkan_platform.h"
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    // NXT has separate push constants for each stage, while Vulkan stages whose push constant
+    // ranges overlap see the same values. All pipeline layouts have a range for the vertex and
+    // compute stages followed by a range for the fragment stage, and fragment shader modules are
+    // patched to read their push constants from the second range. The compute stage can share the
+    // vertex range because they are never used in the same pass.
+    static constexpr uint32_t kPushConstantStageSize = kMaxPushConstants * sizeof(uint32_t);
+    static constexpr uint32_t kPushConstantTotalSize = 2 * kPushConstantStageSize;
+
+    uint32_t GetPushConstantStageOffset(nxt::ShaderStage stage);
+    VkShaderStageFlags GetPushConstantRangeStages(nxt::ShaderStage stage);
+
+    class PipelineLayout : public PipelineLayoutBase {
+      public:
+        PipelineLayout(Device* device, PipelineLayoutBuilder* builder);
+        ~PipelineLayout();
+
+        VkPipelineLayout GetHandle() const;
+
+      private:
+        Device* mDevice = nullptr;
+        VkPipelineLayout mHandle = VK_NULL_HANDLE;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_PIPELINELAYOUTVK_H_
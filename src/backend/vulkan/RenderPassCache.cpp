@@ -0,0 +1,338 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/RenderPassCache.h"
+
+#include "backend/vulkan/TextureVk.h"
+#include "backend/vulkan/VulkanBackend.h"
+#include "common/BitSetIterator.h"
+#include "common/HashUtils.h"
+
+#include <array>
+#include <functional>
+
+namespace backend { namespace vulkan {
+
+    namespace {
+        VkAttachmentLoadOp VulkanAttachmentLoadOp(nxt::LoadOp op) {
+            switch (op) {
+                case nxt::LoadOp::Load:
+                    return VK_ATTACHMENT_LOAD_OP_LOAD;
+                case nxt::LoadOp::Clear:
+                    return VK_ATTACHMENT_LOAD_OP_CLEAR;
+                default:
+                    UNREACHABLE();
+            }
+        }
+
+        VkAttachmentStoreOp VulkanAttachmentStoreOp(nxt::StoreOp op) {
+            switch (op) {
+                case nxt::StoreOp::Store:
+                    return VK_ATTACHMENT_STORE_OP_STORE;
+                case nxt::StoreOp::Discard:
+                    return VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                default:
+                    UNREACHABLE();
+            }
+        }
+    }  // anonymous namespace
+
+    // RenderPassCacheQuery
+
+    RenderPassCacheQuery::RenderPassCacheQuery(RenderPassBase* renderPass,
+                                               const std::vector<VkImageLayout>& layouts) {
+        ASSERT(layouts.size() == renderPass->GetAttachmentCount());
+
+        for (uint32_t i = 0; i < renderPass->GetAttachmentCount(); ++i) {
+            const auto& info = renderPass->GetAttachmentInfo(i);
+
+            Attachment attachment;
+            attachment.format = VulkanImageFormat(info.format);
+            attachment.samples = VulkanSampleCount(info.sampleCount);
+            if (TextureFormatHasDepthOrStencil(info.format)) {
+                attachment.loadOp = VulkanAttachmentLoadOp(info.depthLoadOp);
+                attachment.storeOp = VulkanAttachmentStoreOp(info.depthStoreOp);
+                attachment.stencilLoadOp = VulkanAttachmentLoadOp(info.stencilLoadOp);
+                attachment.stencilStoreOp = VulkanAttachmentStoreOp(info.stencilStoreOp);
+            } else {
+                attachment.loadOp = VulkanAttachmentLoadOp(info.colorLoadOp);
+                attachment.storeOp = VulkanAttachmentStoreOp(info.colorStoreOp);
+                attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+                attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            }
+            attachment.layout = layouts[i];
+            attachment.firstSubpass = info.firstSubpass;
+            attachment.lastSubpass = info.lastSubpass;
+
+            attachments.push_back(attachment);
+        }
+
+        for (uint32_t s = 0; s < renderPass->GetSubpassCount(); ++s) {
+            subpasses.push_back(renderPass->GetSubpassInfo(s));
+        }
+    }
+
+    // RenderPassCache
+
+    RenderPassCache::RenderPassCache(Device* device) : mDevice(device) {
+    }
+
+    RenderPassCache::~RenderPassCache() {
+        // The render passes are only destroyed with the device, after all commands completed.
+        for (auto it : mCache) {
+            mDevice->fn.DestroyRenderPass(mDevice->GetVkDevice(), it.second, nullptr);
+        }
+        mCache.clear();
+    }
+
+    VkRenderPass RenderPassCache::GetRenderPass(const RenderPassCacheQuery& query) {
+        auto it = mCache.find(query);
+        if (it != mCache.end()) {
+            return it->second;
+        }
+
+        VkRenderPass renderPass = CreateRenderPass(query);
+        mCache.emplace(query, renderPass);
+        return renderPass;
+    }
+
+    VkRenderPass RenderPassCache::GetCompatibleRenderPass(RenderPassBase* renderPass) {
+        std::vector<VkImageLayout> layouts;
+        for (uint32_t i = 0; i < renderPass->GetAttachmentCount(); ++i) {
+            nxt::TextureFormat format = renderPass->GetAttachmentInfo(i).format;
+            layouts.push_back(VulkanImageLayout(nxt::TextureUsageBit::OutputAttachment, format));
+        }
+
+        return GetRenderPass(RenderPassCacheQuery(renderPass, layouts));
+    }
+
+    VkRenderPass RenderPassCache::CreateRenderPass(const RenderPassCacheQuery& query) const {
+        std::vector<VkAttachmentDescription> attachmentDescs;
+        for (const auto& attachment : query.attachments) {
+            VkAttachmentDescription desc;
+            desc.flags = 0;
+            desc.format = attachment.format;
+            desc.samples = attachment.samples;
+            desc.loadOp = attachment.loadOp;
+            desc.storeOp = attachment.storeOp;
+            desc.stencilLoadOp = attachment.stencilLoadOp;
+            desc.stencilStoreOp = attachment.stencilStoreOp;
+            // Attachments stay in the layout they are in outside of the render pass, the usage
+            // transitions are done outside of it with pipeline barriers.
+            desc.initialLayout = attachment.layout;
+            desc.finalLayout = attachment.layout;
+            attachmentDescs.push_back(desc);
+        }
+
+        size_t subpassCount = query.subpasses.size();
+        std::vector<std::array<VkAttachmentReference, kMaxColorAttachments>> colorRefs(
+            subpassCount);
+        std::vector<std::array<VkAttachmentReference, kMaxColorAttachments>> resolveRefs(
+            subpassCount);
+        std::vector<VkAttachmentReference> depthStencilRefs(subpassCount);
+        std::vector<std::vector<uint32_t>> preserveAttachments(subpassCount);
+        std::vector<VkSubpassDescription> subpassDescs(subpassCount);
+
+        for (uint32_t s = 0; s < subpassCount; ++s) {
+            const auto& subpass = query.subpasses[s];
+            std::vector<bool> usedInSubpass(query.attachments.size(), false);
+
+            uint32_t colorAttachmentCount = 0;
+            for (uint32_t location = 0; location < kMaxColorAttachments; ++location) {
+                auto& ref = colorRefs[s][location];
+                if (subpass.colorAttachmentsSet[location]) {
+                    uint32_t slot = subpass.colorAttachments[location];
+                    ref.attachment = slot;
+                    ref.layout = query.attachments[slot].layout;
+                    usedInSubpass[slot] = true;
+                    colorAttachmentCount = location + 1;
+                } else {
+                    ref.attachment = VK_ATTACHMENT_UNUSED;
+                    ref.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                }
+            }
+
+            // Vulkan resolves color attachments to the resolve attachment at the same index.
+            VkAttachmentReference* resolveRef = nullptr;
+            if (subpass.resolveAttachmentsSet.any()) {
+                for (uint32_t location = 0; location < kMaxColorAttachments; ++location) {
+                    auto& ref = resolveRefs[s][location];
+                    if (subpass.resolveAttachmentsSet[location]) {
+                        uint32_t slot = subpass.resolveAttachments[location];
+                        ref.attachment = slot;
+                        ref.layout = query.attachments[slot].layout;
+                        usedInSubpass[slot] = true;
+                    } else {
+                        ref.attachment = VK_ATTACHMENT_UNUSED;
+                        ref.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    }
+                }
+                resolveRef = resolveRefs[s].data();
+            }
+
+            VkAttachmentReference* depthStencilRef = nullptr;
+            if (subpass.depthStencilAttachmentSet) {
+                uint32_t slot = subpass.depthStencilAttachment;
+                depthStencilRefs[s].attachment = slot;
+                depthStencilRefs[s].layout = query.attachments[slot].layout;
+                depthStencilRef = &depthStencilRefs[s];
+                usedInSubpass[slot] = true;
+            }
+
+            // Attachments used before and after this subpass must be preserved explicitly.
+            for (uint32_t slot = 0; slot < query.attachments.size(); ++slot) {
+                const auto& attachment = query.attachments[slot];
+                if (!usedInSubpass[slot] && attachment.firstSubpass != UINT32_MAX &&
+                    attachment.firstSubpass < s && s < attachment.lastSubpass) {
+                    preserveAttachments[s].push_back(slot);
+                }
+            }
+
+            auto& desc = subpassDescs[s];
+            desc.flags = 0;
+            desc.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            desc.inputAttachmentCount = 0;
+            desc.pInputAttachments = nullptr;
+            desc.colorAttachmentCount = colorAttachmentCount;
+            desc.pColorAttachments = colorRefs[s].data();
+            desc.pResolveAttachments = resolveRef;
+            desc.pDepthStencilAttachment = depthStencilRef;
+            desc.preserveAttachmentCount = static_cast<uint32_t>(preserveAttachments[s].size());
+            desc.pPreserveAttachments = preserveAttachments[s].data();
+        }
+
+        // Each subpass might read or write the attachments written by the previous one.
+        std::vector<VkSubpassDependency> dependencies;
+        for (uint32_t s = 1; s < subpassCount; ++s) {
+            VkSubpassDependency dependency;
+            dependency.srcSubpass = s - 1;
+            dependency.dstSubpass = s;
+            dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                      VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+            dependencies.push_back(dependency);
+        }
+
+        VkRenderPassCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.attachmentCount = static_cast<uint32_t>(attachmentDescs.size());
+        createInfo.pAttachments = attachmentDescs.data();
+        createInfo.subpassCount = static_cast<uint32_t>(subpassDescs.size());
+        createInfo.pSubpasses = subpassDescs.data();
+        createInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+        createInfo.pDependencies = dependencies.data();
+
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        if (mDevice->fn.CreateRenderPass(mDevice->GetVkDevice(), &createInfo, nullptr,
+                                         &renderPass) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+        return renderPass;
+    }
+
+    size_t RenderPassCache::CacheFuncs::operator()(const RenderPassCacheQuery& query) const {
+        size_t hash = std::hash<size_t>()(query.attachments.size());
+
+        for (const auto& attachment : query.attachments) {
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.format));
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.samples));
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.loadOp));
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.storeOp));
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.stencilLoadOp));
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.stencilStoreOp));
+            CombineHashes(&hash, std::hash<uint32_t>()(attachment.layout));
+        }
+
+        for (const auto& subpass : query.subpasses) {
+            CombineHashes(&hash, std::hash<unsigned long long>()(
+                                     subpass.colorAttachmentsSet.to_ullong()));
+            for (uint32_t location : IterateBitSet(subpass.colorAttachmentsSet)) {
+                CombineHashes(&hash, std::hash<uint32_t>()(subpass.colorAttachments[location]));
+            }
+            CombineHashes(&hash, std::hash<unsigned long long>()(
+                                     subpass.resolveAttachmentsSet.to_ullong()));
+            for (uint32_t location : IterateBitSet(subpass.resolveAttachmentsSet)) {
+                CombineHashes(&hash, std::hash<uint32_t>()(subpass.resolveAttachments[location]));
+            }
+            if (subpass.depthStencilAttachmentSet) {
+                CombineHashes(&hash, std::hash<uint32_t>()(subpass.depthStencilAttachment));
+            }
+        }
+
+        return hash;
+    }
+
+    bool RenderPassCache::CacheFuncs::operator()(const RenderPassCacheQuery& a,
+                                                 const RenderPassCacheQuery& b) const {
+        if (a.attachments.size() != b.attachments.size() ||
+            a.subpasses.size() != b.subpasses.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.attachments.size(); ++i) {
+            const auto& attachmentA = a.attachments[i];
+            const auto& attachmentB = b.attachments[i];
+            // The first and last subpasses are derived from the subpasses, they don't need to be
+            // compared.
+            if (attachmentA.format != attachmentB.format ||
+                attachmentA.samples != attachmentB.samples ||
+                attachmentA.loadOp != attachmentB.loadOp ||
+                attachmentA.storeOp != attachmentB.storeOp ||
+                attachmentA.stencilLoadOp != attachmentB.stencilLoadOp ||
+                attachmentA.stencilStoreOp != attachmentB.stencilStoreOp ||
+                attachmentA.layout != attachmentB.layout) {
+                return false;
+            }
+        }
+
+        for (size_t s = 0; s < a.subpasses.size(); ++s) {
+            const auto& subpassA = a.subpasses[s];
+            const auto& subpassB = b.subpasses[s];
+            if (subpassA.colorAttachmentsSet != subpassB.colorAttachmentsSet ||
+                subpassA.resolveAttachmentsSet != subpassB.resolveAttachmentsSet ||
+                subpassA.depthStencilAttachmentSet != subpassB.depthStencilAttachmentSet) {
+                return false;
+            }
+            for (uint32_t location : IterateBitSet(subpassA.colorAttachmentsSet)) {
+                if (subpassA.colorAttachments[location] != subpassB.colorAttachments[location]) {
+                    return false;
+                }
+            }
+            for (uint32_t location : IterateBitSet(subpassA.resolveAttachmentsSet)) {
+                if (subpassA.resolveAttachments[location] !=
+                    subpassB.resolveAttachments[location]) {
+                    return false;
+                }
+            }
+            if (subpassA.depthStencilAttachmentSet &&
+                subpassA.depthStencilAttachment != subpassB.depthStencilAttachment) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}}  // namespace backend::vulkan
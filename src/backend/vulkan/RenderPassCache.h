@@ -0,0 +1,82 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_RENDERPASSCACHE_H_
+#define BACKEND_VULKAN_RENDERPASSCACHE_H_
+
+#include "backend/RenderPass.h"
+
+#include "backend/vulkan/vulkan_platform.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    // Everything needed to create a VkRenderPass. NXT render passes don't know the layout their
+    // attachments are in, because it depends on the usage of the textures used as attachments,
+    // so the layouts are part of the query and a single NXT render pass can correspond to
+    // multiple VkRenderPasses.
+    struct RenderPassCacheQuery {
+        RenderPassCacheQuery(RenderPassBase* renderPass, const std::vector<VkImageLayout>& layouts);
+
+        struct Attachment {
+            VkFormat format;
+            VkSampleCountFlagBits samples;
+            VkAttachmentLoadOp loadOp;
+            VkAttachmentStoreOp storeOp;
+            VkAttachmentLoadOp stencilLoadOp;
+            VkAttachmentStoreOp stencilStoreOp;
+            VkImageLayout layout;
+            uint32_t firstSubpass;
+            uint32_t lastSubpass;
+        };
+
+        std::vector<Attachment> attachments;
+        std::vector<RenderPassBase::SubpassInfo> subpasses;
+    };
+
+    // Caches the VkRenderPasses so that they are created once per device for a given query. This
+    // also makes the pipelines and framebuffers of different but compatible NXT render passes
+    // share the same VkRenderPass.
+    class RenderPassCache {
+      public:
+        RenderPassCache(Device* device);
+        ~RenderPassCache();
+
+        VkRenderPass GetRenderPass(const RenderPassCacheQuery& query);
+
+        // Returns a VkRenderPass compatible with `renderPass` with all the attachments in their
+        // optimal layout, for use when creating pipelines and framebuffers.
+        VkRenderPass GetCompatibleRenderPass(RenderPassBase* renderPass);
+
+      private:
+        VkRenderPass CreateRenderPass(const RenderPassCacheQuery& query) const;
+
+        struct CacheFuncs {
+            size_t operator()(const RenderPassCacheQuery& query) const;
+            bool operator()(const RenderPassCacheQuery& a, const RenderPassCacheQuery& b) const;
+        };
+        using Cache =
+            std::unordered_map<RenderPassCacheQuery, VkRenderPass, CacheFuncs, CacheFuncs>;
+
+        Device* mDevice = nullptr;
+        Cache mCache;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_RENDERPASSCACHE_H_
@@ -0,0 +1,215 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/RenderPipelineVk.h"
+
+#include "backend/vulkan/BlendStateVk.h"
+#include "backend/vulkan/DepthStencilStateVk.h"
+#include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/InputStateVk.h"
+#include "backend/vulkan/PipelineCache.h"
+#include "backend/vulkan/PipelineLayoutVk.h"
+#include "backend/vulkan/RenderPassCache.h"
+#include "backend/vulkan/ShaderModuleVk.h"
+#include "backend/vulkan/TextureVk.h"
+#include "backend/vulkan/VulkanBackend.h"
+
+namespace backend { namespace vulkan {
+
+    namespace {
+        VkPrimitiveTopology VulkanPrimitiveTopology(nxt::PrimitiveTopology topology) {
+            switch (topology) {
+                case nxt::PrimitiveTopology::PointList:
+                    return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+                case nxt::PrimitiveTopology::LineList:
+                    return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+                case nxt::PrimitiveTopology::LineStrip:
+                    return VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+                case nxt::PrimitiveTopology::TriangleList:
+                    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+                case nxt::PrimitiveTopology::TriangleStrip:
+                    return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+                default:
+                    UNREACHABLE();
+            }
+        }
+    }  // anonymous namespace
+
+    RenderPipeline::RenderPipeline(RenderPipelineBuilder* builder)
+        : RenderPipelineBase(builder), mDevice(ToBackend(builder->GetDevice())) {
+        std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages;
+        const nxt::ShaderStage stages[] = {nxt::ShaderStage::Vertex, nxt::ShaderStage::Fragment};
+        const VkShaderStageFlagBits vkStages[] = {VK_SHADER_STAGE_VERTEX_BIT,
+                                                  VK_SHADER_STAGE_FRAGMENT_BIT};
+        const SpecializationInfo specializations[] = {
+            {builder->GetStageInfo(nxt::ShaderStage::Vertex).specialization},
+            {builder->GetStageInfo(nxt::ShaderStage::Fragment).specialization},
+        };
+        for (uint32_t i = 0; i < shaderStages.size(); ++i) {
+            auto& stageInfo = builder->GetStageInfo(stages[i]);
+            shaderStages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            shaderStages[i].pNext = nullptr;
+            shaderStages[i].flags = 0;
+            shaderStages[i].stage = vkStages[i];
+            shaderStages[i].module = ToBackend(stageInfo.module)->GetHandle(stages[i]);
+            shaderStages[i].pName = stageInfo.entryPoint.c_str();
+            shaderStages[i].pSpecializationInfo = specializations[i].GetVkSpecializationInfo();
+        }
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.pNext = nullptr;
+        inputAssembly.flags = 0;
+        inputAssembly.topology = VulkanPrimitiveTopology(GetPrimitiveTopology());
+        // NXT always uses primitive restart for strips, Vulkan only allows it for them.
+        inputAssembly.primitiveRestartEnable =
+            (GetPrimitiveTopology() == nxt::PrimitiveTopology::LineStrip ||
+             GetPrimitiveTopology() == nxt::PrimitiveTopology::TriangleStrip)
+                ? VK_TRUE
+                : VK_FALSE;
+
+        // The viewport and scissor are dynamic state, only their count is used.
+        VkPipelineViewportStateCreateInfo viewport;
+        viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport.pNext = nullptr;
+        viewport.flags = 0;
+        viewport.viewportCount = 1;
+        viewport.pViewports = nullptr;
+        viewport.scissorCount = 1;
+        viewport.pScissors = nullptr;
+
+        VkPipelineRasterizationStateCreateInfo rasterization;
+        rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization.pNext = nullptr;
+        rasterization.flags = 0;
+        rasterization.depthClampEnable = VK_FALSE;
+        rasterization.rasterizerDiscardEnable = VK_FALSE;
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = VK_CULL_MODE_NONE;
+        rasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterization.depthBiasEnable = VK_FALSE;
+        rasterization.depthBiasConstantFactor = 0.0f;
+        rasterization.depthBiasClamp = 0.0f;
+        rasterization.depthBiasSlopeFactor = 0.0f;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample;
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.pNext = nullptr;
+        multisample.flags = 0;
+        multisample.rasterizationSamples = VulkanSampleCount(GetSampleCount());
+        multisample.sampleShadingEnable = VK_FALSE;
+        multisample.minSampleShading = 0.0f;
+        multisample.pSampleMask = nullptr;
+        multisample.alphaToCoverageEnable = VK_FALSE;
+        multisample.alphaToOneEnable = VK_FALSE;
+
+        // Vulkan needs a blend state for each location up to the last one used by the subpass,
+        // locations without an attachment get a state that doesn't write anything.
+        const auto& subpassInfo = GetRenderPass()->GetSubpassInfo(GetSubPass());
+        std::array<VkPipelineColorBlendAttachmentState, kMaxColorAttachments> colorBlendAttachments;
+        uint32_t colorAttachmentCount = 0;
+        for (uint32_t location = 0; location < kMaxColorAttachments; ++location) {
+            if (subpassInfo.colorAttachmentsSet[location]) {
+                colorBlendAttachments[location] = ToBackend(GetBlendState(location))->GetState();
+                colorAttachmentCount = location + 1;
+            } else {
+                colorBlendAttachments[location] = {};
+                colorBlendAttachments[location].blendEnable = VK_FALSE;
+                colorBlendAttachments[location].colorWriteMask = 0;
+            }
+        }
+
+        VkPipelineColorBlendStateCreateInfo colorBlend;
+        colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlend.pNext = nullptr;
+        colorBlend.flags = 0;
+        colorBlend.logicOpEnable = VK_FALSE;
+        colorBlend.logicOp = VK_LOGIC_OP_CLEAR;
+        colorBlend.attachmentCount = colorAttachmentCount;
+        colorBlend.pAttachments = colorBlendAttachments.data();
+        // The blend constants are dynamic
+        colorBlend.blendConstants[0] = 0.0f;
+        colorBlend.blendConstants[1] = 0.0f;
+        colorBlend.blendConstants[2] = 0.0f;
+        colorBlend.blendConstants[3] = 0.0f;
+
+        // The viewport, scissor and the parts of the pipeline set via commands are dynamic.
+        VkDynamicState dynamicStates[] = {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR,
+            VK_DYNAMIC_STATE_BLEND_CONSTANTS,
+            VK_DYNAMIC_STATE_STENCIL_REFERENCE,
+        };
+        VkPipelineDynamicStateCreateInfo dynamic;
+        dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic.pNext = nullptr;
+        dynamic.flags = 0;
+        dynamic.dynamicStateCount = sizeof(dynamicStates) / sizeof(dynamicStates[0]);
+        dynamic.pDynamicStates = dynamicStates;
+
+        // Pipelines can be used with any compatible VkRenderPass so the one with the attachments
+        // in their optimal layout is used regardless of the layouts when the pipeline is used.
+        VkGraphicsPipelineCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+        createInfo.pStages = shaderStages.data();
+        createInfo.pVertexInputState = ToBackend(GetInputState())->GetCreateInfo();
+        createInfo.pInputAssemblyState = &inputAssembly;
+        createInfo.pTessellationState = nullptr;
+        createInfo.pViewportState = &viewport;
+        createInfo.pRasterizationState = &rasterization;
+        createInfo.pMultisampleState = &multisample;
+        createInfo.pDepthStencilState = ToBackend(GetDepthStencilState())->GetCreateInfo();
+        createInfo.pColorBlendState = &colorBlend;
+        createInfo.pDynamicState = &dynamic;
+        createInfo.layout = ToBackend(GetLayout())->GetHandle();
+        createInfo.renderPass = mDevice->GetRenderPassCache()->GetCompatibleRenderPass(
+            GetRenderPass());
+        createInfo.subpass = GetSubPass();
+        createInfo.basePipelineHandle = VK_NULL_HANDLE;
+        createInfo.basePipelineIndex = -1;
+
+        if (mDevice->fn.CreateGraphicsPipelines(mDevice->GetVkDevice(),
+                                                mDevice->GetPipelineCache()->GetHandle(), 1,
+                                                &createInfo, nullptr, &mHandle) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+    }
+
+    RenderPipeline::~RenderPipeline() {
+        if (mHandle != VK_NULL_HANDLE) {
+            mDevice->GetFencedDeleter()->DeleteWhenUnused(mHandle);
+            mHandle = VK_NULL_HANDLE;
+        }
+    }
+
+    VkPipeline RenderPipeline::GetHandle() const {
+        return mHandle;
+    }
+
+    VkIndexType RenderPipeline::GetVkIndexType() const {
+        switch (GetIndexFormat()) {
+            case nxt::IndexFormat::Uint16:
+                return VK_INDEX_TYPE_UINT16;
+            case nxt::IndexFormat::Uint32:
+                return VK_INDEX_TYPE_UINT32;
+            default:
+                UNREACHABLE();
+        }
+    }
+
+}}  // namespace backend::vulkan
@@ -0,0 +1,161 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/vulkan/ShaderModuleVk.h"
+
+#include "backend/vulkan/PipelineLayoutVk.h"
+#include "backend/vulkan/VulkanBackend.h"
+
+#include <map>
+#include <set>
+
+namespace backend { namespace vulkan {
+
+    namespace {
+        constexpr size_t kSpirvHeaderSize = 5;
+        constexpr uint32_t kSpirvOpTypePointer = 32;
+        constexpr uint32_t kSpirvOpVariable = 59;
+        constexpr uint32_t kSpirvOpMemberDecorate = 72;
+        constexpr uint32_t kSpirvStorageClassPushConstant = 9;
+        constexpr uint32_t kSpirvDecorationOffset = 35;
+
+        // Moves the push constant block of the module by `offset` bytes by patching the Offset
+        // decorations of its members. Decorations come before the types in SPIR-V so the block
+        // types are found in a first pass over the instructions.
+        void OffsetPushConstantBlock(std::vector<uint32_t>* spirv, uint32_t offset) {
+            std::vector<uint32_t>& code = *spirv;
+
+            std::map<uint32_t, uint32_t> pushConstantPointees;
+            std::set<uint32_t> blockTypes;
+            for (size_t i = kSpirvHeaderSize; i < code.size();) {
+                uint32_t wordCount = code[i] >> 16;
+                uint32_t opcode = code[i] & 0xFFFF;
+                if (wordCount == 0 || i + wordCount > code.size()) {
+                    // The SPIR-V was validated by the frontend, this should never happen.
+                    ASSERT(false);
+                    return;
+                }
+
+                // OpTypePointer <result id> <storage class> <pointee type>
+                if (opcode == kSpirvOpTypePointer && wordCount == 4 &&
+                    code[i + 2] == kSpirvStorageClassPushConstant) {
+                    pushConstantPointees[code[i + 1]] = code[i + 3];
+                }
+                // OpVariable <result type> <result id> <storage class> [initializer]
+                if (opcode == kSpirvOpVariable && wordCount >= 4 &&
+                    code[i + 3] == kSpirvStorageClassPushConstant) {
+                    auto pointee = pushConstantPointees.find(code[i + 1]);
+                    if (pointee != pushConstantPointees.end()) {
+                        blockTypes.insert(pointee->second);
+                    }
+                }
+
+                i += wordCount;
+            }
+
+            if (blockTypes.empty()) {
+                return;
+            }
+
+            for (size_t i = kSpirvHeaderSize; i < code.size();) {
+                uint32_t wordCount = code[i] >> 16;
+                uint32_t opcode = code[i] & 0xFFFF;
+
+                // OpMemberDecorate <struct type> <member> <decoration> <literals...>
+                if (opcode == kSpirvOpMemberDecorate && wordCount == 5 &&
+                    code[i + 3] == kSpirvDecorationOffset && blockTypes.count(code[i + 1]) != 0) {
+                    code[i + 4] += offset;
+                }
+
+                i += wordCount;
+            }
+        }
+    }  // anonymous namespace
+
+    // SpecializationInfo
+
+    SpecializationInfo::SpecializationInfo(const SpecializationValues& specialization) {
+        // All specialization constants are 32-bit scalars, booleans included since they are given
+        // as VkBool32.
+        for (const auto& it : specialization) {
+            VkSpecializationMapEntry entry;
+            entry.constantID = it.first;
+            entry.offset = static_cast<uint32_t>(mData.size() * sizeof(uint32_t));
+            entry.size = sizeof(uint32_t);
+
+            mEntries.push_back(entry);
+            mData.push_back(it.second);
+        }
+
+        mInfo.mapEntryCount = static_cast<uint32_t>(mEntries.size());
+        mInfo.pMapEntries = mEntries.data();
+        mInfo.dataSize = mData.size() * sizeof(uint32_t);
+        mInfo.pData = mData.data();
+    }
+
+    const VkSpecializationInfo* SpecializationInfo::GetVkSpecializationInfo() const {
+        if (mEntries.empty()) {
+            return nullptr;
+        }
+        return &mInfo;
+    }
+
+    // ShaderModule
+
+    ShaderModule::ShaderModule(Device* device, ShaderModuleBuilder* builder)
+        : ShaderModuleBase(builder), mDevice(device) {
+    }
+
+    ShaderModule::~ShaderModule() {
+        // Shader modules are only used to create pipelines so they can be destroyed immediately.
+        for (const auto& it : mHandles) {
+            mDevice->fn.DestroyShaderModule(mDevice->GetVkDevice(), it.second, nullptr);
+        }
+        mHandles.clear();
+    }
+
+    VkShaderModule ShaderModule::GetHandle(nxt::ShaderStage stage) {
+        // Each stage has its own range of push constants in the pipeline layouts, see
+        // PipelineLayoutVk.h. The entry points of the module can be used in different stages so
+        // there is a VkShaderModule for each push constant offset used, created on first use.
+        uint32_t pushConstantOffset = GetPushConstantStageOffset(stage);
+
+        auto it = mHandles.find(pushConstantOffset);
+        if (it != mHandles.end()) {
+            return it->second;
+        }
+
+        std::vector<uint32_t> spirv = GetSpirv();
+        if (pushConstantOffset != 0) {
+            OffsetPushConstantBlock(&spirv, pushConstantOffset);
+        }
+
+        VkShaderModuleCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.codeSize = spirv.size() * sizeof(uint32_t);
+        createInfo.pCode = spirv.data();
+
+        VkShaderModule handle = VK_NULL_HANDLE;
+        if (mDevice->fn.CreateShaderModule(mDevice->GetVkDevice(), &createInfo, nullptr,
+                                           &handle) != VK_SUCCESS) {
+            ASSERT(false);
+        }
+
+        mHandles[pushConstantOffset] = handle;
+        return handle;
+    }
+
+}}  // namespace backend::vulkan
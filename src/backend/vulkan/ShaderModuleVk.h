@@ -0,0 +1,61 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BACKEND_VULKAN_SHADERMODULEVK_H_
+#define BACKEND_VULKAN_SHADERMODULEVK_H_
+
+#include "backend/ShaderModule.h"
+
+#include "backend/vulkan/vulkan_platform.h"
+
+#include <map>
+#include <vector>
+
+namespace backend { namespace vulkan {
+
+    class Device;
+
+    // The Vulkan version of the specialization of a pipeline stage. The VkSpecializationInfo points
+    // to storage in this object so it must outlive the creation of the pipeline.
+    class SpecializationInfo {
+      public:
+        SpecializationInfo(const SpecializationValues& specialization);
+        SpecializationInfo(const SpecializationInfo&) = delete;
+        SpecializationInfo& operator=(const SpecializationInfo&) = delete;
+
+        // Returns nullptr when no specialization constant is set.
+        const VkSpecializationInfo* GetVkSpecializationInfo() const;
+
+      private:
+        std::vector<VkSpecializationMapEntry> mEntries;
+        std::vector<uint32_t> mData;
+        VkSpecializationInfo mInfo;
+    };
+
+    class ShaderModule : public ShaderModuleBase {
+      public:
+        ShaderModule(Device* device, ShaderModuleBuilder* builder);
+        ~ShaderModule();
+
+        VkShaderModule GetHandle(nxt::ShaderStage stage);
+
+      private:
+        Device* mDevice = nullptr;
+        // The VkShaderModules indexed by the offset of their push constant block.
+        std::map<uint32_t, VkShaderModule> mHandles;
+    };
+
+}}  // namespace backend::vulkan
+
+#endif  // BACKEND_VULKAN_SHADERMODULEVK_H_
@@ -14,9 +14,12 @@
 
 #include "backend/vulkan/TextureVk.h"
 
+#include "backend/vulkan/BufferUploader.h"
 #include "backend/vulkan/FencedDeleter.h"
 #include "backend/vulkan/VulkanBackend.h"
 
+#include <algorithm>
+
 namespace backend { namespace vulkan {
 
     namespace {
@@ -26,23 +29,24 @@ namespace backend { namespace vulkan {
         VkImageType VulkanImageType(nxt::TextureDimension dimension) {
             switch (dimension) {
                 case nxt::TextureDimension::e2D:
+                case nxt::TextureDimension::e2DArray:
                     return VK_IMAGE_TYPE_2D;
+                case nxt::TextureDimension::e3D:
+                    return VK_IMAGE_TYPE_3D;
                 default:
                     UNREACHABLE();
             }
         }
 
-        // Converts NXT texture format to Vulkan formats.
-        VkFormat VulkanImageFormat(nxt::TextureFormat format) {
-            switch (format) {
-                case nxt::TextureFormat::R8G8B8A8Unorm:
-                    return VK_FORMAT_R8G8B8A8_UNORM;
-                case nxt::TextureFormat::R8G8B8A8Uint:
-                    return VK_FORMAT_R8G8B8A8_UINT;
-                case nxt::TextureFormat::B8G8R8A8Unorm:
-                    return VK_FORMAT_B8G8R8A8_UNORM;
-                case nxt::TextureFormat::D32FloatS8Uint:
-                    return VK_FORMAT_D32_SFLOAT_S8_UINT;
+        // Converts an NXT texture dimension to a Vulkan image view type.
+        VkImageViewType VulkanImageViewType(nxt::TextureDimension dimension) {
+            switch (dimension) {
+                case nxt::TextureDimension::e2D:
+                    return VK_IMAGE_VIEW_TYPE_2D;
+                case nxt::TextureDimension::e2DArray:
+                    return VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+                case nxt::TextureDimension::e3D:
+                    return VK_IMAGE_VIEW_TYPE_3D;
                 default:
                     UNREACHABLE();
             }
@@ -107,44 +111,6 @@ namespace backend { namespace vulkan {
             return flags;
         }
 
-        // Chooses which Vulkan image layout should be used for the given NXT usage
-        VkImageLayout VulkanImageLayout(nxt::TextureUsageBit usage, nxt::TextureFormat format) {
-            if (usage == nxt::TextureUsageBit::None) {
-                return VK_IMAGE_LAYOUT_UNDEFINED;
-            }
-
-            if (!nxt::HasZeroOrOneBits(usage)) {
-                return VK_IMAGE_LAYOUT_GENERAL;
-            }
-
-            // Usage has a single bit so we can switch on its value directly.
-            switch (usage) {
-                case nxt::TextureUsageBit::TransferDst:
-                    return VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                case nxt::TextureUsageBit::Sampled:
-                    return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                // Vulkan texture copy functions require the image to be in _one_  known layout.
-                // Depending on whether parts of the texture have been transitioned to only
-                // TransferSrc or a combination with something else, the texture could be in a
-                // combination of GENERAL and TRANSFER_SRC_OPTIMAL. This would be a problem, so we
-                // make TransferSrc use GENERAL.
-                case nxt::TextureUsageBit::TransferSrc:
-                // Writable storage textures must use general. If we could know the texture is read
-                // only we could use SHADER_READ_ONLY_OPTIMAL
-                case nxt::TextureUsageBit::Storage:
-                case nxt::TextureUsageBit::Present:
-                    return VK_IMAGE_LAYOUT_GENERAL;
-                case nxt::TextureUsageBit::OutputAttachment:
-                    if (TextureFormatHasDepthOrStencil(format)) {
-                        return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-                    } else {
-                        return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-                    }
-                default:
-                    UNREACHABLE();
-            }
-        }
-
         // Computes which Vulkan pipeline stage can access a texture in the given NXT usage
         VkPipelineStageFlags VulkanPipelineStage(nxt::TextureUsageBit usage,
                                                  nxt::TextureFormat format) {
@@ -200,6 +166,91 @@ namespace backend { namespace vulkan {
 
     }  // namespace
 
+    // Converts NXT texture format to Vulkan formats.
+    VkFormat VulkanImageFormat(nxt::TextureFormat format) {
+        switch (format) {
+            case nxt::TextureFormat::R8G8B8A8Unorm:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+            case nxt::TextureFormat::R8G8B8A8Uint:
+                return VK_FORMAT_R8G8B8A8_UINT;
+            case nxt::TextureFormat::B8G8R8A8Unorm:
+                return VK_FORMAT_B8G8R8A8_UNORM;
+            case nxt::TextureFormat::D32FloatS8Uint:
+                return VK_FORMAT_D32_SFLOAT_S8_UINT;
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+                return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+                return VK_FORMAT_BC2_UNORM_BLOCK;
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+                return VK_FORMAT_BC3_UNORM_BLOCK;
+            case nxt::TextureFormat::Bc4RUnorm:
+                return VK_FORMAT_BC4_UNORM_BLOCK;
+            case nxt::TextureFormat::Bc5RGUnorm:
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+                return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+                return VK_FORMAT_BC7_UNORM_BLOCK;
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+                return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+                return VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK;
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    // Chooses which Vulkan image layout should be used for the given NXT usage
+    VkImageLayout VulkanImageLayout(nxt::TextureUsageBit usage, nxt::TextureFormat format) {
+        if (usage == nxt::TextureUsageBit::None) {
+            return VK_IMAGE_LAYOUT_UNDEFINED;
+        }
+
+        if (!nxt::HasZeroOrOneBits(usage)) {
+            return VK_IMAGE_LAYOUT_GENERAL;
+        }
+
+        // Usage has a single bit so we can switch on its value directly.
+        switch (usage) {
+            case nxt::TextureUsageBit::TransferDst:
+                return VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            case nxt::TextureUsageBit::Sampled:
+                return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            // Vulkan texture copy functions require the image to be in _one_  known layout.
+            // Depending on whether parts of the texture have been transitioned to only
+            // TransferSrc or a combination with something else, the texture could be in a
+            // combination of GENERAL and TRANSFER_SRC_OPTIMAL. This would be a problem, so we
+            // make TransferSrc use GENERAL.
+            case nxt::TextureUsageBit::TransferSrc:
+            // Writable storage textures must use general. If we could know the texture is read
+            // only we could use SHADER_READ_ONLY_OPTIMAL
+            case nxt::TextureUsageBit::Storage:
+            case nxt::TextureUsageBit::Present:
+                return VK_IMAGE_LAYOUT_GENERAL;
+            case nxt::TextureUsageBit::OutputAttachment:
+                if (TextureFormatHasDepthOrStencil(format)) {
+                    return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+                } else {
+                    return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                }
+            default:
+                UNREACHABLE();
+        }
+    }
+
+    VkSampleCountFlagBits VulkanSampleCount(uint32_t sampleCount) {
+        switch (sampleCount) {
+            case 1:
+                return VK_SAMPLE_COUNT_1_BIT;
+            case 4:
+                return VK_SAMPLE_COUNT_4_BIT;
+            default:
+                UNREACHABLE();
+        }
+    }
+
     Texture::Texture(TextureBuilder* builder) : TextureBase(builder) {
         Device* device = ToBackend(GetDevice());
 
@@ -212,10 +263,10 @@ namespace backend { namespace vulkan {
         createInfo.flags = 0;
         createInfo.imageType = VulkanImageType(GetDimension());
         createInfo.format = VulkanImageFormat(GetFormat());
-        createInfo.extent = VkExtent3D{GetWidth(), GetHeight(), GetDepth()};
+        createInfo.extent = VkExtent3D{GetWidth(), GetHeight(), GetExtentDepth()};
         createInfo.mipLevels = GetNumMipLevels();
-        createInfo.arrayLayers = 1;
-        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        createInfo.arrayLayers = GetArrayLayers();
+        createInfo.samples = VulkanSampleCount(GetSampleCount());
         createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
         createInfo.usage = VulkanImageUsage(GetAllowedUsage(), GetFormat());
         createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -267,6 +318,8 @@ namespace backend { namespace vulkan {
     // Helper function to add a texture barrier to a command buffer. This is inefficient because we
     // should be coalescing barriers as much as possible.
     void Texture::RecordBarrier(VkCommandBuffer commands,
+                                uint32_t baseLevel,
+                                uint32_t levelCount,
                                 nxt::TextureUsageBit currentUsage,
                                 nxt::TextureUsageBit targetUsage) const {
         nxt::TextureFormat format = GetFormat();
@@ -283,23 +336,199 @@ namespace backend { namespace vulkan {
         barrier.srcQueueFamilyIndex = 0;
         barrier.dstQueueFamilyIndex = 0;
         barrier.image = mHandle;
-        // This transitions the whole resource but assumes it is a 2D texture
-        ASSERT(GetDimension() == nxt::TextureDimension::e2D);
         barrier.subresourceRange.aspectMask = VulkanAspectMask(format);
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = GetNumMipLevels();
+        barrier.subresourceRange.baseMipLevel = baseLevel;
+        barrier.subresourceRange.levelCount = levelCount;
         barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
+        barrier.subresourceRange.layerCount = GetArrayLayers();
 
         ToBackend(GetDevice())
             ->fn.CmdPipelineBarrier(commands, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, 1,
                                     &barrier);
     }
 
-    void Texture::TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+    void Texture::TransitionLevelsNow(VkCommandBuffer commands,
+                                      uint32_t baseLevel,
+                                      uint32_t levelCount,
+                                      nxt::TextureUsageBit targetUsage,
+                                      bool skipSameUsage) {
+        for (const auto& range : GetLevelUsageRanges(baseLevel, levelCount)) {
+            if (skipSameUsage && range.usage == targetUsage) {
+                continue;
+            }
+            RecordBarrier(commands, range.baseLevel, range.levelCount, range.usage, targetUsage);
+        }
+        UpdateLevelsUsageInternal(baseLevel, levelCount, targetUsage);
+    }
+
+    uint32_t Texture::GetArrayLayers() const {
+        return GetDimension() == nxt::TextureDimension::e2DArray ? GetDepth() : 1;
+    }
+
+    uint32_t Texture::GetExtentDepth() const {
+        return GetDimension() == nxt::TextureDimension::e3D ? GetDepth() : 1;
+    }
+
+    void Texture::RecordGenerateMipmaps(VkCommandBuffer commands,
+                                        uint32_t baseLevel,
+                                        uint32_t levelCount) const {
+        ASSERT(GetDimension() == nxt::TextureDimension::e2D);
+        if (levelCount <= 1) {
+            return;
+        }
+
+        Device* device = ToBackend(GetDevice());
+        VkImageAspectFlags aspect = VulkanAspectMask(GetFormat());
+
+        VkImageMemoryBarrier barrier;
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.pNext = nullptr;
+        barrier.srcQueueFamilyIndex = 0;
+        barrier.dstQueueFamilyIndex = 0;
+        barrier.image = mHandle;
+        barrier.subresourceRange.aspectMask = aspect;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        for (uint32_t level = baseLevel + 1; level < baseLevel + levelCount; ++level) {
+            // Make the level above readable once its writes are done.
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            device->fn.CmdPipelineBarrier(commands, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                          VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                                          nullptr, 1, &barrier);
+
+            int32_t srcWidth = static_cast<int32_t>(std::max(GetWidth() >> (level - 1), 1u));
+            int32_t srcHeight = static_cast<int32_t>(std::max(GetHeight() >> (level - 1), 1u));
+            int32_t dstWidth = static_cast<int32_t>(std::max(GetWidth() >> level, 1u));
+            int32_t dstHeight = static_cast<int32_t>(std::max(GetHeight() >> level, 1u));
+
+            VkImageBlit blit;
+            blit.srcSubresource.aspectMask = aspect;
+            blit.srcSubresource.mipLevel = level - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = 1;
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {srcWidth, srcHeight, 1};
+            blit.dstSubresource.aspectMask = aspect;
+            blit.dstSubresource.mipLevel = level;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = 1;
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {dstWidth, dstHeight, 1};
+
+            device->fn.CmdBlitImage(commands, mHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                    mHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                                    VK_FILTER_LINEAR);
+        }
+
+        // Put the source levels back in the layout of the TransferDst usage the NXT state
+        // tracking expects the levels to be in.
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.subresourceRange.baseMipLevel = baseLevel;
+        barrier.subresourceRange.levelCount = levelCount - 1;
+        device->fn.CmdPipelineBarrier(commands, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                      VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                                      &barrier);
+    }
+
+    void Texture::SetSubDataImpl(uint32_t level,
+                                 uint32_t x,
+                                 uint32_t y,
+                                 uint32_t width,
+                                 uint32_t height,
+                                 uint32_t rowPitch,
+                                 const uint8_t* data) {
+        BufferUploader* uploader = ToBackend(GetDevice())->GetBufferUploader();
+        uploader->TextureSubData(this, level, x, y, width, height, rowPitch, data);
+    }
+
+    void Texture::TransitionUsageImpl(uint32_t baseLevel,
+                                      uint32_t levelCount,
+                                      nxt::TextureUsageBit currentUsage,
                                       nxt::TextureUsageBit targetUsage) {
         VkCommandBuffer commands = ToBackend(GetDevice())->GetPendingCommandBuffer();
-        RecordBarrier(commands, currentUsage, targetUsage);
+        RecordBarrier(commands, baseLevel, levelCount, currentUsage, targetUsage);
+    }
+
+    // TextureView
+
+    TextureView::TextureView(TextureViewBuilder* builder) : TextureViewBase(builder) {
+        Texture* texture = ToBackend(GetTexture());
+        nxt::TextureFormat format = texture->GetFormat();
+
+        // Attachments use all the aspects of depth-stencil textures but sampled views must only
+        // have one of them, so views of these textures that can be sampled get a second image
+        // view of their depth aspect.
+        mHandle = CreateImageView(texture->GetVkAspectMask());
+        mSampledHandle = mHandle;
+        if (TextureFormatHasDepth(format) && TextureFormatHasStencil(format) &&
+            (texture->GetAllowedUsage() & nxt::TextureUsageBit::Sampled)) {
+            mSampledHandle = CreateImageView(VK_IMAGE_ASPECT_DEPTH_BIT);
+            mOwnsSampledHandle = true;
+        }
+    }
+
+    TextureView::~TextureView() {
+        Device* device = ToBackend(GetTexture()->GetDevice());
+
+        if (mHandle != VK_NULL_HANDLE) {
+            device->GetFencedDeleter()->DeleteWhenUnused(mHandle);
+            mHandle = VK_NULL_HANDLE;
+        }
+        if (mOwnsSampledHandle) {
+            device->GetFencedDeleter()->DeleteWhenUnused(mSampledHandle);
+        }
+        mSampledHandle = VK_NULL_HANDLE;
+    }
+
+    VkImageView TextureView::GetHandle() const {
+        return mHandle;
+    }
+
+    VkImageView TextureView::GetSampledHandle() const {
+        return mSampledHandle;
+    }
+
+    VkImageView TextureView::CreateImageView(VkImageAspectFlags aspectMask) {
+        Texture* texture = ToBackend(GetTexture());
+        Device* device = ToBackend(texture->GetDevice());
+
+        VkImageViewCreateInfo createInfo;
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        createInfo.pNext = nullptr;
+        createInfo.flags = 0;
+        createInfo.image = texture->GetHandle();
+        createInfo.viewType = VulkanImageViewType(GetDimension());
+        createInfo.format = VulkanImageFormat(texture->GetFormat());
+        createInfo.components = VkComponentMapping{
+            VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY};
+        createInfo.subresourceRange.aspectMask = aspectMask;
+        createInfo.subresourceRange.baseMipLevel = 0;
+        createInfo.subresourceRange.levelCount = texture->GetNumMipLevels();
+        // The NXT layers of 3D textures are the depth slices which Vulkan doesn't view as layers.
+        if (GetDimension() == nxt::TextureDimension::e3D) {
+            createInfo.subresourceRange.baseArrayLayer = 0;
+            createInfo.subresourceRange.layerCount = 1;
+        } else {
+            createInfo.subresourceRange.baseArrayLayer = GetBaseArrayLayer();
+            createInfo.subresourceRange.layerCount = GetLayerCount();
+        }
+
+        VkImageView handle = VK_NULL_HANDLE;
+        if (device->fn.CreateImageView(device->GetVkDevice(), &createInfo, nullptr, &handle) !=
+            VK_SUCCESS) {
+            ASSERT(false);
+        }
+        return handle;
     }
 
 }}  // namespace backend::vulkan
@@ -22,6 +22,10 @@
 
 namespace backend { namespace vulkan {
 
+    VkFormat VulkanImageFormat(nxt::TextureFormat format);
+    VkImageLayout VulkanImageLayout(nxt::TextureUsageBit usage, nxt::TextureFormat format);
+    VkSampleCountFlagBits VulkanSampleCount(uint32_t sampleCount);
+
     class Texture : public TextureBase {
       public:
         Texture(TextureBuilder* builder);
@@ -29,19 +33,67 @@ namespace backend { namespace vulkan {
 
         VkImage GetHandle() const;
         VkImageAspectFlags GetVkAspectMask() const;
+        // Vulkan splits NXT's depth into array layers for 2D arrays and the extent for 3D
+        uint32_t GetArrayLayers() const;
+        uint32_t GetExtentDepth() const;
 
+        // Records a barrier for levels [baseLevel, baseLevel + levelCount) that are all in
+        // currentUsage.
         void RecordBarrier(VkCommandBuffer commands,
+                           uint32_t baseLevel,
+                           uint32_t levelCount,
                            nxt::TextureUsageBit currentUsage,
                            nxt::TextureUsageBit targetUsage) const;
+        // Records the barriers for levels [baseLevel, baseLevel + levelCount) that can be in
+        // different usages, and updates their usage. Levels already in the target usage are
+        // skipped if skipSameUsage is true.
+        void TransitionLevelsNow(VkCommandBuffer commands,
+                                 uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit targetUsage,
+                                 bool skipSameUsage);
+
+        // Records blits that fill levels [baseLevel + 1, baseLevel + levelCount) from baseLevel.
+        // These levels must be in the TransferDst usage and are left in it.
+        void RecordGenerateMipmaps(VkCommandBuffer commands,
+                                   uint32_t baseLevel,
+                                   uint32_t levelCount) const;
 
       private:
-        void TransitionUsageImpl(nxt::TextureUsageBit currentUsage,
+        void SetSubDataImpl(uint32_t level,
+                            uint32_t x,
+                            uint32_t y,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t rowPitch,
+                            const uint8_t* data) override;
+        void TransitionUsageImpl(uint32_t baseLevel,
+                                 uint32_t levelCount,
+                                 nxt::TextureUsageBit currentUsage,
                                  nxt::TextureUsageBit targetUsage) override;
 
         VkImage mHandle = VK_NULL_HANDLE;
         DeviceMemoryAllocation mMemoryAllocation;
     };
 
+    class TextureView : public TextureViewBase {
+      public:
+        TextureView(TextureViewBuilder* builder);
+        ~TextureView();
+
+        // The view to use as an attachment.
+        VkImageView GetHandle() const;
+        // The view to sample from, which only has the depth aspect for depth-stencil textures.
+        VkImageView GetSampledHandle() const;
+
+      private:
+        VkImageView CreateImageView(VkImageAspectFlags aspectMask);
+
+        VkImageView mHandle = VK_NULL_HANDLE;
+        VkImageView mSampledHandle = VK_NULL_HANDLE;
+        bool mOwnsSampledHandle = false;
+    };
+
 }}  // namespace backend::vulkan
 
 #endif  // BACKEND_VULKAN_TEXTUREVK_H_
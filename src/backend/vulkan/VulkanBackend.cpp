@@ -15,15 +15,26 @@
 #include "backend/vulkan/VulkanBackend.h"
 
 #include "backend/Commands.h"
+#include "backend/vulkan/BindGroupLayoutVk.h"
+#include "backend/vulkan/BindGroupVk.h"
+#include "backend/vulkan/BlendStateVk.h"
 #include "backend/vulkan/BufferUploader.h"
 #include "backend/vulkan/BufferVk.h"
 #include "backend/vulkan/CommandBufferVk.h"
+#include "backend/vulkan/ComputePipelineVk.h"
+#include "backend/vulkan/DepthStencilStateVk.h"
 #include "backend/vulkan/FencedDeleter.h"
+#include "backend/vulkan/FramebufferVk.h"
+#include "backend/vulkan/InputStateVk.h"
+#include "backend/vulkan/PipelineCache.h"
+#include "backend/vulkan/PipelineLayoutVk.h"
+#include "backend/vulkan/RenderPassCache.h"
+#include "backend/vulkan/RenderPipelineVk.h"
+#include "backend/vulkan/SamplerVk.h"
+#include "backend/vulkan/ShaderModuleVk.h"
 #include "backend/vulkan/TextureVk.h"
 #include "common/Platform.h"
 
-#include <spirv-cross/spirv_cross.hpp>
-
 #include <iostream>
 
 #if NXT_PLATFORM_LINUX
@@ -52,6 +63,9 @@ namespace backend { namespace vulkan {
             return;
         }
 
+        // Unlike the pipeline cache, the functions and the global and device info can't be
+        // loaded lazily: creating the instance and device needs them to choose the layers,
+        // extensions and queue family.
         VulkanFunctions* functions = GetMutableFunctions();
 
         if (!functions->LoadGlobalProcs(mVulkanLib)) {
@@ -114,6 +128,7 @@ namespace backend { namespace vulkan {
         mDeleter = new FencedDeleter(this);
         mMapReadRequestTracker = new MapReadRequestTracker(this);
         mMemoryAllocator = new MemoryAllocator(this);
+        mRenderPassCache = new RenderPassCache(this);
     }
 
     Device::~Device() {
@@ -143,6 +158,19 @@ namespace backend { namespace vulkan {
         }
         mUnusedFences.clear();
 
+        // All the pipelines and framebuffers have been deleted by the Tick above so the render
+        // passes can be destroyed.
+        delete mRenderPassCache;
+        mRenderPassCache = nullptr;
+
+        delete mPipelineCache;
+        mPipelineCache = nullptr;
+
+        if (mEmptyDescriptorSetLayout != VK_NULL_HANDLE) {
+            fn.DestroyDescriptorSetLayout(mVkDevice, mEmptyDescriptorSetLayout, nullptr);
+            mEmptyDescriptorSetLayout = VK_NULL_HANDLE;
+        }
+
         delete mBufferUploader;
         mBufferUploader = nullptr;
 
@@ -174,10 +202,10 @@ namespace backend { namespace vulkan {
     }
 
     BindGroupBase* Device::CreateBindGroup(BindGroupBuilder* builder) {
-        return new BindGroup(builder);
+        return new BindGroup(this, builder);
     }
     BindGroupLayoutBase* Device::CreateBindGroupLayout(BindGroupLayoutBuilder* builder) {
-        return new BindGroupLayout(builder);
+        return new BindGroupLayout(this, builder);
     }
     BlendStateBase* Device::CreateBlendState(BlendStateBuilder* builder) {
         return new BlendState(builder);
@@ -204,7 +232,7 @@ namespace backend { namespace vulkan {
         return new InputState(builder);
     }
     PipelineLayoutBase* Device::CreatePipelineLayout(PipelineLayoutBuilder* builder) {
-        return new PipelineLayout(builder);
+        return new PipelineLayout(this, builder);
     }
     QueueBase* Device::CreateQueue(QueueBuilder* builder) {
         return new Queue(builder);
@@ -216,15 +244,10 @@ namespace backend { namespace vulkan {
         return new RenderPipeline(builder);
     }
     SamplerBase* Device::CreateSampler(SamplerBuilder* builder) {
-        return new Sampler(builder);
+        return new Sampler(this, builder);
     }
     ShaderModuleBase* Device::CreateShaderModule(ShaderModuleBuilder* builder) {
-        auto module = new ShaderModule(builder);
-
-        spirv_cross::Compiler compiler(builder->AcquireSpirv());
-        module->ExtractSpirvInfo(compiler);
-
-        return module;
+        return new ShaderModule(this, builder);
     }
     SwapChainBase* Device::CreateSwapChain(SwapChainBuilder* builder) {
         return new SwapChain(builder);
@@ -272,10 +295,62 @@ namespace backend { namespace vulkan {
         return mBufferUploader;
     }
 
+    PipelineCache* Device::GetPipelineCache() {
+        // Loading the cache reads it from disk so it is only done once pipelines are created.
+        if (mPipelineCache == nullptr) {
+            mPipelineCache = new PipelineCache(this);
+        }
+        return mPipelineCache;
+    }
+
+    RenderPassCache* Device::GetRenderPassCache() const {
+        return mRenderPassCache;
+    }
+
+    VkDescriptorSetLayout Device::GetEmptyDescriptorSetLayout() {
+        if (mEmptyDescriptorSetLayout == VK_NULL_HANDLE) {
+            VkDescriptorSetLayoutCreateInfo emptyLayoutInfo;
+            emptyLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            emptyLayoutInfo.pNext = nullptr;
+            emptyLayoutInfo.flags = 0;
+            emptyLayoutInfo.bindingCount = 0;
+            emptyLayoutInfo.pBindings = nullptr;
+
+            if (fn.CreateDescriptorSetLayout(mVkDevice, &emptyLayoutInfo, nullptr,
+                                             &mEmptyDescriptorSetLayout) != VK_SUCCESS) {
+                ASSERT(false);
+            }
+        }
+        return mEmptyDescriptorSetLayout;
+    }
+
+    bool Device::IsTextureFormatSupported(nxt::TextureFormat format) const {
+        switch (format) {
+            case nxt::TextureFormat::Bc1RGBAUnorm:
+            case nxt::TextureFormat::Bc2RGBAUnorm:
+            case nxt::TextureFormat::Bc3RGBAUnorm:
+            case nxt::TextureFormat::Bc4RUnorm:
+            case nxt::TextureFormat::Bc5RGUnorm:
+            case nxt::TextureFormat::Bc6hRGBUfloat:
+            case nxt::TextureFormat::Bc7RGBAUnorm:
+                return mDeviceInfo.features.textureCompressionBC == VK_TRUE;
+            case nxt::TextureFormat::Etc2R8G8B8Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+            case nxt::TextureFormat::Etc2R8G8B8A8Unorm:
+                return mDeviceInfo.features.textureCompressionETC2 == VK_TRUE;
+            default:
+                return DeviceBase::IsTextureFormatSupported(format);
+        }
+    }
+
     FencedDeleter* Device::GetFencedDeleter() const {
         return mDeleter;
     }
 
+    Serial Device::GetCompletedSerial() const {
+        return mCompletedSerial;
+    }
+
     Serial Device::GetSerial() const {
         return mNextSerial;
     }
@@ -393,6 +468,28 @@ namespace backend { namespace vulkan {
             usedKnobs->swapchain = true;
         }
 
+        // VK_KHR_maintenance1 allows negative viewport heights, which are used to flip the Y axis
+        // so that it matches NXT's coordinate system.
+        if (!mDeviceInfo.maintenance1) {
+            return false;
+        }
+        extensionsToRequest.push_back(kExtensionNameKhrMaintenance1);
+        usedKnobs->maintenance1 = true;
+
+        // Each stage gets its own range of push constants, see PipelineLayoutVk.h
+        if (mDeviceInfo.properties.limits.maxPushConstantsSize < kPushConstantTotalSize) {
+            return false;
+        }
+
+        // Enable the compressed texture features when available, the frontend then checks them
+        // via IsTextureFormatSupported.
+        if (mDeviceInfo.features.textureCompressionBC == VK_TRUE) {
+            usedKnobs->features.textureCompressionBC = VK_TRUE;
+        }
+        if (mDeviceInfo.features.textureCompressionETC2 == VK_TRUE) {
+            usedKnobs->features.textureCompressionETC2 = VK_TRUE;
+        }
+
         // Find a universal queue family
         {
             constexpr uint32_t kUniversalFlags =
@@ -44,31 +44,33 @@
 
 namespace backend { namespace vulkan {
 
-    using BindGroup = BindGroupBase;
-    using BindGroupLayout = BindGroupLayoutBase;
-    using BlendState = BlendStateBase;
+    class BindGroup;
+    class BindGroupLayout;
+    class BlendState;
     class Buffer;
     using BufferView = BufferViewBase;
     class CommandBuffer;
-    using ComputePipeline = ComputePipelineBase;
-    using DepthStencilState = DepthStencilStateBase;
+    class ComputePipeline;
+    class DepthStencilState;
     class Device;
-    using Framebuffer = FramebufferBase;
-    using InputState = InputStateBase;
-    using PipelineLayout = PipelineLayoutBase;
+    class Framebuffer;
+    class InputState;
+    class PipelineLayout;
     class Queue;
     using RenderPass = RenderPassBase;
-    using RenderPipeline = RenderPipelineBase;
-    using Sampler = SamplerBase;
-    using ShaderModule = ShaderModuleBase;
+    class RenderPipeline;
+    class Sampler;
+    class ShaderModule;
     class SwapChain;
     class Texture;
-    using TextureView = TextureViewBase;
+    class TextureView;
 
     class BufferUploader;
     class FencedDeleter;
     class MapReadRequestTracker;
     class MemoryAllocator;
+    class PipelineCache;
+    class RenderPassCache;
 
     struct VulkanBackendTraits {
         using BindGroupType = BindGroup;
@@ -114,7 +116,14 @@ namespace backend { namespace vulkan {
         FencedDeleter* GetFencedDeleter() const;
         MapReadRequestTracker* GetMapReadRequestTracker() const;
         MemoryAllocator* GetMemoryAllocator() const;
+        PipelineCache* GetPipelineCache();
+        RenderPassCache* GetRenderPassCache() const;
 
+        // A descriptor set layout without bindings, used for the bind groups that are not part of
+        // pipeline layouts. Created the first time it is needed.
+        VkDescriptorSetLayout GetEmptyDescriptorSetLayout();
+
+        Serial GetCompletedSerial() const;
         Serial GetSerial() const;
 
         VkCommandBuffer GetPendingCommandBuffer();
@@ -142,6 +151,7 @@ namespace backend { namespace vulkan {
         TextureViewBase* CreateTextureView(TextureViewBuilder* builder) override;
 
         void TickImpl() override;
+        bool IsTextureFormatSupported(nxt::TextureFormat format) const override;
 
       private:
         bool CreateInstance(VulkanGlobalKnobs* usedKnobs);
@@ -179,6 +189,10 @@ namespace backend { namespace vulkan {
         FencedDeleter* mDeleter = nullptr;
         MapReadRequestTracker* mMapReadRequestTracker = nullptr;
         MemoryAllocator* mMemoryAllocator = nullptr;
+        PipelineCache* mPipelineCache = nullptr;
+        RenderPassCache* mRenderPassCache = nullptr;
+
+        VkDescriptorSetLayout mEmptyDescriptorSetLayout = VK_NULL_HANDLE;
 
         VkFence GetUnusedFence();
         void CheckPassedFences();
@@ -34,6 +34,7 @@ namespace backend { namespace vulkan {
 
     const char kExtensionNameExtDebugReport[] = "VK_EXT_debug_report";
     const char kExtensionNameKhrSurface[] = "VK_KHR_surface";
+    const char kExtensionNameKhrMaintenance1[] = "VK_KHR_maintenance1";
     const char kExtensionNameKhrSwapchain[] = "VK_KHR_swapchain";
 
     bool GatherGlobalInfo(const Device& device, VulkanGlobalInfo* info) {
@@ -172,6 +173,9 @@ namespace backend { namespace vulkan {
             }
 
             for (const auto& extension : info->extensions) {
+                if (IsExtensionName(extension, kExtensionNameKhrMaintenance1)) {
+                    info->maintenance1 = true;
+                }
                 if (IsExtensionName(extension, kExtensionNameKhrSwapchain)) {
                     info->swapchain = true;
                 }
@@ -27,6 +27,7 @@ namespace backend { namespace vulkan {
 
     extern const char kExtensionNameExtDebugReport[];
     extern const char kExtensionNameKhrSurface[];
+    extern const char kExtensionNameKhrMaintenance1[];
     extern const char kExtensionNameKhrSwapchain[];
 
     // Global information - gathered before the instance is created
@@ -50,6 +51,7 @@ namespace backend { namespace vulkan {
         VkPhysicalDeviceFeatures features;
 
         // Extensions
+        bool maintenance1 = false;
         bool swapchain = false;
     };
 
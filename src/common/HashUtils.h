@@ -0,0 +1,27 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON_HASHUTILS_H_
+#define COMMON_HASHUTILS_H_
+
+#include <cstddef>
+
+// Mixes the hash h2 into h1, used to hash objects made of several members.
+// TODO(cwallez@chromium.org): see if we can use boost's hash combined or some equivalent
+// this currently assumes that size_t is 64 bits
+inline void CombineHashes(size_t* h1, size_t h2) {
+    *h1 ^= (h2 << 7) + (h2 >> (sizeof(size_t) * 8 - 7)) + 0x304975;
+}
+
+#endif  // COMMON_HASHUTILS_H_
@@ -12,9 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <gtest/gtest.h>
+#include "tests/NXTTest.h"
 
 int main(int argc, char** argv) {
     testing::InitGoogleTest(&argc, argv);
+    InitNXTEnd2EndTestEnvironment(argc, argv);
     return RUN_ALL_TESTS();
 }
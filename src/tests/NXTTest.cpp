@@ -55,6 +55,10 @@ namespace {
         }
     }
 
+    // Set by InitNXTEnd2EndTestEnvironment, headless tests use offscreen swap chains instead of
+    // GLFW windows so that they can run on machines without a display.
+    bool gHeadless = false;
+
     // Windows don't usually like to be bound to one API than the other, for example switching
     // from Vulkan to OpenGL causes crashes on some drivers. Because of this, we lazily created
     // a window for each backing API.
@@ -93,6 +97,14 @@ namespace {
     };
 }
 
+void InitNXTEnd2EndTestEnvironment(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string("--headless") == argv[i]) {
+            gHeadless = true;
+        }
+    }
+}
+
 NXTTest::~NXTTest() {
     // We need to destroy child objects before the Device
     mReadbackSlots.clear();
@@ -123,13 +135,20 @@ bool NXTTest::IsVulkan() const {
 }
 
 void NXTTest::SetUp() {
-    mBinding = utils::CreateBinding(ParamToBackendType(GetParam()));
-    NXT_ASSERT(mBinding != nullptr);
+    if (gHeadless) {
+        mBinding = utils::CreateHeadlessBinding(ParamToBackendType(GetParam()));
+        if (mBinding == nullptr) {
+            FAIL() << "No headless binding for the " << ParamName(GetParam()) << " backend";
+        }
+    } else {
+        mBinding = utils::CreateBinding(ParamToBackendType(GetParam()));
+        NXT_ASSERT(mBinding != nullptr);
 
-    GLFWwindow* testWindow = GetWindowForBackend(mBinding, GetParam());
-    NXT_ASSERT(testWindow != nullptr);
+        GLFWwindow* testWindow = GetWindowForBackend(mBinding, GetParam());
+        NXT_ASSERT(testWindow != nullptr);
 
-    mBinding->SetWindow(testWindow);
+        mBinding->SetWindow(testWindow);
+    }
 
     nxtDevice backendDevice;
     nxtProcTable backendProcs;
@@ -58,6 +58,10 @@ namespace utils {
     class BackendBinding;
 }
 
+// Parses the end2end tests' own command line arguments, must be called after gtest removed the
+// arguments it handles. --headless runs the tests without creating windows.
+void InitNXTEnd2EndTestEnvironment(int argc, char** argv);
+
 namespace detail {
     class Expectation;
 }
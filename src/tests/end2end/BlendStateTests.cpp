@@ -973,4 +973,4 @@ TEST_P(BlendStateTest, DefaultBlendColor) {
     }
 }
 
-NXT_INSTANTIATE_TEST(BlendStateTest, D3D12Backend, MetalBackend, OpenGLBackend)
+NXT_INSTANTIATE_TEST(BlendStateTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -0,0 +1,148 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/NXTTest.h"
+
+#include "common/Constants.h"
+#include "common/Math.h"
+#include "utils/NXTHelpers.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+class CompressedTextureFormatTests : public NXTTest {
+    protected:
+        // Support for compressed formats is optional so it is probed by trying to create a texture
+        bool IsFormatSupported(nxt::TextureFormat format) {
+            bool supported = false;
+            device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(4, 4, 1)
+                .SetFormat(format)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferDst)
+                .SetErrorCallback(OnProbeStatus,
+                                  static_cast<nxt::CallbackUserdata>(
+                                      reinterpret_cast<uintptr_t>(&supported)),
+                                  0)
+                .GetResult();
+            return supported;
+        }
+
+        // Uploads blocks of data to `level` with a buffer to texture copy, reads them back with a
+        // texture to buffer copy and checks they are unchanged. Compressed data is opaque to the
+        // copies so any bytes will do.
+        void DoRoundTrip(nxt::TextureFormat format, uint32_t size, uint32_t level) {
+            if (!IsFormatSupported(format)) {
+                std::cout << "Test skipped, format " << static_cast<uint32_t>(format)
+                          << " is not supported" << std::endl;
+                return;
+            }
+
+            nxt::Texture texture = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(size, size, 1)
+                .SetFormat(format)
+                .SetMipLevels(level + 1)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::TransferSrc)
+                .GetResult();
+
+            uint32_t levelSize = std::max(size >> level, 1u);
+            uint32_t blockSize = BlockSize(format);
+            uint32_t blocksPerRow = (levelSize + 3) / 4;
+            uint32_t rowCount = (levelSize + 3) / 4;
+            uint32_t rowPitch = Align(blocksPerRow * blockSize, kTextureRowPitchAlignment);
+            uint32_t bufferSize = rowPitch * (rowCount - 1) + blocksPerRow * blockSize;
+
+            // Pad the buffers to whole uint32_t so the expectation can compare them
+            std::vector<uint32_t> data(Align(bufferSize, 4) / sizeof(uint32_t));
+            for (uint32_t i = 0; i < data.size(); ++i) {
+                data[i] = i * 0x01030507u + level;
+            }
+            nxt::Buffer uploadBuffer = utils::CreateFrozenBufferFromData(
+                device, data.data(), static_cast<uint32_t>(data.size() * sizeof(uint32_t)),
+                nxt::BufferUsageBit::TransferSrc);
+
+            nxt::Buffer readbackBuffer = device.CreateBufferBuilder()
+                .SetSize(static_cast<uint32_t>(data.size() * sizeof(uint32_t)))
+                .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+                .CopyBufferToTexture(uploadBuffer, 0, rowPitch, texture, 0, 0, 0, levelSize, levelSize, 1, level)
+                .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+                .CopyTextureToBuffer(texture, 0, 0, 0, levelSize, levelSize, 1, level, readbackBuffer, 0, rowPitch)
+                .GetResult();
+            queue.Submit(1, &commands);
+
+            // Only the blocks are written by the copy, compare each row of blocks separately.
+            uint32_t rowWords = blocksPerRow * blockSize / sizeof(uint32_t);
+            for (uint32_t row = 0; row < rowCount; ++row) {
+                uint32_t offset = row * rowPitch;
+                EXPECT_BUFFER_U32_RANGE_EQ(&data[offset / sizeof(uint32_t)], readbackBuffer,
+                                           offset, rowWords)
+                    << "Round trip failed for format " << static_cast<uint32_t>(format)
+                    << " at level " << level << ", block row " << row;
+            }
+        }
+
+    private:
+        static uint32_t BlockSize(nxt::TextureFormat format) {
+            switch (format) {
+                case nxt::TextureFormat::Bc1RGBAUnorm:
+                case nxt::TextureFormat::Bc4RUnorm:
+                case nxt::TextureFormat::Etc2R8G8B8Unorm:
+                case nxt::TextureFormat::Etc2R8G8B8A1Unorm:
+                    return 8;
+                default:
+                    return 16;
+            }
+        }
+
+        static void OnProbeStatus(nxtBuilderErrorStatus status,
+                                  const char*,
+                                  nxtCallbackUserdata userdata1,
+                                  nxtCallbackUserdata) {
+            bool* supported = reinterpret_cast<bool*>(static_cast<uintptr_t>(userdata1));
+            *supported = status == NXT_BUILDER_ERROR_STATUS_SUCCESS;
+        }
+};
+
+// Test round trips of every compressed format through a full mip level
+TEST_P(CompressedTextureFormatTests, FullLevel) {
+    for (nxt::TextureFormat format :
+         {nxt::TextureFormat::Bc1RGBAUnorm, nxt::TextureFormat::Bc2RGBAUnorm,
+          nxt::TextureFormat::Bc3RGBAUnorm, nxt::TextureFormat::Bc4RUnorm,
+          nxt::TextureFormat::Bc5RGUnorm, nxt::TextureFormat::Bc6hRGBUfloat,
+          nxt::TextureFormat::Bc7RGBAUnorm, nxt::TextureFormat::Etc2R8G8B8Unorm,
+          nxt::TextureFormat::Etc2R8G8B8A1Unorm, nxt::TextureFormat::Etc2R8G8B8A8Unorm}) {
+        DoRoundTrip(format, 64, 0);
+    }
+}
+
+// Test round trips through mip levels smaller than a block, which are copied as a whole block
+TEST_P(CompressedTextureFormatTests, LevelSmallerThanBlock) {
+    for (nxt::TextureFormat format :
+         {nxt::TextureFormat::Bc1RGBAUnorm, nxt::TextureFormat::Bc7RGBAUnorm,
+          nxt::TextureFormat::Etc2R8G8B8A8Unorm}) {
+        DoRoundTrip(format, 16, 3);
+        DoRoundTrip(format, 16, 4);
+    }
+}
+
+NXT_INSTANTIATE_TEST(CompressedTextureFormatTests, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -0,0 +1,319 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <array>
+
+constexpr uint32_t kRTSize = 4;
+constexpr uint32_t kNumValues = 64;
+
+// The tests use the results of dispatches in the same command buffer, so they only pass if the
+// backend makes the storage writes of the dispatches visible to the operations that follow.
+class ComputeMemoryBarrierTest : public NXTTest {
+    protected:
+        void SetUp() override {
+            NXTTest::SetUp();
+
+            bgl = device.CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Compute, nxt::BindingType::StorageBuffer, 0, 1)
+                .GetResult();
+
+            renderpass = device.CreateRenderPassBuilder()
+                .SetAttachmentCount(1)
+                .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+                .SetSubpassCount(1)
+                .SubpassSetColorAttachment(0, 0, 0)
+                .GetResult();
+
+            renderTarget = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kRTSize, kRTSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+                .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+                .GetResult();
+
+            nxt::TextureView renderTargetView = renderTarget.CreateTextureViewBuilder().GetResult();
+
+            framebuffer = device.CreateFramebufferBuilder()
+                .SetRenderPass(renderpass)
+                .SetAttachment(0, renderTargetView)
+                .SetDimensions(kRTSize, kRTSize)
+                .GetResult();
+
+            nxt::InputState inputState = device.CreateInputStateBuilder()
+                .SetInput(0, 4 * sizeof(float), nxt::InputStepMode::Vertex)
+                .SetAttribute(0, 0, nxt::VertexFormat::FloatR32G32B32A32, 0)
+                .GetResult();
+
+            nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                layout(location = 0) in vec4 pos;
+                void main() {
+                    gl_Position = pos;
+                })"
+            );
+
+            nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.0, 1.0, 0.0, 1.0);
+                })"
+            );
+
+            renderPipeline = device.CreateRenderPipelineBuilder()
+                .SetSubpass(renderpass, 0)
+                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                .SetInputState(inputState)
+                .GetResult();
+        }
+
+        // Creates a compute pipeline using a single storage buffer at binding 0
+        nxt::ComputePipeline MakeComputePipeline(const char* source) {
+            nxt::ShaderModule module = utils::CreateShaderModule(device, nxt::ShaderStage::Compute, source);
+
+            return device.CreateComputePipelineBuilder()
+                .SetLayout(device.CreatePipelineLayoutBuilder().SetBindGroupLayout(0, bgl).GetResult())
+                .SetStage(nxt::ShaderStage::Compute, module, "main")
+                .GetResult();
+        }
+
+        nxt::BindGroup MakeStorageBindGroup(const nxt::Buffer& buffer, uint32_t size) {
+            nxt::BufferView view = buffer.CreateBufferViewBuilder()
+                .SetExtent(0, size)
+                .GetResult();
+
+            return device.CreateBindGroupBuilder()
+                .SetLayout(bgl)
+                .SetUsage(nxt::BindGroupUsage::Frozen)
+                .SetBufferViews(0, 1, &view)
+                .GetResult();
+        }
+
+        // Creates a buffer of kNumValues zeroes that can be used as a storage buffer
+        nxt::Buffer MakeZeroedStorageBuffer(nxt::BufferUsageBit extraUsage) {
+            nxt::Buffer buffer = device.CreateBufferBuilder()
+                .SetSize(kNumValues * sizeof(uint32_t))
+                .SetAllowedUsage(nxt::BufferUsageBit::Storage | nxt::BufferUsageBit::TransferDst | extraUsage)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+
+            std::array<uint32_t, kNumValues> zeroes = {};
+            buffer.SetSubData(0, kNumValues, zeroes.data());
+            return buffer;
+        }
+
+        void CheckAllGreen() {
+            for (uint32_t y = 0; y < kRTSize; ++y) {
+                for (uint32_t x = 0; x < kRTSize; ++x) {
+                    EXPECT_PIXEL_RGBA8_EQ(RGBA8(0, 255, 0, 255), renderTarget, x, y);
+                }
+            }
+        }
+
+        nxt::BindGroupLayout bgl;
+        nxt::RenderPass renderpass;
+        nxt::Texture renderTarget;
+        nxt::Framebuffer framebuffer;
+        nxt::RenderPipeline renderPipeline;
+};
+
+// Test that a dispatch sees the storage buffer writes of the previous dispatch
+TEST_P(ComputeMemoryBarrierTest, DependentDispatches) {
+    // Each workgroup increments one value, so the values are only right if each dispatch reads
+    // what the previous one wrote.
+    nxt::ComputePipeline pipeline = MakeComputePipeline(R"(
+        #version 450
+        layout(local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer Data {
+            uint values[];
+        } data;
+        void main() {
+            data.values[gl_GlobalInvocationID.x] += 1;
+        })");
+
+    nxt::Buffer buffer = MakeZeroedStorageBuffer(nxt::BufferUsageBit::TransferSrc);
+    nxt::BindGroup bindGroup = MakeStorageBindGroup(buffer, kNumValues * sizeof(uint32_t));
+
+    constexpr uint32_t kDispatches = 4;
+    nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+    builder.TransitionBufferUsage(buffer, nxt::BufferUsageBit::Storage)
+        .BeginComputePass()
+        .SetComputePipeline(pipeline)
+        .SetBindGroup(0, bindGroup);
+    for (uint32_t i = 0; i < kDispatches; ++i) {
+        builder.Dispatch(kNumValues, 1, 1);
+    }
+    nxt::CommandBuffer commands = builder.EndComputePass().GetResult();
+
+    queue.Submit(1, &commands);
+
+    std::array<uint32_t, kNumValues> expected;
+    expected.fill(kDispatches);
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), buffer, 0, kNumValues);
+}
+
+// Test that a draw sees the vertices written by a dispatch
+TEST_P(ComputeMemoryBarrierTest, DispatchThenVertexBuffer) {
+    // Writes two triangles covering the whole render target
+    nxt::ComputePipeline pipeline = MakeComputePipeline(R"(
+        #version 450
+        layout(local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer Vertices {
+            vec4 positions[6];
+        } vertices;
+        void main() {
+            vertices.positions[0] = vec4(-1.0, -1.0, 0.0, 1.0);
+            vertices.positions[1] = vec4( 1.0, -1.0, 0.0, 1.0);
+            vertices.positions[2] = vec4(-1.0,  1.0, 0.0, 1.0);
+            vertices.positions[3] = vec4( 1.0, -1.0, 0.0, 1.0);
+            vertices.positions[4] = vec4( 1.0,  1.0, 0.0, 1.0);
+            vertices.positions[5] = vec4(-1.0,  1.0, 0.0, 1.0);
+        })");
+
+    constexpr uint32_t kVertexBufferSize = 6 * 4 * sizeof(float);
+    nxt::Buffer vertexBuffer = device.CreateBufferBuilder()
+        .SetSize(kVertexBufferSize)
+        .SetAllowedUsage(nxt::BufferUsageBit::Storage | nxt::BufferUsageBit::Vertex)
+        .GetResult();
+    nxt::BindGroup bindGroup = MakeStorageBindGroup(vertexBuffer, kVertexBufferSize);
+
+    uint32_t zeroOffset = 0;
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionBufferUsage(vertexBuffer, nxt::BufferUsageBit::Storage)
+        .BeginComputePass()
+            .SetComputePipeline(pipeline)
+            .SetBindGroup(0, bindGroup)
+            .Dispatch(1, 1, 1)
+        .EndComputePass()
+        .TransitionBufferUsage(vertexBuffer, nxt::BufferUsageBit::Vertex)
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(renderPipeline)
+            .SetVertexBuffers(0, 1, &vertexBuffer, &zeroOffset)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+
+    CheckAllGreen();
+}
+
+// Test that a draw sees the indices written by a dispatch
+TEST_P(ComputeMemoryBarrierTest, DispatchThenIndexBuffer) {
+    // Writes the indices of two triangles covering the whole render target
+    nxt::ComputePipeline pipeline = MakeComputePipeline(R"(
+        #version 450
+        layout(local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer Indices {
+            uint values[6];
+        } indices;
+        void main() {
+            indices.values[0] = 0;
+            indices.values[1] = 1;
+            indices.values[2] = 2;
+            indices.values[3] = 1;
+            indices.values[4] = 3;
+            indices.values[5] = 2;
+        })");
+
+    nxt::Buffer vertexBuffer = utils::CreateFrozenBufferFromData<float>(device, nxt::BufferUsageBit::Vertex, {
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+    });
+
+    constexpr uint32_t kIndexBufferSize = 6 * sizeof(uint32_t);
+    nxt::Buffer indexBuffer = device.CreateBufferBuilder()
+        .SetSize(kIndexBufferSize)
+        .SetAllowedUsage(nxt::BufferUsageBit::Storage | nxt::BufferUsageBit::Index)
+        .GetResult();
+    nxt::BindGroup bindGroup = MakeStorageBindGroup(indexBuffer, kIndexBufferSize);
+
+    uint32_t zeroOffset = 0;
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionBufferUsage(indexBuffer, nxt::BufferUsageBit::Storage)
+        .BeginComputePass()
+            .SetComputePipeline(pipeline)
+            .SetBindGroup(0, bindGroup)
+            .Dispatch(1, 1, 1)
+        .EndComputePass()
+        .TransitionBufferUsage(indexBuffer, nxt::BufferUsageBit::Index)
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(renderPipeline)
+            .SetVertexBuffers(0, 1, &vertexBuffer, &zeroOffset)
+            .SetIndexBuffer(indexBuffer, 0)
+            .DrawElements(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+
+    CheckAllGreen();
+}
+
+// Test that a buffer copy sees the storage buffer writes of a dispatch
+TEST_P(ComputeMemoryBarrierTest, DispatchThenCopy) {
+    nxt::ComputePipeline pipeline = MakeComputePipeline(R"(
+        #version 450
+        layout(local_size_x = 1) in;
+        layout(set = 0, binding = 0) buffer Data {
+            uint values[];
+        } data;
+        void main() {
+            data.values[gl_GlobalInvocationID.x] = gl_GlobalInvocationID.x + 1;
+        })");
+
+    nxt::Buffer source = MakeZeroedStorageBuffer(nxt::BufferUsageBit::TransferSrc);
+    nxt::BindGroup bindGroup = MakeStorageBindGroup(source, kNumValues * sizeof(uint32_t));
+
+    nxt::Buffer destination = device.CreateBufferBuilder()
+        .SetSize(kNumValues * sizeof(uint32_t))
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+        .GetResult();
+
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionBufferUsage(source, nxt::BufferUsageBit::Storage)
+        .BeginComputePass()
+            .SetComputePipeline(pipeline)
+            .SetBindGroup(0, bindGroup)
+            .Dispatch(kNumValues, 1, 1)
+        .EndComputePass()
+        .TransitionBufferUsage(source, nxt::BufferUsageBit::TransferSrc)
+        .TransitionBufferUsage(destination, nxt::BufferUsageBit::TransferDst)
+        .CopyBufferToBuffer(source, 0, destination, 0, kNumValues * sizeof(uint32_t))
+        .GetResult();
+
+    queue.Submit(1, &commands);
+
+    std::array<uint32_t, kNumValues> expected;
+    for (uint32_t i = 0; i < kNumValues; ++i) {
+        expected[i] = i + 1;
+    }
+    EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), destination, 0, kNumValues);
+}
+
+NXT_INSTANTIATE_TEST(ComputeMemoryBarrierTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
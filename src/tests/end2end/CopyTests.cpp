@@ -499,3 +499,78 @@ TEST_P(CopyTests_B2T, RowPitchUnaligned) {
 }
 
 NXT_INSTANTIATE_TEST(CopyTests_B2T, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
+
+class CopyTests_Layered : public CopyTests {
+    protected:
+        // Uploads `copyDepth` layers starting at `z` with a single copy, reads them back with a
+        // single copy into another buffer and checks the data of each layer made the round trip.
+        void DoTest(nxt::TextureDimension dimension, uint32_t width, uint32_t height, uint32_t depth, uint32_t z, uint32_t copyDepth, uint32_t bufferOffset) {
+            nxt::Texture texture = device.CreateTextureBuilder()
+                .SetDimension(dimension)
+                .SetExtent(width, height, depth)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::TransferSrc)
+                .GetResult();
+
+            uint32_t rowPitch = Align(kBytesPerTexel * width, kTextureRowPitchAlignment);
+            uint32_t texelsPerImage = rowPitch / kBytesPerTexel * height;
+            uint32_t bufferSize = bufferOffset + texelsPerImage * copyDepth * kBytesPerTexel;
+
+            // Give each texel of each layer a different value
+            std::vector<RGBA8> bufferData(bufferSize / kBytesPerTexel);
+            for (size_t i = 0; i < bufferData.size(); ++i) {
+                bufferData[i] = RGBA8(
+                    static_cast<uint8_t>(i % 256),
+                    static_cast<uint8_t>((i / 256) % 256),
+                    static_cast<uint8_t>((i / texelsPerImage) % 256),
+                    255);
+            }
+            nxt::Buffer uploadBuffer = utils::CreateFrozenBufferFromData(device, bufferData.data(), bufferSize, nxt::BufferUsageBit::TransferSrc);
+
+            nxt::Buffer readbackBuffer = device.CreateBufferBuilder()
+                .SetSize(bufferSize)
+                .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+                .CopyBufferToTexture(uploadBuffer, bufferOffset, rowPitch, texture, 0, 0, z, width, height, copyDepth, 0)
+                .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+                .CopyTextureToBuffer(texture, 0, 0, z, width, height, copyDepth, 0, readbackBuffer, bufferOffset, rowPitch)
+                .GetResult();
+            queue.Submit(1, &commands);
+
+            // Only compare the texels of each image, the padding of the rows isn't written.
+            for (uint32_t layer = 0; layer < copyDepth; ++layer) {
+                uint32_t imageOffset = bufferOffset + layer * texelsPerImage * kBytesPerTexel;
+                for (uint32_t y = 0; y < height; ++y) {
+                    uint32_t rowOffset = imageOffset + y * rowPitch;
+                    EXPECT_BUFFER_U32_RANGE_EQ(reinterpret_cast<const uint32_t*>(&bufferData[rowOffset / kBytesPerTexel]), readbackBuffer, rowOffset, width) <<
+                        "Layered copy failed for layer " << z + layer << " row " << y << " of " << width << " x " << height << " x " << depth << " texture" << std::endl;
+                }
+            }
+        }
+};
+
+// Test copying all the layers of a 2D array texture at once
+TEST_P(CopyTests_Layered, ArrayAllLayers) {
+    DoTest(nxt::TextureDimension::e2DArray, 64, 16, 6, 0, 6, 0);
+}
+
+// Test copying a range of layers of a 2D array texture, with an unaligned buffer offset
+TEST_P(CopyTests_Layered, ArrayLayerRange) {
+    DoTest(nxt::TextureDimension::e2DArray, 64, 16, 6, 2, 3, 0);
+    DoTest(nxt::TextureDimension::e2DArray, 31, 7, 6, 5, 1, 4);
+    DoTest(nxt::TextureDimension::e2DArray, 31, 7, 6, 1, 4, 256 + 4);
+}
+
+// Test copying slices of 3D textures
+TEST_P(CopyTests_Layered, Texture3D) {
+    DoTest(nxt::TextureDimension::e3D, 64, 16, 8, 0, 8, 0);
+    DoTest(nxt::TextureDimension::e3D, 31, 7, 8, 3, 4, 0);
+    DoTest(nxt::TextureDimension::e3D, 31, 7, 8, 1, 4, 256 + 4);
+}
+
+NXT_INSTANTIATE_TEST(CopyTests_Layered, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
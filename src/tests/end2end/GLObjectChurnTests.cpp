@@ -0,0 +1,181 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/NXTTest.h"
+
+#include "common/Constants.h"
+#include "utils/NXTHelpers.h"
+
+#include "glad/glad.h"
+
+constexpr static unsigned int kRTSize = 4;
+constexpr static unsigned int kChurnIterations = 50;
+
+// GL implementations hand out object names as small integers that are reused after deletion, so
+// querying the first names is enough to count how many objects of each type are alive.
+constexpr static GLuint kMaxNameToCheck = 4096;
+
+class GLObjectChurnTests : public NXTTest {
+    protected:
+        struct GLObjectCounts {
+            uint32_t buffers = 0;
+            uint32_t framebuffers = 0;
+            uint32_t programs = 0;
+            uint32_t samplers = 0;
+            uint32_t shaders = 0;
+            uint32_t textures = 0;
+            uint32_t vertexArrays = 0;
+        };
+
+        GLObjectCounts CountGLObjects() {
+            GLObjectCounts counts;
+            for (GLuint name = 1; name <= kMaxNameToCheck; ++name) {
+                counts.buffers += glIsBuffer(name) ? 1 : 0;
+                counts.framebuffers += glIsFramebuffer(name) ? 1 : 0;
+                counts.programs += glIsProgram(name) ? 1 : 0;
+                counts.samplers += glIsSampler(name) ? 1 : 0;
+                counts.shaders += glIsShader(name) ? 1 : 0;
+                counts.textures += glIsTexture(name) ? 1 : 0;
+                counts.vertexArrays += glIsVertexArray(name) ? 1 : 0;
+            }
+            return counts;
+        }
+
+        void ExpectSameCounts(const GLObjectCounts& before, const GLObjectCounts& after) {
+            EXPECT_EQ(before.buffers, after.buffers);
+            EXPECT_EQ(before.framebuffers, after.framebuffers);
+            EXPECT_EQ(before.programs, after.programs);
+            EXPECT_EQ(before.samplers, after.samplers);
+            EXPECT_EQ(before.shaders, after.shaders);
+            EXPECT_EQ(before.textures, after.textures);
+            EXPECT_EQ(before.vertexArrays, after.vertexArrays);
+        }
+
+        // Deletions are deferred until the GPU is done with the objects, which is known only
+        // after a device tick has seen the fences pass. Objects released after the last submit
+        // wait on a fence inserted by the first tick, so a second tick is needed for them.
+        void WaitForDeferredDeletions() {
+            glFinish();
+            device.Tick();
+            glFinish();
+            device.Tick();
+        }
+
+        // Creates, uses and releases one object of each type backed by a GL object.
+        void Churn() {
+            nxt::Buffer buffer = device.CreateBufferBuilder()
+                .SetSize(kRTSize * kTextureRowPitchAlignment)
+                .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+            uint32_t value = 0xC0FFEE;
+            buffer.SetSubData(0, 1, &value);
+
+            nxt::Texture texture = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kRTSize, kRTSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+                .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+                .GetResult();
+            nxt::TextureView view = texture.CreateTextureViewBuilder().GetResult();
+
+            nxt::Sampler sampler = device.CreateSamplerBuilder()
+                .SetFilterMode(nxt::FilterMode::Linear, nxt::FilterMode::Linear, nxt::FilterMode::Linear)
+                .GetResult();
+
+            nxt::RenderPass renderpass = device.CreateRenderPassBuilder()
+                .SetAttachmentCount(1)
+                .SetSubpassCount(1)
+                .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+                .SubpassSetColorAttachment(0, 0, 0)
+                .GetResult();
+            nxt::Framebuffer framebuffer = device.CreateFramebufferBuilder()
+                .SetRenderPass(renderpass)
+                .SetDimensions(kRTSize, kRTSize)
+                .SetAttachment(0, view)
+                .GetResult();
+
+            nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                void main() {
+                    gl_Position = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+                })"
+            );
+            nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.0f, 1.0f, 0.0f, 1.0f);
+                })"
+            );
+            nxt::InputState inputState = device.CreateInputStateBuilder().GetResult();
+            nxt::RenderPipeline pipeline = device.CreateRenderPipelineBuilder()
+                .SetSubpass(renderpass, 0)
+                .SetInputState(inputState)
+                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                .GetResult();
+
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .BeginRenderPass(renderpass, framebuffer)
+                .BeginRenderSubpass()
+                    .SetRenderPipeline(pipeline)
+                    .DrawArrays(1, 1, 0, 0)
+                .EndRenderSubpass()
+                .EndRenderPass()
+                .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+                .CopyTextureToBuffer(texture, 0, 0, 0, kRTSize, kRTSize, 1, 0, buffer, 0, 0)
+                .GetResult();
+
+            queue.Submit(1, &commands);
+        }
+};
+
+// Test that creating and releasing objects repeatedly doesn't leak GL objects
+TEST_P(GLObjectChurnTests, ObjectCountsStayFlat) {
+    // Run once so that objects created lazily by the device or the driver are accounted for.
+    Churn();
+    WaitForDeferredDeletions();
+    GLObjectCounts before = CountGLObjects();
+
+    for (unsigned int i = 0; i < kChurnIterations; ++i) {
+        Churn();
+        device.Tick();
+    }
+    WaitForDeferredDeletions();
+    GLObjectCounts after = CountGLObjects();
+
+    ExpectSameCounts(before, after);
+}
+
+// Test that objects are kept alive until the commands using them have completed
+TEST_P(GLObjectChurnTests, DeletionDeferredUntilFencePassed) {
+    GLObjectCounts before = CountGLObjects();
+    Churn();
+    GLObjectCounts pending = CountGLObjects();
+
+    // The device hasn't been ticked yet so none of the objects can have been deleted.
+    EXPECT_GT(pending.buffers, before.buffers);
+    EXPECT_GT(pending.textures, before.textures);
+    EXPECT_GT(pending.programs, before.programs);
+
+    WaitForDeferredDeletions();
+    ExpectSameCounts(before, CountGLObjects());
+}
+
+NXT_INSTANTIATE_TEST(GLObjectChurnTests, OpenGLBackend)
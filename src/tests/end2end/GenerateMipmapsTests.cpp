@@ -0,0 +1,172 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/NXTTest.h"
+
+#include <array>
+#include <vector>
+
+class GenerateMipmapsTests : public NXTTest {
+    protected:
+        static constexpr uint32_t kSize = 16;
+        static constexpr uint32_t kLevels = 5;
+
+        void SetUp() override {
+            NXTTest::SetUp();
+
+            mTexture = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kSize, kSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(kLevels)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst)
+                .SetInitialUsage(nxt::TextureUsageBit::TransferDst)
+                .GetResult();
+        }
+
+        // Fills level 0 with one color per quadrant. Each quadrant stays uniform down to the 2x2
+        // level, and the colors are chosen so that their average is exact in the 1x1 level.
+        void SetQuadrantColors(const std::array<RGBA8, 4>& colors) {
+            std::vector<RGBA8> data(kSize * kSize);
+            for (uint32_t y = 0; y < kSize; ++y) {
+                for (uint32_t x = 0; x < kSize; ++x) {
+                    data[x + y * kSize] = colors[QuadrantIndex(x, y, kSize)];
+                }
+            }
+
+            mTexture.TransitionUsage(nxt::TextureUsageBit::TransferDst);
+            mTexture.SetSubData(0, 0, 0, kSize, kSize, 0,
+                                static_cast<uint32_t>(data.size() * sizeof(RGBA8)),
+                                reinterpret_cast<const uint8_t*>(data.data()));
+        }
+
+        void GenerateMipmaps(uint32_t baseLevel, uint32_t levelCount) {
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .TransitionTextureUsage(mTexture, nxt::TextureUsageBit::TransferDst)
+                .GenerateMipmaps(mTexture, baseLevel, levelCount)
+                .GetResult();
+            queue.Submit(1, &commands);
+        }
+
+        void ExpectQuadrantColors(uint32_t level, const std::array<RGBA8, 4>& colors) {
+            uint32_t size = kSize >> level;
+            std::vector<RGBA8> expected(size * size);
+            for (uint32_t y = 0; y < size; ++y) {
+                for (uint32_t x = 0; x < size; ++x) {
+                    expected[x + y * size] = colors[QuadrantIndex(x, y, size)];
+                }
+            }
+            EXPECT_TEXTURE_RGBA8_EQ(expected.data(), mTexture, 0, 0, size, size, level);
+        }
+
+        static uint32_t QuadrantIndex(uint32_t x, uint32_t y, uint32_t size) {
+            return (x < size / 2 ? 0 : 1) + (y < size / 2 ? 0 : 2);
+        }
+
+        nxt::Texture mTexture;
+};
+
+constexpr uint32_t GenerateMipmapsTests::kSize;
+constexpr uint32_t GenerateMipmapsTests::kLevels;
+
+namespace {
+    const std::array<RGBA8, 4> kColors = {{
+        RGBA8(0, 64, 128, 255),
+        RGBA8(64, 128, 192, 255),
+        RGBA8(128, 192, 0, 255),
+        RGBA8(192, 0, 64, 255),
+    }};
+    const RGBA8 kAverageColor(96, 96, 96, 255);
+
+    const std::array<RGBA8, 4> kOtherColors = {{
+        RGBA8(255, 0, 0, 255),
+        RGBA8(0, 255, 0, 255),
+        RGBA8(0, 0, 255, 255),
+        RGBA8(255, 255, 255, 255),
+    }};
+}  // anonymous namespace
+
+// Test generating the full mip chain of a texture
+TEST_P(GenerateMipmapsTests, FullChain) {
+    SetQuadrantColors(kColors);
+    GenerateMipmaps(0, kLevels);
+
+    for (uint32_t level = 0; level < kLevels - 1; ++level) {
+        ExpectQuadrantColors(level, kColors);
+    }
+    EXPECT_TEXTURE_RGBA8_EQ(&kAverageColor, mTexture, 0, 0, 1, 1, kLevels - 1);
+}
+
+// Test that only the requested levels are regenerated
+TEST_P(GenerateMipmapsTests, PartialChain) {
+    SetQuadrantColors(kColors);
+    GenerateMipmaps(0, kLevels);
+
+    SetQuadrantColors(kOtherColors);
+    GenerateMipmaps(0, 3);
+
+    ExpectQuadrantColors(1, kOtherColors);
+    ExpectQuadrantColors(2, kOtherColors);
+    ExpectQuadrantColors(3, kColors);
+    EXPECT_TEXTURE_RGBA8_EQ(&kAverageColor, mTexture, 0, 0, 1, 1, kLevels - 1);
+}
+
+// Test generating mipmaps starting from a level other than 0
+TEST_P(GenerateMipmapsTests, NonZeroBaseLevel) {
+    SetQuadrantColors(kColors);
+    GenerateMipmaps(0, 2);
+
+    SetQuadrantColors(kOtherColors);
+    GenerateMipmaps(1, kLevels - 1);
+
+    ExpectQuadrantColors(0, kOtherColors);
+    for (uint32_t level = 1; level < kLevels - 1; ++level) {
+        ExpectQuadrantColors(level, kColors);
+    }
+    EXPECT_TEXTURE_RGBA8_EQ(&kAverageColor, mTexture, 0, 0, 1, 1, kLevels - 1);
+}
+
+// Test that a level can be read while the levels below it are generated in the same command buffer
+TEST_P(GenerateMipmapsTests, OtherLevelsInOtherUsages) {
+    SetQuadrantColors(kColors);
+    GenerateMipmaps(0, 2);
+    SetQuadrantColors(kOtherColors);
+
+    constexpr uint32_t kRowPitch = 256;
+    nxt::Buffer buffer = device.CreateBufferBuilder()
+        .SetSize(kRowPitch * kSize)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+        .GetResult();
+
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionTextureLevelsUsage(mTexture, 0, 1, nxt::TextureUsageBit::TransferSrc)
+        .TransitionTextureLevelsUsage(mTexture, 1, kLevels - 1, nxt::TextureUsageBit::TransferDst)
+        .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferDst)
+        .CopyTextureToBuffer(mTexture, 0, 0, 0, kSize, kSize, 1, 0, buffer, 0, kRowPitch)
+        .GenerateMipmaps(mTexture, 1, kLevels - 1)
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    // Level 0 was read in its new contents, the other levels were generated from level 1.
+    EXPECT_BUFFER_U32_EQ(*reinterpret_cast<const uint32_t*>(&kOtherColors[0]), buffer, 0);
+    EXPECT_BUFFER_U32_EQ(*reinterpret_cast<const uint32_t*>(&kOtherColors[3]), buffer,
+                         kRowPitch * (kSize - 1) + sizeof(RGBA8) * (kSize - 1));
+    for (uint32_t level = 1; level < kLevels - 1; ++level) {
+        ExpectQuadrantColors(level, kColors);
+    }
+    EXPECT_TEXTURE_RGBA8_EQ(&kAverageColor, mTexture, 0, 0, 1, 1, kLevels - 1);
+}
+
+NXT_INSTANTIATE_TEST(GenerateMipmapsTests, MetalBackend, OpenGLBackend, VulkanBackend)
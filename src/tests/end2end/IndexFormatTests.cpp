@@ -267,4 +267,4 @@ TEST_P(IndexFormatTest, ChangePipelineAfterSetIndexBuffer) {
     EXPECT_PIXEL_RGBA8_EQ(RGBA8(0, 255, 0, 255), renderTarget, 100, 100);
 }
 
-NXT_INSTANTIATE_TEST(IndexFormatTest, MetalBackend, OpenGLBackend)
+NXT_INSTANTIATE_TEST(IndexFormatTest, MetalBackend, OpenGLBackend, VulkanBackend)
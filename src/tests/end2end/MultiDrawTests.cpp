@@ -0,0 +1,195 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "utils/NXTHelpers.h"
+
+constexpr uint32_t kRTSize = 400;
+
+// The tests draw some of the quarters of the render target, each in its own sub-draw, and check
+// that exactly the drawn quarters are green.
+class MultiDrawTest : public NXTTest {
+    protected:
+        void SetUp() override {
+            NXTTest::SetUp();
+
+            renderpass = device.CreateRenderPassBuilder()
+                .SetAttachmentCount(1)
+                .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+                .SetSubpassCount(1)
+                .SubpassSetColorAttachment(0, 0, 0)
+                .GetResult();
+
+            renderTarget = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kRTSize, kRTSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+                .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+                .GetResult();
+
+            nxt::TextureView renderTargetView = renderTarget.CreateTextureViewBuilder().GetResult();
+
+            framebuffer = device.CreateFramebufferBuilder()
+                .SetRenderPass(renderpass)
+                .SetAttachment(0, renderTargetView)
+                .SetDimensions(kRTSize, kRTSize)
+                .GetResult();
+
+            nxt::InputState inputState = device.CreateInputStateBuilder()
+                .SetInput(0, 2 * sizeof(float), nxt::InputStepMode::Vertex)
+                .SetAttribute(0, 0, nxt::VertexFormat::FloatR32G32, 0)
+                .GetResult();
+
+            nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                layout(location = 0) in vec2 pos;
+                void main() {
+                    gl_Position = vec4(pos, 0.0, 1.0);
+                })"
+            );
+
+            nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.0, 1.0, 0.0, 1.0);
+                })"
+            );
+
+            pipeline = device.CreateRenderPipelineBuilder()
+                .SetSubpass(renderpass, 0)
+                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                .SetInputState(inputState)
+                .GetResult();
+        }
+
+        // Checks the center of each quarter of the render target, in the order top-left,
+        // top-right, bottom-left, bottom-right.
+        void CheckQuarters(bool topLeft, bool topRight, bool bottomLeft, bool bottomRight) {
+            const bool drawn[4] = {topLeft, topRight, bottomLeft, bottomRight};
+            const uint32_t x[4] = {kRTSize / 4, 3 * kRTSize / 4, kRTSize / 4, 3 * kRTSize / 4};
+            const uint32_t y[4] = {kRTSize / 4, kRTSize / 4, 3 * kRTSize / 4, 3 * kRTSize / 4};
+            for (uint32_t i = 0; i < 4; ++i) {
+                RGBA8 expected = drawn[i] ? RGBA8(0, 255, 0, 255) : RGBA8(0, 0, 0, 0);
+                EXPECT_PIXEL_RGBA8_EQ(expected, renderTarget, x[i], y[i]) << "quarter " << i;
+            }
+        }
+
+        nxt::RenderPass renderpass;
+        nxt::Texture renderTarget;
+        nxt::Framebuffer framebuffer;
+        nxt::RenderPipeline pipeline;
+};
+
+// Test that each sub-draw of MultiDrawArrays uses its own vertex count and first vertex
+TEST_P(MultiDrawTest, MultiDrawArrays) {
+    // Two triangles per quarter, in the order top-left, top-right, bottom-left, bottom-right.
+    nxt::Buffer vertexBuffer = utils::CreateFrozenBufferFromData<float>(device, nxt::BufferUsageBit::Vertex, {
+        -1.0f,  1.0f,  0.0f,  1.0f, -1.0f,  0.0f,    0.0f,  1.0f,  0.0f,  0.0f, -1.0f,  0.0f,
+         0.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f,    1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  0.0f,
+        -1.0f,  0.0f,  0.0f,  0.0f, -1.0f, -1.0f,    0.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f,
+         0.0f,  0.0f,  1.0f,  0.0f,  0.0f, -1.0f,    1.0f,  0.0f,  1.0f, -1.0f,  0.0f, -1.0f,
+    });
+
+    // Skip the bottom-left quarter.
+    uint32_t vertexCounts[3] = {6, 6, 6};
+    uint32_t firstVertices[3] = {0, 6, 18};
+
+    uint32_t zeroOffset = 0;
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetVertexBuffers(0, 1, &vertexBuffer, &zeroOffset)
+            .MultiDrawArrays(3, vertexCounts, firstVertices, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+
+    CheckQuarters(true, true, false, true);
+}
+
+// Test that each sub-draw of MultiDrawElements uses its own index count and first index
+TEST_P(MultiDrawTest, MultiDrawElements) {
+    // The corners of the quarters, in the order top-left, top-right, bottom-left, bottom-right.
+    nxt::Buffer vertexBuffer = utils::CreateFrozenBufferFromData<float>(device, nxt::BufferUsageBit::Vertex, {
+        -1.0f,  1.0f,  0.0f,  1.0f, -1.0f,  0.0f,  0.0f,  0.0f,
+         0.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f,  0.0f,
+        -1.0f,  0.0f,  0.0f,  0.0f, -1.0f, -1.0f,  0.0f, -1.0f,
+         0.0f,  0.0f,  1.0f,  0.0f,  0.0f, -1.0f,  1.0f, -1.0f,
+    });
+    nxt::Buffer indexBuffer = utils::CreateFrozenBufferFromData<uint32_t>(device, nxt::BufferUsageBit::Index, {
+        0,  1,  2,  1,  3,  2,
+        4,  5,  6,  5,  7,  6,
+        8,  9, 10,  9, 11, 10,
+       12, 13, 14, 13, 15, 14,
+    });
+
+    // Only draw the top-right and bottom-left quarters.
+    uint32_t indexCounts[2] = {6, 6};
+    uint32_t firstIndices[2] = {6, 12};
+
+    uint32_t zeroOffset = 0;
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetVertexBuffers(0, 1, &vertexBuffer, &zeroOffset)
+            .SetIndexBuffer(indexBuffer, 0)
+            .MultiDrawElements(2, indexCounts, firstIndices, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+
+    CheckQuarters(false, true, true, false);
+}
+
+// Test instanced multi-draws, which the OpenGL backend submits one draw at a time
+TEST_P(MultiDrawTest, Instanced) {
+    nxt::Buffer vertexBuffer = utils::CreateFrozenBufferFromData<float>(device, nxt::BufferUsageBit::Vertex, {
+        -1.0f,  1.0f,  0.0f,  1.0f, -1.0f,  0.0f,    0.0f,  1.0f,  0.0f,  0.0f, -1.0f,  0.0f,
+         0.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f,    1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  0.0f,
+        -1.0f,  0.0f,  0.0f,  0.0f, -1.0f, -1.0f,    0.0f,  0.0f,  0.0f, -1.0f, -1.0f, -1.0f,
+         0.0f,  0.0f,  1.0f,  0.0f,  0.0f, -1.0f,    1.0f,  0.0f,  1.0f, -1.0f,  0.0f, -1.0f,
+    });
+
+    uint32_t vertexCounts[2] = {6, 6};
+    uint32_t firstVertices[2] = {0, 18};
+
+    uint32_t zeroOffset = 0;
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetVertexBuffers(0, 1, &vertexBuffer, &zeroOffset)
+            .MultiDrawArrays(2, vertexCounts, firstVertices, 2, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+
+    CheckQuarters(true, false, false, true);
+}
+
+NXT_INSTANTIATE_TEST(MultiDrawTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -0,0 +1,167 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "common/Assert.h"
+#include "utils/NXTHelpers.h"
+
+constexpr static unsigned int kRTSize = 16;
+constexpr static unsigned int kSampleCount = 4;
+
+namespace {
+
+    // Checks that a pixel is partially covered by the green triangle drawn on a transparent black
+    // background, which is only possible if its samples were averaged by the resolve.
+    class ExpectPartiallyCovered : public detail::Expectation {
+        public:
+            testing::AssertionResult Check(const void* data, size_t size) override {
+                ASSERT(size == sizeof(RGBA8));
+                const RGBA8& pixel = *static_cast<const RGBA8*>(data);
+                if (pixel.r == 0 && pixel.b == 0 && pixel.g == pixel.a && pixel.g > 0 &&
+                    pixel.g < 255) {
+                    return testing::AssertionSuccess();
+                }
+                return testing::AssertionFailure()
+                       << "Expected a partially covered green pixel, got " << pixel << std::endl;
+            }
+    };
+
+}  // anonymous namespace
+
+class MultisampledRenderingTest : public NXTTest {
+    protected:
+        void SetUp() override {
+            NXTTest::SetUp();
+
+            nxt::Texture multisampledTexture = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kRTSize, kRTSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetSampleCount(kSampleCount)
+                .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+                .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+                .GetResult();
+            nxt::TextureView multisampledView =
+                multisampledTexture.CreateTextureViewBuilder().GetResult();
+
+            resolveTarget = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kRTSize, kRTSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+                .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+                .GetResult();
+            nxt::TextureView resolveView = resolveTarget.CreateTextureViewBuilder().GetResult();
+
+            // Only the resolved result is used so the multisampled contents are discarded.
+            renderpass = device.CreateRenderPassBuilder()
+                .SetAttachmentCount(2)
+                .SetSubpassCount(1)
+                .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                .AttachmentSetSampleCount(0, kSampleCount)
+                .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+                .AttachmentSetColorStoreOp(0, nxt::StoreOp::Discard)
+                .AttachmentSetFormat(1, nxt::TextureFormat::R8G8B8A8Unorm)
+                .SubpassSetColorAttachment(0, 0, 0)
+                .SubpassSetResolveAttachment(0, 0, 1)
+                .GetResult();
+
+            framebuffer = device.CreateFramebufferBuilder()
+                .SetRenderPass(renderpass)
+                .SetDimensions(kRTSize, kRTSize)
+                .SetAttachment(0, multisampledView)
+                .SetAttachment(1, resolveView)
+                .GetResult();
+            framebuffer.AttachmentSetClearColor(0, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        // Draws a green triangle pointing right whose slanted edges cross pixels partially. It is
+        // symmetric along the X axis so the covered pixels don't depend on the Y orientation.
+        nxt::CommandBuffer DrawTriangle() {
+            nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                void main() {
+                    const vec2 pos[3] = vec2[3](vec2(-1.f, -1.f), vec2(-1.f, 1.f), vec2(1.f, 0.f));
+                    gl_Position = vec4(pos[gl_VertexIndex], 0.f, 1.f);
+                })"
+            );
+
+            nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.f, 1.f, 0.f, 1.f);
+                })"
+            );
+
+            nxt::RenderPipeline pipeline = device.CreateRenderPipelineBuilder()
+                .SetSubpass(renderpass, 0)
+                .SetLayout(device.CreatePipelineLayoutBuilder().GetResult())
+                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                .SetSampleCount(kSampleCount)
+                .GetResult();
+
+            return device.CreateCommandBufferBuilder()
+                .BeginRenderPass(renderpass, framebuffer)
+                .BeginRenderSubpass()
+                    .SetRenderPipeline(pipeline)
+                    .DrawArrays(3, 1, 0, 0)
+                .EndRenderSubpass()
+                .EndRenderPass()
+                .GetResult();
+        }
+
+        nxt::Texture resolveTarget;
+        nxt::RenderPass renderpass;
+        nxt::Framebuffer framebuffer;
+};
+
+// Test that the clear of the multisampled attachment is resolved to the whole resolve target
+TEST_P(MultisampledRenderingTest, ResolveClear) {
+    framebuffer.AttachmentSetClearColor(0, 0.0f, 1.0f, 0.0f, 1.0f);
+
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    std::vector<RGBA8> expected(kRTSize * kRTSize, RGBA8(0, 255, 0, 255));
+    EXPECT_TEXTURE_RGBA8_EQ(expected.data(), resolveTarget, 0, 0, kRTSize, kRTSize, 0);
+}
+
+// Test that the edges of a triangle are anti-aliased by the resolve
+TEST_P(MultisampledRenderingTest, ResolveDraw) {
+    nxt::CommandBuffer commands = DrawTriangle();
+    queue.Submit(1, &commands);
+
+    // Fully covered and fully uncovered pixels
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8(0, 255, 0, 255), resolveTarget, 0, kRTSize / 2);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8(0, 0, 0, 0), resolveTarget, kRTSize - 1, 0);
+    EXPECT_PIXEL_RGBA8_EQ(RGBA8(0, 0, 0, 0), resolveTarget, kRTSize - 1, kRTSize - 1);
+
+    // The corners on the left are crossed by the slanted edges
+    AddTextureExpectation(__FILE__, __LINE__, resolveTarget, 0, 0, 1, 1, 0, sizeof(RGBA8),
+                          new ExpectPartiallyCovered());
+    AddTextureExpectation(__FILE__, __LINE__, resolveTarget, 0, kRTSize - 1, 1, 1, 0,
+                          sizeof(RGBA8), new ExpectPartiallyCovered());
+}
+
+NXT_INSTANTIATE_TEST(MultisampledRenderingTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
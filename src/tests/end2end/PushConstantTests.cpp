@@ -456,4 +456,4 @@ TEST_P(PushConstantTest, SimultaneousVertexAndFragmentConstants) {
 
     EXPECT_PIXEL_RGBA8_EQ(RGBA8(1, 1, 0, 0), renderTarget, 0, 0);
 }
-NXT_INSTANTIATE_TEST(PushConstantTest, MetalBackend, OpenGLBackend)
+NXT_INSTANTIATE_TEST(PushConstantTest, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -231,4 +231,100 @@ TEST_P(RenderPassLoadOpTests, ClearsOnlyOnFirstUsePerRenderPass) {
     EXPECT_TEXTURE_RGBA8_EQ(expectBlue.data(), renderTarget, kRTSize / 2, 0, kRTSize / 2, kRTSize, 0);
 }
 
-NXT_INSTANTIATE_TEST(RenderPassLoadOpTests, D3D12Backend, MetalBackend, OpenGLBackend)
+// Tests that an attachment whose contents were discarded can be cleared and stored again
+TEST_P(RenderPassLoadOpTests, ClearAfterDiscard) {
+    auto discardRenderpass = device.CreateRenderPassBuilder()
+        .SetAttachmentCount(1)
+        .SetSubpassCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+        .AttachmentSetColorStoreOp(0, nxt::StoreOp::Discard)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+    auto discardFramebuffer = device.CreateFramebufferBuilder()
+        .SetRenderPass(discardRenderpass)
+        .SetDimensions(kRTSize, kRTSize)
+        .SetAttachment(0, renderTargetView)
+        .GetResult();
+    discardFramebuffer.AttachmentSetClearColor(0, 0.0f, 0.0f, 1.0f, 1.0f); // blue
+
+    auto storeRenderpass = device.CreateRenderPassBuilder()
+        .SetAttachmentCount(1)
+        .SetSubpassCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+        .AttachmentSetColorStoreOp(0, nxt::StoreOp::Store)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+    auto storeFramebuffer = device.CreateFramebufferBuilder()
+        .SetRenderPass(storeRenderpass)
+        .SetDimensions(kRTSize, kRTSize)
+        .SetAttachment(0, renderTargetView)
+        .GetResult();
+    storeFramebuffer.AttachmentSetClearColor(0, 0.0f, 1.0f, 0.0f, 1.0f); // green
+
+    auto commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(discardRenderpass, discardFramebuffer)
+        .BeginRenderSubpass()
+            // Clear should occur implicitly
+            // Contents are discarded at the end of the render pass
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .BeginRenderPass(storeRenderpass, storeFramebuffer)
+        .BeginRenderSubpass()
+            // Clear should occur implicitly
+            // Store should occur implicitly
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+    EXPECT_TEXTURE_RGBA8_EQ(expectGreen.data(), renderTarget, 0, 0, kRTSize, kRTSize, 0);
+}
+
+// Tests that discarding an attachment doesn't affect the other attachments of the render pass
+TEST_P(RenderPassLoadOpTests, DiscardOnlyAffectsItsAttachment) {
+    nxt::Texture transientTarget = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(kRTSize, kRTSize, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    nxt::TextureView transientTargetView = transientTarget.CreateTextureViewBuilder().GetResult();
+
+    auto renderpass = device.CreateRenderPassBuilder()
+        .SetAttachmentCount(2)
+        .SetSubpassCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+        .AttachmentSetFormat(1, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorLoadOp(1, nxt::LoadOp::Clear)
+        .AttachmentSetColorStoreOp(1, nxt::StoreOp::Discard)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetColorAttachment(0, 1, 1)
+        .GetResult();
+    auto framebuffer = device.CreateFramebufferBuilder()
+        .SetRenderPass(renderpass)
+        .SetDimensions(kRTSize, kRTSize)
+        .SetAttachment(0, renderTargetView)
+        .SetAttachment(1, transientTargetView)
+        .GetResult();
+    framebuffer.AttachmentSetClearColor(0, 0.0f, 1.0f, 0.0f, 1.0f); // green
+    framebuffer.AttachmentSetClearColor(1, 0.0f, 0.0f, 1.0f, 1.0f); // blue
+
+    auto commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            // Clears should occur implicitly
+            // Only the first attachment is stored
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    queue.Submit(1, &commands);
+    EXPECT_TEXTURE_RGBA8_EQ(expectGreen.data(), renderTarget, 0, 0, kRTSize, kRTSize, 0);
+}
+
+NXT_INSTANTIATE_TEST(RenderPassLoadOpTests, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -0,0 +1,142 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <array>
+#include <cstring>
+
+class SpecializationConstantTest : public NXTTest {
+    protected:
+        void SetUp() override {
+            NXTTest::SetUp();
+
+            module = utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+                #version 450
+                layout(constant_id = 0) const uint a = 1;
+                layout(constant_id = 1) const int b = -2;
+                layout(constant_id = 2) const float c = 3.0;
+                layout(constant_id = 3) const bool d = false;
+                layout(std430, set = 0, binding = 0) buffer Result {
+                    uint result[4];
+                };
+                void main() {
+                    result[0] = a;
+                    result[1] = uint(b);
+                    result[2] = floatBitsToUint(c);
+                    result[3] = d ? 1u : 0u;
+                })"
+            );
+
+            bgl = device.CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Compute, nxt::BindingType::StorageBuffer, 0, 1)
+                .GetResult();
+
+            layout = device.CreatePipelineLayoutBuilder()
+                .SetBindGroupLayout(0, bgl)
+                .GetResult();
+        }
+
+        nxt::ComputePipeline MakePipeline(uint32_t count, const uint32_t* ids, const uint32_t* values) {
+            return device.CreateComputePipelineBuilder()
+                .SetLayout(layout)
+                .SetStage(nxt::ShaderStage::Compute, module, "main")
+                .SetStageSpecialization(nxt::ShaderStage::Compute, count, ids, values)
+                .GetResult();
+        }
+
+        // Runs the pipeline and checks it wrote the expected values of the constants
+        void RunAndCheck(const nxt::ComputePipeline& pipeline, const std::array<uint32_t, 4>& expected) {
+            nxt::Buffer buffer = device.CreateBufferBuilder()
+                .SetSize(sizeof(expected))
+                .SetAllowedUsage(nxt::BufferUsageBit::Storage | nxt::BufferUsageBit::TransferSrc)
+                .SetInitialUsage(nxt::BufferUsageBit::Storage)
+                .GetResult();
+
+            nxt::BufferView view = buffer.CreateBufferViewBuilder()
+                .SetExtent(0, sizeof(expected))
+                .GetResult();
+
+            nxt::BindGroup bindGroup = device.CreateBindGroupBuilder()
+                .SetLayout(bgl)
+                .SetUsage(nxt::BindGroupUsage::Frozen)
+                .SetBufferViews(0, 1, &view)
+                .GetResult();
+
+            nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+                .BeginComputePass()
+                    .SetComputePipeline(pipeline)
+                    .SetBindGroup(0, bindGroup)
+                    .Dispatch(1, 1, 1)
+                .EndComputePass()
+                .GetResult();
+
+            queue.Submit(1, &commands);
+
+            EXPECT_BUFFER_U32_RANGE_EQ(expected.data(), buffer, 0, expected.size());
+        }
+
+        static uint32_t FloatBits(float value) {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        nxt::ShaderModule module;
+        nxt::BindGroupLayout bgl;
+        nxt::PipelineLayout layout;
+};
+
+// Test that the default values of the constants are used when they aren't specialized
+TEST_P(SpecializationConstantTest, DefaultValues) {
+    nxt::ComputePipeline pipeline = MakePipeline(0, nullptr, nullptr);
+    RunAndCheck(pipeline, {{1, static_cast<uint32_t>(-2), FloatBits(3.0f), 0}});
+}
+
+// Test specializing constants of all the scalar types
+TEST_P(SpecializationConstantTest, AllTypes) {
+    uint32_t ids[] = {0, 1, 2, 3};
+    uint32_t values[] = {42, static_cast<uint32_t>(-7), FloatBits(0.5f), 1};
+
+    nxt::ComputePipeline pipeline = MakePipeline(4, ids, values);
+    RunAndCheck(pipeline, {{42, static_cast<uint32_t>(-7), FloatBits(0.5f), 1}});
+}
+
+// Test that constants that aren't specialized keep their default value
+TEST_P(SpecializationConstantTest, SomeConstants) {
+    uint32_t ids[] = {2, 0};
+    uint32_t values[] = {FloatBits(-1.0f), 5};
+
+    nxt::ComputePipeline pipeline = MakePipeline(2, ids, values);
+    RunAndCheck(pipeline, {{5, static_cast<uint32_t>(-2), FloatBits(-1.0f), 0}});
+}
+
+// Test that pipelines using different specializations of the same module don't share their shaders
+TEST_P(SpecializationConstantTest, DifferentSpecializationsOfAModule) {
+    uint32_t id = 0;
+    uint32_t value1 = 10;
+    uint32_t value2 = 20;
+
+    nxt::ComputePipeline pipeline1 = MakePipeline(1, &id, &value1);
+    nxt::ComputePipeline pipeline2 = MakePipeline(1, &id, &value2);
+    nxt::ComputePipeline pipelineDefault = MakePipeline(0, nullptr, nullptr);
+
+    RunAndCheck(pipeline1, {{10, static_cast<uint32_t>(-2), FloatBits(3.0f), 0}});
+    RunAndCheck(pipeline2, {{20, static_cast<uint32_t>(-2), FloatBits(3.0f), 0}});
+    RunAndCheck(pipelineDefault, {{1, static_cast<uint32_t>(-2), FloatBits(3.0f), 0}});
+}
+
+NXT_INSTANTIATE_TEST(SpecializationConstantTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -0,0 +1,122 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/NXTTest.h"
+
+#include <vector>
+
+class TextureSetSubDataTests : public NXTTest {
+    protected:
+        nxt::Texture CreateTexture(uint32_t width, uint32_t height, uint32_t levels) {
+            return device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(width, height, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(levels)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst)
+                .SetInitialUsage(nxt::TextureUsageBit::TransferDst)
+                .GetResult();
+        }
+
+        // Returns texel data where each texel is unique, using rowPitch bytes per row
+        std::vector<RGBA8> GetExpectedData(uint32_t width, uint32_t height, uint32_t seed) {
+            std::vector<RGBA8> data(width * height);
+            for (uint32_t y = 0; y < height; ++y) {
+                for (uint32_t x = 0; x < width; ++x) {
+                    data[x + y * width] = RGBA8(static_cast<uint8_t>(x + seed),
+                                                static_cast<uint8_t>(y + seed),
+                                                static_cast<uint8_t>(x * y),
+                                                static_cast<uint8_t>(seed));
+                }
+            }
+            return data;
+        }
+
+        void SetSubData(const nxt::Texture& texture, uint32_t level, uint32_t x, uint32_t y,
+                        uint32_t width, uint32_t height, const std::vector<RGBA8>& data) {
+            texture.SetSubData(level, x, y, width, height, 0,
+                               static_cast<uint32_t>(data.size() * sizeof(RGBA8)),
+                               reinterpret_cast<const uint8_t*>(data.data()));
+        }
+};
+
+// Test setting the whole texture
+TEST_P(TextureSetSubDataTests, FullTexture) {
+    constexpr uint32_t kSize = 64;
+    nxt::Texture texture = CreateTexture(kSize, kSize, 1);
+
+    std::vector<RGBA8> data = GetExpectedData(kSize, kSize, 0);
+    SetSubData(texture, 0, 0, 0, kSize, kSize, data);
+
+    EXPECT_TEXTURE_RGBA8_EQ(data.data(), texture, 0, 0, kSize, kSize, 0);
+}
+
+// Test setting a subregion of a mip level, using data with padding between rows
+TEST_P(TextureSetSubDataTests, SubRegionWithRowPitch) {
+    constexpr uint32_t kSize = 64;
+    constexpr uint32_t kRegionWidth = 13;
+    constexpr uint32_t kRegionHeight = 7;
+    constexpr uint32_t kRowPitch = 20 * sizeof(RGBA8);
+    nxt::Texture texture = CreateTexture(kSize, kSize, 2);
+
+    std::vector<RGBA8> expected = GetExpectedData(kRegionWidth, kRegionHeight, 17);
+    std::vector<RGBA8> data(kRowPitch / sizeof(RGBA8) * kRegionHeight);
+    for (uint32_t y = 0; y < kRegionHeight; ++y) {
+        for (uint32_t x = 0; x < kRegionWidth; ++x) {
+            data[x + y * kRowPitch / sizeof(RGBA8)] = expected[x + y * kRegionWidth];
+        }
+    }
+
+    texture.SetSubData(1, 5, 11, kRegionWidth, kRegionHeight, kRowPitch,
+                       static_cast<uint32_t>(data.size() * sizeof(RGBA8)),
+                       reinterpret_cast<const uint8_t*>(data.data()));
+
+    EXPECT_TEXTURE_RGBA8_EQ(expected.data(), texture, 5, 11, kRegionWidth, kRegionHeight, 1);
+}
+
+// Test that later calls to SetSubData overwrite previous ones
+TEST_P(TextureSetSubDataTests, ManySetSubData) {
+    constexpr uint32_t kSize = 32;
+    constexpr uint32_t kIterations = 100;
+    nxt::Texture texture = CreateTexture(kSize, kSize, 1);
+
+    std::vector<RGBA8> data;
+    for (uint32_t i = 0; i < kIterations; ++i) {
+        data = GetExpectedData(kSize, kSize, i);
+        SetSubData(texture, 0, 0, 0, kSize, kSize, data);
+    }
+
+    EXPECT_TEXTURE_RGBA8_EQ(data.data(), texture, 0, 0, kSize, kSize, 0);
+}
+
+// Test setting a texture with more data than fits in staging memory at once
+TEST_P(TextureSetSubDataTests, LargeSetSubData) {
+    constexpr uint32_t kWidth = 2048;
+    constexpr uint32_t kHeight = 1024;
+    nxt::Texture texture = CreateTexture(kWidth, kHeight, 1);
+
+    std::vector<RGBA8> data = GetExpectedData(kWidth, kHeight, 3);
+    SetSubData(texture, 0, 0, 0, kWidth, kHeight, data);
+
+    EXPECT_PIXEL_RGBA8_EQ(data[0], texture, 0, 0);
+    EXPECT_PIXEL_RGBA8_EQ(data[kWidth * kHeight - 1], texture, kWidth - 1, kHeight - 1);
+    EXPECT_TEXTURE_RGBA8_EQ(&data[kWidth * 500], texture, 0, 500, kWidth, 1, 0);
+}
+
+NXT_INSTANTIATE_TEST(TextureSetSubDataTests,
+                     D3D12Backend,
+                     MetalBackend,
+                     OpenGLBackend,
+                     VulkanBackend)
@@ -0,0 +1,228 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/NXTTest.h"
+
+#include "utils/NXTHelpers.h"
+
+#include <vector>
+
+constexpr static unsigned int kRTSize = 16;
+
+class ViewportAndScissorTest : public NXTTest {
+    protected:
+        void SetUp() override {
+            NXTTest::SetUp();
+
+            renderTarget = device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(kRTSize, kRTSize, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(1)
+                .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+                .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+                .GetResult();
+
+            renderpass = device.CreateRenderPassBuilder()
+                .SetAttachmentCount(1)
+                .SetSubpassCount(1)
+                .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+                .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+                .SubpassSetColorAttachment(0, 0, 0)
+                .GetResult();
+
+            framebuffer = device.CreateFramebufferBuilder()
+                .SetRenderPass(renderpass)
+                .SetDimensions(kRTSize, kRTSize)
+                .SetAttachment(0, renderTarget.CreateTextureViewBuilder().GetResult())
+                .GetResult();
+            framebuffer.AttachmentSetClearColor(0, 0.0f, 0.0f, 0.0f, 0.0f);
+
+            pipeline = MakePipeline(renderpass, 0);
+        }
+
+        // Creates a pipeline that draws a green quad covering the whole viewport
+        nxt::RenderPipeline MakePipeline(const nxt::RenderPass& pass, uint32_t subpass) {
+            nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                void main() {
+                    const vec2 pos[6] = vec2[6](
+                        vec2(-1, -1), vec2(1, -1), vec2(-1, 1),
+                        vec2(-1,  1), vec2(1, -1), vec2(1, 1));
+                    gl_Position = vec4(pos[gl_VertexIndex], 0.f, 1.f);
+                })"
+            );
+
+            nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.f, 1.f, 0.f, 1.f);
+                })"
+            );
+
+            return device.CreateRenderPipelineBuilder()
+                .SetSubpass(pass, subpass)
+                .SetLayout(device.CreatePipelineLayoutBuilder().GetResult())
+                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                .GetResult();
+        }
+
+        // Checks the render target is green in the rectangle and cleared to zero around it
+        void ExpectGreenRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+            std::vector<RGBA8> expected(kRTSize * kRTSize, RGBA8(0, 0, 0, 0));
+            for (uint32_t j = y; j < y + height; ++j) {
+                for (uint32_t i = x; i < x + width; ++i) {
+                    expected[j * kRTSize + i] = RGBA8(0, 255, 0, 255);
+                }
+            }
+            EXPECT_TEXTURE_RGBA8_EQ(expected.data(), renderTarget, 0, 0, kRTSize, kRTSize, 0);
+        }
+
+        nxt::Texture renderTarget;
+        nxt::RenderPass renderpass;
+        nxt::Framebuffer framebuffer;
+        nxt::RenderPipeline pipeline;
+};
+
+// Test that only the pixels inside the scissor rect are drawn
+TEST_P(ViewportAndScissorTest, ScissorRect) {
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetScissorRect(3, 5, 8, 4)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    ExpectGreenRect(3, 5, 8, 4);
+}
+
+// Test that the quad is mapped to the viewport
+TEST_P(ViewportAndScissorTest, Viewport) {
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetViewport(2.0f, 6.0f, 12.0f, 4.0f, 0.0f, 1.0f)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    ExpectGreenRect(2, 6, 12, 4);
+}
+
+// Test that drawing is clipped to the intersection of the viewport and scissor rect
+TEST_P(ViewportAndScissorTest, ViewportAndScissorRect) {
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetViewport(0.0f, 0.0f, 8.0f, 8.0f, 0.0f, 1.0f)
+            .SetScissorRect(4, 2, 12, 12)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    ExpectGreenRect(4, 2, 4, 6);
+}
+
+// Test that the viewport and scissor rect are reset to the whole framebuffer in later subpasses
+TEST_P(ViewportAndScissorTest, ResetInLaterSubpasses) {
+    nxt::RenderPass twoSubpasses = device.CreateRenderPassBuilder()
+        .SetAttachmentCount(1)
+        .SetSubpassCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorLoadOp(0, nxt::LoadOp::Clear)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetColorAttachment(1, 0, 0)
+        .GetResult();
+
+    nxt::Framebuffer twoSubpassesFramebuffer = device.CreateFramebufferBuilder()
+        .SetRenderPass(twoSubpasses)
+        .SetDimensions(kRTSize, kRTSize)
+        .SetAttachment(0, renderTarget.CreateTextureViewBuilder().GetResult())
+        .GetResult();
+    twoSubpassesFramebuffer.AttachmentSetClearColor(0, 0.0f, 0.0f, 0.0f, 0.0f);
+
+    nxt::RenderPipeline pipeline0 = MakePipeline(twoSubpasses, 0);
+    nxt::RenderPipeline pipeline1 = MakePipeline(twoSubpasses, 1);
+
+    // The second subpass draws the whole render target, not only the rect of the first subpass
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(twoSubpasses, twoSubpassesFramebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline0)
+            .SetViewport(2.0f, 2.0f, 4.0f, 4.0f, 0.0f, 1.0f)
+            .SetScissorRect(2, 2, 4, 4)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline1)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+    ExpectGreenRect(0, 0, kRTSize, kRTSize);
+}
+
+// Test that the viewport and scissor rect of a render pass don't apply to the load ops and draws
+// of the next render pass
+TEST_P(ViewportAndScissorTest, ResetInLaterRenderPasses) {
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .SetViewport(2.0f, 2.0f, 4.0f, 4.0f, 0.0f, 1.0f)
+            .SetScissorRect(2, 2, 4, 4)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+    ExpectGreenRect(2, 2, 4, 4);
+
+    // The whole render target is cleared
+    commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+    ExpectGreenRect(0, 0, 0, 0);
+
+    // The whole render target is drawn
+    commands = device.CreateCommandBufferBuilder()
+        .BeginRenderPass(renderpass, framebuffer)
+        .BeginRenderSubpass()
+            .SetRenderPipeline(pipeline)
+            .DrawArrays(6, 1, 0, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+    queue.Submit(1, &commands);
+    ExpectGreenRect(0, 0, kRTSize, kRTSize);
+}
+
+NXT_INSTANTIATE_TEST(ViewportAndScissorTest, D3D12Backend, MetalBackend, OpenGLBackend, VulkanBackend)
@@ -0,0 +1,171 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "backend/Device.h"
+
+#include <cstring>
+#include <vector>
+
+// Tests that consecutive buffer to buffer copies are gathered in as few backend copies as
+// possible. The null backend does one copy per batched region, like the OpenGL backend.
+class BufferCopyBatchingTest : public ValidationTest {
+    protected:
+        void SetUp() override {
+            ValidationTest::SetUp();
+            queue = device.CreateQueueBuilder().GetResult();
+            source = CreateBuffer(nxt::BufferUsageBit::TransferSrc);
+            destination = CreateBuffer(nxt::BufferUsageBit::TransferDst);
+        }
+
+        // Source buffers contain their index in each uint32_t, destination buffers are zeroed and
+        // can be mapped for reading.
+        nxt::Buffer CreateBuffer(nxt::BufferUsageBit usage) {
+            bool isSource = usage == nxt::BufferUsageBit::TransferSrc;
+            nxt::BufferUsageBit extraUsage =
+                isSource ? nxt::BufferUsageBit::TransferDst : nxt::BufferUsageBit::MapRead;
+            nxt::Buffer buffer = device.CreateBufferBuilder()
+                .SetSize(kBufferSize)
+                .SetAllowedUsage(usage | nxt::BufferUsageBit::TransferDst | extraUsage)
+                .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+            std::vector<uint32_t> data(kBufferSize / sizeof(uint32_t));
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = isSource ? static_cast<uint32_t>(i) : 0;
+            }
+            buffer.SetSubData(0, static_cast<uint32_t>(data.size()), data.data());
+            return buffer;
+        }
+
+        // Transitions are recorded first so that they don't split the copies in several batches
+        nxt::CommandBufferBuilder CreateCopyBuilder() {
+            nxt::CommandBufferBuilder builder = device.CreateCommandBufferBuilder();
+            builder.TransitionBufferUsage(source, nxt::BufferUsageBit::TransferSrc);
+            builder.TransitionBufferUsage(destination, nxt::BufferUsageBit::TransferDst);
+            return builder;
+        }
+
+        // Submits the commands and returns how many backend copies were made for them
+        uint64_t SubmitAndCountCopyCalls(const nxt::CommandBuffer& commands,
+                                         uint64_t expectedCommands) {
+            const backend::BackendCallCounters& counters =
+                reinterpret_cast<backend::DeviceBase*>(device.Get())->GetBackendCallCounters();
+            uint64_t commandsBefore = counters.bufferCopyCommands;
+            uint64_t callsBefore = counters.bufferCopyCalls;
+
+            queue.Submit(1, &commands);
+
+            EXPECT_EQ(expectedCommands, counters.bufferCopyCommands - commandsBefore);
+            return counters.bufferCopyCalls - callsBefore;
+        }
+
+        // Reads back the first `count` uint32_t of the destination buffer
+        std::vector<uint32_t> ReadDestination(uint32_t count) {
+            std::vector<uint32_t> result(count);
+            destination.TransitionUsage(nxt::BufferUsageBit::MapRead);
+            auto userdata = static_cast<nxtCallbackUserdata>(reinterpret_cast<uintptr_t>(&result));
+            destination.MapReadAsync(0, count * sizeof(uint32_t), OnMapRead, userdata);
+            queue.Submit(0, nullptr);
+            destination.Unmap();
+            return result;
+        }
+
+        static void OnMapRead(nxtBufferMapReadStatus status, const void* ptr,
+                              nxtCallbackUserdata userdata) {
+            ASSERT_EQ(NXT_BUFFER_MAP_READ_STATUS_SUCCESS, status);
+            auto result =
+                reinterpret_cast<std::vector<uint32_t>*>(static_cast<uintptr_t>(userdata));
+            memcpy(result->data(), ptr, result->size() * sizeof(uint32_t));
+        }
+
+        static constexpr uint32_t kBufferSize = 256;
+
+        nxt::Queue queue;
+        nxt::Buffer source;
+        nxt::Buffer destination;
+};
+
+// Test copies of contiguous ranges are merged in a single copy
+TEST_F(BufferCopyBatchingTest, ContiguousCopiesAreMerged) {
+    nxt::CommandBufferBuilder builder = CreateCopyBuilder();
+    for (uint32_t i = 0; i < 16; ++i) {
+        builder.CopyBufferToBuffer(source, i * 4, destination, i * 4, 4);
+    }
+    nxt::CommandBuffer commands = builder.GetResult();
+    ASSERT_EQ(1u, SubmitAndCountCopyCalls(commands, 16));
+
+    std::vector<uint32_t> result = ReadDestination(16);
+    for (uint32_t i = 0; i < 16; ++i) {
+        ASSERT_EQ(i, result[i]);
+    }
+}
+
+// Test copies to disjoint ranges are batched but each needs its own region
+TEST_F(BufferCopyBatchingTest, DisjointCopiesAreBatched) {
+    nxt::CommandBufferBuilder builder = CreateCopyBuilder();
+    for (uint32_t i = 0; i < 8; ++i) {
+        builder.CopyBufferToBuffer(source, i * 4, destination, (7 - i) * 8, 4);
+    }
+    nxt::CommandBuffer commands = builder.GetResult();
+    ASSERT_EQ(8u, SubmitAndCountCopyCalls(commands, 8));
+
+    std::vector<uint32_t> result = ReadDestination(16);
+    for (uint32_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(i, result[(7 - i) * 2]);
+        ASSERT_EQ(0u, result[(7 - i) * 2 + 1]);
+    }
+}
+
+// Test copies writing to the same range of the destination stay ordered
+TEST_F(BufferCopyBatchingTest, OverlappingCopiesStayOrdered) {
+    nxt::CommandBuffer commands = CreateCopyBuilder()
+        .CopyBufferToBuffer(source, 0, destination, 0, 8)
+        .CopyBufferToBuffer(source, 16, destination, 16, 8)
+        .CopyBufferToBuffer(source, 32, destination, 4, 8)
+        .GetResult();
+    ASSERT_EQ(3u, SubmitAndCountCopyCalls(commands, 3));
+
+    std::vector<uint32_t> result = ReadDestination(6);
+    ASSERT_EQ(0u, result[0]);
+    ASSERT_EQ(8u, result[1]);
+    ASSERT_EQ(9u, result[2]);
+    ASSERT_EQ(0u, result[3]);
+    ASSERT_EQ(4u, result[4]);
+    ASSERT_EQ(5u, result[5]);
+}
+
+// Test copies aren't batched across other commands or between different buffers
+TEST_F(BufferCopyBatchingTest, BatchesStopAtOtherCommands) {
+    nxt::Buffer otherDestination = CreateBuffer(nxt::BufferUsageBit::TransferDst);
+
+    nxt::CommandBuffer commands = CreateCopyBuilder()
+        .TransitionBufferUsage(otherDestination, nxt::BufferUsageBit::TransferDst)
+        .CopyBufferToBuffer(source, 0, destination, 0, 4)
+        .CopyBufferToBuffer(source, 4, otherDestination, 4, 4)
+        .CopyBufferToBuffer(source, 8, destination, 8, 4)
+        .TransitionBufferUsage(otherDestination, nxt::BufferUsageBit::MapRead)
+        .CopyBufferToBuffer(source, 12, destination, 12, 4)
+        .GetResult();
+    ASSERT_EQ(4u, SubmitAndCountCopyCalls(commands, 4));
+}
+
+// Test empty copies are counted but don't make backend copies
+TEST_F(BufferCopyBatchingTest, EmptyCopies) {
+    nxt::CommandBuffer commands = CreateCopyBuilder()
+        .CopyBufferToBuffer(source, 0, destination, 0, 0)
+        .CopyBufferToBuffer(source, 4, destination, 4, 0)
+        .GetResult();
+    ASSERT_EQ(0u, SubmitAndCountCopyCalls(commands, 2));
+}
@@ -326,6 +326,47 @@ TEST(CommandAllocator, IteratorReset) {
     }
 }
 
+// Test peeking at commands doesn't move the iterator, including across blocks and at the end
+TEST(CommandAllocator, Peek) {
+    CommandAllocator allocator;
+
+    const int kCommandCount = 4;
+    for (int i = 0; i < kCommandCount; i++) {
+        CommandBig* big = allocator.Allocate<CommandBig>(CommandType::Big);
+        big->buffer[0] = i;
+        CommandSmall* small = allocator.Allocate<CommandSmall>(CommandType::Small);
+        small->data = static_cast<uint16_t>(i);
+    }
+
+    CommandIterator iterator(std::move(allocator));
+    CommandType type;
+    for (int i = 0; i < kCommandCount; i++) {
+        ASSERT_TRUE(iterator.PeekCommandId(&type));
+        ASSERT_EQ(type, CommandType::Big);
+        ASSERT_EQ(iterator.PeekCommand<CommandBig>()->buffer[0], uint32_t(i));
+
+        ASSERT_TRUE(iterator.NextCommandId(&type));
+        ASSERT_EQ(type, CommandType::Big);
+        CommandBig* big = iterator.NextCommand<CommandBig>();
+        ASSERT_EQ(big->buffer[0], uint32_t(i));
+
+        ASSERT_TRUE(iterator.PeekCommandId(&type));
+        ASSERT_EQ(type, CommandType::Small);
+        ASSERT_EQ(iterator.PeekCommand<CommandSmall>()->data, i);
+
+        ASSERT_TRUE(iterator.NextCommandId(&type));
+        ASSERT_EQ(type, CommandType::Small);
+        CommandSmall* small = iterator.NextCommand<CommandSmall>();
+        ASSERT_EQ(small->data, i);
+    }
+
+    // Peeking past the last command leaves the iterator at the end
+    ASSERT_FALSE(iterator.PeekCommandId(&type));
+    ASSERT_FALSE(iterator.NextCommandId(&type));
+
+    iterator.DataWasDestroyed();
+}
+
 // Test iterating empty iterators
 TEST(CommandAllocator, EmptyIterator) {
     {
@@ -0,0 +1,201 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+#include "mock/mock_nxt.h"
+
+#include "wire/TerribleCommandBuffer.h"
+#include "wire/Wire.h"
+#include "wire/WireServerHost.h"
+
+#include <memory>
+#include <vector>
+
+using namespace testing;
+using namespace nxt::wire;
+
+class MockHostDeviceErrorCallback {
+    public:
+        MOCK_METHOD2(Call, void(const char* message, nxtCallbackUserdata userdata));
+};
+
+static MockHostDeviceErrorCallback* mockHostDeviceErrorCallback = nullptr;
+static void ToMockHostDeviceErrorCallback(const char* message, nxtCallbackUserdata userdata) {
+    mockHostDeviceErrorCallback->Call(message, userdata);
+}
+
+// Gives the commands of a client to the host when they are flushed.
+class HostSubmitSerializer : public CommandSerializer {
+    public:
+        HostSubmitSerializer(ServerHost* host) : mHost(host) {
+        }
+
+        void SetClient(ServerHost::ClientId client) {
+            mClient = client;
+        }
+
+        void* GetCmdSpace(size_t size) override {
+            size_t offset = mData.size();
+            mData.resize(offset + size);
+            return &mData[offset];
+        }
+
+        void Flush() override {
+            mLastSubmitSucceeded = mHost->SubmitCommands(mClient, mData.data(), mData.size());
+            mData.clear();
+        }
+
+        bool LastSubmitSucceeded() const {
+            return mLastSubmitSucceeded;
+        }
+
+    private:
+        ServerHost* mHost;
+        ServerHost::ClientId mClient = 0;
+        std::vector<uint8_t> mData;
+        bool mLastSubmitSucceeded = true;
+};
+
+class WireServerHostTests : public Test {
+    protected:
+        struct TestClient {
+            nxtDevice device;
+            CommandHandler* handler = nullptr;
+            HostSubmitSerializer* c2sBuf = nullptr;
+            TerribleCommandBuffer* s2cBuf = nullptr;
+            ServerHost::ClientId id;
+        };
+
+        void SetUp() override {
+            mockHostDeviceErrorCallback = new MockHostDeviceErrorCallback;
+
+            nxtProcTable mockProcs;
+            api.GetProcTableAndDevice(&mockProcs, &apiDevice);
+
+            // Each server registers the error callback of the shared device before handling commands.
+            EXPECT_CALL(api, OnDeviceSetErrorCallback(_, _, _)).Times(AnyNumber());
+            EXPECT_CALL(api, OnBuilderSetErrorCallback(_, _, _, _)).Times(AnyNumber());
+            EXPECT_CALL(api, DeviceTick(_)).Times(AnyNumber());
+
+            host = new ServerHost(2);
+            ServerHost::DeviceId hostDevice = host->AddDevice(apiDevice, mockProcs);
+
+            for (TestClient& client : clients) {
+                client.c2sBuf = new HostSubmitSerializer(host);
+                client.s2cBuf = new TerribleCommandBuffer();
+
+                nxtProcTable clientProcs;
+                client.handler = NewClientDevice(&clientProcs, &client.device, client.c2sBuf);
+                client.s2cBuf->SetHandler(client.handler);
+                client.id = host->AddClient(hostDevice, client.s2cBuf);
+                client.c2sBuf->SetClient(client.id);
+
+                // The client procs are the same for all client devices.
+                nxtSetProcs(&clientProcs);
+            }
+        }
+
+        void TearDown() override {
+            for (TestClient& client : clients) {
+                host->RemoveClient(client.id);
+            }
+            delete host;
+
+            nxtSetProcs(nullptr);
+            for (TestClient& client : clients) {
+                delete client.handler;
+                delete client.c2sBuf;
+                delete client.s2cBuf;
+            }
+            delete mockHostDeviceErrorCallback;
+        }
+
+        // Sends the client's commands and waits for them to be handled, so that the calls on the
+        // mock happen in a deterministic order.
+        void FlushClient(TestClient& client) {
+            client.c2sBuf->Flush();
+            host->WaitIdle();
+        }
+
+        MockProcTable api;
+        nxtDevice apiDevice;
+        ServerHost* host = nullptr;
+        TestClient clients[2];
+};
+
+// Test that clients of the same device have their own object IDs.
+TEST_F(WireServerHostTests, ClientsHaveSeparateObjects) {
+    nxtCommandBufferBuilder builder0 = nxtDeviceCreateCommandBufferBuilder(clients[0].device);
+    nxtCommandBufferBuilder builder1 = nxtDeviceCreateCommandBufferBuilder(clients[1].device);
+
+    nxtCommandBufferBuilder apiBuilder0 = api.GetNewCommandBufferBuilder();
+    nxtCommandBufferBuilder apiBuilder1 = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder0))
+        .WillOnce(Return(apiBuilder1));
+
+    FlushClient(clients[0]);
+    FlushClient(clients[1]);
+
+    // Both builders have the same ID on the wire but are different objects on the server.
+    nxtCommandBufferBuilderGetResult(builder1);
+    nxtCommandBufferBuilderGetResult(builder0);
+
+    nxtCommandBuffer apiCmdBuf0 = api.GetNewCommandBuffer();
+    nxtCommandBuffer apiCmdBuf1 = api.GetNewCommandBuffer();
+    EXPECT_CALL(api, CommandBufferBuilderGetResult(apiBuilder0)).WillOnce(Return(apiCmdBuf0));
+    EXPECT_CALL(api, CommandBufferBuilderGetResult(apiBuilder1)).WillOnce(Return(apiCmdBuf1));
+
+    FlushClient(clients[0]);
+    FlushClient(clients[1]);
+}
+
+// Test that a device error is reported to the client whose commands caused it.
+TEST_F(WireServerHostTests, DeviceErrorForwardedToCausingClient) {
+    nxtDeviceSetErrorCallback(clients[0].device, ToMockHostDeviceErrorCallback, 1);
+    nxtDeviceSetErrorCallback(clients[1].device, ToMockHostDeviceErrorCallback, 2);
+
+    nxtDeviceCreateBufferBuilder(clients[1].device);
+
+    EXPECT_CALL(api, DeviceCreateBufferBuilder(apiDevice))
+        .WillOnce(InvokeWithoutArgs([&]() -> nxtBufferBuilder {
+            api.CallDeviceErrorCallback(apiDevice, "Error :(");
+            return nullptr;
+        }));
+    EXPECT_CALL(*mockHostDeviceErrorCallback, Call(_, 1)).Times(0);
+    EXPECT_CALL(*mockHostDeviceErrorCallback, Call(_, 2)).Times(1);
+
+    FlushClient(clients[0]);
+    FlushClient(clients[1]);
+}
+
+// Test that a client sending invalid commands doesn't prevent others from being served.
+TEST_F(WireServerHostTests, InvalidCommandsOnlyAffectTheirClient) {
+    // A truncated command
+    std::vector<uint8_t> garbage(3, 0);
+    ASSERT_TRUE(host->SubmitCommands(clients[0].id, garbage.data(), garbage.size()));
+    host->WaitIdle();
+
+    nxtDeviceCreateCommandBufferBuilder(clients[0].device);
+    nxtDeviceCreateCommandBufferBuilder(clients[1].device);
+
+    nxtCommandBufferBuilder apiBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice)).WillOnce(Return(apiBuilder));
+
+    FlushClient(clients[0]);
+    ASSERT_FALSE(clients[0].c2sBuf->LastSubmitSucceeded());
+
+    FlushClient(clients[1]);
+    ASSERT_TRUE(clients[1].c2sBuf->LastSubmitSucceeded());
+}
@@ -16,8 +16,12 @@
 #include "mock/mock_nxt.h"
 
 #include "wire/TerribleCommandBuffer.h"
+#include "wire/TerribleTransferBuffer.h"
 #include "wire/Wire.h"
 
+#include <cstring>
+#include <vector>
+
 using namespace testing;
 using namespace nxt::wire;
 
@@ -76,12 +80,13 @@ class WireTestsBase : public Test {
 
             mS2cBuf = new TerribleCommandBuffer();
             mC2sBuf = new TerribleCommandBuffer(mWireServer);
+            transferBuf = new TerribleTransferBuffer();
 
-            mWireServer = NewServerCommandHandler(mockDevice, mockProcs, mS2cBuf);
+            mWireServer = NewServerCommandHandler(mockDevice, mockProcs, mS2cBuf, transferBuf);
             mC2sBuf->SetHandler(mWireServer);
 
             nxtProcTable clientProcs;
-            mWireClient = NewClientDevice(&clientProcs, &device, mC2sBuf);
+            mWireClient = NewClientDevice(&clientProcs, &device, mC2sBuf, transferBuf);
             nxtSetProcs(&clientProcs);
             mS2cBuf->SetHandler(mWireClient);
 
@@ -94,6 +99,7 @@ class WireTestsBase : public Test {
             delete mWireClient;
             delete mC2sBuf;
             delete mS2cBuf;
+            delete transferBuf;
             delete mockDeviceErrorCallback;
             delete mockBuilderErrorCallback;
             delete mockBufferMapReadCallback;
@@ -110,6 +116,7 @@ class WireTestsBase : public Test {
         MockProcTable api;
         nxtDevice apiDevice;
         nxtDevice device;
+        TerribleTransferBuffer* transferBuf = nullptr;
 
     private:
         bool mIgnoreSetCallbackCalls = false;
@@ -227,6 +234,178 @@ TEST_F(WireTests, ValueArrayArgument) {
     FlushClient();
 }
 
+// Test that large arrays of numerical values are sent through the transfer buffer
+TEST_F(WireTests, LargeValueArrayArgumentInTransferBuffer) {
+    std::vector<uint32_t> data(1024);
+    for (uint32_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 3;
+    }
+
+    nxtBufferBuilder builder = nxtDeviceCreateBufferBuilder(device);
+    nxtBuffer buffer = nxtBufferBuilderGetResult(builder);
+    nxtBufferSetSubData(buffer, 0, static_cast<uint32_t>(data.size()), data.data());
+
+    // Small arrays stay inline in the command stream
+    nxtBufferSetSubData(buffer, 0, 4, testPushConstantValues);
+
+    nxtBufferBuilder apiBuilder = api.GetNewBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+
+    nxtBuffer apiBuffer = api.GetNewBuffer();
+    EXPECT_CALL(api, BufferBuilderGetResult(apiBuilder))
+        .WillOnce(Return(apiBuffer));
+
+    EXPECT_CALL(api, BufferSetSubData(apiBuffer, 0, 1024, _))
+        .WillOnce(WithArg<3>(Invoke([&](const uint32_t* received) {
+            ASSERT_EQ(0, memcmp(data.data(), received, data.size() * sizeof(uint32_t)));
+        })));
+    EXPECT_CALL(api, BufferSetSubData(apiBuffer, 0, 4, ResultOf(CheckPushConstantValues, Eq(true))));
+
+    ASSERT_EQ(1u, transferBuf->GetLastAllocatedSerial());
+    ASSERT_EQ(0u, transferBuf->GetLastReleasedSerial());
+
+    FlushClient();
+
+    // The data was released once the server executed the command
+    ASSERT_EQ(1u, transferBuf->GetLastReleasedSerial());
+}
+
+// Test that transfer buffer memory is reused once the server released it
+TEST_F(WireTests, TransferBufferMemoryIsRecycled) {
+    std::vector<uint32_t> data(TerribleTransferBuffer::kDefaultChunkSize / sizeof(uint32_t) / 2);
+
+    nxtBufferBuilder builder = nxtDeviceCreateBufferBuilder(device);
+    nxtBuffer buffer = nxtBufferBuilderGetResult(builder);
+
+    nxtBufferBuilder apiBuilder = api.GetNewBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+
+    nxtBuffer apiBuffer = api.GetNewBuffer();
+    EXPECT_CALL(api, BufferBuilderGetResult(apiBuilder))
+        .WillOnce(Return(apiBuffer));
+
+    EXPECT_CALL(api, BufferSetSubData(apiBuffer, 0, static_cast<uint32_t>(data.size()), _))
+        .Times(12);
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            nxtBufferSetSubData(buffer, 0, static_cast<uint32_t>(data.size()), data.data());
+        }
+        FlushClient();
+    }
+
+    // Three uploads in flight need two chunks, which are reused after each flush.
+    ASSERT_EQ(2u, transferBuf->GetChunkCount());
+}
+
+// Test that the compact encoding of command buffer recording sends floats as-is
+TEST_F(WireTests, CompactCommandFloatArguments) {
+    nxtCommandBufferBuilder builder = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBufferBuilderSetBlendColor(builder, 0.0f, 0.25f, -1.5f, 1e20f);
+
+    nxtCommandBufferBuilder apiBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+
+    EXPECT_CALL(api, CommandBufferBuilderSetBlendColor(apiBuilder, 0.0f, 0.25f, -1.5f, 1e20f));
+
+    FlushClient();
+}
+
+// Test that the compact encoding of command buffer recording sends several arrays sharing a length
+TEST_F(WireTests, CompactCommandMultipleArrayArguments) {
+    const uint32_t indexCounts[3] = {3, 300, 0xFFFFFFFFu};
+    const uint32_t firstIndices[3] = {0, 128, 7};
+
+    nxtCommandBufferBuilder builder = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBufferBuilderMultiDrawElements(builder, 3, indexCounts, firstIndices, 2, 1);
+
+    nxtCommandBufferBuilder apiBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+
+    EXPECT_CALL(api, CommandBufferBuilderMultiDrawElements(apiBuilder, 3, _, _, 2, 1))
+        .WillOnce(WithArgs<2, 3>(Invoke([&](const uint32_t* counts, const uint32_t* firsts) {
+            ASSERT_EQ(0, memcmp(indexCounts, counts, sizeof(indexCounts)));
+            ASSERT_EQ(0, memcmp(firstIndices, firsts, sizeof(firstIndices)));
+        })));
+
+    FlushClient();
+}
+
+// Test that compact commands are recorded in the right builder when recording is interleaved
+TEST_F(WireTests, CompactCommandsInterleavedBuilders) {
+    nxtCommandBufferBuilder builder1 = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBufferBuilder builder2 = nxtDeviceCreateCommandBufferBuilder(device);
+
+    nxtCommandBufferBuilderDrawArrays(builder1, 3, 1, 0, 0);
+    nxtCommandBufferBuilderDrawArrays(builder2, 300, 1, 0, 0);
+    nxtCommandBufferBuilderDrawArrays(builder2, 0xFFFFFFFFu, 2, 0, 0);
+    nxtCommandBufferBuilderDrawArrays(builder1, 6, 1, 0, 0);
+
+    nxtCommandBufferBuilder apiBuilder1 = api.GetNewCommandBufferBuilder();
+    nxtCommandBufferBuilder apiBuilder2 = api.GetNewCommandBufferBuilder();
+    Sequence s;
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .InSequence(s)
+        .WillOnce(Return(apiBuilder1));
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .InSequence(s)
+        .WillOnce(Return(apiBuilder2));
+    EXPECT_CALL(api, CommandBufferBuilderDrawArrays(apiBuilder1, 3, 1, 0, 0)).InSequence(s);
+    EXPECT_CALL(api, CommandBufferBuilderDrawArrays(apiBuilder2, 300, 1, 0, 0)).InSequence(s);
+    EXPECT_CALL(api, CommandBufferBuilderDrawArrays(apiBuilder2, 0xFFFFFFFFu, 2, 0, 0)).InSequence(s);
+    EXPECT_CALL(api, CommandBufferBuilderDrawArrays(apiBuilder1, 6, 1, 0, 0)).InSequence(s);
+
+    FlushClient();
+}
+
+// Test that a builder reusing the ID of a destroyed builder gets the compact commands
+TEST_F(WireTests, CompactCommandsAfterBuilderIdReuse) {
+    nxtCommandBufferBuilder builder = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBufferBuilderDispatch(builder, 1, 2, 3);
+    nxtCommandBufferBuilderRelease(builder);
+
+    nxtCommandBufferBuilder apiBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+    EXPECT_CALL(api, CommandBufferBuilderDispatch(apiBuilder, 1, 2, 3));
+    EXPECT_CALL(api, CommandBufferBuilderRelease(apiBuilder));
+
+    FlushClient();
+
+    builder = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBufferBuilderDispatch(builder, 4, 5, 6);
+
+    apiBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+    EXPECT_CALL(api, CommandBufferBuilderDispatch(apiBuilder, 4, 5, 6));
+
+    FlushClient();
+}
+
+// Test that commands with arguments too large for the compact encoding are still sent
+TEST_F(WireTests, LargeCompactCommandFallback) {
+    std::vector<uint32_t> data(20000, 0xFFFFFFFFu);
+
+    nxtCommandBufferBuilder builder = nxtDeviceCreateCommandBufferBuilder(device);
+    nxtCommandBufferBuilderSetPushConstants(builder, NXT_SHADER_STAGE_BIT_VERTEX, 0, static_cast<uint32_t>(data.size()), data.data());
+
+    nxtCommandBufferBuilder apiBuilder = api.GetNewCommandBufferBuilder();
+    EXPECT_CALL(api, DeviceCreateCommandBufferBuilder(apiDevice))
+        .WillOnce(Return(apiBuilder));
+
+    EXPECT_CALL(api, CommandBufferBuilderSetPushConstants(apiBuilder, NXT_SHADER_STAGE_BIT_VERTEX, 0, 20000, _))
+        .WillOnce(WithArg<4>(Invoke([&](const uint32_t* received) {
+            ASSERT_EQ(0, memcmp(data.data(), received, data.size() * sizeof(uint32_t)));
+        })));
+
+    FlushClient();
+}
+
 // Test that the wire is able to send C strings
 TEST_F(WireTests, CStringArgument) {
     // Create shader module
@@ -313,6 +313,46 @@ TEST_F(CopySplitTest, TextureY) {
     }
 }
 
+TEST_F(CopySplitTest, TextureZ) {
+    for (TextureSpec textureSpec : kBaseTextureSpecs) {
+        for (uint32_t val : kCheckValues) {
+            textureSpec.z = val;
+            for (BufferSpec bufferSpec : BaseBufferSpecs(textureSpec)) {
+
+                TextureCopySplit copySplit = DoTest(textureSpec, bufferSpec);
+                if (HasFatalFailure()) {
+                    std::ostringstream message;
+                    message << "Failed generating splits: " << textureSpec << ", " << bufferSpec << std::endl
+                        << copySplit << std::endl;
+                    FAIL() << message.str();
+                }
+            }
+        }
+    }
+}
+
+// Copies of more than one slice are only split when the buffer offset is aligned
+TEST_F(CopySplitTest, TextureDepth) {
+    for (TextureSpec textureSpec : kBaseTextureSpecs) {
+        for (uint32_t val : kCheckValues) {
+            textureSpec.depth = val;
+            for (BufferSpec bufferSpec : BaseBufferSpecs(textureSpec)) {
+                if (bufferSpec.offset % D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT != 0) {
+                    continue;
+                }
+
+                TextureCopySplit copySplit = DoTest(textureSpec, bufferSpec);
+                if (HasFatalFailure()) {
+                    std::ostringstream message;
+                    message << "Failed generating splits: " << textureSpec << ", " << bufferSpec << std::endl
+                        << copySplit << std::endl;
+                    FAIL() << message.str();
+                }
+            }
+        }
+    }
+}
+
 TEST_F(CopySplitTest, TexelSize) {
     for (TextureSpec textureSpec : kBaseTextureSpecs) {
         for (uint32_t texelSize : {4, 8, 16, 32, 64}) {
@@ -0,0 +1,144 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "backend/null/MemoryAllocator.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace backend::null;
+
+namespace {
+
+    bool IsZero(const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            if (data[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const size_t kTestedSizes[] = {
+        0, 1, 16, 17, 100, 1000, 4096, 5000, 65536, 65537, 1024 * 1024 + 3,
+    };
+
+}  // anonymous namespace
+
+// Test that new allocations are zero-filled and don't overlap
+TEST(NullMemoryAllocatorTests, AllocationsAreZeroedAndDisjoint) {
+    MemoryAllocator allocator;
+
+    std::vector<MemoryAllocation> allocations(sizeof(kTestedSizes) / sizeof(kTestedSizes[0]));
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        ASSERT_TRUE(allocator.Allocate(kTestedSizes[i], &allocations[i]));
+        ASSERT_NE(nullptr, allocations[i].GetPointer());
+        ASSERT_TRUE(IsZero(allocations[i].GetPointer(), kTestedSizes[i]));
+        memset(allocations[i].GetPointer(), static_cast<int>(i + 1), kTestedSizes[i]);
+    }
+
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        for (size_t j = 0; j < kTestedSizes[i]; ++j) {
+            ASSERT_EQ(static_cast<uint8_t>(i + 1), allocations[i].GetPointer()[j]);
+        }
+        allocator.Free(&allocations[i]);
+        ASSERT_EQ(nullptr, allocations[i].GetPointer());
+    }
+}
+
+// Test that memory that is reused after being freed is zero-filled again
+TEST(NullMemoryAllocatorTests, ReusedAllocationsAreZeroed) {
+    MemoryAllocator allocator;
+
+    for (size_t size : kTestedSizes) {
+        MemoryAllocation allocation;
+        ASSERT_TRUE(allocator.Allocate(size, &allocation));
+        memset(allocation.GetPointer(), 0xFF, size);
+        allocator.Free(&allocation);
+
+        ASSERT_TRUE(allocator.Allocate(size, &allocation));
+        ASSERT_TRUE(IsZero(allocation.GetPointer(), size));
+        allocator.Free(&allocation);
+    }
+}
+
+// Test that freed arena blocks are reused for allocations of the same size class
+TEST(NullMemoryAllocatorTests, ArenaBlocksAreReused) {
+    MemoryAllocator allocator;
+
+    MemoryAllocation allocation;
+    ASSERT_TRUE(allocator.Allocate(100, &allocation));
+    uint8_t* pointer = allocation.GetPointer();
+    allocator.Free(&allocation);
+
+    ASSERT_TRUE(allocator.Allocate(128, &allocation));
+    ASSERT_EQ(pointer, allocation.GetPointer());
+    allocator.Free(&allocation);
+}
+
+// Test that many small allocations can be made, they are sub-allocated from shared arenas
+TEST(NullMemoryAllocatorTests, ManySmallAllocations) {
+    MemoryAllocator allocator;
+
+    std::vector<MemoryAllocation> allocations(1000000);
+    for (MemoryAllocation& allocation : allocations) {
+        ASSERT_TRUE(allocator.Allocate(64, &allocation));
+    }
+    for (MemoryAllocation& allocation : allocations) {
+        allocator.Free(&allocation);
+    }
+}
+
+// Test that a large allocation can be made and only the touched parts of it are used
+TEST(NullMemoryAllocatorTests, LargeAllocation) {
+    MemoryAllocator allocator;
+
+    const size_t kSize = size_t(1) << 30;
+    MemoryAllocation allocation;
+    ASSERT_TRUE(allocator.Allocate(kSize, &allocation));
+
+    uint8_t* data = allocation.GetPointer();
+    data[0] = 1;
+    data[kSize / 2] = 2;
+    data[kSize - 1] = 3;
+    ASSERT_EQ(1u, data[0]);
+    ASSERT_EQ(0u, data[kSize / 4]);
+    ASSERT_EQ(2u, data[kSize / 2]);
+    ASSERT_EQ(3u, data[kSize - 1]);
+
+    allocator.Free(&allocation);
+}
+
+// Test that moving an allocation transfers it, leaving the source empty
+TEST(NullMemoryAllocatorTests, MoveAllocation) {
+    MemoryAllocator allocator;
+
+    MemoryAllocation allocation;
+    ASSERT_TRUE(allocator.Allocate(100, &allocation));
+    uint8_t* pointer = allocation.GetPointer();
+
+    MemoryAllocation moved(std::move(allocation));
+    ASSERT_EQ(nullptr, allocation.GetPointer());
+    ASSERT_EQ(pointer, moved.GetPointer());
+
+    MemoryAllocation assigned;
+    assigned = std::move(moved);
+    ASSERT_EQ(nullptr, moved.GetPointer());
+    ASSERT_EQ(pointer, assigned.GetPointer());
+
+    allocator.Free(&assigned);
+}
@@ -103,3 +103,51 @@ TEST_F(BindGroupValidationTest, BufferViewOffset) {
             .GetResult();
     }
 }
+
+// Test that frozen bind groups with the same layout and bindings are the same object
+TEST_F(BindGroupValidationTest, FrozenBindGroupsAreDeduplicated) {
+    auto layout = device.CreateBindGroupLayoutBuilder()
+        .SetBindingsType(nxt::ShaderStageBit::Vertex, nxt::BindingType::UniformBuffer, 0, 1)
+        .GetResult();
+
+    auto buffer = device.CreateBufferBuilder()
+        .SetAllowedUsage(nxt::BufferUsageBit::Uniform)
+        .SetInitialUsage(nxt::BufferUsageBit::Uniform)
+        .SetSize(512)
+        .GetResult();
+
+    auto bufferView1 = buffer.CreateBufferViewBuilder()
+        .SetExtent(0, 256)
+        .GetResult();
+    auto bufferView2 = buffer.CreateBufferViewBuilder()
+        .SetExtent(256, 256)
+        .GetResult();
+
+    auto CreateBindGroup = [&](nxt::BindGroupUsage usage, const nxt::BufferView& view) {
+        return AssertWillBeSuccess(device.CreateBindGroupBuilder())
+            .SetLayout(layout)
+            .SetUsage(usage)
+            .SetBufferViews(0, 1, &view)
+            .GetResult();
+    };
+
+    nxt::BindGroup frozen1 = CreateBindGroup(nxt::BindGroupUsage::Frozen, bufferView1);
+    nxt::BindGroup frozen1Again = CreateBindGroup(nxt::BindGroupUsage::Frozen, bufferView1);
+    nxt::BindGroup frozen2 = CreateBindGroup(nxt::BindGroupUsage::Frozen, bufferView2);
+    ASSERT_EQ(frozen1.Get(), frozen1Again.Get());
+    ASSERT_NE(frozen1.Get(), frozen2.Get());
+
+    // Dynamic bind groups are never deduplicated
+    nxt::BindGroup dynamic1 = CreateBindGroup(nxt::BindGroupUsage::Dynamic, bufferView1);
+    nxt::BindGroup dynamic1Again = CreateBindGroup(nxt::BindGroupUsage::Dynamic, bufferView1);
+    ASSERT_NE(dynamic1.Get(), dynamic1Again.Get());
+    ASSERT_NE(dynamic1.Get(), frozen1.Get());
+
+    // The cached bind group is removed from the cache when it is destroyed, and a new one gets
+    // created and cached.
+    frozen1 = nxt::BindGroup();
+    frozen1Again = nxt::BindGroup();
+    nxt::BindGroup recreated = CreateBindGroup(nxt::BindGroupUsage::Frozen, bufferView1);
+    nxt::BindGroup recreatedAgain = CreateBindGroup(nxt::BindGroupUsage::Frozen, bufferView1);
+    ASSERT_EQ(recreated.Get(), recreatedAgain.Get());
+}
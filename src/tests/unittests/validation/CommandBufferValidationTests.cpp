@@ -63,3 +63,113 @@ TEST_F(CommandBufferValidationTest, RenderPass) {
         .BeginRenderPass(renderpass, framebuffer)
         .GetResult();
 }
+
+// Tests that attachment contents discarded by a render pass can't be read until they are rewritten
+TEST_F(CommandBufferValidationTest, DiscardedAttachmentContents) {
+    nxt::Texture texture = AssertWillBeSuccess(device.CreateTextureBuilder())
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(16, 16, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment |
+                         nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst)
+        .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    nxt::TextureView view = AssertWillBeSuccess(texture.CreateTextureViewBuilder()).GetResult();
+
+    nxt::Buffer upload = AssertWillBeSuccess(device.CreateBufferBuilder())
+        .SetSize(16 * 256)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferSrc)
+        .GetResult();
+    upload.FreezeUsage(nxt::BufferUsageBit::TransferSrc);
+    nxt::Buffer readback = AssertWillBeSuccess(device.CreateBufferBuilder())
+        .SetSize(16 * 256)
+        .SetAllowedUsage(nxt::BufferUsageBit::TransferDst)
+        .SetInitialUsage(nxt::BufferUsageBit::TransferDst)
+        .GetResult();
+    readback.FreezeUsage(nxt::BufferUsageBit::TransferDst);
+
+    struct Pass {
+        nxt::RenderPass renderpass;
+        nxt::Framebuffer framebuffer;
+    };
+    auto CreatePass = [&](nxt::LoadOp loadOp, nxt::StoreOp storeOp) {
+        Pass pass;
+        pass.renderpass = AssertWillBeSuccess(device.CreateRenderPassBuilder())
+            .SetAttachmentCount(1)
+            .SetSubpassCount(1)
+            .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+            .AttachmentSetColorLoadOp(0, loadOp)
+            .AttachmentSetColorStoreOp(0, storeOp)
+            .SubpassSetColorAttachment(0, 0, 0)
+            .GetResult();
+        pass.framebuffer = AssertWillBeSuccess(device.CreateFramebufferBuilder())
+            .SetRenderPass(pass.renderpass)
+            .SetDimensions(16, 16)
+            .SetAttachment(0, view)
+            .GetResult();
+        return pass;
+    };
+    Pass storePass = CreatePass(nxt::LoadOp::Clear, nxt::StoreOp::Store);
+    Pass discardPass = CreatePass(nxt::LoadOp::Clear, nxt::StoreOp::Discard);
+    Pass loadPass = CreatePass(nxt::LoadOp::Load, nxt::StoreOp::Store);
+
+    // Control case: stored contents can be read
+    AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(storePass.renderpass, storePass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+        .CopyTextureToBuffer(texture, 0, 0, 0, 16, 16, 1, 0, readback, 0, 256)
+        .GetResult();
+
+    // Discarded contents can't be copied from
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(discardPass.renderpass, discardPass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+        .CopyTextureToBuffer(texture, 0, 0, 0, 16, 16, 1, 0, readback, 0, 256)
+        .GetResult();
+
+    // Discarded contents can't be loaded by a render pass
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(discardPass.renderpass, discardPass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .BeginRenderPass(loadPass.renderpass, loadPass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    // Clearing the attachment in a render pass that stores it rewrites the contents
+    AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(discardPass.renderpass, discardPass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .BeginRenderPass(storePass.renderpass, storePass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+        .CopyTextureToBuffer(texture, 0, 0, 0, 16, 16, 1, 0, readback, 0, 256)
+        .GetResult();
+
+    // Copying to the texture rewrites the contents
+    AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(discardPass.renderpass, discardPass.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+        .CopyBufferToTexture(upload, 0, 256, texture, 0, 0, 0, 16, 16, 1, 0)
+        .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferSrc)
+        .CopyTextureToBuffer(texture, 0, 0, 0, 16, 16, 1, 0, readback, 0, 256)
+        .GetResult();
+}
@@ -42,7 +42,7 @@ class CopyCommandTest : public ValidationTest {
 
         uint32_t BufferSizeForTextureCopy(uint32_t width, uint32_t height, uint32_t depth) {
             uint32_t rowPitch = Align(width * 4, kTextureRowPitchAlignment);
-            return (rowPitch * (height - 1) + width) * depth;
+            return rowPitch * height * (depth - 1) + rowPitch * (height - 1) + width * 4;
         }
 };
 
@@ -186,7 +186,7 @@ TEST_F(CopyCommandTest_B2T, OutOfBoundsOnBuffer) {
             .GetResult();
     }
 
-    // OOB on the buffer because (row pitch * (height - 1) + width) * depth overflows
+    // OOB on the buffer because (row pitch * (height - 1) + width * 4) * depth overflows
     {
         nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
             .CopyBufferToTexture(source, 0, 512, destination, 0, 0, 0, 4, 3, 1, 0)
@@ -194,7 +194,7 @@ TEST_F(CopyCommandTest_B2T, OutOfBoundsOnBuffer) {
     }
 
     // Not OOB on the buffer although row pitch * height overflows
-    // but (row pitch * (height - 1) + width) * depth does not overlow
+    // but (row pitch * (height - 1) + width * 4) * depth does not overlow
     {
         uint32_t sourceBufferSize = BufferSizeForTextureCopy(7, 3, 1);
         ASSERT_TRUE(256 * 3 > sourceBufferSize) << "row pitch * height should overflow buffer";
@@ -451,7 +451,7 @@ TEST_F(CopyCommandTest_T2B, OutOfBoundsOnBuffer) {
             .GetResult();
     }
 
-    // OOB on the buffer because (row pitch * (height - 1) + width) * depth overflows
+    // OOB on the buffer because (row pitch * (height - 1) + width * 4) * depth overflows
     {
         nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
             .CopyTextureToBuffer(source, 0, 0, 0, 4, 3, 1, 0, destination, 0, 512)
@@ -459,7 +459,7 @@ TEST_F(CopyCommandTest_T2B, OutOfBoundsOnBuffer) {
     }
 
     // Not OOB on the buffer although row pitch * height overflows
-    // but (row pitch * (height - 1) + width) * depth does not overlow
+    // but (row pitch * (height - 1) + width * 4) * depth does not overlow
     {
         uint32_t destinationBufferSize = BufferSizeForTextureCopy(7, 3, 1);
         ASSERT_TRUE(256 * 3 > destinationBufferSize) << "row pitch * height should overflow buffer";
@@ -576,3 +576,202 @@ TEST_F(CopyCommandTest_T2B, IncorrectBufferOffset) {
     }
 }
 
+
+class CopyCommandTest_Compressed : public CopyCommandTest {
+};
+
+// Test copies to and from compressed textures must cover whole blocks, except at the edge of a mip
+TEST_F(CopyCommandTest_Compressed, BlockAlignment) {
+    nxt::Buffer source = CreateFrozenBuffer(256 * 4, nxt::BufferUsageBit::TransferSrc);
+    nxt::Buffer destination = CreateFrozenBuffer(256 * 4, nxt::BufferUsageBit::TransferDst);
+    nxt::Texture dstTexture = CreateFrozen2DTexture(16, 16, 5, nxt::TextureFormat::Bc1RGBAUnorm,
+                                                    nxt::TextureUsageBit::TransferDst);
+    nxt::Texture srcTexture = CreateFrozen2DTexture(16, 16, 5, nxt::TextureFormat::Bc1RGBAUnorm,
+                                                    nxt::TextureUsageBit::TransferSrc);
+
+    // Block aligned regions and regions touching the edge of small mips are valid
+    {
+        nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 16, 16, 1, 0)
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 4, 8, 0, 8, 4, 1, 0)
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 2, 2, 1, 3)
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 1, 1, 1, 4)
+            .CopyTextureToBuffer(srcTexture, 4, 4, 0, 4, 4, 1, 0, destination, 0, 256)
+            .CopyTextureToBuffer(srcTexture, 0, 0, 0, 2, 2, 1, 3, destination, 0, 256)
+            .GetResult();
+    }
+
+    // Origin not on a block boundary
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 2, 0, 0, 4, 4, 1, 0)
+            .GetResult();
+    }
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyTextureToBuffer(srcTexture, 0, 1, 0, 4, 4, 1, 0, destination, 0, 256)
+            .GetResult();
+    }
+
+    // Partial blocks in the middle of the mip
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 6, 4, 1, 0)
+            .GetResult();
+    }
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyTextureToBuffer(srcTexture, 0, 0, 0, 4, 3, 1, 0, destination, 0, 256)
+            .GetResult();
+    }
+}
+
+// Test the buffer footprint of compressed copies is computed in rows of blocks
+TEST_F(CopyCommandTest_Compressed, BufferLayout) {
+    // Two rows of 4x4 BC1 blocks, 8 bytes per block
+    uint32_t bufferSize = 256 + 8;
+    nxt::Buffer source = CreateFrozenBuffer(bufferSize, nxt::BufferUsageBit::TransferSrc);
+    nxt::Texture destination = CreateFrozen2DTexture(16, 16, 1, nxt::TextureFormat::Bc1RGBAUnorm,
+                                                     nxt::TextureUsageBit::TransferDst);
+
+    // The copy exactly fits in the buffer, the offset is a multiple of the block size
+    {
+        nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, destination, 0, 0, 0, 4, 8, 1, 0)
+            .CopyBufferToTexture(source, 8, 256, destination, 0, 0, 0, 4, 4, 1, 0)
+            .GetResult();
+    }
+
+    // OOB on the buffer because of the offset
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 8, 256, destination, 0, 0, 0, 4, 8, 1, 0)
+            .GetResult();
+    }
+
+    // Offset isn't a multiple of the block size
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 4, 256, destination, 0, 0, 0, 4, 4, 1, 0)
+            .GetResult();
+    }
+
+    // Row pitch is smaller than a row of blocks
+    {
+        nxt::Buffer bigSource = CreateFrozenBuffer(256 * 64, nxt::BufferUsageBit::TransferSrc);
+        nxt::Texture bigDestination = CreateFrozen2DTexture(
+            256, 4, 1, nxt::TextureFormat::Bc7RGBAUnorm, nxt::TextureUsageBit::TransferDst);
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(bigSource, 0, 256, bigDestination, 0, 0, 0, 256, 4, 1, 0)
+            .GetResult();
+    }
+}
+
+class CopyCommandTest_Layered : public CopyCommandTest {
+    protected:
+        nxt::Texture CreateFrozenLayeredTexture(nxt::TextureDimension dimension, uint32_t depth,
+                                                uint32_t levels, nxt::TextureUsageBit usage) {
+            nxt::Texture tex = AssertWillBeSuccess(device.CreateTextureBuilder())
+                .SetDimension(dimension)
+                .SetExtent(16, 16, depth)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(levels)
+                .SetAllowedUsage(usage)
+                .GetResult();
+            tex.FreezeUsage(usage);
+            return tex;
+        }
+};
+
+// Test copies to and from ranges of layers of 2D array textures
+TEST_F(CopyCommandTest_Layered, ArrayLayers) {
+    uint32_t bufferSize = BufferSizeForTextureCopy(16, 16, 6);
+    nxt::Buffer source = CreateFrozenBuffer(bufferSize, nxt::BufferUsageBit::TransferSrc);
+    nxt::Buffer destination = CreateFrozenBuffer(bufferSize, nxt::BufferUsageBit::TransferDst);
+    nxt::Texture dstTexture = CreateFrozenLayeredTexture(nxt::TextureDimension::e2DArray, 6, 2,
+                                                         nxt::TextureUsageBit::TransferDst);
+    nxt::Texture srcTexture = CreateFrozenLayeredTexture(nxt::TextureDimension::e2DArray, 6, 2,
+                                                         nxt::TextureUsageBit::TransferSrc);
+
+    // All layers at once, a range of layers and layers of a smaller mip are valid
+    {
+        nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 16, 16, 6, 0)
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 2, 16, 16, 3, 0)
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 5, 8, 8, 1, 1)
+            .CopyTextureToBuffer(srcTexture, 0, 0, 0, 16, 16, 6, 0, destination, 0, 256)
+            .CopyTextureToBuffer(srcTexture, 0, 0, 3, 8, 8, 3, 1, destination, 0, 256)
+            .GetResult();
+    }
+
+    // Layer range out of the texture
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 4, 16, 16, 3, 0)
+            .GetResult();
+    }
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyTextureToBuffer(srcTexture, 0, 0, 6, 16, 16, 1, 0, destination, 0, 256)
+            .GetResult();
+    }
+
+    // Copies of no layers
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 16, 16, 0, 0)
+            .GetResult();
+    }
+}
+
+// Test copies to and from 3D textures are bounded by the depth of the mip level
+TEST_F(CopyCommandTest_Layered, Texture3D) {
+    uint32_t bufferSize = BufferSizeForTextureCopy(16, 16, 8);
+    nxt::Buffer source = CreateFrozenBuffer(bufferSize, nxt::BufferUsageBit::TransferSrc);
+    nxt::Buffer destination = CreateFrozenBuffer(bufferSize, nxt::BufferUsageBit::TransferDst);
+    nxt::Texture dstTexture = CreateFrozenLayeredTexture(nxt::TextureDimension::e3D, 8, 2,
+                                                         nxt::TextureUsageBit::TransferDst);
+    nxt::Texture srcTexture = CreateFrozenLayeredTexture(nxt::TextureDimension::e3D, 8, 2,
+                                                         nxt::TextureUsageBit::TransferSrc);
+
+    // Whole levels and sub-volumes are valid
+    {
+        nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 16, 16, 8, 0)
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 0, 8, 8, 4, 1)
+            .CopyTextureToBuffer(srcTexture, 2, 2, 5, 4, 4, 3, 0, destination, 0, 256)
+            .GetResult();
+    }
+
+    // Level 1 only has a depth of 4
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, dstTexture, 0, 0, 1, 8, 8, 4, 1)
+            .GetResult();
+    }
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyTextureToBuffer(srcTexture, 0, 0, 0, 8, 8, 5, 1, destination, 0, 256)
+            .GetResult();
+    }
+}
+
+// Test the buffer must contain one image per layer, with only the last row of the last image
+// allowed to be shorter than the row pitch
+TEST_F(CopyCommandTest_Layered, BufferSize) {
+    uint32_t bufferSize = BufferSizeForTextureCopy(4, 4, 3);
+    nxt::Buffer source = CreateFrozenBuffer(bufferSize, nxt::BufferUsageBit::TransferSrc);
+    nxt::Texture destination = CreateFrozenLayeredTexture(nxt::TextureDimension::e2DArray, 3, 1,
+                                                          nxt::TextureUsageBit::TransferDst);
+
+    {
+        nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 0, 256, destination, 0, 0, 0, 4, 4, 3, 0)
+            .GetResult();
+    }
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .CopyBufferToTexture(source, 4, 256, destination, 0, 0, 0, 4, 4, 3, 0)
+            .GetResult();
+    }
+}
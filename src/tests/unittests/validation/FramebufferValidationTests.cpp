@@ -225,3 +225,96 @@ TEST_F(FramebufferValidationTest, AttachmentFormatMatchTextureFormat) {
 
     // TODO(kainino@chromium.org): also check attachment samples, etc.
 }
+
+// Test that the sample count of the textures must match the one of the attachments
+TEST_F(FramebufferValidationTest, AttachmentSampleCountMatchTextureSampleCount) {
+    auto renderpass = AssertWillBeSuccess(device.CreateRenderPassBuilder())
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetSubpassCount(1)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    nxt::Texture multisampledTexture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(100, 100, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    nxt::TextureView multisampled = multisampledTexture.CreateTextureViewBuilder().GetResult();
+    nxt::TextureView singleSampled = Create2DAttachment(100, 100, nxt::TextureFormat::R8G8B8A8Unorm);
+
+    // Control case: the sample counts match
+    AssertWillBeSuccess(device.CreateFramebufferBuilder())
+        .SetRenderPass(renderpass)
+        .SetAttachment(0, multisampled)
+        .SetAttachment(1, singleSampled)
+        .SetDimensions(100, 100)
+        .GetResult();
+
+    // Error: single-sampled texture for a multisampled attachment
+    AssertWillBeError(device.CreateFramebufferBuilder())
+        .SetRenderPass(renderpass)
+        .SetAttachment(0, singleSampled)
+        .SetAttachment(1, singleSampled)
+        .SetDimensions(100, 100)
+        .GetResult();
+
+    // Error: multisampled texture for a single-sampled attachment
+    AssertWillBeError(device.CreateFramebufferBuilder())
+        .SetRenderPass(renderpass)
+        .SetAttachment(0, multisampled)
+        .SetAttachment(1, multisampled)
+        .SetDimensions(100, 100)
+        .GetResult();
+}
+
+// Test that resolve targets can only be single-layer views at layer 0
+TEST_F(FramebufferValidationTest, ResolveTargetLayers) {
+    auto renderpass = AssertWillBeSuccess(device.CreateRenderPassBuilder())
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetSubpassCount(1)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    nxt::Texture multisampledTexture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(100, 100, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .SetInitialUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    nxt::TextureView multisampled = multisampledTexture.CreateTextureViewBuilder().GetResult();
+
+    // Control case: a 2D texture, its view is its only layer
+    {
+        nxt::TextureView view = Create2DAttachment(100, 100, nxt::TextureFormat::R8G8B8A8Unorm);
+        AssertWillBeSuccess(device.CreateFramebufferBuilder())
+            .SetRenderPass(renderpass)
+            .SetAttachment(0, multisampled)
+            .SetAttachment(1, view)
+            .SetDimensions(100, 100)
+            .GetResult();
+    }
+
+    // Error: array textures, which have views of other layers, can't be output attachments
+    AssertWillBeError(device.CreateTextureBuilder())
+        .SetDimension(nxt::TextureDimension::e2DArray)
+        .SetExtent(100, 100, 3)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+}
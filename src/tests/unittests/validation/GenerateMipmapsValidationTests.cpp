@@ -0,0 +1,164 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+class GenerateMipmapsValidationTest : public ValidationTest {
+    protected:
+        nxt::Texture CreateFrozen2DTexture(uint32_t width, uint32_t height, uint32_t levels,
+                                           nxt::TextureFormat format,
+                                           nxt::TextureUsageBit allowedUsage,
+                                           nxt::TextureUsageBit frozenUsage) {
+            nxt::Texture tex = AssertWillBeSuccess(device.CreateTextureBuilder())
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(width, height, 1)
+                .SetFormat(format)
+                .SetMipLevels(levels)
+                .SetAllowedUsage(allowedUsage)
+                .GetResult();
+            tex.FreezeUsage(frozenUsage);
+            return tex;
+        }
+
+        // Mipmap generation reads from the texture as well as writing to it, so mipmappable
+        // textures can't be frozen in the TransferDst usage and are transitioned to it instead.
+        nxt::Texture Create2DTexture(uint32_t levels, nxt::TextureFormat format) {
+            return AssertWillBeSuccess(device.CreateTextureBuilder())
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(16, 16, 1)
+                .SetFormat(format)
+                .SetMipLevels(levels)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst)
+                .GetResult();
+        }
+
+        nxt::Texture CreateMipmappableTexture(uint32_t levels) {
+            return Create2DTexture(levels, nxt::TextureFormat::R8G8B8A8Unorm);
+        }
+};
+
+// Test the success cases for GenerateMipmaps
+TEST_F(GenerateMipmapsValidationTest, Success) {
+    nxt::Texture texture = CreateMipmappableTexture(5);
+
+    nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+        // The full mip chain
+        .GenerateMipmaps(texture, 0, 5)
+        // A subset of the chain
+        .GenerateMipmaps(texture, 1, 3)
+        .GenerateMipmaps(texture, 3, 2)
+        // A single level is a no-op
+        .GenerateMipmaps(texture, 4, 1)
+        .GetResult();
+}
+
+// Test GenerateMipmaps with level ranges that aren't in the texture
+TEST_F(GenerateMipmapsValidationTest, OutOfBounds) {
+    nxt::Texture texture = CreateMipmappableTexture(5);
+
+    // Empty range
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .GenerateMipmaps(texture, 0, 0)
+            .GetResult();
+    }
+
+    // Too many levels
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .GenerateMipmaps(texture, 0, 6)
+            .GetResult();
+    }
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .GenerateMipmaps(texture, 4, 2)
+            .GetResult();
+    }
+
+    // Level range overflowing 32 bits
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .GenerateMipmaps(texture, 1, 0xFFFFFFFF)
+            .GetResult();
+    }
+}
+
+// Test GenerateMipmaps with textures in the wrong usage
+TEST_F(GenerateMipmapsValidationTest, BadUsage) {
+    // Not in the TransferDst usage
+    {
+        nxt::Texture texture = CreateFrozen2DTexture(16, 16, 2, nxt::TextureFormat::R8G8B8A8Unorm,
+                                                     nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst,
+                                                     nxt::TextureUsageBit::TransferSrc);
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .GenerateMipmaps(texture, 0, 2)
+            .GetResult();
+    }
+
+    // TransferSrc isn't an allowed usage
+    {
+        nxt::Texture texture = CreateFrozen2DTexture(16, 16, 2, nxt::TextureFormat::R8G8B8A8Unorm,
+                                                     nxt::TextureUsageBit::TransferDst,
+                                                     nxt::TextureUsageBit::TransferDst);
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .GenerateMipmaps(texture, 0, 2)
+            .GetResult();
+    }
+
+    // Only some of the levels are in the TransferDst usage
+    {
+        nxt::Texture texture = CreateMipmappableTexture(4);
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureLevelsUsage(texture, 0, 2, nxt::TextureUsageBit::TransferDst)
+            .TransitionTextureLevelsUsage(texture, 2, 2, nxt::TextureUsageBit::TransferSrc)
+            .GenerateMipmaps(texture, 1, 2)
+            .GetResult();
+    }
+}
+
+// Test that only the generated levels and their source need to be in the TransferDst usage
+TEST_F(GenerateMipmapsValidationTest, OtherLevelsInAnyUsage) {
+    nxt::Texture texture = CreateMipmappableTexture(5);
+
+    nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .TransitionTextureLevelsUsage(texture, 0, 1, nxt::TextureUsageBit::TransferSrc)
+        .TransitionTextureLevelsUsage(texture, 1, 3, nxt::TextureUsageBit::TransferDst)
+        .TransitionTextureLevelsUsage(texture, 4, 1, nxt::TextureUsageBit::TransferSrc)
+        .GenerateMipmaps(texture, 1, 3)
+        .GetResult();
+}
+
+// Test GenerateMipmaps with formats that can't be filtered
+TEST_F(GenerateMipmapsValidationTest, UnfilterableFormat) {
+    {
+        nxt::Texture texture = Create2DTexture(2, nxt::TextureFormat::R8G8B8A8Uint);
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .GenerateMipmaps(texture, 0, 2)
+            .GetResult();
+    }
+    {
+        nxt::Texture texture = Create2DTexture(2, nxt::TextureFormat::D32FloatS8Uint);
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .GenerateMipmaps(texture, 0, 2)
+            .GetResult();
+    }
+}
@@ -0,0 +1,173 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/NXTHelpers.h"
+
+class MultiDrawValidationTest : public ValidationTest {
+    protected:
+        void SetUp() override {
+            ValidationTest::SetUp();
+
+            dummy = CreateDummyRenderPass();
+
+            nxt::ShaderModule vsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Vertex, R"(
+                #version 450
+                void main() {
+                    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+                })"
+            );
+
+            nxt::ShaderModule fsModule = utils::CreateShaderModule(device, nxt::ShaderStage::Fragment, R"(
+                #version 450
+                layout(location = 0) out vec4 fragColor;
+                void main() {
+                    fragColor = vec4(0.0, 1.0, 0.0, 1.0);
+                })");
+
+            pipeline = AssertWillBeSuccess(device.CreateRenderPipelineBuilder())
+                .SetSubpass(dummy.renderPass, 0)
+                .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+                .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+                .GetResult();
+
+            indexBuffer = AssertWillBeSuccess(device.CreateBufferBuilder())
+                .SetSize(256)
+                .SetAllowedUsage(nxt::BufferUsageBit::Index)
+                .GetResult();
+            indexBuffer.FreezeUsage(nxt::BufferUsageBit::Index);
+        }
+
+        DummyRenderPass dummy;
+        nxt::RenderPipeline pipeline;
+        nxt::Buffer indexBuffer;
+
+        uint32_t counts[3] = {3, 6, 3};
+        uint32_t firsts[3] = {0, 3, 9};
+};
+
+// Test the success cases of MultiDrawArrays and MultiDrawElements
+TEST_F(MultiDrawValidationTest, Success) {
+    AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .MultiDrawArrays(3, counts, firsts, 1, 0)
+        .SetIndexBuffer(indexBuffer, 0)
+        .MultiDrawElements(3, counts, firsts, 2, 1)
+        // A multi-draw without draws is a no-op
+        .MultiDrawArrays(0, nullptr, nullptr, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+}
+
+// Test that multi-draws need a render pipeline
+TEST_F(MultiDrawValidationTest, NoPipeline) {
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .MultiDrawArrays(3, counts, firsts, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .MultiDrawElements(3, counts, firsts, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+}
+
+// Test that multi-draws must happen in a render subpass
+TEST_F(MultiDrawValidationTest, OutsideSubpass) {
+    // Outside of a render pass
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .MultiDrawArrays(3, counts, firsts, 1, 0)
+        .GetResult();
+
+    // After the subpass that set the pipeline ended
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .EndRenderSubpass()
+        .MultiDrawArrays(3, counts, firsts, 1, 0)
+        .EndRenderPass()
+        .GetResult();
+
+    // In a compute pass
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginComputePass()
+        .MultiDrawArrays(3, counts, firsts, 1, 0)
+        .EndComputePass()
+        .GetResult();
+}
+
+// Test that the arrays must have an element per draw. All the arrays share the draw count so
+// they can only disagree with it by being missing.
+TEST_F(MultiDrawValidationTest, MissingArrays) {
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .MultiDrawArrays(3, counts, nullptr, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .MultiDrawArrays(3, nullptr, firsts, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .SetIndexBuffer(indexBuffer, 0)
+        .MultiDrawElements(3, nullptr, firsts, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+}
+
+// Test that MultiDrawElements needs an index buffer
+TEST_F(MultiDrawValidationTest, MultiDrawElementsWithoutIndexBuffer) {
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .MultiDrawElements(3, counts, firsts, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    // MultiDrawArrays doesn't need one
+    AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(dummy.renderPass, dummy.framebuffer)
+        .BeginRenderSubpass()
+        .SetRenderPipeline(pipeline)
+        .MultiDrawArrays(3, counts, firsts, 1, 0)
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+}
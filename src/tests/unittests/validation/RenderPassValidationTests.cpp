@@ -63,6 +63,25 @@ TEST_F(RenderPassValidationTest, AttachmentLoadOps) {
         .GetResult();
 }
 
+// Tests for setting attachment store ops
+TEST_F(RenderPassValidationTest, AttachmentStoreOps) {
+    AssertWillBeSuccess(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetColorStoreOp(0, nxt::StoreOp::Discard)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+
+    AssertWillBeSuccess(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::D32FloatS8Uint)
+        .AttachmentSetDepthStencilStoreOps(0, nxt::StoreOp::Discard, nxt::StoreOp::Store)
+        .SubpassSetDepthStencilAttachment(0, 0)
+        .GetResult();
+}
+
 // Test for attachment slot arguments out of bounds
 TEST_F(RenderPassValidationTest, AttachmentOutOfBounds) {
     // Control case
@@ -96,6 +115,22 @@ TEST_F(RenderPassValidationTest, AttachmentOutOfBounds) {
         .AttachmentSetDepthStencilLoadOps(1, nxt::LoadOp::Clear, nxt::LoadOp::Clear)
         .GetResult();
 
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        // Test AttachmentSetColorStoreOp slot out of bounds
+        .AttachmentSetColorStoreOp(1, nxt::StoreOp::Discard)
+        .GetResult();
+
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        // Test AttachmentSetDepthStencilStoreOps slot out of bounds
+        .AttachmentSetDepthStencilStoreOps(1, nxt::StoreOp::Discard, nxt::StoreOp::Discard)
+        .GetResult();
+
     AssertWillBeError(device.CreateRenderPassBuilder())
         .SetSubpassCount(1)
         .SetAttachmentCount(1)
@@ -157,3 +192,122 @@ TEST_F(RenderPassValidationTest, SubpassAttachmentWrongAspect) {
         .SubpassSetColorAttachment(0, 0, 0)
         .GetResult();
 }
+
+// Test the sample count of attachments and that the attachments of a subpass must match
+TEST_F(RenderPassValidationTest, AttachmentSampleCount) {
+    // Control case: multisampled color and depth-stencil attachments
+    AssertWillBeSuccess(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::D32FloatS8Uint)
+        .AttachmentSetSampleCount(1, 4)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetDepthStencilAttachment(0, 1)
+        .GetResult();
+
+    // Unsupported sample count
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 2)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+
+    // Color attachments with different sample counts
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::R8G8B8A8Unorm)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetColorAttachment(0, 1, 1)
+        .GetResult();
+
+    // Color and depth-stencil attachments with different sample counts
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::D32FloatS8Uint)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetDepthStencilAttachment(0, 1)
+        .GetResult();
+}
+
+// Test the constraints on resolve attachments
+TEST_F(RenderPassValidationTest, ResolveAttachments) {
+    auto CreateBuilder = [](nxt::RenderPassBuilder builder, nxt::TextureFormat format,
+                            uint32_t colorSampleCount, uint32_t resolveSampleCount) {
+        builder.SetSubpassCount(1)
+            .SetAttachmentCount(2)
+            .AttachmentSetFormat(0, format)
+            .AttachmentSetSampleCount(0, colorSampleCount)
+            .AttachmentSetFormat(1, format)
+            .AttachmentSetSampleCount(1, resolveSampleCount)
+            .SubpassSetColorAttachment(0, 0, 0);
+        return builder;
+    };
+
+    // Control case: resolving a multisampled attachment to a single-sampled attachment
+    CreateBuilder(AssertWillBeSuccess(device.CreateRenderPassBuilder()),
+                  nxt::TextureFormat::R8G8B8A8Unorm, 4, 1)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    // The resolve location must have a color attachment
+    CreateBuilder(AssertWillBeError(device.CreateRenderPassBuilder()),
+                  nxt::TextureFormat::R8G8B8A8Unorm, 4, 1)
+        .SubpassSetResolveAttachment(0, 1, 1)
+        .GetResult();
+
+    // The resolve location is set twice
+    CreateBuilder(AssertWillBeError(device.CreateRenderPassBuilder()),
+                  nxt::TextureFormat::R8G8B8A8Unorm, 4, 1)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    // Resolving from a single-sampled attachment or to a multisampled attachment
+    CreateBuilder(AssertWillBeError(device.CreateRenderPassBuilder()),
+                  nxt::TextureFormat::R8G8B8A8Unorm, 1, 1)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+    CreateBuilder(AssertWillBeError(device.CreateRenderPassBuilder()),
+                  nxt::TextureFormat::R8G8B8A8Unorm, 4, 4)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    // Integer formats can't be resolved
+    CreateBuilder(AssertWillBeError(device.CreateRenderPassBuilder()),
+                  nxt::TextureFormat::R8G8B8A8Uint, 4, 1)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    // The resolve attachment must have the same format as the color attachment
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::B8G8R8A8Unorm)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+
+    // The resolve attachment can't be rendered to in the same subpass
+    AssertWillBeError(device.CreateRenderPassBuilder())
+        .SetSubpassCount(1)
+        .SetAttachmentCount(2)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .AttachmentSetFormat(1, nxt::TextureFormat::R8G8B8A8Unorm)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .SubpassSetColorAttachment(0, 1, 1)
+        .SubpassSetResolveAttachment(0, 0, 1)
+        .GetResult();
+}
@@ -109,6 +109,48 @@ TEST_F(RenderPipelineValidationTest, CreationMissingProperty) {
     }
 }
 
+// Test that the sample count of the pipeline must match the one of its subpass
+TEST_F(RenderPipelineValidationTest, SampleCount) {
+    nxt::RenderPass multisampledRenderpass = AssertWillBeSuccess(device.CreateRenderPassBuilder())
+        .SetAttachmentCount(1)
+        .AttachmentSetFormat(0, nxt::TextureFormat::R8G8B8A8Unorm)
+        .AttachmentSetSampleCount(0, 4)
+        .SetSubpassCount(1)
+        .SubpassSetColorAttachment(0, 0, 0)
+        .GetResult();
+
+    // Control cases: the sample counts match
+    AddDefaultStates(AssertWillBeSuccess(device.CreateRenderPipelineBuilder()))
+        .SetSampleCount(1)
+        .GetResult();
+
+    AssertWillBeSuccess(device.CreateRenderPipelineBuilder())
+        .SetSubpass(multisampledRenderpass, 0)
+        .SetLayout(pipelineLayout)
+        .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+        .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+        .SetSampleCount(4)
+        .GetResult();
+
+    // Error case: the default sample count is 1
+    AssertWillBeError(device.CreateRenderPipelineBuilder())
+        .SetSubpass(multisampledRenderpass, 0)
+        .SetLayout(pipelineLayout)
+        .SetStage(nxt::ShaderStage::Vertex, vsModule, "main")
+        .SetStage(nxt::ShaderStage::Fragment, fsModule, "main")
+        .GetResult();
+
+    // Error case: multisampled pipeline in a single-sampled subpass
+    AddDefaultStates(AssertWillBeError(device.CreateRenderPipelineBuilder()))
+        .SetSampleCount(4)
+        .GetResult();
+
+    // Error case: unsupported sample count
+    AddDefaultStates(AssertWillBeError(device.CreateRenderPipelineBuilder()))
+        .SetSampleCount(3)
+        .GetResult();
+}
+
 TEST_F(RenderPipelineValidationTest, BlendState) {
     // Fails because blend state is set on a nonexistent color attachment
     {
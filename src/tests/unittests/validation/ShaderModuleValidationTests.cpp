@@ -0,0 +1,120 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/NXTHelpers.h"
+
+class ShaderModuleValidationTest : public ValidationTest {
+    protected:
+        void SetUp() override {
+            ValidationTest::SetUp();
+
+            CreateSimpleRenderPassAndFramebuffer(device, &renderpass, &framebuffer);
+
+            // GLSL can't have more than one entry point so the module is assembled by hand.
+            const uint32_t multipleEntryPoints[] = {
+                // Header: magic, version 1.0, generator, bound, schema
+                0x07230203, 0x00010000, 0x00000000, 7, 0,
+                // OpCapability Shader
+                0x00020011, 0x00000001,
+                // OpMemoryModel Logical GLSL450
+                0x0003000e, 0x00000000, 0x00000001,
+                // OpEntryPoint Vertex %3 "vs"
+                0x0004000f, 0x00000000, 0x00000003, 0x00007376,
+                // OpEntryPoint Fragment %5 "fs"
+                0x0004000f, 0x00000004, 0x00000005, 0x00007366,
+                // OpExecutionMode %5 OriginUpperLeft
+                0x00030010, 0x00000005, 0x00000007,
+                // %1 = OpTypeVoid
+                0x00020013, 0x00000001,
+                // %2 = OpTypeFunction %1
+                0x00030021, 0x00000002, 0x00000001,
+                // %3 = OpFunction %1 None %2
+                0x00050036, 0x00000001, 0x00000003, 0x00000000, 0x00000002,
+                // %4 = OpLabel
+                0x000200f8, 0x00000004,
+                // OpReturn
+                0x000100fd,
+                // OpFunctionEnd
+                0x00010038,
+                // %5 = OpFunction %1 None %2
+                0x00050036, 0x00000001, 0x00000005, 0x00000000, 0x00000002,
+                // %6 = OpLabel
+                0x000200f8, 0x00000006,
+                // OpReturn
+                0x000100fd,
+                // OpFunctionEnd
+                0x00010038,
+            };
+            module = device.CreateShaderModuleBuilder()
+                .SetSource(sizeof(multipleEntryPoints) / sizeof(uint32_t), multipleEntryPoints)
+                .GetResult();
+        }
+
+        nxt::RenderPipelineBuilder& AddDefaultStates(nxt::RenderPipelineBuilder&& builder) {
+            builder.SetSubpass(renderpass, 0)
+                .SetPrimitiveTopology(nxt::PrimitiveTopology::TriangleList);
+            return builder;
+        }
+
+        nxt::RenderPass renderpass;
+        nxt::Framebuffer framebuffer;
+        nxt::ShaderModule module;
+};
+
+// Test that the entry points of a module can be used in the stages of a pipeline
+TEST_F(ShaderModuleValidationTest, MultipleEntryPoints) {
+    AddDefaultStates(AssertWillBeSuccess(device.CreateRenderPipelineBuilder()))
+        .SetStage(nxt::ShaderStage::Vertex, module, "vs")
+        .SetStage(nxt::ShaderStage::Fragment, module, "fs")
+        .GetResult();
+}
+
+// Test that entry points can only be used for the stage of their execution model
+TEST_F(ShaderModuleValidationTest, EntryPointWrongStage) {
+    AddDefaultStates(AssertWillBeError(device.CreateRenderPipelineBuilder()))
+        .SetStage(nxt::ShaderStage::Vertex, module, "fs")
+        .SetStage(nxt::ShaderStage::Fragment, module, "fs")
+        .GetResult();
+
+    AddDefaultStates(AssertWillBeError(device.CreateRenderPipelineBuilder()))
+        .SetStage(nxt::ShaderStage::Vertex, module, "vs")
+        .SetStage(nxt::ShaderStage::Fragment, module, "vs")
+        .GetResult();
+}
+
+// Test that using an entry point that isn't in the module is an error
+TEST_F(ShaderModuleValidationTest, EntryPointNotInModule) {
+    AddDefaultStates(AssertWillBeError(device.CreateRenderPipelineBuilder()))
+        .SetStage(nxt::ShaderStage::Vertex, module, "main")
+        .SetStage(nxt::ShaderStage::Fragment, module, "fs")
+        .GetResult();
+
+    nxt::ShaderModule computeModule =
+        utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+        #version 450
+        void main() {
+        })"
+    );
+
+    // Control case: the GLSL entry point is main
+    AssertWillBeSuccess(device.CreateComputePipelineBuilder())
+        .SetStage(nxt::ShaderStage::Compute, computeModule, "main")
+        .GetResult();
+
+    AssertWillBeError(device.CreateComputePipelineBuilder())
+        .SetStage(nxt::ShaderStage::Compute, computeModule, "foo")
+        .GetResult();
+}
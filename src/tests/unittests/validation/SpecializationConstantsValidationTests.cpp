@@ -0,0 +1,158 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include "utils/NXTHelpers.h"
+
+class SpecializationConstantsValidationTest : public ValidationTest {
+    protected:
+        void SetUp() override {
+            ValidationTest::SetUp();
+
+            module = utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+                #version 450
+                layout(constant_id = 0) const uint a = 0;
+                layout(constant_id = 3) const float b = 1.0;
+                layout(constant_id = 7) const bool c = false;
+                layout(std430, set = 0, binding = 0) buffer Result {
+                    float result;
+                };
+                void main() {
+                    result = c ? float(a) : b;
+                })"
+            );
+
+            nxt::BindGroupLayout bgl = device.CreateBindGroupLayoutBuilder()
+                .SetBindingsType(nxt::ShaderStageBit::Compute, nxt::BindingType::StorageBuffer, 0, 1)
+                .GetResult();
+
+            layout = device.CreatePipelineLayoutBuilder()
+                .SetBindGroupLayout(0, bgl)
+                .GetResult();
+        }
+
+        nxt::ComputePipelineBuilder CreatePipelineBuilder(bool success) {
+            nxt::ComputePipelineBuilder builder;
+            if (success) {
+                builder = AssertWillBeSuccess(device.CreateComputePipelineBuilder());
+            } else {
+                builder = AssertWillBeError(device.CreateComputePipelineBuilder());
+            }
+            builder.SetLayout(layout);
+            return builder;
+        }
+
+        nxt::ShaderModule module;
+        nxt::PipelineLayout layout;
+};
+
+// Test that setting any subset of the specialization constants of the module is valid
+TEST_F(SpecializationConstantsValidationTest, Success) {
+    uint32_t ids[] = {7, 0, 3};
+    uint32_t values[] = {1, 42, 0x40000000};
+
+    // Setting no constant is the same as not setting the specialization
+    CreatePipelineBuilder(true)
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 0, nullptr, nullptr)
+        .GetResult();
+
+    // Setting some of the constants
+    CreatePipelineBuilder(true)
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 1, ids, values)
+        .GetResult();
+
+    // Setting all the constants, in any order
+    CreatePipelineBuilder(true)
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 3, ids, values)
+        .GetResult();
+}
+
+// Test that the specialization can only be set on a stage that is set
+TEST_F(SpecializationConstantsValidationTest, StageNotSet) {
+    uint32_t id = 0;
+    uint32_t value = 1;
+
+    CreatePipelineBuilder(false)
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 1, &id, &value)
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .GetResult();
+}
+
+// Test that the specialization of a stage can only be set once
+TEST_F(SpecializationConstantsValidationTest, SetTwice) {
+    uint32_t ids[] = {0, 3};
+    uint32_t values[] = {1, 2};
+
+    CreatePipelineBuilder(false)
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 1, &ids[0], &values[0])
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 1, &ids[1], &values[1])
+        .GetResult();
+}
+
+// Test that only constants that are in the module can be set
+TEST_F(SpecializationConstantsValidationTest, UnknownConstant) {
+    // Control case: constant 3 is in the module
+    {
+        uint32_t id = 3;
+        uint32_t value = 1;
+        CreatePipelineBuilder(true)
+            .SetStage(nxt::ShaderStage::Compute, module, "main")
+            .SetStageSpecialization(nxt::ShaderStage::Compute, 1, &id, &value)
+            .GetResult();
+    }
+
+    // Error case: constant 4 isn't in the module
+    {
+        uint32_t id = 4;
+        uint32_t value = 1;
+        CreatePipelineBuilder(false)
+            .SetStage(nxt::ShaderStage::Compute, module, "main")
+            .SetStageSpecialization(nxt::ShaderStage::Compute, 1, &id, &value)
+            .GetResult();
+    }
+}
+
+// Test that a constant can't be given two values
+TEST_F(SpecializationConstantsValidationTest, DuplicateConstant) {
+    uint32_t ids[] = {3, 0, 3};
+    uint32_t values[] = {1, 2, 3};
+
+    CreatePipelineBuilder(false)
+        .SetStage(nxt::ShaderStage::Compute, module, "main")
+        .SetStageSpecialization(nxt::ShaderStage::Compute, 3, ids, values)
+        .GetResult();
+}
+
+// Test that modules with specialization constants that aren't 32-bit scalars can't be used
+TEST_F(SpecializationConstantsValidationTest, Non32BitConstant) {
+    nxt::ShaderModule doubleModule = utils::CreateShaderModule(device, nxt::ShaderStage::Compute, R"(
+        #version 450
+        layout(constant_id = 0) const double a = 0.0;
+        layout(std430, set = 0, binding = 0) buffer Result {
+            float result;
+        };
+        void main() {
+            result = float(a);
+        })"
+    );
+
+    CreatePipelineBuilder(false)
+        .SetStage(nxt::ShaderStage::Compute, doubleModule, "main")
+        .GetResult();
+}
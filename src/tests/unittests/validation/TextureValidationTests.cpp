@@ -0,0 +1,383 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include <vector>
+
+class TextureValidationTest : public ValidationTest {
+    protected:
+        nxt::Texture CreateSetSubDataTexture(uint32_t width, uint32_t height, uint32_t levels) {
+            return device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(width, height, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(levels)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
+                .SetInitialUsage(nxt::TextureUsageBit::TransferDst)
+                .GetResult();
+        }
+};
+
+// Test the success cases for Texture::SetSubData
+TEST_F(TextureValidationTest, SetSubDataSuccess) {
+    nxt::Texture texture = CreateSetSubDataTexture(16, 8, 2);
+    std::vector<uint8_t> data(16 * 8 * 4);
+
+    // Full level 0, tightly packed with an implicit row pitch
+    texture.SetSubData(0, 0, 0, 16, 8, 0, data.size(), data.data());
+
+    // Full level 1, with an explicit row pitch
+    texture.SetSubData(1, 0, 0, 8, 4, 16 * 4, data.size(), data.data());
+
+    // Subregion
+    texture.SetSubData(0, 4, 2, 2, 2, 0, data.size(), data.data());
+
+    // Last row doesn't need to be padded to the row pitch
+    texture.SetSubData(0, 0, 0, 2, 2, 64, 64 + 2 * 4, data.data());
+
+    // Empty region
+    texture.SetSubData(0, 16, 8, 0, 0, 0, 0, data.data());
+}
+
+// Test error cases for SetSubData regions out of the texture
+TEST_F(TextureValidationTest, SetSubDataOutOfBounds) {
+    nxt::Texture texture = CreateSetSubDataTexture(16, 8, 2);
+    std::vector<uint8_t> data(16 * 8 * 4);
+
+    // Mip level doesn't exist
+    ASSERT_DEVICE_ERROR(texture.SetSubData(2, 0, 0, 1, 1, 0, data.size(), data.data()));
+
+    // Region too big for level 0
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 17, 8, 0, data.size(), data.data()));
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 15, 0, 2, 1, 0, data.size(), data.data()));
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 7, 1, 2, 0, data.size(), data.data()));
+
+    // Region too big for level 1
+    ASSERT_DEVICE_ERROR(texture.SetSubData(1, 0, 0, 16, 8, 0, data.size(), data.data()));
+
+    // Offset overflowing 32 bits
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0xFFFFFFFF, 0, 2, 1, 0, data.size(), data.data()));
+}
+
+// Test error cases for SetSubData with an invalid row pitch or not enough data
+TEST_F(TextureValidationTest, SetSubDataBadDataLayout) {
+    nxt::Texture texture = CreateSetSubDataTexture(16, 8, 1);
+    std::vector<uint8_t> data(16 * 8 * 4);
+
+    // Row pitch smaller than a row
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 16, 8, 16 * 4 - 4, data.size(), data.data()));
+
+    // Row pitch not a multiple of the pixel size
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 1, 2, 5, data.size(), data.data()));
+
+    // Data too small for the region
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 16, 8, 0, data.size() - 1, data.data()));
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 2, 2, 64, 64 + 2 * 4 - 1, data.data()));
+}
+
+// Test error case for SetSubData with the wrong usage
+TEST_F(TextureValidationTest, SetSubDataWrongUsage) {
+    nxt::Texture texture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(1, 1, 1)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
+        .SetInitialUsage(nxt::TextureUsageBit::Sampled)
+        .GetResult();
+
+    uint32_t data = 0;
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 1, 1, 0, sizeof(data), reinterpret_cast<uint8_t*>(&data)));
+
+    texture.TransitionUsage(nxt::TextureUsageBit::TransferDst);
+    texture.SetSubData(0, 0, 0, 1, 1, 0, sizeof(data), reinterpret_cast<uint8_t*>(&data));
+}
+
+// Test error case for SetSubData on depth stencil textures
+TEST_F(TextureValidationTest, SetSubDataDepthStencil) {
+    nxt::Texture texture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(1, 1, 1)
+        .SetFormat(nxt::TextureFormat::D32FloatS8Uint)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::TransferDst)
+        .SetInitialUsage(nxt::TextureUsageBit::TransferDst)
+        .GetResult();
+
+    uint64_t data = 0;
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 1, 1, 0, sizeof(data), reinterpret_cast<uint8_t*>(&data)));
+}
+
+// Test the creation constraints of compressed textures
+TEST_F(TextureValidationTest, CompressedTextureCreation) {
+    // Success case
+    {
+        nxt::Texture texture = AssertWillBeSuccess(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(16, 8, 1)
+            .SetFormat(nxt::TextureFormat::Bc3RGBAUnorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
+            .GetResult();
+    }
+
+    // The size must be a multiple of the block size
+    {
+        nxt::Texture texture = AssertWillBeError(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(6, 8, 1)
+            .SetFormat(nxt::TextureFormat::Bc3RGBAUnorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+            .GetResult();
+    }
+
+    // Compressed textures can't be rendered to
+    {
+        nxt::Texture texture = AssertWillBeError(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(16, 16, 1)
+            .SetFormat(nxt::TextureFormat::Bc3RGBAUnorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+            .GetResult();
+    }
+}
+
+// Test SetSubData on compressed textures works in units of blocks
+TEST_F(TextureValidationTest, SetSubDataCompressed) {
+    nxt::Texture texture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2D)
+        .SetExtent(16, 16, 1)
+        .SetFormat(nxt::TextureFormat::Bc1RGBAUnorm)
+        .SetMipLevels(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
+        .SetInitialUsage(nxt::TextureUsageBit::TransferDst)
+        .GetResult();
+    // 4x4 blocks of 8 bytes
+    std::vector<uint8_t> data(4 * 4 * 8);
+
+    // Full level 0, tightly packed
+    texture.SetSubData(0, 0, 0, 16, 16, 0, data.size(), data.data());
+
+    // A single block, and the last level that is smaller than a block
+    texture.SetSubData(0, 4, 12, 4, 4, 0, 8, data.data());
+    texture.SetSubData(3, 0, 0, 2, 2, 0, 8, data.data());
+
+    // Not enough data for two rows of blocks
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 16, 8, 0, 63, data.data()));
+
+    // Regions that aren't aligned to blocks
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 2, 0, 4, 4, 0, data.size(), data.data()));
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 4, 3, 0, data.size(), data.data()));
+
+    // Row pitch that isn't a multiple of the block size
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 4, 8, 12, data.size(), data.data()));
+}
+
+// Test the creation constraints of each texture dimension
+TEST_F(TextureValidationTest, TextureDimensionCreation) {
+    // 2D array and 3D textures used for transfers and sampling
+    {
+        nxt::Texture texture = AssertWillBeSuccess(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e2DArray)
+            .SetExtent(16, 16, 6)
+            .SetFormat(nxt::TextureFormat::Bc1RGBAUnorm)
+            .SetMipLevels(5)
+            .SetAllowedUsage(nxt::TextureUsageBit::TransferDst | nxt::TextureUsageBit::Sampled)
+            .GetResult();
+    }
+    {
+        nxt::Texture texture = AssertWillBeSuccess(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e3D)
+            .SetExtent(16, 16, 16)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+            .SetMipLevels(5)
+            .SetAllowedUsage(nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::Sampled)
+            .GetResult();
+    }
+
+    // 2D textures must have a depth of 1
+    {
+        nxt::Texture texture = AssertWillBeError(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(16, 16, 2)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+            .GetResult();
+    }
+
+    // Layered textures can't be rendered to
+    {
+        nxt::Texture texture = AssertWillBeError(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e2DArray)
+            .SetExtent(16, 16, 2)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+            .GetResult();
+    }
+
+    // 3D textures can't be compressed
+    {
+        nxt::Texture texture = AssertWillBeError(device.CreateTextureBuilder())
+            .SetDimension(nxt::TextureDimension::e3D)
+            .SetExtent(16, 16, 4)
+            .SetFormat(nxt::TextureFormat::Bc1RGBAUnorm)
+            .SetMipLevels(1)
+            .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+            .GetResult();
+    }
+}
+
+// Test the creation constraints of multisampled textures
+TEST_F(TextureValidationTest, MultisampledTextureCreation) {
+    auto CreateBuilder = [](nxt::TextureBuilder builder) {
+        builder.SetDimension(nxt::TextureDimension::e2D)
+            .SetExtent(16, 16, 1)
+            .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm);
+        return builder;
+    };
+
+    // Control cases: multisampled render targets
+    CreateBuilder(AssertWillBeSuccess(device.CreateTextureBuilder()))
+        .SetMipLevels(1)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    CreateBuilder(AssertWillBeSuccess(device.CreateTextureBuilder()))
+        .SetMipLevels(1)
+        .SetSampleCount(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+        .GetResult();
+
+    // Only sample counts supported by all backends are valid
+    CreateBuilder(AssertWillBeError(device.CreateTextureBuilder()))
+        .SetMipLevels(1)
+        .SetSampleCount(0)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+    CreateBuilder(AssertWillBeError(device.CreateTextureBuilder()))
+        .SetMipLevels(1)
+        .SetSampleCount(3)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+
+    // Multisampled textures can't have mipmaps
+    CreateBuilder(AssertWillBeError(device.CreateTextureBuilder()))
+        .SetMipLevels(2)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+
+    // Multisampled textures can only be rendered to
+    CreateBuilder(AssertWillBeError(device.CreateTextureBuilder()))
+        .SetMipLevels(1)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::Sampled)
+        .GetResult();
+    CreateBuilder(AssertWillBeError(device.CreateTextureBuilder()))
+        .SetMipLevels(1)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment | nxt::TextureUsageBit::TransferSrc)
+        .GetResult();
+
+    // Multisampled textures must be 2D
+    AssertWillBeError(device.CreateTextureBuilder())
+        .SetDimension(nxt::TextureDimension::e2DArray)
+        .SetExtent(16, 16, 2)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetSampleCount(4)
+        .SetAllowedUsage(nxt::TextureUsageBit::OutputAttachment)
+        .GetResult();
+}
+
+// Test SetSubData is only available on 2D textures
+TEST_F(TextureValidationTest, SetSubDataArray) {
+    nxt::Texture texture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2DArray)
+        .SetExtent(1, 1, 2)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::TransferDst)
+        .SetInitialUsage(nxt::TextureUsageBit::TransferDst)
+        .GetResult();
+
+    uint32_t data = 0;
+    ASSERT_DEVICE_ERROR(texture.SetSubData(0, 0, 0, 1, 1, 0, sizeof(data), reinterpret_cast<uint8_t*>(&data)));
+}
+
+// Test the dimension and layer range of texture views
+TEST_F(TextureValidationTest, TextureViewCreation) {
+    nxt::Texture arrayTexture = device.CreateTextureBuilder()
+        .SetDimension(nxt::TextureDimension::e2DArray)
+        .SetExtent(16, 16, 6)
+        .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+        .SetMipLevels(1)
+        .SetAllowedUsage(nxt::TextureUsageBit::Sampled)
+        .GetResult();
+    nxt::Texture texture2D = CreateSetSubDataTexture(16, 16, 1);
+
+    // Views of the whole texture, of a range of layers, and of a single layer as a 2D texture
+    {
+        nxt::TextureView view = AssertWillBeSuccess(arrayTexture.CreateTextureViewBuilder())
+            .GetResult();
+    }
+    {
+        nxt::TextureView view = AssertWillBeSuccess(arrayTexture.CreateTextureViewBuilder())
+            .SetArrayLayers(2, 4)
+            .GetResult();
+    }
+    {
+        nxt::TextureView view = AssertWillBeSuccess(arrayTexture.CreateTextureViewBuilder())
+            .SetDimension(nxt::TextureDimension::e2D)
+            .SetArrayLayers(5, 1)
+            .GetResult();
+    }
+
+    // Layer ranges out of the texture or empty
+    {
+        nxt::TextureView view = AssertWillBeError(arrayTexture.CreateTextureViewBuilder())
+            .SetArrayLayers(4, 3)
+            .GetResult();
+    }
+    {
+        nxt::TextureView view = AssertWillBeError(arrayTexture.CreateTextureViewBuilder())
+            .SetArrayLayers(0, 0)
+            .GetResult();
+    }
+
+    // 2D views must have a single layer
+    {
+        nxt::TextureView view = AssertWillBeError(arrayTexture.CreateTextureViewBuilder())
+            .SetDimension(nxt::TextureDimension::e2D)
+            .GetResult();
+    }
+
+    // 2D textures can't be viewed as arrays or have their layers selected
+    {
+        nxt::TextureView view = AssertWillBeError(texture2D.CreateTextureViewBuilder())
+            .SetDimension(nxt::TextureDimension::e2DArray)
+            .GetResult();
+    }
+    {
+        nxt::TextureView view = AssertWillBeError(texture2D.CreateTextureViewBuilder())
+            .SetArrayLayers(0, 1)
+            .GetResult();
+    }
+}
@@ -54,3 +54,127 @@ TEST_F(UsageValidationTest, UsageAfterCommandBuffer) {
 
     buf.SetSubData(0, 1, &foo);
 }
+
+class TextureLevelsUsageValidationTest : public UsageValidationTest {
+    protected:
+        nxt::Texture CreateTexture(uint32_t levels) {
+            return device.CreateTextureBuilder()
+                .SetDimension(nxt::TextureDimension::e2D)
+                .SetExtent(4, 4, 1)
+                .SetFormat(nxt::TextureFormat::R8G8B8A8Unorm)
+                .SetMipLevels(levels)
+                .SetAllowedUsage(nxt::TextureUsageBit::TransferSrc | nxt::TextureUsageBit::TransferDst)
+                .GetResult();
+        }
+
+        nxt::Buffer CreateBuffer() {
+            return device.CreateBufferBuilder()
+                .SetSize(1024)
+                .SetAllowedUsage(nxt::BufferUsageBit::TransferSrc | nxt::BufferUsageBit::TransferDst)
+                .GetResult();
+        }
+};
+
+// Test that the level range of texture transitions must be in the texture
+TEST_F(TextureLevelsUsageValidationTest, OutOfBounds) {
+    nxt::Texture texture = CreateTexture(3);
+
+    // Success case, the whole mip chain
+    {
+        nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+            .TransitionTextureLevelsUsage(texture, 0, 3, nxt::TextureUsageBit::TransferDst)
+            .GetResult();
+    }
+
+    // Empty range
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureLevelsUsage(texture, 1, 0, nxt::TextureUsageBit::TransferDst)
+            .GetResult();
+    }
+
+    // Too many levels
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureLevelsUsage(texture, 1, 3, nxt::TextureUsageBit::TransferDst)
+            .GetResult();
+    }
+
+    // Base level after the last level
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionTextureLevelsUsage(texture, 3, 1, nxt::TextureUsageBit::TransferDst)
+            .GetResult();
+    }
+}
+
+// Test that levels of the same texture can be read from and written to in the same command buffer
+TEST_F(TextureLevelsUsageValidationTest, LevelsInDifferentUsages) {
+    nxt::Texture texture = CreateTexture(2);
+    nxt::Buffer buffer = CreateBuffer();
+
+    nxt::CommandBuffer commands = AssertWillBeSuccess(device.CreateCommandBufferBuilder())
+        .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferDst)
+        .TransitionTextureLevelsUsage(texture, 0, 1, nxt::TextureUsageBit::TransferSrc)
+        .TransitionTextureLevelsUsage(texture, 1, 1, nxt::TextureUsageBit::TransferDst)
+        .CopyTextureToBuffer(texture, 0, 0, 0, 4, 4, 1, 0, buffer, 0, 256)
+        .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferSrc)
+        .CopyBufferToTexture(buffer, 0, 256, texture, 0, 0, 0, 2, 2, 1, 1)
+        .GetResult();
+}
+
+// Test that copies check the usage of the level they use
+TEST_F(TextureLevelsUsageValidationTest, CopiesCheckTheirLevel) {
+    nxt::Texture texture = CreateTexture(2);
+    nxt::Buffer buffer = CreateBuffer();
+
+    // Writing to a level in the TransferSrc usage
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferSrc)
+            .TransitionTextureLevelsUsage(texture, 0, 1, nxt::TextureUsageBit::TransferSrc)
+            .TransitionTextureLevelsUsage(texture, 1, 1, nxt::TextureUsageBit::TransferDst)
+            .CopyBufferToTexture(buffer, 0, 256, texture, 0, 0, 0, 4, 4, 1, 0)
+            .GetResult();
+    }
+
+    // Reading from a level that wasn't transitioned in this command buffer
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferDst)
+            .TransitionTextureLevelsUsage(texture, 1, 1, nxt::TextureUsageBit::TransferSrc)
+            .CopyTextureToBuffer(texture, 0, 0, 0, 4, 4, 1, 0, buffer, 0, 256)
+            .GetResult();
+    }
+
+    // Transitioning the whole texture overrides the usage of all its levels
+    {
+        nxt::CommandBuffer commands = AssertWillBeError(device.CreateCommandBufferBuilder())
+            .TransitionBufferUsage(buffer, nxt::BufferUsageBit::TransferDst)
+            .TransitionTextureLevelsUsage(texture, 1, 1, nxt::TextureUsageBit::TransferSrc)
+            .TransitionTextureUsage(texture, nxt::TextureUsageBit::TransferDst)
+            .CopyTextureToBuffer(texture, 0, 0, 0, 2, 2, 1, 1, buffer, 0, 256)
+            .GetResult();
+    }
+}
+
+// Test that submitting a command buffer changes the usage of the transitioned levels only
+TEST_F(TextureLevelsUsageValidationTest, UsageAfterCommandBuffer) {
+    nxt::Texture texture = CreateTexture(2);
+    texture.TransitionUsage(nxt::TextureUsageBit::TransferDst);
+
+    nxt::CommandBuffer commands = device.CreateCommandBufferBuilder()
+        .TransitionTextureLevelsUsage(texture, 0, 1, nxt::TextureUsageBit::TransferSrc)
+        .GetResult();
+    queue.Submit(1, &commands);
+
+    // Level 1 is still in the TransferDst usage, level 0 isn't anymore
+    uint32_t data[4] = {};
+    texture.SetSubData(1, 0, 0, 2, 2, 0, sizeof(data), reinterpret_cast<uint8_t*>(data));
+    ASSERT_DEVICE_ERROR(
+        texture.SetSubData(0, 0, 0, 2, 2, 0, sizeof(data), reinterpret_cast<uint8_t*>(data)));
+
+    // Transitioning the whole texture puts all the levels back in the same usage
+    texture.TransitionUsage(nxt::TextureUsageBit::TransferDst);
+    texture.SetSubData(0, 0, 0, 2, 2, 0, sizeof(data), reinterpret_cast<uint8_t*>(data));
+}
@@ -0,0 +1,145 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tests/unittests/validation/ValidationTest.h"
+
+#include <limits>
+
+class ViewportAndScissorValidationTest : public ValidationTest {
+    protected:
+        void SetUp() override {
+            ValidationTest::SetUp();
+            renderpassData = CreateDummyRenderPass();
+        }
+
+        void TestViewport(bool success, float x, float y, float width, float height,
+                          float minDepth, float maxDepth) {
+            nxt::CommandBufferBuilder builder;
+            if (success) {
+                builder = AssertWillBeSuccess(device.CreateCommandBufferBuilder());
+            } else {
+                builder = AssertWillBeError(device.CreateCommandBufferBuilder());
+            }
+            builder.BeginRenderPass(renderpassData.renderPass, renderpassData.framebuffer)
+                .BeginRenderSubpass()
+                .SetViewport(x, y, width, height, minDepth, maxDepth)
+                .EndRenderSubpass()
+                .EndRenderPass()
+                .GetResult();
+        }
+
+        void TestScissorRect(bool success, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+            nxt::CommandBufferBuilder builder;
+            if (success) {
+                builder = AssertWillBeSuccess(device.CreateCommandBufferBuilder());
+            } else {
+                builder = AssertWillBeError(device.CreateCommandBufferBuilder());
+            }
+            builder.BeginRenderPass(renderpassData.renderPass, renderpassData.framebuffer)
+                .BeginRenderSubpass()
+                .SetScissorRect(x, y, width, height)
+                .EndRenderSubpass()
+                .EndRenderPass()
+                .GetResult();
+        }
+
+        DummyRenderPass renderpassData;
+};
+
+// Test that the viewport and scissor can only be set inside subpasses
+TEST_F(ViewportAndScissorValidationTest, OnlyInSubpass) {
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .SetViewport(0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f)
+        .GetResult();
+
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(renderpassData.renderPass, renderpassData.framebuffer)
+        .SetViewport(0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .EndRenderPass()
+        .GetResult();
+
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginComputePass()
+        .SetScissorRect(0, 0, 1, 1)
+        .EndComputePass()
+        .GetResult();
+
+    AssertWillBeError(device.CreateCommandBufferBuilder())
+        .BeginRenderPass(renderpassData.renderPass, renderpassData.framebuffer)
+        .BeginRenderSubpass()
+        .EndRenderSubpass()
+        .SetScissorRect(0, 0, 1, 1)
+        .EndRenderPass()
+        .GetResult();
+}
+
+// Test the viewport must be a non-empty rectangle contained in the framebuffer
+TEST_F(ViewportAndScissorValidationTest, ViewportRect) {
+    float width = static_cast<float>(renderpassData.width);
+    float height = static_cast<float>(renderpassData.height);
+
+    // Control cases: the whole framebuffer and a part of it
+    TestViewport(true, 0.0f, 0.0f, width, height, 0.0f, 1.0f);
+    TestViewport(true, 10.5f, 20.0f, 1.5f, height - 20.0f, 0.0f, 1.0f);
+
+    // Empty viewports
+    TestViewport(false, 0.0f, 0.0f, 0.0f, height, 0.0f, 1.0f);
+    TestViewport(false, 0.0f, 0.0f, width, 0.0f, 0.0f, 1.0f);
+    TestViewport(false, 0.0f, 0.0f, -1.0f, height, 0.0f, 1.0f);
+
+    // Viewports going outside of the framebuffer
+    TestViewport(false, -1.0f, 0.0f, width, height, 0.0f, 1.0f);
+    TestViewport(false, 0.0f, -1.0f, width, height, 0.0f, 1.0f);
+    TestViewport(false, 1.0f, 0.0f, width, height, 0.0f, 1.0f);
+    TestViewport(false, 0.0f, 0.5f, width, height, 0.0f, 1.0f);
+
+    // NaNs
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    TestViewport(false, nan, 0.0f, width, height, 0.0f, 1.0f);
+    TestViewport(false, 0.0f, 0.0f, width, nan, 0.0f, 1.0f);
+}
+
+// Test the viewport depth range must be in [0, 1]
+TEST_F(ViewportAndScissorValidationTest, ViewportDepthRange) {
+    // Control cases, including a reversed depth range
+    TestViewport(true, 0.0f, 0.0f, 1.0f, 1.0f, 0.25f, 0.75f);
+    TestViewport(true, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f);
+
+    TestViewport(false, 0.0f, 0.0f, 1.0f, 1.0f, -0.1f, 1.0f);
+    TestViewport(false, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.1f);
+    TestViewport(false, 0.0f, 0.0f, 1.0f, 1.0f, std::numeric_limits<float>::quiet_NaN(), 1.0f);
+}
+
+// Test the scissor rect must be contained in the framebuffer
+TEST_F(ViewportAndScissorValidationTest, ScissorRect) {
+    uint32_t width = renderpassData.width;
+    uint32_t height = renderpassData.height;
+
+    // Control cases: the whole framebuffer, a part of it and an empty rectangle
+    TestScissorRect(true, 0, 0, width, height);
+    TestScissorRect(true, 10, 20, 30, height - 20);
+    TestScissorRect(true, width, height, 0, 0);
+
+    // Rectangles going outside of the framebuffer
+    TestScissorRect(false, 0, 0, width + 1, height);
+    TestScissorRect(false, 0, 0, width, height + 1);
+    TestScissorRect(false, 1, 0, width, height);
+    TestScissorRect(false, 0, height + 1, 0, 0);
+
+    // Rectangles whose end overflows
+    TestScissorRect(false, 1, 0, std::numeric_limits<uint32_t>::max(), height);
+    TestScissorRect(false, 0, std::numeric_limits<uint32_t>::max(), width, 2);
+}
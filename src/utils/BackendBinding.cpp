@@ -30,6 +30,9 @@ namespace utils {
 #if defined(NXT_ENABLE_BACKEND_OPENGL)
     BackendBinding* CreateOpenGLBinding();
 #endif
+#if defined(NXT_ENABLE_HEADLESS_OPENGL)
+    BackendBinding* CreateOpenGLHeadlessBinding();
+#endif
 #if defined(NXT_ENABLE_BACKEND_VULKAN)
     BackendBinding* CreateVulkanBinding();
 #endif
@@ -70,4 +73,28 @@ namespace utils {
         }
     }
 
+    BackendBinding* CreateHeadlessBinding(BackendType type) {
+        switch (type) {
+#if defined(NXT_ENABLE_BACKEND_NULL)
+            case BackendType::Null:
+                return CreateNullBinding();
+#endif
+
+#if defined(NXT_ENABLE_HEADLESS_OPENGL)
+            case BackendType::OpenGL:
+                return CreateOpenGLHeadlessBinding();
+#endif
+
+#if defined(NXT_ENABLE_BACKEND_VULKAN)
+            // The Vulkan binding never uses its window: the backend doesn't need the surface
+            // extensions and its swap chain textures are regular textures.
+            case BackendType::Vulkan:
+                return CreateVulkanBinding();
+#endif
+
+            default:
+                return nullptr;
+        }
+    }
+
 }  // namespace utils
@@ -48,6 +48,11 @@ namespace utils {
 
     BackendBinding* CreateBinding(BackendType type);
 
+    // Headless bindings don't need a window: they render to offscreen swap chains so that the
+    // backends can run on machines without a display. Returns nullptr if there is no headless
+    // binding for the backend.
+    BackendBinding* CreateHeadlessBinding(BackendType type);
+
 }  // namespace utils
 
 #endif  // UTILS_BACKENDBINDING_H_
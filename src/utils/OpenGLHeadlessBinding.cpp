@@ -0,0 +1,259 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utils/BackendBinding.h"
+
+#include "common/Assert.h"
+#include "nxt/nxt_wsi.h"
+#include "utils/SwapChainImpl.h"
+
+#include "glad/glad.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstdio>
+#include <cstring>
+
+#if !defined(EGL_PLATFORM_SURFACELESS_MESA)
+#    define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace backend { namespace opengl {
+    void Init(void* (*getProc)(const char*), nxtProcTable* procs, nxtDevice* device);
+}}  // namespace backend::opengl
+
+namespace utils {
+
+    namespace {
+
+        bool HasExtension(const char* extensions, const char* name) {
+            if (extensions == nullptr) {
+                return false;
+            }
+
+            size_t nameLength = strlen(name);
+            for (const char* found = strstr(extensions, name); found != nullptr;
+                 found = strstr(found + nameLength, name)) {
+                bool startsWord = found == extensions || found[-1] == ' ';
+                bool endsWord = found[nameLength] == ' ' || found[nameLength] == '\0';
+                if (startsWord && endsWord) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        EGLDisplay InitializeDisplay() {
+            EGLDisplay display = EGL_NO_DISPLAY;
+
+            // Prefer Mesa's surfaceless platform that doesn't need a display server at all and
+            // fallback to the default display otherwise.
+            const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+            if (HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+                auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                    eglGetProcAddress("eglGetPlatformDisplayEXT"));
+                if (getPlatformDisplay != nullptr) {
+                    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                                 EGL_DEFAULT_DISPLAY, nullptr);
+                }
+            }
+            if (display == EGL_NO_DISPLAY) {
+                display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            }
+            if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+                return EGL_NO_DISPLAY;
+            }
+            return display;
+        }
+
+        // Initializing the display loads the driver, which is most of the cost of creating a
+        // binding. The display is initialized the first time it is needed and then shared by all
+        // the bindings of the process, without ever being terminated, so that tools and tests
+        // creating many devices only pay for it once.
+        EGLDisplay GetSharedDisplay() {
+            static EGLDisplay display = InitializeDisplay();
+            return display;
+        }
+
+    }  // namespace
+
+    // Like SwapChainImplGL but the back buffer is never presented to a window: each frame is
+    // rendered to the same texture, that stays readable by the application.
+    class SwapChainImplGLOffscreen : SwapChainImpl {
+      public:
+        static nxtSwapChainImplementation Create() {
+            auto impl =
+                GenerateSwapChainImplementation<SwapChainImplGLOffscreen, nxtWSIContextGL>();
+            impl.userData = new SwapChainImplGLOffscreen;
+            return impl;
+        }
+
+      private:
+        GLuint mBackTexture = 0;
+
+        ~SwapChainImplGLOffscreen() {
+            glDeleteTextures(1, &mBackTexture);
+        }
+
+        // For GenerateSwapChainImplementation
+        friend class SwapChainImpl;
+
+        void Init(nxtWSIContextGL*) {
+            glGenTextures(1, &mBackTexture);
+            glBindTexture(GL_TEXTURE_2D, mBackTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        nxtSwapChainError Configure(nxtTextureFormat format,
+                                    nxtTextureUsageBit,
+                                    uint32_t width,
+                                    uint32_t height) {
+            if (format != NXT_TEXTURE_FORMAT_R8_G8_B8_A8_UNORM) {
+                return "unsupported format";
+            }
+            ASSERT(width > 0);
+            ASSERT(height > 0);
+
+            glBindTexture(GL_TEXTURE_2D, mBackTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         nullptr);
+
+            return NXT_SWAP_CHAIN_NO_ERROR;
+        }
+
+        nxtSwapChainError GetNextTexture(nxtSwapChainNextTexture* nextTexture) {
+            nextTexture->texture = reinterpret_cast<void*>(static_cast<size_t>(mBackTexture));
+            return NXT_SWAP_CHAIN_NO_ERROR;
+        }
+
+        nxtSwapChainError Present() {
+            // There is no SwapBuffers to submit the frame's work, flush it so that headless runs
+            // make progress at the same rate as windowed runs.
+            glFlush();
+            return NXT_SWAP_CHAIN_NO_ERROR;
+        }
+    };
+
+    // Creates the OpenGL context with EGL instead of GLFW so that no window, and on Mesa no
+    // display server, is needed. This is what allows running the OpenGL backend on machines
+    // without a display such as CI bots, for example with Mesa's llvmpipe software renderer.
+    class OpenGLHeadlessBinding : public BackendBinding {
+      public:
+        ~OpenGLHeadlessBinding() override {
+            if (mDisplay == EGL_NO_DISPLAY) {
+                return;
+            }
+
+            eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (mSurface != EGL_NO_SURFACE) {
+                eglDestroySurface(mDisplay, mSurface);
+            }
+            if (mContext != EGL_NO_CONTEXT) {
+                eglDestroyContext(mDisplay, mContext);
+            }
+        }
+
+        void SetupGLFWWindowHints() override {
+        }
+
+        void GetProcAndDevice(nxtProcTable* procs, nxtDevice* device) override {
+            if (!CreateContext()) {
+                fprintf(stderr, "Failed to create a headless OpenGL context with EGL\n");
+                *device = nullptr;
+                return;
+            }
+
+            backend::opengl::Init(reinterpret_cast<void* (*)(const char*)>(eglGetProcAddress),
+                                  procs, device);
+        }
+
+        uint64_t GetSwapChainImplementation() override {
+            if (mSwapchainImpl.userData == nullptr) {
+                mSwapchainImpl = SwapChainImplGLOffscreen::Create();
+            }
+            return reinterpret_cast<uint64_t>(&mSwapchainImpl);
+        }
+
+        nxtTextureFormat GetPreferredSwapChainTextureFormat() override {
+            return NXT_TEXTURE_FORMAT_R8_G8_B8_A8_UNORM;
+        }
+
+      private:
+        bool CreateContext() {
+            mDisplay = GetSharedDisplay();
+            if (mDisplay == EGL_NO_DISPLAY) {
+                return false;
+            }
+
+            if (!eglBindAPI(EGL_OPENGL_API)) {
+                return false;
+            }
+
+            // Without EGL_KHR_surfaceless_context a context can't be made current without a
+            // surface so a small pbuffer is used instead. NXT never renders to it.
+            bool surfaceless = HasExtension(eglQueryString(mDisplay, EGL_EXTENSIONS),
+                                            "EGL_KHR_surfaceless_context");
+
+            const EGLint configAttribs[] = {
+                EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_NONE,
+            };
+            EGLConfig config;
+            EGLint configCount = 0;
+            if (!eglChooseConfig(mDisplay, configAttribs, &config, 1, &configCount) ||
+                configCount == 0) {
+                return false;
+            }
+
+            // Same version and profile as the windowed OpenGL binding.
+            const EGLint contextAttribs[] = {
+                EGL_CONTEXT_MAJOR_VERSION_KHR, 4,
+                EGL_CONTEXT_MINOR_VERSION_KHR, 4,
+                EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+                EGL_NONE,
+            };
+            mContext = eglCreateContext(mDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+            if (mContext == EGL_NO_CONTEXT) {
+                return false;
+            }
+
+            if (!surfaceless) {
+                const EGLint pbufferAttribs[] = {
+                    EGL_WIDTH, 1,
+                    EGL_HEIGHT, 1,
+                    EGL_NONE,
+                };
+                mSurface = eglCreatePbufferSurface(mDisplay, config, pbufferAttribs);
+                if (mSurface == EGL_NO_SURFACE) {
+                    return false;
+                }
+            }
+
+            return eglMakeCurrent(mDisplay, mSurface, mSurface, mContext) == EGL_TRUE;
+        }
+
+        EGLDisplay mDisplay = EGL_NO_DISPLAY;
+        EGLContext mContext = EGL_NO_CONTEXT;
+        EGLSurface mSurface = EGL_NO_SURFACE;
+        nxtSwapChainImplementation mSwapchainImpl = {};
+    };
+
+    BackendBinding* CreateOpenGLHeadlessBinding() {
+        return new OpenGLHeadlessBinding;
+    }
+
+}  // namespace utils
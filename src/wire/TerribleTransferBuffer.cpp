@@ -0,0 +1,123 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "wire/TerribleTransferBuffer.h"
+
+#include "common/Math.h"
+
+#include <limits>
+
+namespace nxt { namespace wire {
+
+    TerribleTransferBuffer::TerribleTransferBuffer(size_t chunkSize) : mChunkSize(chunkSize) {
+    }
+
+    void* TerribleTransferBuffer::Allocate(size_t size, TransferAllocation* allocation) {
+        // Offsets are sent as uint32_t on the wire.
+        if (size > std::numeric_limits<uint32_t>::max()) {
+            return nullptr;
+        }
+
+        bool needsNewChunk = mChunks.empty();
+        uint32_t offset = 0;
+        if (!needsNewChunk) {
+            Chunk* current = &mChunks[mCurrentChunk];
+
+            // Everything in the current chunk was released, it can be reused from the start.
+            if (current->lastSerial <= mLastReleasedSerial) {
+                current->offset = 0;
+            }
+
+            offset = Align(static_cast<uint32_t>(current->offset), 8);
+            needsNewChunk = offset > current->size || size > current->size - offset;
+        }
+
+        if (needsNewChunk) {
+            StartNewChunk(size);
+            offset = 0;
+        }
+
+        Chunk* chunk = &mChunks[mCurrentChunk];
+        chunk->offset = offset + size;
+        chunk->lastSerial = ++mLastAllocatedSerial;
+
+        allocation->handle = mCurrentChunk;
+        allocation->offset = offset;
+        allocation->serial = chunk->lastSerial;
+
+        return &chunk->data[offset];
+    }
+
+    const void* TerribleTransferBuffer::GetData(const TransferAllocation& allocation,
+                                                size_t size) {
+        if (allocation.handle >= mChunks.size()) {
+            return nullptr;
+        }
+
+        const Chunk& chunk = mChunks[allocation.handle];
+        if (allocation.offset > chunk.size || size > chunk.size - allocation.offset) {
+            return nullptr;
+        }
+
+        return &chunk.data[allocation.offset];
+    }
+
+    void TerribleTransferBuffer::Release(uint64_t serial) {
+        if (serial <= mLastReleasedSerial) {
+            return;
+        }
+        mLastReleasedSerial = serial;
+
+        for (uint32_t chunk : mRetiredChunks.IterateUpTo(serial)) {
+            mFreeChunks.push_back(chunk);
+        }
+        mRetiredChunks.ClearUpTo(serial);
+    }
+
+    uint64_t TerribleTransferBuffer::GetLastAllocatedSerial() const {
+        return mLastAllocatedSerial;
+    }
+
+    uint64_t TerribleTransferBuffer::GetLastReleasedSerial() const {
+        return mLastReleasedSerial;
+    }
+
+    size_t TerribleTransferBuffer::GetChunkCount() const {
+        return mChunks.size();
+    }
+
+    void TerribleTransferBuffer::StartNewChunk(size_t size) {
+        if (!mChunks.empty()) {
+            mRetiredChunks.Enqueue(mCurrentChunk, mChunks[mCurrentChunk].lastSerial);
+        }
+
+        // Reuse a free chunk if one is large enough, otherwise make a new one.
+        for (auto it = mFreeChunks.begin(); it != mFreeChunks.end(); ++it) {
+            if (mChunks[*it].size >= size) {
+                mCurrentChunk = *it;
+                mChunks[mCurrentChunk].offset = 0;
+                mFreeChunks.erase(it);
+                return;
+            }
+        }
+
+        Chunk chunk;
+        chunk.size = size > mChunkSize ? size : mChunkSize;
+        chunk.data.reset(new uint8_t[chunk.size]);
+
+        mCurrentChunk = static_cast<uint32_t>(mChunks.size());
+        mChunks.push_back(std::move(chunk));
+    }
+
+}}  // namespace nxt::wire
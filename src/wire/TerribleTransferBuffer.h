@@ -0,0 +1,67 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef WIRE_TERRIBLE_TRANSFER_BUFFER_H_
+#define WIRE_TERRIBLE_TRANSFER_BUFFER_H_
+
+#include <memory>
+#include <vector>
+
+#include "common/SerialQueue.h"
+#include "wire/Wire.h"
+
+namespace nxt { namespace wire {
+
+    // A TransferBuffer for a client and server living in the same process. Allocations are
+    // sub-allocated linearly in chunks of memory that get recycled once all their allocations
+    // have been released.
+    class TerribleTransferBuffer : public TransferBuffer {
+      public:
+        static constexpr size_t kDefaultChunkSize = 4 * 1024 * 1024;
+
+        TerribleTransferBuffer(size_t chunkSize = kDefaultChunkSize);
+
+        void* Allocate(size_t size, TransferAllocation* allocation) override;
+        const void* GetData(const TransferAllocation& allocation, size_t size) override;
+        void Release(uint64_t serial) override;
+
+        uint64_t GetLastAllocatedSerial() const;
+        uint64_t GetLastReleasedSerial() const;
+        size_t GetChunkCount() const;
+
+      private:
+        struct Chunk {
+            std::unique_ptr<uint8_t[]> data;
+            size_t size = 0;
+            size_t offset = 0;
+            Serial lastSerial = 0;
+        };
+
+        void StartNewChunk(size_t size);
+
+        size_t mChunkSize;
+        std::vector<Chunk> mChunks;
+        // Index of the chunk allocations are made from, only valid when mChunks isn't empty.
+        uint32_t mCurrentChunk = 0;
+        // Chunks that are full and wait for their allocations to be released.
+        SerialQueue<uint32_t> mRetiredChunks;
+        std::vector<uint32_t> mFreeChunks;
+
+        Serial mLastAllocatedSerial = 0;
+        Serial mLastReleasedSerial = 0;
+    };
+
+}}  // namespace nxt::wire
+
+#endif  // WIRE_TERRIBLE_TRANSFER_BUFFER_H_
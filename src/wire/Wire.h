@@ -15,6 +15,7 @@
 #ifndef WIRE_WIRE_H_
 #define WIRE_WIRE_H_
 
+#include <cstddef>
 #include <cstdint>
 
 #include "nxt/nxt.h"
@@ -28,6 +29,32 @@ namespace nxt { namespace wire {
         virtual void Flush() = 0;
     };
 
+    // Reference to data written in a TransferBuffer instead of inline in the command stream.
+    struct TransferAllocation {
+        uint32_t handle;
+        uint32_t offset;
+        uint64_t serial;
+    };
+
+    // Handle used on the wire for arguments that are inline in the command stream.
+    static constexpr uint32_t kInlineTransferHandle = 0xFFFFFFFFu;
+
+    // Memory shared by the client and the server for large command arguments such as buffer data
+    // or SPIR-V code. The client writes the data in an allocation and only sends its handle and
+    // offset, the server reads the data in place and releases all the allocations up to a serial
+    // once it is done with them.
+    class TransferBuffer {
+      public:
+        virtual ~TransferBuffer() = default;
+
+        // Client side, returns nullptr if there is no space available for the allocation.
+        virtual void* Allocate(size_t size, TransferAllocation* allocation) = 0;
+
+        // Server side, returns nullptr if the range isn't contained in an allocation.
+        virtual const void* GetData(const TransferAllocation& allocation, size_t size) = 0;
+        virtual void Release(uint64_t serial) = 0;
+    };
+
     class CommandHandler {
       public:
         virtual ~CommandHandler() = default;
@@ -36,10 +63,19 @@ namespace nxt { namespace wire {
 
     CommandHandler* NewClientDevice(nxtProcTable* procs,
                                     nxtDevice* device,
-                                    CommandSerializer* serializer);
+                                    CommandSerializer* serializer,
+                                    TransferBuffer* transferBuffer = nullptr);
     CommandHandler* NewServerCommandHandler(nxtDevice device,
                                             const nxtProcTable& procs,
-                                            CommandSerializer* serializer);
+                                            CommandSerializer* serializer,
+                                            TransferBuffer* transferBuffer = nullptr);
+    // Like NewServerCommandHandler for a device that is shared with other servers. The servers of
+    // a device must never handle commands concurrently, device errors are reported to the server
+    // that is handling commands when they happen.
+    CommandHandler* NewSharedDeviceServerCommandHandler(nxtDevice device,
+                                                        const nxtProcTable& procs,
+                                                        CommandSerializer* serializer,
+                                                        TransferBuffer* transferBuffer = nullptr);
 
 }}  // namespace nxt::wire
 
@@ -16,6 +16,10 @@
 
 namespace nxt { namespace wire {
 
+    size_t SelectCommandBufferBuilderCmd::GetRequiredSize() const {
+        return sizeof(*this);
+    }
+
     size_t ReturnDeviceErrorCallbackCmd::GetRequiredSize() const {
         return sizeof(*this) + messageStrlen + 1;
     }
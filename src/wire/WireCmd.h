@@ -17,8 +17,122 @@
 
 #include "wire/WireCmd_autogen.h"
 
+#include "common/Assert.h"
+
+#include <cstring>
+
 namespace nxt { namespace wire {
 
+    // CommandBufferBuilder methods that don't return an object are sent with a compact encoding
+    // instead of their generic XxxCmd structure. Each command is a single header word containing
+    // kCompactCommandBit, the method's opcode and the payload size, followed by the arguments
+    // encoded as varints (floats are copied as-is). The builder doesn't appear in the command:
+    // the server records in the builder set by the last SelectCommandBufferBuilderCmd.
+    static constexpr uint32_t kCompactCommandBit = 0x80000000u;
+    static constexpr size_t kMaxCompactPayloadSize = 0xFFFF;
+    static constexpr size_t kMaxVarUintSize = 5;
+
+    // These helpers are inline because they are used for each command or each of its arguments.
+    inline uint32_t MakeCompactCommandHeader(uint32_t opcode, size_t payloadSize) {
+        ASSERT(opcode <= 0x7FFF);
+        ASSERT(payloadSize <= kMaxCompactPayloadSize);
+        return kCompactCommandBit | (opcode << 16) | static_cast<uint32_t>(payloadSize);
+    }
+
+    inline uint32_t GetCompactCommandOpcode(uint32_t header) {
+        return (header & ~kCompactCommandBit) >> 16;
+    }
+
+    inline size_t GetCompactCommandPayloadSize(uint32_t header) {
+        return header & 0xFFFF;
+    }
+
+    inline size_t GetVarUintSize(uint32_t value) {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            size++;
+        }
+        return size;
+    }
+
+    class CompactCommandWriter {
+      public:
+        CompactCommandWriter(uint8_t* payload) : mCurrent(payload) {
+        }
+
+        void WriteVarUint(uint32_t value) {
+            while (value >= 0x80) {
+                *mCurrent++ = static_cast<uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            *mCurrent++ = static_cast<uint8_t>(value);
+        }
+
+        void WriteFloat(float value) {
+            memcpy(mCurrent, &value, sizeof(float));
+            mCurrent += sizeof(float);
+        }
+
+      private:
+        uint8_t* mCurrent;
+    };
+
+    class CompactCommandReader {
+      public:
+        CompactCommandReader(const uint8_t* payload, size_t size)
+            : mCurrent(payload), mEnd(payload + size) {
+        }
+
+        // Return false if there isn't enough data left or the encoding is invalid.
+        bool ReadVarUint(uint32_t* value) {
+            uint32_t result = 0;
+            for (size_t i = 0; i < kMaxVarUintSize; ++i) {
+                if (mCurrent == mEnd) {
+                    return false;
+                }
+
+                uint8_t byte = *mCurrent++;
+                // The fifth byte only has 4 bits left to fill in the uint32_t
+                if (i == kMaxVarUintSize - 1 && byte > 0xF) {
+                    return false;
+                }
+
+                result |= static_cast<uint32_t>(byte & 0x7F) << (7 * i);
+                if ((byte & 0x80) == 0) {
+                    *value = result;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ReadFloat(float* value) {
+            if (GetRemainingSize() < sizeof(float)) {
+                return false;
+            }
+            memcpy(value, mCurrent, sizeof(float));
+            mCurrent += sizeof(float);
+            return true;
+        }
+
+        size_t GetRemainingSize() const {
+            return static_cast<size_t>(mEnd - mCurrent);
+        }
+
+      private:
+        const uint8_t* mCurrent;
+        const uint8_t* mEnd;
+    };
+
+    struct SelectCommandBufferBuilderCmd {
+        wire::WireCmd commandId = WireCmd::SelectCommandBufferBuilder;
+
+        uint32_t builderId;
+
+        size_t GetRequiredSize() const;
+    };
+
     struct ReturnDeviceErrorCallbackCmd {
         wire::ReturnWireCmd commandId = ReturnWireCmd::DeviceErrorCallback;
 
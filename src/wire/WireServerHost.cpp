@@ -0,0 +1,223 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "wire/WireServerHost.h"
+
+#include "common/Assert.h"
+
+#include <algorithm>
+
+namespace nxt { namespace wire {
+
+    ServerHost::ServerHost(uint32_t threadCount) {
+        ASSERT(threadCount > 0);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            mThreads.emplace_back([this]() { WorkerThread(); });
+        }
+    }
+
+    ServerHost::~ServerHost() {
+        WaitIdle();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWorkAvailable.notify_all();
+        for (std::thread& thread : mThreads) {
+            thread.join();
+        }
+
+        // No thread uses the devices anymore, the servers can be destroyed in any order.
+        mClients.clear();
+    }
+
+    ServerHost::DeviceId ServerHost::AddDevice(nxtDevice device, const nxtProcTable& procs) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::unique_ptr<Device> deviceData(new Device);
+        deviceData->device = device;
+        deviceData->procs = procs;
+        mDevices.push_back(std::move(deviceData));
+
+        return static_cast<DeviceId>(mDevices.size() - 1);
+    }
+
+    ServerHost::ClientId ServerHost::AddClient(DeviceId deviceId,
+                                               CommandSerializer* serializer,
+                                               TransferBuffer* transferBuffer) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        ASSERT(deviceId < mDevices.size());
+        Device* device = mDevices[deviceId].get();
+
+        // Creating the server sets the device's error callback so no other thread must be
+        // handling commands for the device.
+        AcquireDevice(device, &lock);
+        lock.unlock();
+
+        std::unique_ptr<Client> client(new Client);
+        client->device = device;
+        client->serializer = serializer;
+        client->handler.reset(NewSharedDeviceServerCommandHandler(device->device, device->procs,
+                                                                  serializer, transferBuffer));
+
+        lock.lock();
+        device->clients.push_back(client.get());
+        mClients.push_back(std::move(client));
+        ReleaseDevice(device);
+
+        return static_cast<ClientId>(mClients.size() - 1);
+    }
+
+    void ServerHost::RemoveClient(ClientId clientId) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        ASSERT(clientId < mClients.size() && mClients[clientId] != nullptr);
+        Client* client = mClients[clientId].get();
+        Device* device = client->device;
+
+        mWorkDone.wait(lock, [client]() { return client->pendingBatches.empty(); });
+
+        // The last batch of the client might still be handled, wait for it to be done.
+        AcquireDevice(device, &lock);
+        ASSERT(!client->queued);
+
+        for (size_t i = 0; i < device->clients.size(); ++i) {
+            if (device->clients[i] == client) {
+                device->clients.erase(device->clients.begin() + i);
+                break;
+            }
+        }
+        std::unique_ptr<Client> removed = std::move(mClients[clientId]);
+
+        lock.unlock();
+        removed = nullptr;
+        lock.lock();
+
+        ReleaseDevice(device);
+    }
+
+    bool ServerHost::SubmitCommands(ClientId clientId, const uint8_t* commands, size_t size) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ASSERT(clientId < mClients.size() && mClients[clientId] != nullptr);
+        Client* client = mClients[clientId].get();
+        Device* device = client->device;
+
+        if (client->failed) {
+            return false;
+        }
+
+        client->pendingBatches.emplace_back(commands, commands + size);
+        mPendingBatchCount++;
+
+        if (!client->queued) {
+            device->runQueue.push_back(client);
+            client->queued = true;
+        }
+        if (!device->busy && !device->ready) {
+            mReadyDevices.push_back(device);
+            device->ready = true;
+            mWorkAvailable.notify_one();
+        }
+
+        return true;
+    }
+
+    void ServerHost::WaitIdle() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkDone.wait(lock, [this]() { return mPendingBatchCount == 0; });
+    }
+
+    void ServerHost::WorkerThread() {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        while (true) {
+            mWorkAvailable.wait(lock, [this]() { return mStopping || !mReadyDevices.empty(); });
+            if (mStopping) {
+                return;
+            }
+
+            Device* device = mReadyDevices.front();
+            mReadyDevices.pop_front();
+            device->ready = false;
+
+            // The device was acquired by AddClient or RemoveClient while it was waiting, it will
+            // be made ready again when they release it.
+            if (device->busy) {
+                continue;
+            }
+            device->busy = true;
+
+            // Handle one batch of the client at the front of the run queue, then let the other
+            // clients of the device and the other devices have a turn.
+            ASSERT(!device->runQueue.empty());
+            Client* client = device->runQueue.front();
+            device->runQueue.pop_front();
+            client->queued = false;
+
+            std::vector<uint8_t> batch = std::move(client->pendingBatches.front());
+            client->pendingBatches.pop_front();
+
+            lock.unlock();
+
+            bool success = client->handler->HandleCommands(batch.data(), batch.size()) != nullptr;
+
+            // Handling commands ticks the device, which can call callbacks for any of the clients
+            // of the device so all their return commands are flushed. The list of clients can't
+            // change while the device is used.
+            for (Client* deviceClient : device->clients) {
+                deviceClient->serializer->Flush();
+            }
+
+            lock.lock();
+
+            mPendingBatchCount--;
+            if (!success) {
+                client->failed = true;
+                mPendingBatchCount -= client->pendingBatches.size();
+                client->pendingBatches.clear();
+                if (client->queued) {
+                    device->runQueue.erase(
+                        std::find(device->runQueue.begin(), device->runQueue.end(), client));
+                    client->queued = false;
+                }
+            }
+            // More commands for the client might have been submitted while the device was used.
+            if (!client->queued && !client->pendingBatches.empty()) {
+                device->runQueue.push_back(client);
+                client->queued = true;
+            }
+
+            ReleaseDevice(device);
+            mWorkDone.notify_all();
+        }
+    }
+
+    void ServerHost::AcquireDevice(Device* device, std::unique_lock<std::mutex>* lock) {
+        mWorkDone.wait(*lock, [device]() { return !device->busy; });
+        device->busy = true;
+    }
+
+    void ServerHost::ReleaseDevice(Device* device) {
+        ASSERT(device->busy);
+        device->busy = false;
+
+        if (!device->runQueue.empty() && !device->ready) {
+            mReadyDevices.push_back(device);
+            device->ready = true;
+            mWorkAvailable.notify_one();
+        }
+        mWorkDone.notify_all();
+    }
+
+}}  // namespace nxt::wire
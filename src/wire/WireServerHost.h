@@ -0,0 +1,108 @@
+// Copyright 2017 The NXT Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef WIRE_WIRE_SERVER_HOST_H_
+#define WIRE_WIRE_SERVER_HOST_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "wire/Wire.h"
+
+namespace nxt { namespace wire {
+
+    // Serves many wire clients with a pool of threads. Each client has its own server command
+    // handler, and so its own object ID space, on one of the devices of the host. Clients on the
+    // same device share everything the device caches (deduplicated objects, pipeline caches...)
+    // and have their commands handled one at a time, while different devices are used
+    // concurrently. The devices must support being used from any thread, one thread at a time.
+    //
+    // Commands are handled in batches, in the order they were submitted for each client. The
+    // clients of a device take turns handling one batch and the devices with work take turns
+    // being given to the threads, so that a busy client can't starve the others.
+    class ServerHost {
+      public:
+        using DeviceId = uint32_t;
+        using ClientId = uint32_t;
+
+        ServerHost(uint32_t threadCount);
+        ~ServerHost();
+
+        // The device must stay alive until the host is destroyed.
+        DeviceId AddDevice(nxtDevice device, const nxtProcTable& procs);
+
+        // The return commands of the client are written to `serializer`, which is flushed after
+        // each batch of commands handled for any client of the device.
+        ClientId AddClient(DeviceId device,
+                           CommandSerializer* serializer,
+                           TransferBuffer* transferBuffer = nullptr);
+        // Waits for the client's commands to be handled before removing it.
+        void RemoveClient(ClientId client);
+
+        // Queues a copy of the commands to be handled for the client. Returns false if handling
+        // a previous batch of the client failed, in which case the commands are dropped.
+        bool SubmitCommands(ClientId client, const uint8_t* commands, size_t size);
+
+        // Waits until all the submitted commands have been handled.
+        void WaitIdle();
+
+      private:
+        struct Device;
+
+        struct Client {
+            Device* device = nullptr;
+            CommandSerializer* serializer = nullptr;
+            std::unique_ptr<CommandHandler> handler;
+            std::deque<std::vector<uint8_t>> pendingBatches;
+            // Whether the client is in its device's run queue.
+            bool queued = false;
+            bool failed = false;
+        };
+
+        struct Device {
+            nxtDevice device;
+            nxtProcTable procs;
+            std::vector<Client*> clients;
+            std::deque<Client*> runQueue;
+            // Whether a thread is using the device.
+            bool busy = false;
+            // Whether the device is in mReadyDevices.
+            bool ready = false;
+        };
+
+        void WorkerThread();
+        // Waits until no thread uses the device and reserves it for the calling thread.
+        void AcquireDevice(Device* device, std::unique_lock<std::mutex>* lock);
+        void ReleaseDevice(Device* device);
+
+        std::mutex mMutex;
+        std::condition_variable mWorkAvailable;
+        std::condition_variable mWorkDone;
+
+        std::vector<std::unique_ptr<Device>> mDevices;
+        std::vector<std::unique_ptr<Client>> mClients;
+        std::deque<Device*> mReadyDevices;
+        size_t mPendingBatchCount = 0;
+        bool mStopping = false;
+
+        std::vector<std::thread> mThreads;
+    };
+
+}}  // namespace nxt::wire
+
+#endif  // WIRE_WIRE_SERVER_HOST_H_
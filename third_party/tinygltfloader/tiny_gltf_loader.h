@@ -26,6 +26,7 @@
 
 // Version:
 //  - v0.9.5 Support parsing `extras` parameter.
+//           (NXT) Add TINYGLTF_LOADER_NO_IMAGE_DECODING to defer image decoding.
 //  - v0.9.4 Support parsing `shader`, `program` and `tecnique` thanks to
 //  @lukesanantonio
 //  - v0.9.3 Support binary glTF
@@ -883,6 +884,17 @@ static bool LoadExternalFile(std::vector<unsigned char> *out, std::string *err,
 static bool LoadImageData(Image *image, std::string *err, int req_width,
                           int req_height, const unsigned char *bytes,
                           int size) {
+#ifdef TINYGLTF_LOADER_NO_IMAGE_DECODING
+  // Keep the encoded image data so the application can decode it later, for
+  // example on other threads. `component` is 0 to tell it apart from decoded
+  // images.
+  (void)err;
+  image->width = req_width;
+  image->height = req_height;
+  image->component = 0;
+  image->image.assign(bytes, bytes + size);
+  return true;
+#else
   int w, h, comp;
   unsigned char *data = stbi_load_from_memory(bytes, size, &w, &h, &comp, 0);
   if (!data) {
@@ -929,6 +941,7 @@ static bool LoadImageData(Image *image, std::string *err, int req_width,
   free(data);
 
   return true;
+#endif
 }
 
 static bool IsDataURI(const std::string &in) {